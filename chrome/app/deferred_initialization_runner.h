@@ -8,44 +8,98 @@
 #import <Foundation/Foundation.h>
 
 #include "base/ios/block_types.h"
+#include "base/time/time.h"
 
 // Constants for deferred initialization of preferences observer.
 extern NSString* const kPrefObserverInit;
 
+// Priority of a deferred initialization block. Among the blocks ready to run,
+// blocks with a higher priority run first.
+typedef NS_ENUM(NSInteger, DeferredInitializationPriority) {
+  DeferredInitializationPriorityLow = 0,
+  DeferredInitializationPriorityNormal,
+  DeferredInitializationPriorityHigh,
+};
+
+// Thread on which a deferred initialization block runs.
+typedef NS_ENUM(NSInteger, DeferredInitializationThread) {
+  // The block runs on the main thread, when the main run loop is idle.
+  DeferredInitializationThreadMain = 0,
+  // The block runs on a background sequence as soon as it is ready. It must
+  // not use UIKit or objects owned by the main thread.
+  DeferredInitializationThreadBackground,
+};
+
+// Timeline entry describing the execution of a deferred initialization block.
+@interface DeferredInitializationRecord : NSObject
+
+// Name of the block.
+@property(nonatomic, copy, readonly) NSString* name;
+
+// Thread on which the block ran.
+@property(nonatomic, assign, readonly) DeferredInitializationThread thread;
+
+// Whether the block was run synchronously by |-runBlockIfNecessary:|.
+@property(nonatomic, assign, readonly) BOOL ranSynchronously;
+
+// Times at which the block was enqueued, started and finished.
+@property(nonatomic, assign, readonly) base::TimeTicks enqueueTime;
+@property(nonatomic, assign, readonly) base::TimeTicks startTime;
+@property(nonatomic, assign, readonly) base::TimeTicks endTime;
+
+@end
+
 // A singleton object to run initialization code asynchronously. Blocks are
-// scheduled to be run after a delay. The block is named when added to the
-// singleton so that other code can force a deferred block to be run
-// synchronously if necessary.
+// named when added to the singleton so that other code can force a deferred
+// block to be run synchronously if necessary.
+//
+// No block runs before |delayBeforeFirstBlock| has elapsed after the first
+// block is enqueued. After that, a block is ready once all its dependencies
+// have run. Ready background blocks are posted immediately, and ready main
+// thread blocks run one at a time, each time the main run loop is about to
+// become idle, so that they never delay pending UI work.
 @interface DeferredInitializationRunner : NSObject
 
 // Returns singleton instance.
 + (DeferredInitializationRunner*)sharedInstance;
 
-// Stores |block| under |name| to a queue of blocks to run. All blocks are run
-// sequentially with a small delay before the first block and between each
-// successive block. If a block is already registered under |name|, it is
-// replaced with |block| unless it has already been run.
+// Stores |block| under |name| to run it on the main thread with a normal
+// priority and no dependencies. If a block is already registered under
+// |name|, it is replaced with |block| unless it has already been run.
 - (void)enqueueBlockNamed:(NSString*)name block:(ProceduralBlock)block;
 
+// Stores |block| under |name| to run it on |thread| after the blocks named in
+// |dependencies| have run. Dependencies that are not pending, either because
+// they already ran, were cancelled or were never enqueued, are considered
+// satisfied. If a block is already registered under |name|, it is replaced
+// with |block| unless it has already been run.
+- (void)enqueueBlockNamed:(NSString*)name
+             dependencies:(NSArray<NSString*>*)dependencies
+                 priority:(DeferredInitializationPriority)priority
+                   thread:(DeferredInitializationThread)thread
+                    block:(ProceduralBlock)block;
+
 // Looks up a previously scheduled block of |name|. If block has not been
-// run yet, run it synchronously now.
+// run yet, run it synchronously now on the main thread, after its pending
+// dependencies. If the block or one of its dependencies is running on a
+// background sequence, blocks the main thread until it has finished.
 - (void)runBlockIfNecessary:(NSString*)name;
 
 // Cancels a previously scheduled block of |name|. This is a no-op if the
 // block has already been executed.
 - (void)cancelBlockNamed:(NSString*)name;
 
-// Number of blocks that have been registered but not executed yet.
+// Number of blocks that have been registered but not finished yet.
 // Exposed for testing.
 @property(nonatomic, readonly) NSUInteger numberOfBlocksRemaining;
 
+// Blocks that have finished running, in the order they finished.
+@property(nonatomic, readonly) NSArray<DeferredInitializationRecord*>* timeline;
+
 @end
 
 @interface DeferredInitializationRunner (ExposedForTesting)
 
-// Time interval between two blocks. Default value is 200ms.
-@property(nonatomic, assign) NSTimeInterval delayBetweenBlocks;
-
 // Time interval before running the first block. To override default value of
 // 3s, set this property before the first call to |-enqueueBlockNamed:block:|.
 @property(nonatomic, assign) NSTimeInterval delayBeforeFirstBlock;
@@ -6,7 +6,15 @@
 
 #include <stdint.h>
 
+#include "base/bind.h"
 #include "base/check.h"
+#include "base/mac/scoped_cftyperef.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/strings/sys_string_conversions.h"
+#include "base/task/thread_pool.h"
+#include "ios/chrome/browser/browser_state/keyed_service_startup_audit.h"
+#include "ios/chrome/browser/metrics/startup_tracer.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
 #error "This file requires ARC support."
@@ -14,6 +22,36 @@
 
 NSString* const kPrefObserverInit = @"PrefObserverInit";
 
+@interface DeferredInitializationRecord ()
+
+- (instancetype)initWithName:(NSString*)name
+                      thread:(DeferredInitializationThread)thread
+    NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property(nonatomic, assign, readwrite) BOOL ranSynchronously;
+@property(nonatomic, assign, readwrite) base::TimeTicks enqueueTime;
+@property(nonatomic, assign, readwrite) base::TimeTicks startTime;
+@property(nonatomic, assign, readwrite) base::TimeTicks endTime;
+
+@end
+
+@implementation DeferredInitializationRecord
+
+- (instancetype)initWithName:(NSString*)name
+                      thread:(DeferredInitializationThread)thread {
+  self = [super init];
+  if (self) {
+    _name = [name copy];
+    _thread = thread;
+    _enqueueTime = base::TimeTicks::Now();
+  }
+  return self;
+}
+
+@end
+
 // An object encapsulating the deferred execution of a block of initialization
 // code.
 @interface DeferredInitializationBlock : NSObject
@@ -22,61 +60,88 @@ NSString* const kPrefObserverInit = @"PrefObserverInit";
 
 // Designated initializer.
 - (instancetype)initWithName:(NSString*)name
+                dependencies:(NSArray<NSString*>*)dependencies
+                    priority:(DeferredInitializationPriority)priority
+                      thread:(DeferredInitializationThread)thread
                        block:(ProceduralBlock)block NS_DESIGNATED_INITIALIZER;
 
-// Executes the deferred block now.
+@property(nonatomic, copy, readonly) NSString* name;
+@property(nonatomic, copy, readonly) NSArray<NSString*>* dependencies;
+@property(nonatomic, assign, readonly) DeferredInitializationPriority priority;
+@property(nonatomic, assign, readonly) DeferredInitializationThread thread;
+@property(nonatomic, strong, readonly) DeferredInitializationRecord* record;
+// Dispatch group entered while the block runs on a background sequence, so
+// that the main thread can wait for it.
+@property(nonatomic, strong, readonly) dispatch_group_t runGroup;
+// Whether the runner has processed the end of the block. Main thread only.
+@property(nonatomic, assign) BOOL finished;
+
+// Executes the deferred block now, on the current thread, and records its
+// start and end times.
 - (void)run;
 
-// Cancels the block's execution.
-- (void)cancel;
-
 @end
 
 @implementation DeferredInitializationBlock {
-  // A string to reference the initialization block.
-  NSString* _name;
   // A block of code to execute.
   ProceduralBlock _runBlock;
 }
 
-- (instancetype)initWithName:(NSString*)name block:(ProceduralBlock)block {
+- (instancetype)initWithName:(NSString*)name
+                dependencies:(NSArray<NSString*>*)dependencies
+                    priority:(DeferredInitializationPriority)priority
+                      thread:(DeferredInitializationThread)thread
+                       block:(ProceduralBlock)block {
   DCHECK(block);
+  DCHECK(![dependencies containsObject:name]);
   self = [super init];
   if (self) {
     _name = [name copy];
+    _dependencies = [dependencies copy] ?: @[];
+    _priority = priority;
+    _thread = thread;
     _runBlock = block;
+    _record = [[DeferredInitializationRecord alloc] initWithName:name
+                                                          thread:thread];
+    _runGroup = dispatch_group_create();
   }
   return self;
 }
 
 - (void)run {
-  DCHECK([NSThread isMainThread]);
   ProceduralBlock deferredBlock = _runBlock;
-  if (!deferredBlock)
-    return;
-  deferredBlock();
-  [[DeferredInitializationRunner sharedInstance] cancelBlockNamed:_name];
-}
-
-- (void)cancel {
   _runBlock = nil;
+  DCHECK(deferredBlock);
+  _record.startTime = base::TimeTicks::Now();
+  // Attribute the keyed services created by a main thread block to it.
+  const std::string requester = base::SysNSStringToUTF8(_name);
+  absl::optional<KeyedServiceStartupAudit::ScopedRequester> scopedRequester;
+  if (_thread == DeferredInitializationThreadMain)
+    scopedRequester.emplace(requester.c_str());
+  deferredBlock();
+  _record.endTime = base::TimeTicks::Now();
 }
 
 @end
 
 @interface DeferredInitializationRunner () {
-  NSMutableArray* _blocksNameQueue;
-  NSMutableDictionary* _runBlocks;
-  BOOL _isBlockScheduled;
+  // Blocks that have not started yet, keyed by name.
+  NSMutableDictionary<NSString*, DeferredInitializationBlock*>* _pendingBlocks;
+  // Names of |_pendingBlocks|, in the order they were enqueued.
+  NSMutableArray<NSString*>* _pendingNames;
+  // Background blocks that have started but not finished yet, keyed by name.
+  NSMutableDictionary<NSString*, DeferredInitializationBlock*>* _runningBlocks;
+  // Records of the blocks that have finished.
+  NSMutableArray<DeferredInitializationRecord*>* _timeline;
+  // Observer of the main run loop, installed while main thread blocks are
+  // ready to run.
+  base::ScopedCFTypeRef<CFRunLoopObserverRef> _idleObserver;
+  // Whether the delay before the first block has been scheduled, and whether
+  // it has elapsed.
+  BOOL _startScheduled;
+  BOOL _started;
 }
 
-// Schedule the next block to be run after |delay| it will automatically
-// schedule the next block after |delayBetweenBlocks|.
-- (void)scheduleNextBlockWithDelay:(NSTimeInterval)delay;
-
-// Time interval between two blocks. Default value is 200ms.
-@property(nonatomic) NSTimeInterval delayBetweenBlocks;
-
 // Time interval before running the first block. Default value is 3s.
 @property(nonatomic) NSTimeInterval delayBeforeFirstBlock;
 
@@ -84,7 +149,6 @@ NSString* const kPrefObserverInit = @"PrefObserverInit";
 
 @implementation DeferredInitializationRunner
 
-@synthesize delayBetweenBlocks = _delayBetweenBlocks;
 @synthesize delayBeforeFirstBlock = _delayBeforeFirstBlock;
 
 + (DeferredInitializationRunner*)sharedInstance {
@@ -99,69 +163,271 @@ NSString* const kPrefObserverInit = @"PrefObserverInit";
 - (instancetype)init {
   self = [super init];
   if (self) {
-    _blocksNameQueue = [NSMutableArray array];
-    _runBlocks = [NSMutableDictionary dictionary];
-    _isBlockScheduled = NO;
-    _delayBetweenBlocks = 0.2;
+    _pendingBlocks = [NSMutableDictionary dictionary];
+    _pendingNames = [NSMutableArray array];
+    _runningBlocks = [NSMutableDictionary dictionary];
+    _timeline = [NSMutableArray array];
     _delayBeforeFirstBlock = 3.0;
   }
   return self;
 }
 
+- (void)dealloc {
+  [self removeIdleObserver];
+}
+
 - (void)enqueueBlockNamed:(NSString*)name block:(ProceduralBlock)block {
+  [self enqueueBlockNamed:name
+             dependencies:nil
+                 priority:DeferredInitializationPriorityNormal
+                   thread:DeferredInitializationThreadMain
+                    block:block];
+}
+
+- (void)enqueueBlockNamed:(NSString*)name
+             dependencies:(NSArray<NSString*>*)dependencies
+                 priority:(DeferredInitializationPriority)priority
+                   thread:(DeferredInitializationThread)thread
+                    block:(ProceduralBlock)block {
   DCHECK(name);
   DCHECK([NSThread isMainThread]);
   [self cancelBlockNamed:name];
-  [_blocksNameQueue addObject:name];
 
   DeferredInitializationBlock* deferredBlock =
-      [[DeferredInitializationBlock alloc] initWithName:name block:block];
-  [_runBlocks setObject:deferredBlock forKey:name];
+      [[DeferredInitializationBlock alloc] initWithName:name
+                                           dependencies:dependencies
+                                               priority:priority
+                                                 thread:thread
+                                                  block:block];
+  [_pendingBlocks setObject:deferredBlock forKey:name];
+  [_pendingNames addObject:name];
+
+  if (!_startScheduled) {
+    _startScheduled = YES;
+    __weak DeferredInitializationRunner* weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW,
+                                 (int64_t)(self.delayBeforeFirstBlock *
+                                           NSEC_PER_SEC)),
+                   dispatch_get_main_queue(), ^{
+                     [weakSelf start];
+                   });
+  } else {
+    [self scheduleReadyBlocks];
+  }
+}
 
-  if (!_isBlockScheduled) {
-    [self scheduleNextBlockWithDelay:self.delayBeforeFirstBlock];
+- (void)runBlockIfNecessary:(NSString*)name {
+  DCHECK([NSThread isMainThread]);
+  DeferredInitializationBlock* runningBlock =
+      [_runningBlocks objectForKey:name];
+  if (runningBlock) {
+    [self waitForRunningBlock:runningBlock];
+    return;
   }
+
+  DeferredInitializationBlock* deferredBlock =
+      [_pendingBlocks objectForKey:name];
+  if (!deferredBlock)
+    return;
+
+  // Dependencies must run first, synchronously as well. Dependencies running
+  // on a background sequence are waited for.
+  for (NSString* dependency in deferredBlock.dependencies) {
+    [self runBlockIfNecessary:dependency];
+  }
+
+  // Running a dependency may have run or cancelled the block.
+  if ([_pendingBlocks objectForKey:name] != deferredBlock)
+    return;
+
+  deferredBlock.record.ranSynchronously = YES;
+  [self removePendingBlock:deferredBlock];
+  [deferredBlock run];
+  [self didFinishBlock:deferredBlock];
 }
 
-- (void)scheduleNextBlockWithDelay:(NSTimeInterval)delay {
+- (void)cancelBlockNamed:(NSString*)name {
   DCHECK([NSThread isMainThread]);
-  _isBlockScheduled = NO;
-  NSString* nextBlockName = [_blocksNameQueue firstObject];
-  if (!nextBlockName)
+  DCHECK(name);
+  DeferredInitializationBlock* deferredBlock =
+      [_pendingBlocks objectForKey:name];
+  if (!deferredBlock)
     return;
 
-  DeferredInitializationBlock* nextBlock =
-      [_runBlocks objectForKey:nextBlockName];
-  DCHECK(nextBlock);
+  [self removePendingBlock:deferredBlock];
+  // The dependents of the cancelled block may now be ready.
+  [self scheduleReadyBlocks];
+}
+
+- (NSUInteger)numberOfBlocksRemaining {
+  return [_pendingBlocks count] + [_runningBlocks count];
+}
 
-  __weak DeferredInitializationRunner* weakSelf = self;
+- (NSArray<DeferredInitializationRecord*>*)timeline {
+  return [_timeline copy];
+}
 
-  dispatch_after(
-      dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
-      dispatch_get_main_queue(), ^{
-        [nextBlock run];
-        [weakSelf scheduleNextBlockWithDelay:[weakSelf delayBetweenBlocks]];
-      });
+#pragma mark - Private
 
-  _isBlockScheduled = YES;
-  [_blocksNameQueue removeObjectAtIndex:0];
+// Called once the delay before the first block has elapsed.
+- (void)start {
+  _started = YES;
+  [self scheduleReadyBlocks];
 }
 
-- (void)runBlockIfNecessary:(NSString*)name {
+// Removes |deferredBlock| from the pending blocks.
+- (void)removePendingBlock:(DeferredInitializationBlock*)deferredBlock {
+  [_pendingBlocks removeObjectForKey:deferredBlock.name];
+  [_pendingNames removeObject:deferredBlock.name];
+}
+
+// Returns whether all the dependencies of |deferredBlock| have run.
+- (BOOL)isReady:(DeferredInitializationBlock*)deferredBlock {
+  for (NSString* dependency in deferredBlock.dependencies) {
+    if ([_pendingBlocks objectForKey:dependency] ||
+        [_runningBlocks objectForKey:dependency]) {
+      return NO;
+    }
+  }
+  return YES;
+}
+
+// Returns the ready main thread block with the highest priority, enqueued
+// first among those with the same priority, or nil if there is none.
+- (DeferredInitializationBlock*)nextReadyMainThreadBlock {
+  DeferredInitializationBlock* nextBlock = nil;
+  for (NSString* name in _pendingNames) {
+    DeferredInitializationBlock* deferredBlock =
+        [_pendingBlocks objectForKey:name];
+    if (deferredBlock.thread != DeferredInitializationThreadMain)
+      continue;
+    if (nextBlock && deferredBlock.priority <= nextBlock.priority)
+      continue;
+    if ([self isReady:deferredBlock])
+      nextBlock = deferredBlock;
+  }
+  return nextBlock;
+}
+
+// Posts the ready background blocks, and waits for the main run loop to be
+// idle if main thread blocks are ready.
+- (void)scheduleReadyBlocks {
+  if (!_started)
+    return;
+
+  for (NSString* name in [_pendingNames copy]) {
+    DeferredInitializationBlock* deferredBlock =
+        [_pendingBlocks objectForKey:name];
+    if (deferredBlock.thread == DeferredInitializationThreadBackground &&
+        [self isReady:deferredBlock]) {
+      [self postBackgroundBlock:deferredBlock];
+    }
+  }
+
+  if ([self nextReadyMainThreadBlock]) {
+    [self installIdleObserver];
+  } else {
+    [self removeIdleObserver];
+  }
+}
+
+// Runs |deferredBlock| on a background sequence.
+- (void)postBackgroundBlock:(DeferredInitializationBlock*)deferredBlock {
+  [self removePendingBlock:deferredBlock];
+  [_runningBlocks setObject:deferredBlock forKey:deferredBlock.name];
+
+  const base::TaskPriority taskPriority =
+      deferredBlock.priority == DeferredInitializationPriorityHigh
+          ? base::TaskPriority::USER_VISIBLE
+          : base::TaskPriority::BEST_EFFORT;
+  dispatch_group_t runGroup = deferredBlock.runGroup;
+  dispatch_group_enter(runGroup);
+  __weak DeferredInitializationRunner* weakSelf = self;
+  base::ThreadPool::PostTaskAndReply(FROM_HERE,
+                                     {base::MayBlock(), taskPriority},
+                                     base::BindOnce(^{
+                                       [deferredBlock run];
+                                       dispatch_group_leave(runGroup);
+                                     }),
+                                     base::BindOnce(^{
+                                       [weakSelf didFinishBlock:deferredBlock];
+                                     }));
+}
+
+// Blocks the main thread until |deferredBlock|, which runs on a background
+// sequence, has finished, for callers relying on its side effects. Background
+// blocks must therefore never wait for the main thread.
+- (void)waitForRunningBlock:(DeferredInitializationBlock*)deferredBlock {
   DCHECK([NSThread isMainThread]);
-  [[_runBlocks objectForKey:name] run];
+  dispatch_group_wait(deferredBlock.runGroup, DISPATCH_TIME_FOREVER);
+  [self didFinishBlock:deferredBlock];
 }
 
-- (void)cancelBlockNamed:(NSString*)name {
+// Called on the main thread when |deferredBlock| has finished running.
+- (void)didFinishBlock:(DeferredInitializationBlock*)deferredBlock {
   DCHECK([NSThread isMainThread]);
-  DCHECK(name);
-  [_blocksNameQueue removeObject:name];
-  [[_runBlocks objectForKey:name] cancel];
-  [_runBlocks removeObjectForKey:name];
+  // The end of a background block which was waited for is processed before
+  // the reply of its task.
+  if (deferredBlock.finished)
+    return;
+  deferredBlock.finished = YES;
+  [_runningBlocks removeObjectForKey:deferredBlock.name];
+
+  DeferredInitializationRecord* record = deferredBlock.record;
+  [_timeline addObject:record];
+  base::UmaHistogramTimes("IOS.DeferredInitialization.BlockDuration",
+                          record.endTime - record.startTime);
+  if (!record.ranSynchronously) {
+    base::UmaHistogramMediumTimes("IOS.DeferredInitialization.BlockDelay",
+                                  record.startTime - record.enqueueTime);
+  }
+  const std::string spanName =
+      "Deferred." + base::SysNSStringToUTF8(record.name);
+  StartupTracer::GetInstance()->RecordSpan(spanName.c_str(), record.startTime,
+                                           record.endTime);
+
+  [self scheduleReadyBlocks];
 }
 
-- (NSUInteger)numberOfBlocksRemaining {
-  return [_runBlocks count];
+// Called when the main run loop is about to wait for events.
+- (void)mainRunLoopWillBecomeIdle {
+  DeferredInitializationBlock* deferredBlock = [self nextReadyMainThreadBlock];
+  if (deferredBlock) {
+    [self removePendingBlock:deferredBlock];
+    [deferredBlock run];
+    [self didFinishBlock:deferredBlock];
+  }
+
+  // Only run one block per run loop iteration, and give the run loop a chance
+  // to process pending events before running the next one.
+  if (_idleObserver)
+    CFRunLoopWakeUp(CFRunLoopGetMain());
+}
+
+- (void)installIdleObserver {
+  if (_idleObserver)
+    return;
+
+  __weak DeferredInitializationRunner* weakSelf = self;
+  _idleObserver.reset(CFRunLoopObserverCreateWithHandler(
+      kCFAllocatorDefault, kCFRunLoopBeforeWaiting, /*repeats=*/true,
+      /*order=*/0,
+      ^(CFRunLoopObserverRef observer, CFRunLoopActivity activity) {
+        [weakSelf mainRunLoopWillBecomeIdle];
+      }));
+  // Only observe the default mode, so that no block runs during scrolling or
+  // other event tracking.
+  CFRunLoopAddObserver(CFRunLoopGetMain(), _idleObserver,
+                       kCFRunLoopDefaultMode);
+  CFRunLoopWakeUp(CFRunLoopGetMain());
+}
+
+- (void)removeIdleObserver {
+  if (!_idleObserver)
+    return;
+
+  CFRunLoopObserverInvalidate(_idleObserver);
+  _idleObserver.reset();
 }
 
 @end
@@ -5,14 +5,22 @@
 #import "ios/chrome/app/deferred_initialization_runner.h"
 
 #import "base/test/ios/wait_util.h"
+#include "base/test/task_environment.h"
 #include "base/time/time.h"
+#include "testing/gtest_mac.h"
 #include "testing/platform_test.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
 #error "This file requires ARC support."
 #endif
 
-using DeferredInitializationRunnerTest = PlatformTest;
+class DeferredInitializationRunnerTest : public PlatformTest {
+ protected:
+  // Background blocks are posted to the thread pool, and main thread blocks
+  // run when the UI message loop is idle.
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::MainThreadType::UI};
+};
 
 TEST_F(DeferredInitializationRunnerTest, TestSharedInstance) {
   EXPECT_TRUE([DeferredInitializationRunner sharedInstance]);
@@ -27,7 +35,7 @@ TEST_F(DeferredInitializationRunnerTest, TestRunBlockSequentially) {
   __block bool firstFlag = NO;
   __block bool secondFlag = NO;
   DeferredInitializationRunner* runner =
-      [DeferredInitializationRunner sharedInstance];
+      [[DeferredInitializationRunner alloc] init];
   ProceduralBlock firstBlock = ^{
     EXPECT_FALSE(firstFlag);
     firstFlag = YES;
@@ -39,7 +47,6 @@ TEST_F(DeferredInitializationRunnerTest, TestRunBlockSequentially) {
   ConditionBlock secondBlockRun = ^bool {
     return secondFlag;
   };
-  runner.delayBetweenBlocks = 0.01;
   runner.delayBeforeFirstBlock = 0.01;
 
   [runner enqueueBlockNamed:@"first block" block:firstBlock];
@@ -65,29 +72,24 @@ TEST_F(DeferredInitializationRunnerTest, TestRunBlock) {
   __block bool quickFlag = NO;
   __block bool slowFlag = NO;
   DeferredInitializationRunner* runner =
-      [DeferredInitializationRunner sharedInstance];
+      [[DeferredInitializationRunner alloc] init];
   ProceduralBlock quickBlock = ^{
     EXPECT_FALSE(quickFlag);
     quickFlag = YES;
-    // Make sure we have time to go back to this test before running the second
-    // task.
-    runner.delayBetweenBlocks = 1;
-  };
-  ConditionBlock quickBlockRun = ^bool {
-    return quickFlag;
   };
   ProceduralBlock slowBlock = ^{
     EXPECT_FALSE(slowFlag);
     slowFlag = YES;
   };
-  runner.delayBeforeFirstBlock = 0.01;
+  // Make sure no block runs asynchronously during the test.
+  runner.delayBeforeFirstBlock = 1000;
 
   // Action.
   [runner enqueueBlockNamed:@"quick block" block:quickBlock];
   [runner enqueueBlockNamed:@"slow block" block:slowBlock];
+  [runner runBlockIfNecessary:@"quick block"];
 
   // Test.
-  base::test::ios::WaitUntilCondition(quickBlockRun);
   EXPECT_TRUE(quickFlag);
   EXPECT_FALSE(slowFlag);
   EXPECT_EQ(1U, [runner numberOfBlocksRemaining]);
@@ -104,9 +106,8 @@ TEST_F(DeferredInitializationRunnerTest, TestCancelBlock) {
   // Setup.
   __block BOOL blockFinished = NO;
   DeferredInitializationRunner* runner =
-      [DeferredInitializationRunner sharedInstance];
+      [[DeferredInitializationRunner alloc] init];
   runner.delayBeforeFirstBlock = 0.01;
-  runner.delayBetweenBlocks = 0.01;
 
   [runner enqueueBlockNamed:@"cancel me"
                       block:^{
@@ -127,9 +128,8 @@ TEST_F(DeferredInitializationRunnerTest, TestCancelledBlockDoNothing) {
   // Setup.
   __block BOOL blockFinished = NO;
   DeferredInitializationRunner* runner =
-      [DeferredInitializationRunner sharedInstance];
+      [[DeferredInitializationRunner alloc] init];
   runner.delayBeforeFirstBlock = 0.01;
-  runner.delayBetweenBlocks = 0.01;
 
   [runner enqueueBlockNamed:@"cancel me"
                       block:^{
@@ -154,9 +154,8 @@ TEST_F(DeferredInitializationRunnerTest, TestSecondBlockInvalidatesFirst) {
     ++blockRunCount;
   };
   DeferredInitializationRunner* runner =
-      [DeferredInitializationRunner sharedInstance];
+      [[DeferredInitializationRunner alloc] init];
   runner.delayBeforeFirstBlock = 0.01;
-  runner.delayBetweenBlocks = 0.01;
 
   // Action.
   [runner enqueueBlockNamed:@"multiple" block:runBlock];
@@ -168,3 +167,165 @@ TEST_F(DeferredInitializationRunnerTest, TestSecondBlockInvalidatesFirst) {
   EXPECT_EQ(0U, [runner numberOfBlocksRemaining]);
   EXPECT_EQ(1, blockRunCount);
 }
+
+// Tests that a block only runs after its dependencies, and that ready blocks
+// run by decreasing priority.
+TEST_F(DeferredInitializationRunnerTest, TestDependenciesAndPriority) {
+  // Setup.
+  NSMutableArray<NSString*>* executionOrder = [NSMutableArray array];
+  DeferredInitializationRunner* runner =
+      [[DeferredInitializationRunner alloc] init];
+  runner.delayBeforeFirstBlock = 0.01;
+
+  // Action.
+  [runner enqueueBlockNamed:@"dependent"
+               dependencies:@[ @"low" ]
+                   priority:DeferredInitializationPriorityHigh
+                     thread:DeferredInitializationThreadMain
+                      block:^{
+                        [executionOrder addObject:@"dependent"];
+                      }];
+  [runner enqueueBlockNamed:@"low"
+               dependencies:nil
+                   priority:DeferredInitializationPriorityLow
+                     thread:DeferredInitializationThreadMain
+                      block:^{
+                        [executionOrder addObject:@"low"];
+                      }];
+  [runner enqueueBlockNamed:@"high"
+               dependencies:nil
+                   priority:DeferredInitializationPriorityHigh
+                     thread:DeferredInitializationThreadMain
+                      block:^{
+                        [executionOrder addObject:@"high"];
+                      }];
+  base::test::ios::WaitUntilCondition(^bool {
+    return [runner numberOfBlocksRemaining] == 0;
+  });
+
+  // Test.
+  NSArray<NSString*>* expectedOrder = @[ @"high", @"low", @"dependent" ];
+  EXPECT_NSEQ(expectedOrder, executionOrder);
+}
+
+// Tests that running a block synchronously runs its pending dependencies
+// first.
+TEST_F(DeferredInitializationRunnerTest, TestRunBlockRunsDependencies) {
+  // Setup.
+  __block BOOL dependencyFinished = NO;
+  __block BOOL blockFinished = NO;
+  DeferredInitializationRunner* runner =
+      [[DeferredInitializationRunner alloc] init];
+  runner.delayBeforeFirstBlock = 1000;
+
+  [runner enqueueBlockNamed:@"dependency"
+                      block:^{
+                        dependencyFinished = YES;
+                      }];
+  [runner enqueueBlockNamed:@"block"
+               dependencies:@[ @"dependency" ]
+                   priority:DeferredInitializationPriorityNormal
+                     thread:DeferredInitializationThreadMain
+                      block:^{
+                        EXPECT_TRUE(dependencyFinished);
+                        blockFinished = YES;
+                      }];
+
+  // Action.
+  [runner runBlockIfNecessary:@"block"];
+
+  // Test.
+  EXPECT_TRUE(dependencyFinished);
+  EXPECT_TRUE(blockFinished);
+  EXPECT_EQ(0U, [runner numberOfBlocksRemaining]);
+  ASSERT_EQ(2U, runner.timeline.count);
+  EXPECT_NSEQ(@"dependency", runner.timeline[0].name);
+  EXPECT_TRUE(runner.timeline[1].ranSynchronously);
+}
+
+// Tests that background blocks run off the main thread and are recorded in
+// the timeline.
+TEST_F(DeferredInitializationRunnerTest, TestBackgroundBlock) {
+  // Setup.
+  __block BOOL ranOnMainThread = YES;
+  DeferredInitializationRunner* runner =
+      [[DeferredInitializationRunner alloc] init];
+  runner.delayBeforeFirstBlock = 0.01;
+
+  // Action.
+  [runner enqueueBlockNamed:@"background"
+               dependencies:nil
+                   priority:DeferredInitializationPriorityNormal
+                     thread:DeferredInitializationThreadBackground
+                      block:^{
+                        ranOnMainThread = [NSThread isMainThread];
+                      }];
+  base::test::ios::WaitUntilCondition(^bool {
+    return [runner numberOfBlocksRemaining] == 0;
+  });
+
+  // Test.
+  EXPECT_FALSE(ranOnMainThread);
+  ASSERT_EQ(1U, runner.timeline.count);
+  DeferredInitializationRecord* record = runner.timeline[0];
+  EXPECT_NSEQ(@"background", record.name);
+  EXPECT_EQ(DeferredInitializationThreadBackground, record.thread);
+  EXPECT_FALSE(record.ranSynchronously);
+  EXPECT_LE(record.enqueueTime, record.startTime);
+  EXPECT_LE(record.startTime, record.endTime);
+}
+
+// Tests that running a block synchronously waits for its dependencies running
+// on a background sequence.
+TEST_F(DeferredInitializationRunnerTest, TestRunBlockWaitsForDependency) {
+  // Setup.
+  dispatch_semaphore_t dependencyStarted = dispatch_semaphore_create(0);
+  dispatch_semaphore_t releaseDependency = dispatch_semaphore_create(0);
+  __block BOOL dependencyFinished = NO;
+  __block BOOL blockFinished = NO;
+  DeferredInitializationRunner* runner =
+      [[DeferredInitializationRunner alloc] init];
+  runner.delayBeforeFirstBlock = 0.01;
+
+  [runner enqueueBlockNamed:@"dependency"
+               dependencies:nil
+                   priority:DeferredInitializationPriorityNormal
+                     thread:DeferredInitializationThreadBackground
+                      block:^{
+                        dispatch_semaphore_signal(dependencyStarted);
+                        dispatch_semaphore_wait(releaseDependency,
+                                                DISPATCH_TIME_FOREVER);
+                        dependencyFinished = YES;
+                      }];
+  [runner enqueueBlockNamed:@"block"
+               dependencies:@[ @"dependency" ]
+                   priority:DeferredInitializationPriorityNormal
+                     thread:DeferredInitializationThreadMain
+                      block:^{
+                        EXPECT_TRUE(dependencyFinished);
+                        blockFinished = YES;
+                      }];
+  base::test::ios::WaitUntilCondition(^bool {
+    return dispatch_semaphore_wait(dependencyStarted, DISPATCH_TIME_NOW) == 0;
+  });
+
+  // Action: release the dependency while the main thread waits for it.
+  dispatch_after(
+      dispatch_time(DISPATCH_TIME_NOW, 50 * NSEC_PER_MSEC),
+      dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        dispatch_semaphore_signal(releaseDependency);
+      });
+  [runner runBlockIfNecessary:@"block"];
+
+  // Test.
+  EXPECT_TRUE(dependencyFinished);
+  EXPECT_TRUE(blockFinished);
+  EXPECT_EQ(0U, [runner numberOfBlocksRemaining]);
+
+  // Verify that the reply of the background task does not record the
+  // dependency twice.
+  task_environment_.RunUntilIdle();
+  ASSERT_EQ(2U, runner.timeline.count);
+  EXPECT_NSEQ(@"dependency", runner.timeline[0].name);
+  EXPECT_NSEQ(@"block", runner.timeline[1].name);
+}
@@ -7,6 +7,7 @@
 
 #include <memory>
 
+#include "base/feature_list.h"
 #include "base/ios/ios_util.h"
 #include "base/mac/bundle_locations.h"
 #include "base/mac/foundation_util.h"
@@ -55,6 +56,7 @@
 #include "ios/chrome/browser/browser_state/chrome_browser_state.h"
 #include "ios/chrome/browser/browser_state/chrome_browser_state_manager.h"
 #include "ios/chrome/browser/browser_state/chrome_browser_state_removal_controller.h"
+#include "ios/chrome/browser/browser_state/keyed_service_startup_audit.h"
 #include "ios/chrome/browser/browsing_data/browsing_data_remover.h"
 #include "ios/chrome/browser/browsing_data/browsing_data_remover_factory.h"
 #import "ios/chrome/browser/browsing_data/sessions_storage_util.h"
@@ -65,18 +67,23 @@
 #include "ios/chrome/browser/crash_report/crash_loop_detection_util.h"
 #include "ios/chrome/browser/crash_report/crash_report_helper.h"
 #import "ios/chrome/browser/crash_report/crash_restore_helper.h"
+#include "ios/chrome/browser/crash_report/main_thread_jank_monitor.h"
 #include "ios/chrome/browser/credential_provider/credential_provider_buildflags.h"
 #include "ios/chrome/browser/download/download_directory_util.h"
 #import "ios/chrome/browser/external_files/external_file_remover_factory.h"
 #import "ios/chrome/browser/external_files/external_file_remover_impl.h"
 #include "ios/chrome/browser/feature_engagement/tracker_factory.h"
 #import "ios/chrome/browser/first_run/first_run.h"
+#include "ios/chrome/browser/history/domain_diversity_reporter_factory.h"
 #include "ios/chrome/browser/main/browser.h"
 #import "ios/chrome/browser/main/browser_list.h"
 #import "ios/chrome/browser/main/browser_list_factory.h"
+#import "ios/chrome/browser/memory/memory_attribution_sampler.h"
+#import "ios/chrome/browser/memory/memory_attribution_sampler_factory.h"
 #import "ios/chrome/browser/memory/memory_debugger_manager.h"
 #include "ios/chrome/browser/metrics/first_user_action_recorder.h"
 #import "ios/chrome/browser/metrics/incognito_usage_app_state_agent.h"
+#include "ios/chrome/browser/metrics/startup_tracer.h"
 #import "ios/chrome/browser/metrics/window_configuration_recorder.h"
 #import "ios/chrome/browser/net/cookie_util.h"
 #import "ios/chrome/browser/omaha/omaha_service.h"
@@ -90,6 +97,7 @@
 #import "ios/chrome/browser/share_extension/share_extension_service_factory.h"
 #include "ios/chrome/browser/signin/authentication_service_delegate.h"
 #include "ios/chrome/browser/signin/authentication_service_factory.h"
+#include "ios/chrome/browser/signin/signin_browser_state_info_updater_factory.h"
 #import "ios/chrome/browser/snapshots/snapshot_browser_agent.h"
 #import "ios/chrome/browser/snapshots/snapshot_cache.h"
 #include "ios/chrome/browser/system_flags.h"
@@ -138,6 +146,10 @@ NSString* const kStartupAttemptReset = @"StartupAttempReset";
 // Constants for deferring memory debugging tools startup.
 NSString* const kMemoryDebuggingToolsStartup = @"MemoryDebuggingToolsStartup";
 
+// Constant for deferring the start of the memory attribution sampling.
+NSString* const kStartMemoryAttributionSampling =
+    @"StartMemoryAttributionSampling";
+
 // Constant for deferring the cleanup of discarded sessions on disk.
 NSString* const kCleanupDiscardedSessions = @"CleanupDiscardedSessions";
 
@@ -179,6 +191,14 @@ NSString* const kEnterpriseManagedDeviceCheck = @"EnterpriseManagedDeviceCheck";
 // Constants for deferred deletion of leftover session state files.
 NSString* const kPurgeWebSessionStates = @"PurgeWebSessionStates";
 
+// Constants for deferring the creation of the keyed services that are not
+// needed for the first paint.
+NSString* const kCreateDeferredKeyedServices = @"CreateDeferredKeyedServices";
+
+// Name of the file in the Documents directory to which the startup trace is
+// exported, when enabled in the experimental settings.
+const char kStartupTraceFileName[] = "startup_trace.json";
+
 // Adapted from chrome/browser/ui/browser_init.cc.
 void RegisterComponentsForUpdate() {
   component_updater::ComponentUpdateService* cus =
@@ -315,6 +335,8 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
 - (void)scheduleAppDistributionPings;
 // Asynchronously schedule the init of the memoryDebuggerManager.
 - (void)scheduleMemoryDebuggingTools;
+// Asynchronously starts sampling the memory cost of the WebStates.
+- (void)scheduleMemoryAttributionSampling;
 // Starts logging breadcrumbs.
 - (void)startLoggingBreadcrumbs;
 // Asynchronously kick off regular free memory checks.
@@ -333,6 +355,9 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
 - (void)scheduleLowPriorityStartupTasks;
 // Schedules tasks that require a fully-functional BVC to be performed.
 - (void)scheduleTasksRequiringBVCWithBrowserState;
+// Schedules the creation of the keyed services that are no longer created with
+// the browser state.
+- (void)scheduleDeferredKeyedServicesCreation;
 // Schedules the deletion of user downloaded files that might be leftover
 // from the last time Chrome was run.
 - (void)scheduleDeleteTempDownloadsDirectory;
@@ -384,6 +409,13 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
   _appLaunchTime = IOSChromeMain::StartTime();
   _isColdStart = YES;
 
+  StartupTracer* startupTracer = StartupTracer::GetInstance();
+  startupTracer->SetProcessStartTime(_appLaunchTime);
+  if (experimental_flags::ShouldExportStartupTrace()) {
+    startupTracer->SetExportPath(
+        base::mac::GetUserDocumentPath().Append(kStartupTraceFileName));
+  }
+
   [SetupDebugging setUpDebuggingOptions];
 
   // Register all providers before calling any Chromium code.
@@ -502,6 +534,8 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
     [self startLoggingBreadcrumbs];
   }
 
+  MainThreadJankMonitor::GetInstance()->Start();
+
   // Force an obvious initialization of the AuthenticationService. This must
   // be done before creation of the UI to ensure the service is initialised
   // before use (it is a security issue, so accessing the service CHECK if
@@ -793,6 +827,9 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
   __weak MainController* weakSelf = self;
   [[DeferredInitializationRunner sharedInstance]
       enqueueBlockNamed:kPrefObserverInit
+           dependencies:nil
+               priority:DeferredInitializationPriorityHigh
+                 thread:DeferredInitializationThreadMain
                   block:^{
                     [weakSelf initializePrefObservers];
                   }];
@@ -849,6 +886,9 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
 - (void)scheduleStartupAttemptReset {
   [[DeferredInitializationRunner sharedInstance]
       enqueueBlockNamed:kStartupAttemptReset
+           dependencies:nil
+               priority:DeferredInitializationPriorityHigh
+                 thread:DeferredInitializationThreadMain
                   block:^{
                     crash_util::ResetFailedStartupAttemptCount();
                   }];
@@ -857,6 +897,9 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
 - (void)scheduleCrashReportCleanup {
   [[DeferredInitializationRunner sharedInstance]
       enqueueBlockNamed:kCleanupCrashReports
+           dependencies:nil
+               priority:DeferredInitializationPriorityLow
+                 thread:DeferredInitializationThreadMain
                   block:^{
                     bool afterUpgrade = [self isFirstLaunchAfterUpgrade];
                     crash_helper::CleanupCrashReports(afterUpgrade);
@@ -874,6 +917,9 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
 - (void)scheduleSnapshotsCleanup {
   [[DeferredInitializationRunner sharedInstance]
       enqueueBlockNamed:kCleanupSnapshots
+           dependencies:@[ kCleanupDiscardedSessions ]
+               priority:DeferredInitializationPriorityNormal
+                 thread:DeferredInitializationThreadMain
                   block:^{
                     [self cleanupSnapshots];
                   }];
@@ -882,6 +928,9 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
 - (void)scheduleSessionStateCacheCleanup {
   [[DeferredInitializationRunner sharedInstance]
       enqueueBlockNamed:kPurgeWebSessionStates
+           dependencies:@[ kCleanupDiscardedSessions ]
+               priority:DeferredInitializationPriorityNormal
+                 thread:DeferredInitializationThreadMain
                   block:^{
                     WebSessionStateCache* cache =
                         WebSessionStateCacheFactory::GetForBrowserState(
@@ -926,6 +975,27 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
   }
 }
 
+- (void)scheduleMemoryAttributionSampling {
+  if (!base::FeatureList::IsEnabled(kMemoryAttributionSampling))
+    return;
+
+  __weak MainController* weakSelf = self;
+  [[DeferredInitializationRunner sharedInstance]
+      enqueueBlockNamed:kStartMemoryAttributionSampling
+           dependencies:nil
+               priority:DeferredInitializationPriorityLow
+                 thread:DeferredInitializationThreadMain
+                  block:^{
+                    ChromeBrowserState* browserState =
+                        weakSelf.appState.mainBrowserState;
+                    if (!browserState)
+                      return;
+                    MemoryAttributionSamplerFactory::GetForBrowserState(
+                        browserState)
+                        ->StartSampling();
+                  }];
+}
+
 - (void)initializedMemoryDebuggingTools {
   DCHECK(!_memoryDebuggerManager);
   DCHECK(experimental_flags::IsMemoryDebuggingEnabled());
@@ -957,10 +1027,13 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
 }
 
 // Schedule a call to |saveFieldTrialValuesForExtensions| for deferred
-// execution.
+// execution. It only writes to NSUserDefaults, so it runs in the background.
 - (void)scheduleSaveFieldTrialValuesForExtensions {
   [[DeferredInitializationRunner sharedInstance]
       enqueueBlockNamed:kSaveFieldTrialValues
+           dependencies:nil
+               priority:DeferredInitializationPriorityNormal
+                 thread:DeferredInitializationThreadBackground
                   block:^{
                     [self saveFieldTrialValuesForExtensions];
                   }];
@@ -989,10 +1062,13 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
 }
 
 // Schedules a call to |logIfEnterpriseManagedDevice| for deferred
-// execution.
+// execution in the background.
 - (void)scheduleEnterpriseManagedDeviceCheck {
   [[DeferredInitializationRunner sharedInstance]
       enqueueBlockNamed:kEnterpriseManagedDeviceCheck
+           dependencies:nil
+               priority:DeferredInitializationPriorityLow
+                 thread:DeferredInitializationThreadBackground
                   block:^{
                     [self logIfEnterpriseManagedDevice];
                   }];
@@ -1040,6 +1116,7 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
   // Deferred tasks.
   [self schedulePrefObserverInitialization];
   [self scheduleMemoryDebuggingTools];
+  [self scheduleMemoryAttributionSampling];
   [StartupTasks
       scheduleDeferredBrowserStateInitialization:self.appState
                                                      .mainBrowserState];
@@ -1054,6 +1131,7 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
   [self initializeMailtoHandling];
   [self scheduleSaveFieldTrialValuesForExtensions];
   [self scheduleEnterpriseManagedDeviceCheck];
+  [self scheduleDeferredKeyedServicesCreation];
 }
 
 - (void)scheduleTasksRequiringBVCWithBrowserState {
@@ -1068,6 +1146,28 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
   }
 }
 
+- (void)scheduleDeferredKeyedServicesCreation {
+  if (ShouldCreateDeferrableServicesWithBrowserState())
+    return;
+
+  __weak MainController* weakSelf = self;
+  [[DeferredInitializationRunner sharedInstance]
+      enqueueBlockNamed:kCreateDeferredKeyedServices
+           dependencies:nil
+               priority:DeferredInitializationPriorityLow
+                 thread:DeferredInitializationThreadMain
+                  block:^{
+                    ChromeBrowserState* browserState =
+                        weakSelf.appState.mainBrowserState;
+                    if (!browserState)
+                      return;
+                    DomainDiversityReporterFactory::GetForBrowserState(
+                        browserState);
+                    SigninBrowserStateInfoUpdaterFactory::GetForBrowserState(
+                        browserState);
+                  }];
+}
+
 - (void)scheduleDeleteTempDownloadsDirectory {
   [[DeferredInitializationRunner sharedInstance]
       enqueueBlockNamed:kDeleteDownloads
@@ -1097,6 +1197,9 @@ void MainControllerAuthenticationServiceDelegate::ClearBrowsingData(
   __weak SpotlightManager* spotlightManager = _spotlightManager;
   [[DeferredInitializationRunner sharedInstance]
       enqueueBlockNamed:kStartSpotlightBookmarksIndexing
+           dependencies:nil
+               priority:DeferredInitializationPriorityLow
+                 thread:DeferredInitializationThreadMain
                   block:^{
                     [spotlightManager resyncIndex];
                   }];
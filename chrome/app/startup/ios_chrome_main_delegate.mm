@@ -7,6 +7,7 @@
 #include "base/logging.h"
 #include "components/component_updater/component_updater_paths.h"
 #include "ios/chrome/browser/chrome_paths.h"
+#include "ios/chrome/browser/prefs/pref_file_prefetcher.h"
 #include "third_party/skia/include/core/SkGraphics.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
@@ -26,6 +27,10 @@ void IOSChromeMainDelegate::BasicStartupComplete() {
   // Initialize the Chrome path provider.
   ios::RegisterPathProvider();
 
+  // Start reading the preference files as soon as their paths are known, to
+  // hide part of their synchronous load later during startup.
+  PrefFilePrefetcher::GetInstance()->StartIfEnabled();
+
   // Register the component updater path provider.
   // Bundled components are not supported on ios, so DIR_USER_DATA is passed
   // for all three arguments.
@@ -116,8 +116,11 @@ void AppLauncherBrowserAgent::TabHelperDelegate::LaunchAppForTabHelper(
     request->GetCallbackManager()->AddCompletionCallback(base::BindOnce(
         &AppLauncherOverlayCallback, base::BindOnce(&LaunchExternalApp, url),
         /*repeated_request=*/false));
+    // The confirmation asks for the permission to leave the browser, so it is
+    // shown ahead of the dialogs queued by the page.
     GetQueueForAppLaunchDialog(tab_helper->web_state())
-        ->AddRequest(std::move(request));
+        ->AddRequestWithPriority(std::move(request),
+                                 OverlayRequestQueue::Priority::kHigh);
   } else {
     LaunchExternalApp(url);
   }
@@ -133,7 +136,8 @@ void AppLauncherBrowserAgent::TabHelperDelegate::ShowRepeatedAppLaunchAlert(
       base::BindOnce(&AppLauncherOverlayCallback, std::move(completion),
                      /*is_repeated_request=*/true));
   GetQueueForAppLaunchDialog(tab_helper->web_state())
-      ->AddRequest(std::move(request));
+      ->AddRequestWithPriority(std::move(request),
+                               OverlayRequestQueue::Priority::kHigh);
 }
 
 #pragma mark Private
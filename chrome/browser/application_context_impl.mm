@@ -55,6 +55,8 @@
 #include "ios/chrome/browser/crash_report/breadcrumbs/breadcrumb_persistent_storage_util.h"
 #include "ios/chrome/browser/gcm/ios_chrome_gcm_profile_service_factory.h"
 #include "ios/chrome/browser/history/history_service_factory.h"
+#include "ios/chrome/browser/history/history_write_coalescer.h"
+#include "ios/chrome/browser/history/history_write_coalescer_factory.h"
 #include "ios/chrome/browser/ios_chrome_io_thread.h"
 #include "ios/chrome/browser/metrics/ios_chrome_metrics_services_manager_client.h"
 #include "ios/chrome/browser/policy/browser_policy_connector_ios.h"
@@ -277,6 +279,12 @@ void ApplicationContextImpl::OnAppEnterBackground() {
   std::vector<ChromeBrowserState*> loaded_browser_state =
       GetChromeBrowserStateManager()->GetLoadedBrowserStates();
   for (ChromeBrowserState* browser_state : loaded_browser_state) {
+    if (HistoryWriteCoalescer* history_write_coalescer =
+            HistoryWriteCoalescerFactory::GetForBrowserStateIfExists(
+                browser_state)) {
+      history_write_coalescer->Flush();
+    }
+
     if (history::HistoryService* history_service =
             ios::HistoryServiceFactory::GetForBrowserStateIfExists(
                 browser_state, ServiceAccessType::EXPLICIT_ACCESS)) {
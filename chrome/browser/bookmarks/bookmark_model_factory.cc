@@ -44,7 +44,7 @@ BookmarkModelFactory* BookmarkModelFactory::GetInstance() {
 }
 
 BookmarkModelFactory::BookmarkModelFactory()
-    : BrowserStateKeyedServiceFactory(
+    : AuditedBrowserStateKeyedServiceFactory(
           "BookmarkModel",
           BrowserStateDependencyManager::GetInstance()) {
   DependsOn(ios::BookmarkUndoServiceFactory::GetInstance());
@@ -58,7 +58,8 @@ void BookmarkModelFactory::RegisterBrowserStatePrefs(
   bookmarks::RegisterProfilePrefs(registry);
 }
 
-std::unique_ptr<KeyedService> BookmarkModelFactory::BuildServiceInstanceFor(
+std::unique_ptr<KeyedService>
+BookmarkModelFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* context) const {
   ChromeBrowserState* browser_state =
       ChromeBrowserState::FromBrowserState(context);
@@ -9,7 +9,7 @@
 
 #include "base/macros.h"
 #include "base/no_destructor.h"
-#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 class ChromeBrowserState;
 
@@ -20,7 +20,7 @@ class BookmarkModel;
 namespace ios {
 // Singleton that owns all BookmarkModels and associates them with
 // ChromeBrowserState.
-class BookmarkModelFactory : public BrowserStateKeyedServiceFactory {
+class BookmarkModelFactory : public AuditedBrowserStateKeyedServiceFactory {
  public:
   static bookmarks::BookmarkModel* GetForBrowserState(
       ChromeBrowserState* browser_state);
@@ -34,10 +34,10 @@ class BookmarkModelFactory : public BrowserStateKeyedServiceFactory {
   BookmarkModelFactory();
   ~BookmarkModelFactory() override;
 
-  // BrowserStateKeyedServiceFactory implementation.
+  // AuditedBrowserStateKeyedServiceFactory implementation.
   void RegisterBrowserStatePrefs(
       user_prefs::PrefRegistrySyncable* registry) override;
-  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+  std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* context) const override;
   web::BrowserState* GetBrowserStateToUse(
       web::BrowserState* context) const override;
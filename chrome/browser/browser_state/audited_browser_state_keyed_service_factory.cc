@@ -0,0 +1,40 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
+
+#include "components/keyed_service/core/keyed_service.h"
+#include "components/keyed_service/core/refcounted_keyed_service.h"
+#include "ios/chrome/browser/browser_state/keyed_service_startup_audit.h"
+
+AuditedBrowserStateKeyedServiceFactory::AuditedBrowserStateKeyedServiceFactory(
+    const char* name,
+    BrowserStateDependencyManager* manager)
+    : BrowserStateKeyedServiceFactory(name, manager) {}
+
+AuditedBrowserStateKeyedServiceFactory::
+    ~AuditedBrowserStateKeyedServiceFactory() = default;
+
+std::unique_ptr<KeyedService>
+AuditedBrowserStateKeyedServiceFactory::BuildServiceInstanceFor(
+    web::BrowserState* context) const {
+  KeyedServiceStartupAudit::ScopedConstruction audit_scope(name());
+  return BuildAuditedServiceInstanceFor(context);
+}
+
+AuditedRefcountedBrowserStateKeyedServiceFactory::
+    AuditedRefcountedBrowserStateKeyedServiceFactory(
+        const char* name,
+        BrowserStateDependencyManager* manager)
+    : RefcountedBrowserStateKeyedServiceFactory(name, manager) {}
+
+AuditedRefcountedBrowserStateKeyedServiceFactory::
+    ~AuditedRefcountedBrowserStateKeyedServiceFactory() = default;
+
+scoped_refptr<RefcountedKeyedService>
+AuditedRefcountedBrowserStateKeyedServiceFactory::BuildServiceInstanceFor(
+    web::BrowserState* context) const {
+  KeyedServiceStartupAudit::ScopedConstruction audit_scope(name());
+  return BuildAuditedServiceInstanceFor(context);
+}
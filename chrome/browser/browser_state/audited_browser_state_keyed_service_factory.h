@@ -0,0 +1,76 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_BROWSER_STATE_AUDITED_BROWSER_STATE_KEYED_SERVICE_FACTORY_H_
+#define IOS_CHROME_BROWSER_BROWSER_STATE_AUDITED_BROWSER_STATE_KEYED_SERVICE_FACTORY_H_
+
+#include <memory>
+
+#include "base/memory/ref_counted.h"
+#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+#include "components/keyed_service/ios/refcounted_browser_state_keyed_service_factory.h"
+
+class BrowserStateDependencyManager;
+class KeyedService;
+class RefcountedKeyedService;
+
+namespace web {
+class BrowserState;
+}  // namespace web
+
+// BrowserStateKeyedServiceFactory whose service constructions are recorded by
+// KeyedServiceStartupAudit. Subclasses build their service in
+// BuildAuditedServiceInstanceFor().
+class AuditedBrowserStateKeyedServiceFactory
+    : public BrowserStateKeyedServiceFactory {
+ public:
+  AuditedBrowserStateKeyedServiceFactory(
+      const AuditedBrowserStateKeyedServiceFactory&) = delete;
+  AuditedBrowserStateKeyedServiceFactory& operator=(
+      const AuditedBrowserStateKeyedServiceFactory&) = delete;
+
+ protected:
+  AuditedBrowserStateKeyedServiceFactory(
+      const char* name,
+      BrowserStateDependencyManager* manager);
+  ~AuditedBrowserStateKeyedServiceFactory() override;
+
+  // Returns a new instance of the service for |context|.
+  virtual std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
+      web::BrowserState* context) const = 0;
+
+ private:
+  // BrowserStateKeyedServiceFactory implementation.
+  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+      web::BrowserState* context) const final;
+};
+
+// RefcountedBrowserStateKeyedServiceFactory whose service constructions are
+// recorded by KeyedServiceStartupAudit. Subclasses build their service in
+// BuildAuditedServiceInstanceFor().
+class AuditedRefcountedBrowserStateKeyedServiceFactory
+    : public RefcountedBrowserStateKeyedServiceFactory {
+ public:
+  AuditedRefcountedBrowserStateKeyedServiceFactory(
+      const AuditedRefcountedBrowserStateKeyedServiceFactory&) = delete;
+  AuditedRefcountedBrowserStateKeyedServiceFactory& operator=(
+      const AuditedRefcountedBrowserStateKeyedServiceFactory&) = delete;
+
+ protected:
+  AuditedRefcountedBrowserStateKeyedServiceFactory(
+      const char* name,
+      BrowserStateDependencyManager* manager);
+  ~AuditedRefcountedBrowserStateKeyedServiceFactory() override;
+
+  // Returns a new instance of the service for |context|.
+  virtual scoped_refptr<RefcountedKeyedService> BuildAuditedServiceInstanceFor(
+      web::BrowserState* context) const = 0;
+
+ private:
+  // RefcountedBrowserStateKeyedServiceFactory implementation.
+  scoped_refptr<RefcountedKeyedService> BuildServiceInstanceFor(
+      web::BrowserState* context) const final;
+};
+
+#endif  // IOS_CHROME_BROWSER_BROWSER_STATE_AUDITED_BROWSER_STATE_KEYED_SERVICE_FACTORY_H_
@@ -25,6 +25,7 @@
 #include "ios/chrome/browser/application_context.h"
 #include "ios/chrome/browser/bookmarks/bookmark_model_factory.h"
 #include "ios/chrome/browser/browser_state/bookmark_model_loaded_observer.h"
+#include "ios/chrome/browser/browser_state/keyed_service_startup_audit.h"
 #include "ios/chrome/browser/browser_state/off_the_record_chrome_browser_state_impl.h"
 #include "ios/chrome/browser/chrome_constants.h"
 #include "ios/chrome/browser/chrome_paths_internal.h"
@@ -124,8 +125,12 @@ ChromeBrowserStateImpl::ChromeBrowserStateImpl(
   MigrateObsoleteLocalStatePrefs(local_state);
   MigrateObsoleteBrowserStatePrefs(prefs_.get());
 
-  BrowserStateDependencyManager::GetInstance()->CreateBrowserStateServices(
-      this);
+  {
+    KeyedServiceStartupAudit::ScopedRequester requester(
+        "CreateBrowserStateServices");
+    BrowserStateDependencyManager::GetInstance()->CreateBrowserStateServices(
+        this);
+  }
 
   base::FilePath cookie_path = state_path_.Append(kIOSChromeCookieFilename);
   base::FilePath cache_path = GetCachePath(base_cache_path);
@@ -0,0 +1,190 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/browser_state/keyed_service_startup_audit.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "base/bind.h"
+#include "base/check_op.h"
+#include "base/logging.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/no_destructor.h"
+#include "base/strings/stringprintf.h"
+#include "ios/chrome/browser/metrics/startup_tracer.h"
+
+const base::Feature kDeferKeyedServiceCreation{
+    "DeferKeyedServiceCreation", base::FEATURE_DISABLED_BY_DEFAULT};
+
+namespace {
+
+// Requester of the services constructed outside of any ScopedRequester.
+const char kUnknownRequester[] = "Unknown";
+
+// Prefix of the histograms recording the construction time of a service.
+const char kServiceHistogramPrefix[] =
+    "IOS.Startup.KeyedServiceConstructionTime.";
+
+// Services whose construction time is reported to UMA individually. Adding a
+// service requires declaring its IOS.Startup.KeyedServiceConstructionTime
+// variant in histograms.xml; other services only count towards the totals.
+const char* const kReportedServices[] = {
+    "AuthenticationService", "BookmarkModel",      "HistoryService",
+    "IdentityManager",       "PasswordStore",      "SyncService",
+    "TemplateURLService",    "WebDataService",
+};
+
+// Whether the construction time of the service named |name| is reported to
+// UMA individually.
+bool IsReportedService(const std::string& name) {
+  return std::any_of(
+      std::begin(kReportedServices), std::end(kReportedServices),
+      [&name](const char* service) { return name == service; });
+}
+
+}  // namespace
+
+bool ShouldCreateDeferrableServicesWithBrowserState() {
+  return !base::FeatureList::IsEnabled(kDeferKeyedServiceCreation);
+}
+
+KeyedServiceStartupAudit::ScopedConstruction::ScopedConstruction(
+    const char* service_name)
+    : ScopedConstruction(KeyedServiceStartupAudit::GetInstance(),
+                         service_name) {}
+
+KeyedServiceStartupAudit::ScopedConstruction::ScopedConstruction(
+    KeyedServiceStartupAudit* audit,
+    const char* service_name)
+    : audit_(audit) {
+  DCHECK(audit);
+  DCHECK_CALLED_ON_VALID_THREAD(audit->thread_checker_);
+  if (!audit->recording_)
+    return;
+
+  Entry entry;
+  entry.service_name = service_name;
+  entry.requester = audit->GetCurrentRequester();
+  entry_index_ = static_cast<int>(audit->entries_.size());
+  audit->entries_.push_back(std::move(entry));
+  audit->construction_stack_.push_back(entry_index_);
+  audit->construction_start_times_.push_back(base::TimeTicks::Now());
+  audit->nested_durations_.push_back(base::TimeDelta());
+}
+
+KeyedServiceStartupAudit::ScopedConstruction::~ScopedConstruction() {
+  if (entry_index_ < 0)
+    return;
+
+  // The audit keeps track of the constructions started while recording even
+  // if it finished in the meantime, so that the stack stays balanced.
+  KeyedServiceStartupAudit* audit = audit_;
+  DCHECK(!audit->construction_stack_.empty());
+  DCHECK_EQ(entry_index_, audit->construction_stack_.back());
+
+  const base::TimeTicks start_time = audit->construction_start_times_.back();
+  const base::TimeTicks end_time = base::TimeTicks::Now();
+  Entry& entry = audit->entries_[entry_index_];
+  entry.total_duration = end_time - start_time;
+  entry.self_duration =
+      entry.total_duration - audit->nested_durations_.back();
+
+  audit->construction_stack_.pop_back();
+  audit->construction_start_times_.pop_back();
+  audit->nested_durations_.pop_back();
+  if (!audit->nested_durations_.empty())
+    audit->nested_durations_.back() += entry.total_duration;
+
+  const std::string span_name = "KeyedService." + entry.service_name;
+  audit->tracer_->RecordSpan(span_name.c_str(), start_time, end_time);
+}
+
+KeyedServiceStartupAudit::ScopedRequester::ScopedRequester(
+    const char* requester)
+    : ScopedRequester(KeyedServiceStartupAudit::GetInstance(), requester) {}
+
+KeyedServiceStartupAudit::ScopedRequester::ScopedRequester(
+    KeyedServiceStartupAudit* audit,
+    const char* requester)
+    : audit_(audit) {
+  DCHECK(audit_);
+  DCHECK_CALLED_ON_VALID_THREAD(audit_->thread_checker_);
+  recording_ = audit_->recording_;
+  if (recording_)
+    audit_->requesters_.push_back(requester);
+}
+
+KeyedServiceStartupAudit::ScopedRequester::~ScopedRequester() {
+  if (!recording_)
+    return;
+  DCHECK(!audit_->requesters_.empty());
+  audit_->requesters_.pop_back();
+}
+
+// static
+KeyedServiceStartupAudit* KeyedServiceStartupAudit::GetInstance() {
+  static base::NoDestructor<KeyedServiceStartupAudit> instance(
+      StartupTracer::GetInstance());
+  return instance.get();
+}
+
+KeyedServiceStartupAudit::KeyedServiceStartupAudit(StartupTracer* tracer)
+    : tracer_(tracer) {
+  DCHECK(tracer_);
+  tracer_->AddStartupCompleteCallback(base::BindOnce(
+      &KeyedServiceStartupAudit::Finish, weak_factory_.GetWeakPtr()));
+}
+
+KeyedServiceStartupAudit::~KeyedServiceStartupAudit() = default;
+
+void KeyedServiceStartupAudit::Finish() {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  if (!recording_)
+    return;
+  recording_ = false;
+
+  base::TimeDelta total_duration;
+  for (const Entry& entry : entries_) {
+    total_duration += entry.self_duration;
+    if (!IsReportedService(entry.service_name))
+      continue;
+    base::UmaHistogramTimes(kServiceHistogramPrefix + entry.service_name,
+                            entry.self_duration);
+  }
+  base::UmaHistogramCounts100("IOS.Startup.KeyedServicesConstructed",
+                              static_cast<int>(entries_.size()));
+  base::UmaHistogramTimes("IOS.Startup.KeyedServicesConstructionTime",
+                          total_duration);
+
+  DVLOG(1) << GetReport();
+}
+
+std::string KeyedServiceStartupAudit::GetReport() const {
+  std::vector<const Entry*> sorted_entries;
+  for (const Entry& entry : entries_)
+    sorted_entries.push_back(&entry);
+  std::stable_sort(sorted_entries.begin(), sorted_entries.end(),
+                   [](const Entry* lhs, const Entry* rhs) {
+                     return lhs->self_duration > rhs->self_duration;
+                   });
+
+  std::string report = base::StringPrintf(
+      "%zu keyed services constructed during startup:\n", entries_.size());
+  for (const Entry* entry : sorted_entries) {
+    base::StringAppendF(&report, "%8.2fms self %8.2fms total  %s <- %s\n",
+                        entry->self_duration.InMillisecondsF(),
+                        entry->total_duration.InMillisecondsF(),
+                        entry->service_name.c_str(), entry->requester.c_str());
+  }
+  return report;
+}
+
+std::string KeyedServiceStartupAudit::GetCurrentRequester() const {
+  if (!construction_stack_.empty())
+    return entries_[construction_stack_.back()].service_name;
+  if (!requesters_.empty())
+    return requesters_.back();
+  return kUnknownRequester;
+}
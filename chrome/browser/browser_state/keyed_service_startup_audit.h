@@ -0,0 +1,140 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_BROWSER_STATE_KEYED_SERVICE_STARTUP_AUDIT_H_
+#define IOS_CHROME_BROWSER_BROWSER_STATE_KEYED_SERVICE_STARTUP_AUDIT_H_
+
+#include <string>
+#include <vector>
+
+#include "base/feature_list.h"
+#include "base/memory/weak_ptr.h"
+#include "base/threading/thread_checker.h"
+#include "base/time/time.h"
+
+class StartupTracer;
+
+// Feature to create the keyed services that are not needed for the first
+// paint on first use or when the main thread is idle, instead of with the
+// browser state.
+extern const base::Feature kDeferKeyedServiceCreation;
+
+// Returns whether services that are not needed for the first paint should
+// still be created with the browser state. Factories of such services return
+// this from ServiceIsCreatedWithBrowserState().
+bool ShouldCreateDeferrableServicesWithBrowserState();
+
+// Records the keyed services constructed during startup, which code requested
+// them, and how long their construction took, so that the services on the
+// critical path of startup can be identified. Recording stops once the
+// StartupTracer reports startup as completed. Main thread only.
+//
+// The factory base classes live in components/keyed_service, so the audit only
+// sees the factories deriving from AuditedBrowserStateKeyedServiceFactory or
+// AuditedRefcountedBrowserStateKeyedServiceFactory. Those are the factories of
+// the services created with the browser state or reached by the first paint;
+// services built by other factories during startup are only accounted for in
+// the self duration of their requesters. Only a fixed list of services is
+// reported to UMA individually.
+class KeyedServiceStartupAudit {
+ public:
+  struct Entry {
+    // Name of the service, as passed to the factory.
+    std::string service_name;
+    // Name of the service whose construction required this one, or label of
+    // the innermost ScopedRequester if the service was requested directly.
+    std::string requester;
+    // Time spent constructing the service, including its dependencies.
+    base::TimeDelta total_duration;
+    // Time spent constructing the service, excluding the dependencies that
+    // were constructed at the same time.
+    base::TimeDelta self_duration;
+  };
+
+  // Records the construction of the service named |service_name| during its
+  // lifetime. Instantiated by the audited factory base classes.
+  class ScopedConstruction {
+   public:
+    // Records the construction in the audit of the process.
+    explicit ScopedConstruction(const char* service_name);
+    ScopedConstruction(KeyedServiceStartupAudit* audit,
+                       const char* service_name);
+    ~ScopedConstruction();
+
+    ScopedConstruction(const ScopedConstruction&) = delete;
+    ScopedConstruction& operator=(const ScopedConstruction&) = delete;
+
+   private:
+    KeyedServiceStartupAudit* const audit_;
+    // Index of the entry in the audit, or -1 if the audit is not recording.
+    int entry_index_ = -1;
+  };
+
+  // Labels the services requested directly during its lifetime with
+  // |requester|.
+  class ScopedRequester {
+   public:
+    // Labels the services recorded in the audit of the process.
+    explicit ScopedRequester(const char* requester);
+    ScopedRequester(KeyedServiceStartupAudit* audit, const char* requester);
+    ~ScopedRequester();
+
+    ScopedRequester(const ScopedRequester&) = delete;
+    ScopedRequester& operator=(const ScopedRequester&) = delete;
+
+   private:
+    KeyedServiceStartupAudit* const audit_;
+    bool recording_ = false;
+  };
+
+  // Returns the audit used for the current process.
+  static KeyedServiceStartupAudit* GetInstance();
+
+  // Creates an audit recording the constructions as spans of |tracer|, until
+  // |tracer| reports startup as completed.
+  explicit KeyedServiceStartupAudit(StartupTracer* tracer);
+  ~KeyedServiceStartupAudit();
+
+  KeyedServiceStartupAudit(const KeyedServiceStartupAudit&) = delete;
+  KeyedServiceStartupAudit& operator=(const KeyedServiceStartupAudit&) =
+      delete;
+
+  // Stops recording and reports the recorded entries to UMA. Called when
+  // startup completes.
+  void Finish();
+
+  // Whether constructions are still recorded.
+  bool is_recording() const { return recording_; }
+
+  // Entries recorded so far, in the order the constructions started.
+  const std::vector<Entry>& entries() const { return entries_; }
+
+  // Returns a human readable table of the recorded entries, sorted by
+  // decreasing self duration.
+  std::string GetReport() const;
+
+ private:
+  // Returns the requester of a construction starting now.
+  std::string GetCurrentRequester() const;
+
+  StartupTracer* const tracer_;
+  bool recording_ = true;
+  std::vector<Entry> entries_;
+
+  // Indices in |entries_| of the constructions in progress, innermost last.
+  std::vector<int> construction_stack_;
+  // Start times of the constructions in progress, and time spent in their
+  // nested constructions so far.
+  std::vector<base::TimeTicks> construction_start_times_;
+  std::vector<base::TimeDelta> nested_durations_;
+
+  // Labels of the active ScopedRequesters, innermost last.
+  std::vector<std::string> requesters_;
+
+  THREAD_CHECKER(thread_checker_);
+
+  base::WeakPtrFactory<KeyedServiceStartupAudit> weak_factory_{this};
+};
+
+#endif  // IOS_CHROME_BROWSER_BROWSER_STATE_KEYED_SERVICE_STARTUP_AUDIT_H_
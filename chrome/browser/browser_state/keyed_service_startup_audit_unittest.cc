@@ -0,0 +1,94 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/browser_state/keyed_service_startup_audit.h"
+
+#include "base/test/metrics/histogram_tester.h"
+#include "ios/chrome/browser/metrics/startup_tracer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+class KeyedServiceStartupAuditTest : public PlatformTest {
+ protected:
+  KeyedServiceStartupAuditTest() : audit_(&tracer_) {}
+
+  StartupTracer tracer_;
+  KeyedServiceStartupAudit audit_;
+};
+
+// Tests that nested constructions are attributed to the enclosing service, and
+// that direct constructions are attributed to the innermost requester.
+TEST_F(KeyedServiceStartupAuditTest, AttributesRequesters) {
+  ASSERT_TRUE(audit_.is_recording());
+
+  {
+    KeyedServiceStartupAudit::ScopedRequester requester(&audit_,
+                                                        "TestRequester");
+    KeyedServiceStartupAudit::ScopedConstruction outer(&audit_, "OuterService");
+    {
+      KeyedServiceStartupAudit::ScopedConstruction inner(&audit_,
+                                                         "InnerService");
+    }
+  }
+  {
+    KeyedServiceStartupAudit::ScopedConstruction other(&audit_,
+                                                       "OtherService");
+  }
+
+  const std::vector<KeyedServiceStartupAudit::Entry>& entries =
+      audit_.entries();
+  ASSERT_EQ(3U, entries.size());
+
+  const KeyedServiceStartupAudit::Entry& outer = entries[0];
+  const KeyedServiceStartupAudit::Entry& inner = entries[1];
+  const KeyedServiceStartupAudit::Entry& other = entries[2];
+  EXPECT_EQ("OuterService", outer.service_name);
+  EXPECT_EQ("TestRequester", outer.requester);
+  EXPECT_EQ("InnerService", inner.service_name);
+  EXPECT_EQ("OuterService", inner.requester);
+  EXPECT_EQ("OtherService", other.service_name);
+  EXPECT_EQ("Unknown", other.requester);
+
+  // The time spent constructing the inner service is excluded from the self
+  // duration of the outer one.
+  EXPECT_EQ(outer.total_duration - inner.total_duration, outer.self_duration);
+  EXPECT_EQ(inner.total_duration, inner.self_duration);
+}
+
+// Tests that constructions are recorded as spans of the tracer, and that
+// recording stops once the tracer completes startup.
+TEST_F(KeyedServiceStartupAuditTest, StopsRecordingWithTracer) {
+  { KeyedServiceStartupAudit::ScopedConstruction service(&audit_, "Service"); }
+  ASSERT_EQ(1U, tracer_.GetSpans().size());
+  EXPECT_STREQ("KeyedService.Service", tracer_.GetSpans()[0].name);
+
+  tracer_.CompleteStartup("Complete");
+  EXPECT_FALSE(audit_.is_recording());
+  { KeyedServiceStartupAudit::ScopedConstruction late(&audit_, "LateService"); }
+  EXPECT_EQ(1U, audit_.entries().size());
+}
+
+// Tests that only the services of the fixed list get their own construction
+// time histogram, and that all of them count towards the totals.
+TEST_F(KeyedServiceStartupAuditTest, ReportsFixedListOfServices) {
+  base::HistogramTester histogram_tester;
+  {
+    KeyedServiceStartupAudit::ScopedConstruction reported(&audit_,
+                                                          "HistoryService");
+  }
+  {
+    KeyedServiceStartupAudit::ScopedConstruction unreported(&audit_,
+                                                            "OtherService");
+  }
+  tracer_.CompleteStartup("Complete");
+
+  histogram_tester.ExpectTotalCount(
+      "IOS.Startup.KeyedServiceConstructionTime.HistoryService", 1);
+  histogram_tester.ExpectTotalCount(
+      "IOS.Startup.KeyedServiceConstructionTime.OtherService", 0);
+  histogram_tester.ExpectUniqueSample("IOS.Startup.KeyedServicesConstructed",
+                                      2, 1);
+  histogram_tester.ExpectTotalCount("IOS.Startup.KeyedServicesConstructionTime",
+                                    1);
+}
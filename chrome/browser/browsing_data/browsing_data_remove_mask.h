@@ -43,7 +43,7 @@ enum class BrowsingDataRemoveMask {
                REMOVE_LAST_USER_ACCOUNT,
 };
 
-// Implementation of bitwise "or", "and" operators and the corresponding
+// Implementation of bitwise "or", "and", "not" operators and the corresponding
 // assignment operators too (as those are not automatically defined for
 // "class enum").
 constexpr BrowsingDataRemoveMask operator|(BrowsingDataRemoveMask lhs,
@@ -60,6 +60,11 @@ constexpr BrowsingDataRemoveMask operator&(BrowsingDataRemoveMask lhs,
       static_cast<std::underlying_type<BrowsingDataRemoveMask>::type>(rhs));
 }
 
+constexpr BrowsingDataRemoveMask operator~(BrowsingDataRemoveMask mask) {
+  return static_cast<BrowsingDataRemoveMask>(
+      ~static_cast<std::underlying_type<BrowsingDataRemoveMask>::type>(mask));
+}
+
 inline BrowsingDataRemoveMask& operator|=(BrowsingDataRemoveMask& lhs,
                                           BrowsingDataRemoveMask rhs) {
   lhs = lhs | rhs;
@@ -45,6 +45,9 @@ class BrowsingDataRemover : public KeyedService {
   // Invokes |OnBrowsingDataRemoved| on all registered observers.
   void NotifyBrowsingDataRemoved(BrowsingDataRemoveMask mask);
 
+  // Invokes |OnBrowsingDataRemovalProgress| on all registered observers.
+  void NotifyBrowsingDataRemovalProgress(int completed_steps, int total_steps);
+
  private:
   base::ObserverList<BrowsingDataRemoverObserver, true>::Unchecked observers_;
 
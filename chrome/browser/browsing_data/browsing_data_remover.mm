@@ -29,3 +29,11 @@ void BrowsingDataRemover::NotifyBrowsingDataRemoved(
     observer.OnBrowsingDataRemoved(this, mask);
   }
 }
+
+void BrowsingDataRemover::NotifyBrowsingDataRemovalProgress(
+    int completed_steps,
+    int total_steps) {
+  for (BrowsingDataRemoverObserver& observer : observers_) {
+    observer.OnBrowsingDataRemovalProgress(this, completed_steps, total_steps);
+  }
+}
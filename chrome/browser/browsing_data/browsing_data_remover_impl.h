@@ -6,7 +6,10 @@
 #define IOS_CHROME_BROWSER_BROWSING_DATA_BROWSING_DATA_REMOVER_IMPL_H_
 
 
+#include <vector>
+
 #include "base/callback.h"
+#include "base/callback_list.h"
 #include "base/containers/queue.h"
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
@@ -62,6 +65,10 @@ class BrowsingDataRemoverImpl : public BrowsingDataRemover {
     BrowsingDataRemoveMask mask;
     base::OnceClosure callback;
     base::Time task_started;
+    // Part of |mask| not already removed by another task of the same plan
+    // covering a wider time range.
+    BrowsingDataRemoveMask mask_to_remove =
+        BrowsingDataRemoveMask::REMOVE_NOTHING;
   };
 
   // Setter for |is_removing_|; DCHECKs that we can only start removing if we're
@@ -74,8 +81,10 @@ class BrowsingDataRemoverImpl : public BrowsingDataRemover {
                         base::Time delete_end,
                         base::OnceClosure callback);
 
-  // Execute the next removal task. Called after the previous task was finished
-  // or directly from Remove.
+  // Merges all the queued removal tasks into a single execution plan and
+  // executes it. The stores affected by the tasks of the plan are cleared
+  // concurrently, and the plan completes when all of them have been cleared.
+  // Called after the previous plan was finished or directly from Remove.
   void RunNextTask();
 
   // Removes the specified items related to browsing.
@@ -87,17 +96,29 @@ class BrowsingDataRemoverImpl : public BrowsingDataRemover {
   void RemoveDataFromWKWebsiteDataStore(base::Time delete_begin,
                                         BrowsingDataRemoveMask mask);
 
-  // Invokes the current task callback that the removal has completed.
+  // Invokes the callbacks of the tasks of the current plan that the removal
+  // has completed.
   void NotifyRemovalComplete();
 
-  // Called by the closures returned by CreatePendingTaskCompletionClosure().
-  // Checks if all tasks have completed, and if so, calls Notify().
-  void OnTaskComplete();
+  // Called by the closures returned by CreatePendingTaskCompletionClosure()
+  // and CreatePendingStepCompletionClosure(). Records the time spent on |name|
+  // since |start_time|, reports the progress of the plan if |is_store|, and
+  // calls NotifyRemovalComplete() if all tasks have completed.
+  void OnTaskComplete(const char* name,
+                      bool is_store,
+                      base::TimeTicks start_time);
 
   // Increments the number of pending tasks by one, and returns a OnceClosure
-  // that calls OnTaskComplete(). The Remover is complete once all the closures
-  // created by this method have been invoked.
-  base::OnceClosure CreatePendingTaskCompletionClosure();
+  // that calls OnTaskComplete() once |store_name| has been cleared. The Remover
+  // is complete once all the closures created by this method have been
+  // invoked. |store_name| must be a string literal.
+  base::OnceClosure CreatePendingTaskCompletionClosure(const char* store_name);
+
+  // Same as CreatePendingTaskCompletionClosure(), for an internal step of the
+  // removal that does not clear a store. Its duration is recorded separately
+  // and it does not count towards the progress of the plan. |step_name| must
+  // be a string literal.
+  base::OnceClosure CreatePendingStepCompletionClosure(const char* step_name);
 
   // Returns a weak pointer to BrowsingDataRemoverImpl for internal
   // purposes.
@@ -118,16 +139,26 @@ class BrowsingDataRemoverImpl : public BrowsingDataRemover {
   // Is the object currently in the process of removing data?
   bool is_removing_ = false;
 
-  // Number of pending tasks.
+  // Number of pending tasks (stores and internal steps) for the current plan.
   int pending_tasks_count_ = 0;
 
-  // Removal tasks to be processed.
+  // Number of pending stores, and number of stores cleared, for the current
+  // plan. Used to report the progress of the plan.
+  int pending_stores_count_ = 0;
+  int completed_stores_count_ = 0;
+
+  // Removal tasks being executed as a single plan.
+  std::vector<RemovalTask> current_plan_;
+
+  // Removal tasks to be processed once the current plan completes.
   base::queue<RemovalTask> removal_queue_;
 
   // Used if we need to clear history.
   base::CancelableTaskTracker history_task_tracker_;
 
-  base::CallbackListSubscription template_url_subscription_;
+  // Subscriptions to the loading of the TemplateURLService, one per task of
+  // the current plan that removes history.
+  std::vector<base::CallbackListSubscription> template_url_subscriptions_;
 
   base::WeakPtrFactory<BrowsingDataRemoverImpl> weak_ptr_factory_;
 
@@ -15,9 +15,11 @@
 #include "base/files/file_path.h"
 #import "base/ios/block_types.h"
 #include "base/logging.h"
+#include "base/metrics/histogram_functions.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/metrics/user_metrics.h"
 #include "base/sequenced_task_runner.h"
+#include "base/strings/strcat.h"
 #include "base/strings/sys_string_conversions.h"
 #include "base/task/post_task.h"
 #include "base/threading/sequenced_task_runner_handle.h"
@@ -48,6 +50,8 @@
 #include "ios/chrome/browser/history/history_service_factory.h"
 #include "ios/chrome/browser/history/web_history_service_factory.h"
 #include "ios/chrome/browser/ios_chrome_io_thread.h"
+#include "ios/chrome/browser/language/language_detection_cache.h"
+#include "ios/chrome/browser/language/language_detection_cache_factory.h"
 #include "ios/chrome/browser/language/url_language_histogram_factory.h"
 #include "ios/chrome/browser/passwords/ios_chrome_password_store_factory.h"
 #include "ios/chrome/browser/reading_list/reading_list_remover_helper.h"
@@ -175,14 +179,15 @@ void BrowsingDataRemoverImpl::Shutdown() {
 
   if (is_removing_) {
     VLOG(1) << "BrowsingDataRemoverImpl shuts down with "
-            << removal_queue_.size() << " pending tasks"
-            << (pending_tasks_count_ ? " (including one in progress)" : "");
+            << current_plan_.size() + removal_queue_.size()
+            << " pending tasks (including " << current_plan_.size()
+            << " in progress)";
 
     SetRemoving(false);
   }
 
   UMA_HISTOGRAM_EXACT_LINEAR("History.ClearBrowsingData.TaskQueueAtShutdown",
-                             removal_queue_.size(), 10);
+                             current_plan_.size() + removal_queue_.size(), 10);
 
   scoped_refptr<base::SequencedTaskRunner> current_task_runner =
       base::SequencedTaskRunnerHandle::Get();
@@ -191,6 +196,14 @@ void BrowsingDataRemoverImpl::Shutdown() {
   // (albeit unsucessfuly) processed. If it becomes a problem that browsing
   // data might not actually be fully cleared when an observer is notified,
   // add a success flag.
+  for (RemovalTask& task : current_plan_) {
+    if (!task.callback.is_null()) {
+      current_task_runner->PostTask(FROM_HERE, std::move(task.callback));
+    }
+  }
+  current_plan_.clear();
+  template_url_subscriptions_.clear();
+
   while (!removal_queue_.empty()) {
     RemovalTask task = std::move(removal_queue_.front());
     removal_queue_.pop();
@@ -243,10 +256,10 @@ void BrowsingDataRemoverImpl::Remove(browsing_data::TimePeriod time_period,
                          browsing_data::CalculateEndDeleteTime(time_period),
                          mask, std::move(callback));
 
-  // If this is the only scheduled task, execute it immediately. Otherwise,
-  // it will be automatically executed when all tasks scheduled before it
-  // finish.
-  if (removal_queue_.size() == 1) {
+  // If no removal is in progress, execute the task immediately. Otherwise, it
+  // will be merged with the other tasks scheduled in the meantime and executed
+  // when the current plan finishes.
+  if (!is_removing_) {
     SetRemoving(true);
     RunNextTask();
   }
@@ -254,11 +267,44 @@ void BrowsingDataRemoverImpl::Remove(browsing_data::TimePeriod time_period,
 
 void BrowsingDataRemoverImpl::RunNextTask() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(current_plan_.empty());
   DCHECK(!removal_queue_.empty());
-  RemovalTask& removal_task = removal_queue_.front();
-  removal_task.task_started = base::Time::Now();
-  RemoveImpl(removal_task.delete_begin, removal_task.delete_end,
-             removal_task.mask);
+
+  while (!removal_queue_.empty()) {
+    current_plan_.push_back(std::move(removal_queue_.front()));
+    removal_queue_.pop();
+  }
+  UMA_HISTOGRAM_EXACT_LINEAR("History.ClearBrowsingData.TasksPerPlan",
+                             current_plan_.size(), 10);
+
+  // A type of data does not need to be removed again for a task if another
+  // task of the plan removes it for a time range containing the task's one.
+  // For identical time ranges, the data is removed for the first task.
+  const base::Time now = base::Time::Now();
+  for (size_t i = 0; i < current_plan_.size(); ++i) {
+    RemovalTask& task = current_plan_[i];
+    task.task_started = now;
+    task.mask_to_remove = task.mask;
+    for (size_t j = 0; j < current_plan_.size(); ++j) {
+      const RemovalTask& other = current_plan_[j];
+      const bool same_range = other.delete_begin == task.delete_begin &&
+                              other.delete_end == task.delete_end;
+      const bool contains_range = other.delete_begin <= task.delete_begin &&
+                                  other.delete_end >= task.delete_end;
+      if (j == i || !contains_range || (same_range && j > i))
+        continue;
+      task.mask_to_remove &= ~other.mask;
+    }
+  }
+
+  // Prevent the plan from completing before all its tasks are scheduled.
+  base::ScopedClosureRunner plan_scheduling(
+      CreatePendingStepCompletionClosure("PlanScheduling"));
+  for (const RemovalTask& task : current_plan_) {
+    if (task.mask_to_remove == BrowsingDataRemoveMask::REMOVE_NOTHING)
+      continue;
+    RemoveImpl(task.delete_begin, task.delete_end, task.mask_to_remove);
+  }
 }
 
 void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
@@ -266,7 +312,7 @@ void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
                                          BrowsingDataRemoveMask mask) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   base::ScopedClosureRunner synchronous_clear_operations(
-      CreatePendingTaskCompletionClosure());
+      CreatePendingStepCompletionClosure("SynchronousOperations"));
 
   scoped_refptr<base::SequencedTaskRunner> current_task_runner =
       base::SequencedTaskRunnerHandle::Get();
@@ -279,13 +325,13 @@ void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
       const base::FilePath& state_path = browser_state_->GetStatePath();
       [session_service_
           deleteAllSessionFilesInDirectory:state_path
-                                completion:
-                                    CreatePendingTaskCompletionClosure()];
+                                completion:CreatePendingTaskCompletionClosure(
+                                               "Sessions")];
     }
 
     // Remove the screenshots taken by the system when backgrounding the
     // application. Partial removal based on timePeriod is not required.
-    ClearIOSSnapshots(CreatePendingTaskCompletionClosure());
+    ClearIOSSnapshots(CreatePendingTaskCompletionClosure("Snapshots"));
   }
 
   constexpr base::TaskTraits task_traits = {
@@ -305,13 +351,14 @@ void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
             &ClearCookies, context_getter_, deletion_time_range,
             base::BindOnce(base::IgnoreResult(&base::TaskRunner::PostTask),
                            current_task_runner, FROM_HERE,
-                           CreatePendingTaskCompletionClosure())));
+                           CreatePendingTaskCompletionClosure("Cookies"))));
     if (!browser_state_->IsOffTheRecord()) {
       GetApplicationContext()->GetSafeBrowsingService()->ClearCookies(
           deletion_time_range,
-          base::BindOnce(base::IgnoreResult(&base::TaskRunner::PostTask),
-                         current_task_runner, FROM_HERE,
-                         CreatePendingTaskCompletionClosure()));
+          base::BindOnce(
+              base::IgnoreResult(&base::TaskRunner::PostTask),
+              current_task_runner, FROM_HERE,
+              CreatePendingTaskCompletionClosure("SafeBrowsingCookies")));
     }
   }
 
@@ -338,7 +385,8 @@ void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
       base::RecordAction(base::UserMetricsAction("ClearBrowsingData_History"));
       history_service->DeleteLocalAndRemoteHistoryBetween(
           ios::WebHistoryServiceFactory::GetForBrowserState(browser_state_),
-          delete_begin, delete_end, CreatePendingTaskCompletionClosure(),
+          delete_begin, delete_end,
+          CreatePendingTaskCompletionClosure("History"),
           &history_task_tracker_);
     }
 
@@ -352,7 +400,7 @@ void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
           FROM_HERE, task_traits,
           base::BindOnce(&IOSChromeIOThread::ClearHostCache,
                          base::Unretained(ios_chrome_io_thread)),
-          CreatePendingTaskCompletionClosure());
+          CreatePendingTaskCompletionClosure("HostCache"));
     }
 
     // As part of history deletion we also delete the auto-generated keywords.
@@ -362,10 +410,13 @@ void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
       TemplateURLService* keywords_model =
           ios::TemplateURLServiceFactory::GetForBrowserState(browser_state_);
       if (keywords_model && !keywords_model->loaded()) {
-        template_url_subscription_ = keywords_model->RegisterOnLoadedCallback(
-            base::BindOnce(&BrowsingDataRemoverImpl::OnKeywordsLoaded,
-                           GetWeakPtr(), delete_begin, delete_end,
-                           CreatePendingTaskCompletionClosure()));
+        // Several tasks of the plan may be waiting for the service to load,
+        // so keep all the subscriptions until the plan completes.
+        template_url_subscriptions_.push_back(
+            keywords_model->RegisterOnLoadedCallback(base::BindOnce(
+                &BrowsingDataRemoverImpl::OnKeywordsLoaded, GetWeakPtr(),
+                delete_begin, delete_end,
+                CreatePendingTaskCompletionClosure("Keywords"))));
         keywords_model->Load();
       } else if (keywords_model) {
         keywords_model->RemoveAutoGeneratedBetween(delete_begin, delete_end);
@@ -396,7 +447,8 @@ void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
                                                         delete_end);
       // Ask for a call back when the above call is finished.
       web_data_service->GetDBTaskRunner()->PostTaskAndReply(
-          FROM_HERE, base::DoNothing(), CreatePendingTaskCompletionClosure());
+          FROM_HERE, base::DoNothing(),
+          CreatePendingTaskCompletionClosure("AutofillOrigins"));
 
       autofill::PersonalDataManager* data_manager =
           autofill::PersonalDataManagerFactory::GetForBrowserState(
@@ -412,6 +464,13 @@ void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
     if (language_histogram) {
       language_histogram->ClearHistory(delete_begin, delete_end);
     }
+
+    // The language detection cache is keyed by the hosts visited. Its entries
+    // are not timestamped, so it is cleared whatever the time range.
+    LanguageDetectionCache* language_detection_cache =
+        LanguageDetectionCacheFactory::GetForBrowserState(browser_state_);
+    if (language_detection_cache)
+      language_detection_cache->Clear();
   }
 
   if (IsRemoveDataMaskSet(mask, BrowsingDataRemoveMask::REMOVE_PASSWORDS)) {
@@ -423,7 +482,8 @@ void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
 
     if (password_store) {
       password_store->RemoveLoginsCreatedBetween(
-          delete_begin, delete_end, CreatePendingTaskCompletionClosure());
+          delete_begin, delete_end,
+          CreatePendingTaskCompletionClosure("Passwords"));
     }
   }
 
@@ -447,7 +507,8 @@ void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
 
       // Ask for a call back when the above calls are finished.
       web_data_service->GetDBTaskRunner()->PostTaskAndReply(
-          FROM_HERE, base::DoNothing(), CreatePendingTaskCompletionClosure());
+          FROM_HERE, base::DoNothing(),
+          CreatePendingTaskCompletionClosure("FormData"));
 
       autofill::PersonalDataManager* data_manager =
           autofill::PersonalDataManagerFactory::GetForBrowserState(
@@ -463,8 +524,9 @@ void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
     ClearHttpCache(context_getter_,
                    base::CreateSingleThreadTaskRunner(task_traits),
                    delete_begin, delete_end,
-                   base::BindOnce(&NetCompletionCallbackAdapter,
-                                  CreatePendingTaskCompletionClosure()));
+                   base::BindOnce(
+                       &NetCompletionCallbackAdapter,
+                       CreatePendingTaskCompletionClosure("HttpCache")));
   }
 
   // Remove omnibox zero-suggest cache results.
@@ -480,7 +542,7 @@ void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
     if (external_file_remover) {
       external_file_remover->RemoveAfterDelay(
           base::TimeDelta::FromSeconds(0),
-          CreatePendingTaskCompletionClosure());
+          CreatePendingTaskCompletionClosure("Downloads"));
     }
   }
 
@@ -495,7 +557,7 @@ void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
     // callback is run.
     bookmarks_remover_helper_ptr->RemoveAllUserBookmarksIOS(base::BindOnce(
         &BookmarkClearedAdapter, std::move(bookmarks_remover_helper),
-        CreatePendingTaskCompletionClosure()));
+        CreatePendingTaskCompletionClosure("Bookmarks")));
   }
 
   if (IsRemoveDataMaskSet(mask, BrowsingDataRemoveMask::REMOVE_READING_LIST)) {
@@ -511,7 +573,7 @@ void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
     reading_list_remover_helper_ptr->RemoveAllUserReadingListItemsIOS(
         base::BindOnce(&ReadingListClearedAdapter,
                        std::move(reading_list_remover_helper),
-                       CreatePendingTaskCompletionClosure()));
+                       CreatePendingTaskCompletionClosure("ReadingList")));
   }
 
   if (IsRemoveDataMaskSet(mask,
@@ -531,7 +593,7 @@ void BrowsingDataRemoverImpl::RemoveImpl(base::Time delete_begin,
   // Always wipe accumulated network related data (TransportSecurityState and
   // HttpServerPropertiesManager data).
   browser_state_->ClearNetworkingHistorySince(
-      delete_begin, CreatePendingTaskCompletionClosure());
+      delete_begin, CreatePendingTaskCompletionClosure("NetworkingHistory"));
 
   // Remove browsing data stored in WKWebsiteDataStore if necessary.
   RemoveDataFromWKWebsiteDataStore(delete_begin, mask);
@@ -592,7 +654,7 @@ void BrowsingDataRemoverImpl::RemoveDataFromWKWebsiteDataStore(
   }
 
   web::ClearBrowsingData(browser_state_, types, delete_begin,
-                         CreatePendingTaskCompletionClosure());
+                         CreatePendingTaskCompletionClosure("WebsiteData"));
 }
 
 void BrowsingDataRemoverImpl::OnKeywordsLoaded(base::Time delete_begin,
@@ -604,13 +666,12 @@ void BrowsingDataRemoverImpl::OnKeywordsLoaded(base::Time delete_begin,
   TemplateURLService* model =
       ios::TemplateURLServiceFactory::GetForBrowserState(browser_state_);
   model->RemoveAutoGeneratedBetween(delete_begin, delete_end);
-  template_url_subscription_ = {};
   std::move(callback).Run();
 }
 
 void BrowsingDataRemoverImpl::NotifyRemovalComplete() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  DCHECK(!removal_queue_.empty());
+  DCHECK(!current_plan_.empty());
 
   scoped_refptr<base::SequencedTaskRunner> current_task_runner =
       base::SequencedTaskRunnerHandle::Get();
@@ -621,8 +682,12 @@ void BrowsingDataRemoverImpl::NotifyRemovalComplete() {
     account_consistency_service->OnBrowsingDataRemoved();
   }
 
-  {
-    RemovalTask task = std::move(removal_queue_.front());
+  template_url_subscriptions_.clear();
+  completed_stores_count_ = 0;
+
+  std::vector<RemovalTask> plan;
+  std::swap(plan, current_plan_);
+  for (RemovalTask& task : plan) {
     // Only log clear browsing data on regular browsing mode. In OTR mode, only
     // few types of data are cleared and the rest is handled by deleting the
     // browser state, so logging in these cases will render the histogram not
@@ -639,7 +704,6 @@ void BrowsingDataRemoverImpl::NotifyRemovalComplete() {
             "History.ClearBrowsingData.Duration.TimeRangeDeletion", delta);
       }
     }
-    removal_queue_.pop();
 
     // Schedule the task to be executed soon. This ensure that the IsRemoving()
     // value is correct when the callback is invoked.
@@ -659,13 +723,15 @@ void BrowsingDataRemoverImpl::NotifyRemovalComplete() {
     return;
   }
 
-  // Yield execution before executing the next removal task.
+  // Yield execution before executing the next removal plan.
   current_task_runner->PostTask(
       FROM_HERE,
       base::BindOnce(&BrowsingDataRemoverImpl::RunNextTask, GetWeakPtr()));
 }
 
-void BrowsingDataRemoverImpl::OnTaskComplete() {
+void BrowsingDataRemoverImpl::OnTaskComplete(const char* name,
+                                             bool is_store,
+                                             base::TimeTicks start_time) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
   // TODO(crbug.com/305259): This should also observe session clearing (what
@@ -673,17 +739,45 @@ void BrowsingDataRemoverImpl::OnTaskComplete() {
   // before continuing.
 
   DCHECK_GT(pending_tasks_count_, 0);
-  if (--pending_tasks_count_ > 0)
+  --pending_tasks_count_;
+  if (is_store) {
+    base::UmaHistogramMediumTimes(
+        base::StrCat({"History.ClearBrowsingData.StoreDuration.", name}),
+        base::TimeTicks::Now() - start_time);
+
+    DCHECK_GT(pending_stores_count_, 0);
+    ++completed_stores_count_;
+    --pending_stores_count_;
+    NotifyBrowsingDataRemovalProgress(
+        completed_stores_count_,
+        completed_stores_count_ + pending_stores_count_);
+  } else {
+    base::UmaHistogramMediumTimes(
+        base::StrCat({"History.ClearBrowsingData.StepDuration.", name}),
+        base::TimeTicks::Now() - start_time);
+  }
+
+  if (pending_tasks_count_ > 0)
     return;
 
   NotifyRemovalComplete();
 }
 
-base::OnceClosure
-BrowsingDataRemoverImpl::CreatePendingTaskCompletionClosure() {
+base::OnceClosure BrowsingDataRemoverImpl::CreatePendingTaskCompletionClosure(
+    const char* store_name) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  ++pending_tasks_count_;
+  ++pending_stores_count_;
+  return base::BindOnce(&BrowsingDataRemoverImpl::OnTaskComplete, GetWeakPtr(),
+                        store_name, /*is_store=*/true, base::TimeTicks::Now());
+}
+
+base::OnceClosure BrowsingDataRemoverImpl::CreatePendingStepCompletionClosure(
+    const char* step_name) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   ++pending_tasks_count_;
-  return base::BindOnce(&BrowsingDataRemoverImpl::OnTaskComplete, GetWeakPtr());
+  return base::BindOnce(&BrowsingDataRemoverImpl::OnTaskComplete, GetWeakPtr(),
+                        step_name, /*is_store=*/false, base::TimeTicks::Now());
 }
 
 base::WeakPtr<BrowsingDataRemoverImpl> BrowsingDataRemoverImpl::GetWeakPtr() {
@@ -52,6 +52,13 @@ const char kFullDeletionHistogram[] =
     "History.ClearBrowsingData.Duration.FullDeletion";
 const char kTimeRangeDeletionHistogram[] =
     "History.ClearBrowsingData.Duration.TimeRangeDeletion";
+const char kTasksPerPlanHistogram[] = "History.ClearBrowsingData.TasksPerPlan";
+const char kHttpCacheDurationHistogram[] =
+    "History.ClearBrowsingData.StoreDuration.HttpCache";
+const char kPlanSchedulingStepHistogram[] =
+    "History.ClearBrowsingData.StepDuration.PlanScheduling";
+const char kPlanSchedulingStoreHistogram[] =
+    "History.ClearBrowsingData.StoreDuration.PlanScheduling";
 
 // Observer used to validate that BrowsingDataRemoverImpl notifies its
 // observers.
@@ -64,13 +71,24 @@ class TestBrowsingDataRemoverObserver : public BrowsingDataRemoverObserver {
   void OnBrowsingDataRemoved(BrowsingDataRemover* remover,
                              BrowsingDataRemoveMask mask) override;
 
+  void OnBrowsingDataRemovalProgress(BrowsingDataRemover* remover,
+                                     int completed_steps,
+                                     int total_steps) override;
+
   // Returns the |mask| value passed to the last call of OnBrowsingDataRemoved.
   // Returns BrowsingDataRemoveMask::REMOVE_NOTHING if it has not been called.
   BrowsingDataRemoveMask last_remove_mask() const { return last_remove_mask_; }
 
+  // Returns the values passed to the last call of
+  // OnBrowsingDataRemovalProgress, or 0 if it has not been called.
+  int last_completed_steps() const { return last_completed_steps_; }
+  int last_total_steps() const { return last_total_steps_; }
+
  private:
   BrowsingDataRemoveMask last_remove_mask_ =
       BrowsingDataRemoveMask::REMOVE_NOTHING;
+  int last_completed_steps_ = 0;
+  int last_total_steps_ = 0;
 
   DISALLOW_COPY_AND_ASSIGN(TestBrowsingDataRemoverObserver);
 };
@@ -82,6 +100,15 @@ void TestBrowsingDataRemoverObserver::OnBrowsingDataRemoved(
   last_remove_mask_ = mask;
 }
 
+void TestBrowsingDataRemoverObserver::OnBrowsingDataRemovalProgress(
+    BrowsingDataRemover* remover,
+    int completed_steps,
+    int total_steps) {
+  DCHECK_LE(completed_steps, total_steps);
+  last_completed_steps_ = completed_steps;
+  last_total_steps_ = total_steps;
+}
+
 }  // namespace
 
 class BrowsingDataRemoverImplTest : public PlatformTest {
@@ -148,6 +175,73 @@ TEST_F(BrowsingDataRemoverImplTest, SerializeRemovals) {
   }));
 }
 
+// Tests that the removals requested while a removal is in progress are merged
+// into a single plan, and that the data types removed by a task for a wider
+// time range are not removed again.
+TEST_F(BrowsingDataRemoverImplTest, MergeQueuedRemovals) {
+  base::HistogramTester histogram_tester;
+  __block int remaining_calls = 3;
+  browsing_data_remover_.Remove(browsing_data::TimePeriod::ALL_TIME,
+                                kRemoveMask, base::BindOnce(^{
+                                  --remaining_calls;
+                                }));
+  browsing_data_remover_.Remove(browsing_data::TimePeriod::ALL_TIME,
+                                kRemoveMask, base::BindOnce(^{
+                                  --remaining_calls;
+                                }));
+  browsing_data_remover_.Remove(browsing_data::TimePeriod::LAST_HOUR,
+                                BrowsingDataRemoveMask::REMOVE_CACHE,
+                                base::BindOnce(^{
+                                  --remaining_calls;
+                                }));
+
+  EXPECT_TRUE(WaitUntilConditionOrTimeout(kWaitForActionTimeout, ^{
+    // Spin the RunLoop as WaitUntilConditionOrTimeout doesn't.
+    base::RunLoop().RunUntilIdle();
+    return remaining_calls == 0;
+  }));
+
+  // The first removal starts immediately, the other two are merged.
+  histogram_tester.ExpectBucketCount(kTasksPerPlanHistogram, 1, 1);
+  histogram_tester.ExpectBucketCount(kTasksPerPlanHistogram, 2, 1);
+  // The cache is cleared once per plan.
+  histogram_tester.ExpectTotalCount(kHttpCacheDurationHistogram, 2);
+}
+
+// Tests that BrowsingDataRemoverImpl::Remove() reports its progress to the
+// observers.
+TEST_F(BrowsingDataRemoverImplTest, ReportsProgress) {
+  base::HistogramTester histogram_tester;
+  TestBrowsingDataRemoverObserver observer;
+  base::ScopedObservation<BrowsingDataRemover, BrowsingDataRemoverObserver>
+      scoped_observer(&observer);
+  scoped_observer.Observe(&browsing_data_remover_);
+
+  __block int remaining_calls = 1;
+  browsing_data_remover_.Remove(browsing_data::TimePeriod::ALL_TIME,
+                                kRemoveMask, base::BindOnce(^{
+                                  --remaining_calls;
+                                }));
+  EXPECT_TRUE(WaitUntilConditionOrTimeout(kWaitForActionTimeout, ^{
+    // Spin the RunLoop as WaitUntilConditionOrTimeout doesn't.
+    base::RunLoop().RunUntilIdle();
+    return remaining_calls == 0;
+  }));
+
+  EXPECT_GT(observer.last_total_steps(), 1);
+  EXPECT_EQ(observer.last_total_steps(), observer.last_completed_steps());
+
+  // Internal steps of the removal are not reported as stores.
+  histogram_tester.ExpectTotalCount(kPlanSchedulingStepHistogram, 1);
+  histogram_tester.ExpectTotalCount(kPlanSchedulingStoreHistogram, 0);
+  int store_count = 0;
+  for (const auto& histogram : histogram_tester.GetTotalCountsForPrefix(
+           "History.ClearBrowsingData.StoreDuration.")) {
+    store_count += histogram.second;
+  }
+  EXPECT_EQ(store_count, observer.last_total_steps());
+}
+
 // Tests that BrowsingDataRemoverImpl::Remove() Logs the duration to the correct
 // histogram for full deletion.
 TEST_F(BrowsingDataRemoverImplTest, LogDurationForFullDeletion) {
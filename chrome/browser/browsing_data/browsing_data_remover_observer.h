@@ -22,6 +22,14 @@ class BrowsingDataRemoverObserver {
   virtual void OnBrowsingDataRemoved(BrowsingDataRemover* remover,
                                      BrowsingDataRemoveMask mask) = 0;
 
+  // Invoked each time one of the stores affected by the ongoing removal has
+  // been cleared. |completed_steps| is the number of stores cleared so far and
+  // |total_steps| the number of stores being cleared. |total_steps| may grow
+  // while the removal is being scheduled.
+  virtual void OnBrowsingDataRemovalProgress(BrowsingDataRemover* remover,
+                                             int completed_steps,
+                                             int total_steps) {}
+
  private:
   DISALLOW_COPY_AND_ASSIGN(BrowsingDataRemoverObserver);
 };
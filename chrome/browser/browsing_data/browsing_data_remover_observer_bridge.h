@@ -17,6 +17,11 @@
 - (void)browsingDataRemover:(BrowsingDataRemover*)remover
     didRemoveBrowsingDataWithMask:(BrowsingDataRemoveMask)mask;
 
+// Invoked by BrowsingDataRemoverObserverBridge::OnBrowsingDataRemovalProgress.
+- (void)browsingDataRemover:(BrowsingDataRemover*)remover
+    didCompleteRemovalSteps:(int)completedSteps
+                 totalSteps:(int)totalSteps;
+
 @end
 
 // Adapter to use an id<BrowsingDataRemoverObserving> as a
@@ -30,6 +35,9 @@ class BrowsingDataRemoverObserverBridge : public BrowsingDataRemoverObserver {
   // BrowsingDataRemoverObserver methods.
   void OnBrowsingDataRemoved(BrowsingDataRemover* remover,
                              BrowsingDataRemoveMask mask) override;
+  void OnBrowsingDataRemovalProgress(BrowsingDataRemover* remover,
+                                     int completed_steps,
+                                     int total_steps) override;
 
  private:
   __weak id<BrowsingDataRemoverObserving> observer_ = nil;
@@ -23,3 +23,15 @@ void BrowsingDataRemoverObserverBridge::OnBrowsingDataRemoved(
     [observer_ browsingDataRemover:remover didRemoveBrowsingDataWithMask:mask];
   }
 }
+
+void BrowsingDataRemoverObserverBridge::OnBrowsingDataRemovalProgress(
+    BrowsingDataRemover* remover,
+    int completed_steps,
+    int total_steps) {
+  if ([observer_ respondsToSelector:@selector(browsingDataRemover:
+                                        didCompleteRemovalSteps:totalSteps:)]) {
+    [observer_ browsingDataRemover:remover
+           didCompleteRemovalSteps:completed_steps
+                        totalSteps:total_steps];
+  }
+}
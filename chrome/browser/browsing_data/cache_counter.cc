@@ -3,6 +3,9 @@
 // found in the LICENSE file.
 
 #include "ios/chrome/browser/browsing_data/cache_counter.h"
+
+#include <memory>
+
 #include "base/bind.h"
 #include "base/task/post_task.h"
 #include "components/browsing_data/core/pref_names.h"
@@ -20,16 +23,25 @@
 
 namespace {
 
+// Number of data streams of a disk cache entry.
+const int kEntryStreamCount = 3;
+
 class IOThreadCacheCounter {
  public:
+  // Counts the cache of |context_getter|, or |backend| if not null.
   IOThreadCacheCounter(
       const scoped_refptr<net::URLRequestContextGetter>& context_getter,
+      disk_cache::Backend* backend,
+      base::Time begin,
+      base::Time end,
       const net::Int64CompletionRepeatingCallback& result_callback)
-      : next_step_(STEP_GET_BACKEND),
+      : next_step_(backend ? STEP_COUNT : STEP_GET_BACKEND),
         context_getter_(context_getter),
+        begin_(begin),
+        end_(end),
         result_callback_(result_callback),
         result_(0),
-        backend_(nullptr) {}
+        backend_(backend) {}
 
   void Count() {
     base::PostTask(FROM_HERE, {web::WebThread::IO},
@@ -39,21 +51,35 @@ class IOThreadCacheCounter {
 
  private:
   enum Step {
-    STEP_GET_BACKEND,  // Get the disk_cache::Backend instance.
-    STEP_COUNT,        // Run CalculateSizeOfAllEntries() on it.
-    STEP_CALLBACK,     // Respond on the UI thread.
+    STEP_GET_BACKEND,      // Get the disk_cache::Backend instance.
+    STEP_COUNT,            // Run CalculateSizeOfEntriesBetween() on it.
+    STEP_COUNT_ALL,        // Run CalculateSizeOfAllEntries() on it.
+    STEP_OPEN_NEXT_ENTRY,  // Open the next entry of the enumeration.
+    STEP_ADD_ENTRY_SIZE,   // Add the size of the entry if used in the period.
+    STEP_CALLBACK,         // Respond on the UI thread.
   };
 
   void CountInternal(int64_t rv) {
     DCHECK_CURRENTLY_ON(web::WebThread::IO);
 
     while (rv != net::ERR_IO_PENDING) {
-      // In case of an error, skip to the last step.
-      if (rv < 0)
+      if (rv == net::ERR_NOT_IMPLEMENTED && next_step_ == STEP_CALLBACK) {
+        // The backend cannot compute the size from its index, e.g. the
+        // blockfile backend for a time period. Enumerate the entries instead.
+        next_step_ = STEP_OPEN_NEXT_ENTRY;
+      } else if (rv < 0 && next_step_ == STEP_ADD_ENTRY_SIZE) {
+        // The iterator reports the end of the enumeration as a failure.
         next_step_ = STEP_CALLBACK;
+        if (rv == net::ERR_FAILED)
+          rv = enumerated_size_;
+      } else if (rv < 0) {
+        // In case of another error, skip to the last step.
+        next_step_ = STEP_CALLBACK;
+      }
 
-      // Process the counting in three steps: STEP_GET_BACKEND -> STEP_COUNT ->
-      // -> STEP_CALLBACK.
+      // Process the counting in the following steps: STEP_GET_BACKEND ->
+      // STEP_COUNT or STEP_COUNT_ALL -> (STEP_OPEN_NEXT_ENTRY ->
+      // STEP_ADD_ENTRY_SIZE, for each entry) -> STEP_CALLBACK.
       switch (next_step_) {
         case STEP_GET_BACKEND: {
           next_step_ = STEP_COUNT;
@@ -72,6 +98,25 @@ class IOThreadCacheCounter {
         }
 
         case STEP_COUNT: {
+          // The simple and memory backends keep the last used time of each
+          // entry in their index, so they count the time period without
+          // opening the entries. The blockfile backend used by the regular
+          // browser states doesn't, and returns ERR_NOT_IMPLEMENTED.
+          if (begin_.is_null() && end_.is_max()) {
+            next_step_ = STEP_COUNT_ALL;
+            break;
+          }
+          next_step_ = STEP_CALLBACK;
+
+          DCHECK(backend_);
+          rv = backend_->CalculateSizeOfEntriesBetween(
+              begin_, end_,
+              base::BindRepeating(&IOThreadCacheCounter::CountInternal,
+                                  base::Unretained(this)));
+          break;
+        }
+
+        case STEP_COUNT_ALL: {
           next_step_ = STEP_CALLBACK;
 
           DCHECK(backend_);
@@ -80,8 +125,42 @@ class IOThreadCacheCounter {
           break;
         }
 
+        case STEP_OPEN_NEXT_ENTRY: {
+          next_step_ = STEP_ADD_ENTRY_SIZE;
+
+          DCHECK(backend_);
+          if (!iterator_)
+            iterator_ = backend_->CreateIterator();
+          disk_cache::EntryResult result = iterator_->OpenNextEntry(
+              base::BindOnce(&IOThreadCacheCounter::OnEntryOpened,
+                             base::Unretained(this)));
+          rv = result.net_error();
+          if (rv != net::ERR_IO_PENDING)
+            entry_ = result.ReleaseEntry();
+          break;
+        }
+
+        case STEP_ADD_ENTRY_SIZE: {
+          next_step_ = STEP_OPEN_NEXT_ENTRY;
+
+          // Same range as CalculateSizeOfEntriesBetween().
+          DCHECK(entry_);
+          const base::Time last_used = entry_->GetLastUsed();
+          if (begin_ <= last_used && last_used < end_) {
+            enumerated_size_ += entry_->GetKey().size();
+            for (int index = 0; index < kEntryStreamCount; ++index)
+              enumerated_size_ += entry_->GetDataSize(index);
+          }
+          entry_->Close();
+          entry_ = nullptr;
+          rv = net::OK;
+          break;
+        }
+
         case STEP_CALLBACK: {
           result_ = rv;
+          // The iterator must be destroyed on the IO thread.
+          iterator_.reset();
 
           base::PostTask(
               FROM_HERE, {web::WebThread::UI},
@@ -97,6 +176,12 @@ class IOThreadCacheCounter {
     }
   }
 
+  void OnEntryOpened(disk_cache::EntryResult result) {
+    const int rv = result.net_error();
+    entry_ = result.ReleaseEntry();
+    CountInternal(rv);
+  }
+
   void OnCountingFinished() {
     DCHECK_CURRENTLY_ON(web::WebThread::UI);
     result_callback_.Run(result_);
@@ -105,9 +190,18 @@ class IOThreadCacheCounter {
 
   Step next_step_;
   scoped_refptr<net::URLRequestContextGetter> context_getter_;
+  const base::Time begin_;
+  const base::Time end_;
   net::Int64CompletionRepeatingCallback result_callback_;
   int64_t result_;
   disk_cache::Backend* backend_;
+  // Enumeration of the entries, for the backends which cannot compute the size
+  // of a time period from their index.
+  std::unique_ptr<disk_cache::Backend::Iterator> iterator_;
+  // Entry being counted by the enumeration.
+  disk_cache::Entry* entry_ = nullptr;
+  // Size of the entries enumerated so far that were used in the time period.
+  int64_t enumerated_size_ = 0;
 };
 
 }  // namespace
@@ -122,18 +216,22 @@ const char* CacheCounter::GetPrefName() const {
 }
 
 void CacheCounter::Count() {
-  // disk_cache::Backend currently does not implement counting for subsets of
-  // cache, only for the entire cache. Thus, ignore the time period setting and
-  // always request counting for the unbounded time interval. It is up to the
-  // UI to interpret the results for finite time intervals as upper estimates.
+  // The size of the entries used in the time period is computed by the disk
+  // cache backend when it can do so from its index. Otherwise, the entries are
+  // enumerated and only those used in the time period are counted.
   // IOThreadCacheCounter deletes itself when done.
   (new IOThreadCacheCounter(
-       browser_state_->GetRequestContext(),
+       browser_state_->GetRequestContext(), backend_for_testing_,
+       GetPeriodStart(), GetPeriodEnd(),
        base::BindRepeating(&CacheCounter::OnCacheSizeCalculated,
                            weak_ptr_factory_.GetWeakPtr())))
       ->Count();
 }
 
+void CacheCounter::SetBackendForTesting(disk_cache::Backend* backend) {
+  backend_for_testing_ = backend;
+}
+
 void CacheCounter::OnCacheSizeCalculated(int64_t result_bytes) {
   // A value less than 0 means a net error code.
   if (result_bytes < 0)
@@ -11,6 +11,10 @@
 
 class ChromeBrowserState;
 
+namespace disk_cache {
+class Backend;
+}  // namespace disk_cache
+
 // CacheCounter is a BrowsingDataCounter used to compute the cache size.
 class CacheCounter : public browsing_data::BrowsingDataCounter {
  public:
@@ -21,12 +25,19 @@ class CacheCounter : public browsing_data::BrowsingDataCounter {
   const char* GetPrefName() const override;
   void Count() override;
 
+  // Counts the entries of |backend| instead of the cache of the browser state.
+  // |backend| must be used on the IO thread and outlive the counting.
+  void SetBackendForTesting(disk_cache::Backend* backend);
+
  private:
   // Invoked when cache size has been computed.
   void OnCacheSizeCalculated(int64_t cache_size);
 
   ChromeBrowserState* browser_state_;
 
+  // Backend counted instead of the cache of the browser state, if not null.
+  disk_cache::Backend* backend_for_testing_ = nullptr;
+
   base::WeakPtrFactory<CacheCounter> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(CacheCounter);
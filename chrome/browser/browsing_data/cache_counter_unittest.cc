@@ -6,13 +6,17 @@
 // when it counts and when not, when result is nonzero and when not. It does not
 // test whether the result of the counting is correct. This is the
 // responsibility of a lower layer, and is tested in
-// DiskCacheBackendTest.CalculateSizeOfAllEntries in net_unittests.
+// DiskCacheBackendTest.CalculateSizeOfEntriesBetween and
+// DiskCacheBackendTest.CalculateSizeOfAllEntries in net_unittests. The
+// enumeration used for the blockfile backend, which doesn't implement
+// CalculateSizeOfEntriesBetween(), is tested here.
 
 #include "ios/chrome/browser/browsing_data/cache_counter.h"
 
 #include <memory>
 
 #include "base/bind.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/run_loop.h"
 #include "base/task/post_task.h"
 #include "base/time/time.h"
@@ -42,7 +46,17 @@ class CacheCounterTest : public PlatformTest {
     context_getter_ = browser_state_->GetRequestContext();
   }
 
-  ~CacheCounterTest() override {}
+  ~CacheCounterTest() override {
+    if (!blockfile_backend_)
+      return;
+    // The blockfile backend must be destroyed on the IO thread, and its
+    // pending file operations completed before deleting its directory.
+    base::PostTask(FROM_HERE, {web::WebThread::IO},
+                   base::BindOnce(&CacheCounterTest::DestroyBlockfileBackend,
+                                  base::Unretained(this)));
+    WaitForIOThread();
+    disk_cache::FlushCacheThreadForTesting();
+  }
 
   ChromeBrowserState* browser_state() { return browser_state_.get(); }
 
@@ -57,10 +71,24 @@ class CacheCounterTest : public PlatformTest {
                         static_cast<int>(period));
   }
 
+  // Creates a blockfile backend in a temporary directory on the IO thread. It
+  // is the backend used by the cache of the regular browser states, and
+  // replaces the cache of the browser state for the next operations.
+  void CreateBlockfileBackend() {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    base::PostTask(FROM_HERE, {web::WebThread::IO},
+                   base::BindOnce(&CacheCounterTest::CreateBlockfileBackendStep,
+                                  base::Unretained(this)));
+    WaitForIOThread();
+    ASSERT_TRUE(blockfile_backend_);
+  }
+
+  disk_cache::Backend* blockfile_backend() { return blockfile_backend_.get(); }
+
   // Create a cache entry on the IO thread.
   void CreateCacheEntry() {
     current_operation_ = OPERATION_ADD_ENTRY;
-    next_step_ = STEP_GET_BACKEND;
+    next_step_ = blockfile_backend_ ? STEP_CREATE_ENTRY : STEP_GET_BACKEND;
 
     base::PostTask(FROM_HERE, {web::WebThread::IO},
                    base::BindOnce(&CacheCounterTest::CacheOperationStep,
@@ -211,6 +239,34 @@ class CacheCounterTest : public PlatformTest {
     }
   }
 
+  void CreateBlockfileBackendStep() {
+    net::HttpCache::DefaultBackend backend_factory(
+        net::DISK_CACHE, net::CACHE_BACKEND_BLOCKFILE, temp_dir_.GetPath(),
+        /*max_bytes=*/0, /*hard_reset=*/false);
+    int rv = backend_factory.CreateBackend(
+        /*net_log=*/nullptr, &blockfile_backend_,
+        base::BindOnce(&CacheCounterTest::OnBlockfileBackendCreated,
+                       base::Unretained(this)));
+    if (rv != net::ERR_IO_PENDING)
+      OnBlockfileBackendCreated(rv);
+  }
+
+  void OnBlockfileBackendCreated(int rv) {
+    DCHECK_EQ(net::OK, rv);
+    backend_ = blockfile_backend_.get();
+    base::PostTask(
+        FROM_HERE, {web::WebThread::UI},
+        base::BindOnce(&CacheCounterTest::Callback, base::Unretained(this)));
+  }
+
+  void DestroyBlockfileBackend() {
+    backend_ = nullptr;
+    blockfile_backend_.reset();
+    base::PostTask(
+        FROM_HERE, {web::WebThread::UI},
+        base::BindOnce(&CacheCounterTest::Callback, base::Unretained(this)));
+  }
+
   void SaveEntryAndStep(disk_cache::EntryResult result) {
     int rv = result.net_error();
     entry_ = result.ReleaseEntry();
@@ -233,6 +289,9 @@ class CacheCounterTest : public PlatformTest {
 
   scoped_refptr<net::URLRequestContextGetter> context_getter_;
   disk_cache::Backend* backend_;
+
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<disk_cache::Backend> blockfile_backend_;
   disk_cache::Entry* entry_;
 
   bool finished_ = false;
@@ -273,6 +332,25 @@ TEST_F(CacheCounterTest, BeforeAndAfterClearing) {
   EXPECT_EQ(0u, GetResult());
 }
 
+// Tests that entries added to the cache after it has been counted are included
+// in the next count.
+TEST_F(CacheCounterTest, EntryAddedAfterCounting) {
+  CacheCounter counter(browser_state());
+  counter.Init(prefs(), browsing_data::ClearBrowsingDataTab::ADVANCED,
+               base::BindRepeating(&CacheCounterTest::CountingCallback,
+                                   base::Unretained(this)));
+  counter.Restart();
+
+  WaitForIOThread();
+  EXPECT_EQ(0u, GetResult());
+
+  CreateCacheEntry();
+  counter.Restart();
+
+  WaitForIOThread();
+  EXPECT_NE(0u, GetResult());
+}
+
 // Tests that the counter starts counting automatically when the deletion
 // pref changes to true.
 TEST_F(CacheCounterTest, PrefChanged) {
@@ -288,10 +366,8 @@ TEST_F(CacheCounterTest, PrefChanged) {
   EXPECT_EQ(0u, GetResult());
 }
 
-// Tests that the counting is restarted when the time period changes. Currently,
-// the results should be the same for every period. This is because the counter
-// always counts the size of the entire cache, and it is up to the UI
-// to interpret it as exact value or upper bound.
+// Tests that the counting is restarted when the time period changes. As the
+// only entry was just used, the results should be the same for every period.
 TEST_F(CacheCounterTest, PeriodChanged) {
   CreateCacheEntry();
 
@@ -321,4 +397,28 @@ TEST_F(CacheCounterTest, PeriodChanged) {
   EXPECT_EQ(result, GetResult());
 }
 
+// Tests that the blockfile backend, which can't compute the size of a time
+// period from its index, only counts the entries used in the time period.
+TEST_F(CacheCounterTest, BlockfileBackendTimePeriod) {
+  CreateBlockfileBackend();
+  CreateCacheEntry();
+  SetDeletionPeriodPref(browsing_data::TimePeriod::LAST_HOUR);
+
+  CacheCounter counter(browser_state());
+  counter.SetBackendForTesting(blockfile_backend());
+  counter.Init(prefs(), browsing_data::ClearBrowsingDataTab::ADVANCED,
+               base::BindRepeating(&CacheCounterTest::CountingCallback,
+                                   base::Unretained(this)));
+  counter.Restart();
+
+  WaitForIOThread();
+  EXPECT_NE(0u, GetResult());
+
+  // The only entry was just used, so it is not counted for a period ending
+  // four weeks ago.
+  SetDeletionPeriodPref(browsing_data::TimePeriod::OLDER_THAN_30_DAYS);
+  WaitForIOThread();
+  EXPECT_EQ(0u, GetResult());
+}
+
 }  // namespace
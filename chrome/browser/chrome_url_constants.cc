@@ -41,6 +41,7 @@ const char kChromeUIHistoryHost[] = "history";
 const char kChromeUIInspectHost[] = "inspect";
 const char kChromeUIIntersitialsHost[] = "interstitials";
 const char kChromeUIManagementHost[] = "management";
+const char kChromeUIMemoryInternalsHost[] = "memory-internals";
 const char kChromeUINetExportHost[] = "net-export";
 const char kChromeUINewTabHost[] = "newtab";
 const char kChromeUINTPTilesInternalsHost[] = "ntp-tiles-internals";
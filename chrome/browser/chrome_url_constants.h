@@ -45,6 +45,7 @@ extern const char kChromeUIHistoryHost[];
 extern const char kChromeUIInspectHost[];
 extern const char kChromeUIIntersitialsHost[];
 extern const char kChromeUIManagementHost[];
+extern const char kChromeUIMemoryInternalsHost[];
 extern const char kChromeUINetExportHost[];
 extern const char kChromeUINewTabHost[];
 extern const char kChromeUINTPTilesInternalsHost[];
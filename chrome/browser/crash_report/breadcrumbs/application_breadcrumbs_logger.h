@@ -12,6 +12,7 @@
 
 #include "base/memory/memory_pressure_listener.h"
 #include "base/metrics/user_metrics.h"
+#include "ios/chrome/browser/crash_report/main_thread_jank_monitor.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace base {
@@ -27,13 +28,16 @@ class BreadcrumbPersistentStorageManager;
 // Name of event logged when device orientation is changed.
 extern const char kBreadcrumbOrientation[];
 
+// Name of event logged when the main thread is janky.
+extern const char kBreadcrumbMainThreadJank[];
+
 // Listens for and logs application wide breadcrumb events to the
 // BreadcrumbManager passed in the constructor.
-class ApplicationBreadcrumbsLogger {
+class ApplicationBreadcrumbsLogger : public MainThreadJankMonitor::Observer {
  public:
   explicit ApplicationBreadcrumbsLogger(
       breadcrumbs::BreadcrumbManager* breadcrumb_manager);
-  ~ApplicationBreadcrumbsLogger();
+  ~ApplicationBreadcrumbsLogger() override;
 
   // Sets a BreadcrumbPersistentStorageManager to persist application breadcrumb
   // events logged by this ApplicationBreadcrumbsLogger instance.
@@ -58,6 +62,12 @@ class ApplicationBreadcrumbsLogger {
   void OnMemoryPressure(
       base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
 
+  // MainThreadJankMonitor::Observer:
+  // Logs the janks exceeding a threshold above the lowest one.
+  void OnMainThreadJank(base::TimeDelta duration,
+                        size_t threshold_index,
+                        const std::string& signature) override;
+
   // Returns true if |action| (UMA User Action) is user triggered.
   static bool IsUserTriggeredAction(const std::string& action);
 
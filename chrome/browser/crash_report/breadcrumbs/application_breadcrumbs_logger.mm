@@ -4,6 +4,8 @@
 
 #import "ios/chrome/browser/crash_report/breadcrumbs/application_breadcrumbs_logger.h"
 
+#include <inttypes.h>
+
 #include "base/bind.h"
 #include "base/strings/stringprintf.h"
 #include "components/breadcrumbs/core/application_breadcrumbs_not_user_action.inc"
@@ -16,6 +18,7 @@
 #endif
 
 const char kBreadcrumbOrientation[] = "Orientation";
+const char kBreadcrumbMainThreadJank[] = "Main Thread Jank";
 
 ApplicationBreadcrumbsLogger::ApplicationBreadcrumbsLogger(
     breadcrumbs::BreadcrumbManager* breadcrumb_manager)
@@ -31,6 +34,7 @@ ApplicationBreadcrumbsLogger::ApplicationBreadcrumbsLogger(
 
   breakpad::MonitorBreadcrumbManager(breadcrumb_manager_);
   breadcrumb_manager_->AddEvent("Startup");
+  MainThreadJankMonitor::GetInstance()->AddObserver(this);
 
   orientation_observer_ = [NSNotificationCenter.defaultCenter
       addObserverForName:UIDeviceOrientationDidChangeNotification
@@ -71,6 +75,7 @@ ApplicationBreadcrumbsLogger::ApplicationBreadcrumbsLogger(
 
 ApplicationBreadcrumbsLogger::~ApplicationBreadcrumbsLogger() {
   [NSNotificationCenter.defaultCenter removeObserver:orientation_observer_];
+  MainThreadJankMonitor::GetInstance()->RemoveObserver(this);
   breadcrumb_manager_->AddEvent("Shutdown");
   base::RemoveActionCallback(user_action_callback_);
   breakpad::StopMonitoringBreadcrumbManager(breadcrumb_manager_);
@@ -133,6 +138,25 @@ void ApplicationBreadcrumbsLogger::OnMemoryPressure(
   breadcrumb_manager_->AddEvent(event);
 }
 
+void ApplicationBreadcrumbsLogger::OnMainThreadJank(
+    base::TimeDelta duration,
+    size_t threshold_index,
+    const std::string& signature) {
+  // The janks only exceeding the lowest threshold are too frequent to be
+  // useful.
+  if (threshold_index == 0)
+    return;
+
+  // Only log the innermost frame, as the breadcrumbs size is limited.
+  const std::string top_frame = signature.substr(
+      0, signature.find(MainThreadJankAggregator::kFrameSeparator));
+  std::string event = base::StringPrintf(
+      "%s %" PRId64 "ms", kBreadcrumbMainThreadJank, duration.InMilliseconds());
+  if (!top_frame.empty())
+    event += " " + top_frame;
+  breadcrumb_manager_->AddEvent(event);
+}
+
 bool ApplicationBreadcrumbsLogger::IsUserTriggeredAction(
     const std::string& action) {
   // The variable kNotUserTriggeredActions is a sorted array of
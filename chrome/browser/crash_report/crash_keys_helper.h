@@ -5,6 +5,8 @@
 #ifndef IOS_CHROME_BROWSER_CRASH_REPORT_CRASH_KEYS_HELPER_H_
 #define IOS_CHROME_BROWSER_CRASH_REPORT_CRASH_KEYS_HELPER_H_
 
+#include <string>
+
 
 @class NSString;
 @class NSArray;
@@ -93,6 +95,10 @@ void RemoveGridToVisibleTabAnimation();
 // Sets a key with the given |breadcrumbs| events.
 void SetBreadcrumbEvents(NSString* breadcrumbs);
 
+// Sets a key with the signatures of the stacks which caused the longest main
+// thread janks, as reported by MainThreadJankMonitor.
+void SetMainThreadJankOffenders(const std::string& offenders);
+
 // Sets a key in browser to store the playback state of media player (audio or
 // video). This function records a new start. This function is called for each
 // stream in the media (once or twice for audio, two or three times for video).
@@ -11,6 +11,7 @@
 #import "components/previous_session_info/previous_session_info.h"
 #import "ios/chrome/browser/crash_report/crash_report_user_application_state.h"
 #import "ios/chrome/browser/crash_report/main_thread_freeze_detector.h"
+#include "ios/chrome/browser/crash_report/main_thread_jank_monitor.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
 #error "This file requires ARC support."
@@ -27,6 +28,7 @@ const char kFreeDiskInKB[] = "free_disk_in_kb";
 const char kFreeMemoryInKB[] = "free_memory_in_kb";
 const char kMemoryWarningInProgress[] = "memory_warning_in_progress";
 const char kMemoryWarningCount[] = "memory_warning_count";
+const char kMainThreadJankOffenders[] = "main_thread_jank_offenders";
 const char kGridToVisibleTabAnimation[] = "grid_to_visible_tab_animation";
 static crash_reporter::CrashKeyString<1028> kRemoveGridToVisibleTabAnimationKey(
     kGridToVisibleTabAnimation);
@@ -54,9 +56,11 @@ void SetCurrentlyInBackground(bool background) {
   if (background) {
     key.Set("yes");
     [[MainThreadFreezeDetector sharedInstance] stop];
+    MainThreadJankMonitor::GetInstance()->Stop();
   } else {
     key.Clear();
     [[MainThreadFreezeDetector sharedInstance] start];
+    MainThreadJankMonitor::GetInstance()->Start();
   }
 }
 
@@ -193,6 +197,11 @@ void SetBreadcrumbEvents(NSString* breadcrumbs) {
   key.Set(base::SysNSStringToUTF8(breadcrumbs));
 }
 
+void SetMainThreadJankOffenders(const std::string& offenders) {
+  static crash_reporter::CrashKeyString<1024> key(kMainThreadJankOffenders);
+  key.Set(offenders);
+}
+
 void MediaStreamPlaybackDidStart() {
   [[CrashReportUserApplicationState sharedInstance]
       incrementValue:kVideoPlaying];
@@ -19,6 +19,9 @@ const base::Feature kMetrickitCrashReport{"MetrickitCrashReport",
 const base::Feature kSyntheticCrashReportsForUte{
     "SyntheticCrashReportsForUte", base::FEATURE_DISABLED_BY_DEFAULT};
 
+const base::Feature kMainThreadJankMonitor{"MainThreadJankMonitor",
+                                           base::FEATURE_DISABLED_BY_DEFAULT};
+
 bool EnableSyntheticCrashReportsForUte() {
   return base::FeatureList::IsEnabled(kSyntheticCrashReportsForUte) &&
          base::FeatureList::IsEnabled(breadcrumbs::kLogBreadcrumbs);
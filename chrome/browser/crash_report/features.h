@@ -13,6 +13,9 @@ extern const base::Feature kMetrickitCrashReport;
 
 extern const base::Feature kSyntheticCrashReportsForUte;
 
+// Feature to record the main thread janks with MainThreadJankMonitor.
+extern const base::Feature kMainThreadJankMonitor;
+
 // Returns true if kSyntheticCrashReportsForUte and kLogBreadcrumbs features are
 // both enabled. There is not much value in uploading Synthetic Crash Reports
 // without Breadcrumbs.
@@ -0,0 +1,114 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/crash_report/main_thread_jank_aggregator.h"
+
+#include <dlfcn.h>
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/strings/stringprintf.h"
+
+namespace {
+
+// Maximum number of symbolized frames kept in the cache.
+const size_t kMaxSymbolCacheSize = 4096;
+
+}  // namespace
+
+const char MainThreadJankAggregator::kOtherSignature[] = "other";
+const char MainThreadJankAggregator::kFrameSeparator = '<';
+
+MainThreadJankAggregator::MainThreadJankAggregator()
+    : MainThreadJankAggregator(
+          base::BindRepeating(&MainThreadJankAggregator::SymbolizeWithDladdr)) {
+}
+
+MainThreadJankAggregator::MainThreadJankAggregator(
+    SymbolizeCallback symbolize)
+    : symbolize_(std::move(symbolize)) {}
+
+MainThreadJankAggregator::~MainThreadJankAggregator() = default;
+
+std::string MainThreadJankAggregator::AddJank(
+    base::TimeDelta duration,
+    const std::vector<std::vector<uintptr_t>>& stacks) {
+  std::map<std::string, int> jank_sample_counts;
+  for (const auto& stack : stacks) {
+    if (stack.empty())
+      continue;
+    std::string signature = SignatureForStack(stack);
+    if (buckets_.find(signature) == buckets_.end() &&
+        buckets_.size() >= kMaxBucketCount) {
+      signature = kOtherSignature;
+    }
+    Offender& offender = buckets_[signature];
+    offender.signature = signature;
+    offender.sample_count++;
+    jank_sample_counts[signature]++;
+  }
+
+  if (jank_sample_counts.empty())
+    return std::string();
+
+  auto dominant = std::max_element(
+      jank_sample_counts.begin(), jank_sample_counts.end(),
+      [](const auto& lhs, const auto& rhs) { return lhs.second < rhs.second; });
+  Offender& offender = buckets_[dominant->first];
+  offender.jank_count++;
+  offender.jank_duration += duration;
+  return dominant->first;
+}
+
+std::vector<MainThreadJankAggregator::Offender>
+MainThreadJankAggregator::GetTopOffenders(size_t count) const {
+  std::vector<Offender> offenders;
+  for (const auto& pair : buckets_) {
+    if (pair.second.jank_count)
+      offenders.push_back(pair.second);
+  }
+  std::sort(offenders.begin(), offenders.end(),
+            [](const Offender& lhs, const Offender& rhs) {
+              return lhs.jank_duration > rhs.jank_duration;
+            });
+  if (offenders.size() > count)
+    offenders.resize(count);
+  return offenders;
+}
+
+// static
+std::string MainThreadJankAggregator::SymbolizeWithDladdr(uintptr_t address) {
+  Dl_info info;
+  if (!dladdr(reinterpret_cast<const void*>(address), &info) ||
+      !info.dli_fname || !info.dli_fbase) {
+    return base::StringPrintf("0x%lx", static_cast<unsigned long>(address));
+  }
+  const uintptr_t image_base = reinterpret_cast<uintptr_t>(info.dli_fbase);
+  return base::StringPrintf(
+      "%s+0x%lx", base::FilePath(info.dli_fname).BaseName().value().c_str(),
+      static_cast<unsigned long>(address - image_base));
+}
+
+std::string MainThreadJankAggregator::SignatureForStack(
+    const std::vector<uintptr_t>& stack) {
+  std::string signature;
+  const size_t frame_count = std::min(stack.size(), kSignatureFrameCount);
+  for (size_t index = 0; index < frame_count; ++index) {
+    auto iter = symbol_cache_.find(stack[index]);
+    if (iter == symbol_cache_.end()) {
+      if (symbol_cache_.size() >= kMaxSymbolCacheSize)
+        symbol_cache_.clear();
+      iter = symbol_cache_
+                 .insert(std::make_pair(stack[index],
+                                        symbolize_.Run(stack[index])))
+                 .first;
+    }
+    if (index)
+      signature += kFrameSeparator;
+    signature += iter->second;
+  }
+  return signature;
+}
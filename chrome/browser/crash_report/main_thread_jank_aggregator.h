@@ -0,0 +1,83 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_CRASH_REPORT_MAIN_THREAD_JANK_AGGREGATOR_H_
+#define IOS_CHROME_BROWSER_CRASH_REPORT_MAIN_THREAD_JANK_AGGREGATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/time/time.h"
+
+// Aggregates the stacks sampled during main thread janks into buckets keyed by
+// a signature made of their innermost frames. The frames are symbolized as
+// "<image>+0x<offset>", which can be resolved offline with the symbols of the
+// build.
+class MainThreadJankAggregator {
+ public:
+  // Number of innermost frames used for the signature of a stack.
+  static const size_t kSignatureFrameCount = 5;
+
+  // Maximum number of buckets. Stacks which do not fit are counted in a bucket
+  // with the |kOtherSignature| signature.
+  static const size_t kMaxBucketCount = 64;
+
+  static const char kOtherSignature[];
+
+  // Separator between the frames of a signature, innermost first.
+  static const char kFrameSeparator;
+
+  // A bucket of sampled stacks.
+  struct Offender {
+    std::string signature;
+    // Number of samples in the bucket.
+    int sample_count = 0;
+    // Number of janks for which the bucket had the most samples.
+    int jank_count = 0;
+    // Total duration of those janks.
+    base::TimeDelta jank_duration;
+  };
+
+  // Returns the symbolized form of |address|.
+  using SymbolizeCallback = base::RepeatingCallback<std::string(uintptr_t)>;
+
+  // Creates an aggregator symbolizing addresses with dladdr().
+  MainThreadJankAggregator();
+  explicit MainThreadJankAggregator(SymbolizeCallback symbolize);
+
+  MainThreadJankAggregator(const MainThreadJankAggregator&) = delete;
+  MainThreadJankAggregator& operator=(const MainThreadJankAggregator&) =
+      delete;
+
+  ~MainThreadJankAggregator();
+
+  // Adds a jank which lasted |duration|, during which |stacks| were sampled.
+  // Returns the signature of the bucket with the most samples, or an empty
+  // string if |stacks| is empty.
+  std::string AddJank(base::TimeDelta duration,
+                      const std::vector<std::vector<uintptr_t>>& stacks);
+
+  // Returns the |count| buckets with the longest total jank duration.
+  std::vector<Offender> GetTopOffenders(size_t count) const;
+
+  // Returns |address| as "<image>+0x<offset>", or as a raw address if it is
+  // not in a loaded image.
+  static std::string SymbolizeWithDladdr(uintptr_t address);
+
+ private:
+  // Returns the signature of |stack|.
+  std::string SignatureForStack(const std::vector<uintptr_t>& stack);
+
+  SymbolizeCallback symbolize_;
+  std::map<std::string, Offender> buckets_;
+  // Symbolized frames, as the same frames are sampled repeatedly.
+  std::map<uintptr_t, std::string> symbol_cache_;
+};
+
+#endif  // IOS_CHROME_BROWSER_CRASH_REPORT_MAIN_THREAD_JANK_AGGREGATOR_H_
@@ -0,0 +1,86 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/crash_report/main_thread_jank_aggregator.h"
+
+#include "base/bind.h"
+#include "base/strings/string_number_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+namespace {
+
+// Symbolizes the addresses as their decimal value.
+std::string SymbolizeAsNumber(uintptr_t address) {
+  return base::NumberToString(address);
+}
+
+class MainThreadJankAggregatorTest : public PlatformTest {
+ protected:
+  MainThreadJankAggregatorTest()
+      : aggregator_(base::BindRepeating(&SymbolizeAsNumber)) {}
+
+  MainThreadJankAggregator aggregator_;
+};
+
+// Tests that a jank without samples has no signature.
+TEST_F(MainThreadJankAggregatorTest, NoSamples) {
+  EXPECT_EQ("", aggregator_.AddJank(base::TimeDelta::FromMilliseconds(200),
+                                    {}));
+  EXPECT_TRUE(aggregator_.GetTopOffenders(3).empty());
+}
+
+// Tests that the signature is made of the innermost frames, and that the jank
+// is attributed to its most sampled bucket.
+TEST_F(MainThreadJankAggregatorTest, Signature) {
+  const std::vector<uintptr_t> stack_a = {1, 2, 3, 4, 5, 6, 7};
+  const std::vector<uintptr_t> stack_b = {8, 9};
+
+  EXPECT_EQ("1<2<3<4<5",
+            aggregator_.AddJank(base::TimeDelta::FromMilliseconds(300),
+                                {stack_b, stack_a, stack_a}));
+
+  std::vector<MainThreadJankAggregator::Offender> offenders =
+      aggregator_.GetTopOffenders(3);
+  ASSERT_EQ(1u, offenders.size());
+  EXPECT_EQ("1<2<3<4<5", offenders[0].signature);
+  EXPECT_EQ(2, offenders[0].sample_count);
+  EXPECT_EQ(1, offenders[0].jank_count);
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(300),
+            offenders[0].jank_duration);
+}
+
+// Tests that the top offenders are sorted by total jank duration.
+TEST_F(MainThreadJankAggregatorTest, TopOffenders) {
+  aggregator_.AddJank(base::TimeDelta::FromMilliseconds(150), {{1}});
+  aggregator_.AddJank(base::TimeDelta::FromMilliseconds(2500), {{2}});
+  aggregator_.AddJank(base::TimeDelta::FromMilliseconds(600), {{3}});
+  aggregator_.AddJank(base::TimeDelta::FromMilliseconds(600), {{1}});
+
+  std::vector<MainThreadJankAggregator::Offender> offenders =
+      aggregator_.GetTopOffenders(2);
+  ASSERT_EQ(2u, offenders.size());
+  EXPECT_EQ("2", offenders[0].signature);
+  EXPECT_EQ("1", offenders[1].signature);
+  EXPECT_EQ(2, offenders[1].jank_count);
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(750),
+            offenders[1].jank_duration);
+}
+
+// Tests that the stacks exceeding the number of buckets are aggregated in a
+// single bucket.
+TEST_F(MainThreadJankAggregatorTest, MaxBucketCount) {
+  const size_t count = MainThreadJankAggregator::kMaxBucketCount;
+  for (uintptr_t address = 1; address <= count + 2; ++address)
+    aggregator_.AddJank(base::TimeDelta::FromMilliseconds(100), {{address}});
+
+  std::vector<MainThreadJankAggregator::Offender> offenders =
+      aggregator_.GetTopOffenders(count + 10);
+  EXPECT_EQ(count + 1, offenders.size());
+  EXPECT_EQ(MainThreadJankAggregator::kOtherSignature,
+            offenders[0].signature);
+  EXPECT_EQ(2, offenders[0].jank_count);
+}
+
+}  // namespace
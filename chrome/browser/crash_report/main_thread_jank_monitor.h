@@ -0,0 +1,129 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_CRASH_REPORT_MAIN_THREAD_JANK_MONITOR_H_
+#define IOS_CHROME_BROWSER_CRASH_REPORT_MAIN_THREAD_JANK_MONITOR_H_
+
+#include <CoreFoundation/CoreFoundation.h>
+#include <dispatch/dispatch.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/no_destructor.h"
+#include "base/observer_list.h"
+#include "base/observer_list_types.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
+#include "ios/chrome/browser/crash_report/main_thread_jank_aggregator.h"
+
+class MainThreadStackSampler;
+
+// Detects the main thread janks, i.e. the run loop tasks lasting longer than
+// the lowest of the configured thresholds (100 ms, 500 ms and 2 s by default).
+// Unlike MainThreadFreezeDetector, which only reports freezes of several
+// seconds, the janks are recorded to UMA, to the crash keys and to the
+// observers, with the signature of the stacks sampled during them.
+//
+// A watchdog queue checks the main thread at the lowest threshold, and only
+// samples its stack at the sampling interval once a task exceeded that
+// threshold, so the monitor is nearly idle while the main thread is
+// responsive.
+class MainThreadJankMonitor {
+ public:
+  // Observer notified on the main thread of the janks.
+  class Observer : public base::CheckedObserver {
+   public:
+    // Called when a task lasted |duration|, exceeding the threshold at
+    // |threshold_index| (and the lower ones). |signature| is the signature of
+    // the most sampled stack, or is empty if none was sampled.
+    virtual void OnMainThreadJank(base::TimeDelta duration,
+                                  size_t threshold_index,
+                                  const std::string& signature) = 0;
+  };
+
+  // Maximum number of stacks sampled per jank.
+  static const size_t kMaxSamplesPerJank = 64;
+
+  // Number of top offenders reported in the crash keys.
+  static const size_t kReportedOffenderCount = 3;
+
+  static MainThreadJankMonitor* GetInstance();
+
+  MainThreadJankMonitor(const MainThreadJankMonitor&) = delete;
+  MainThreadJankMonitor& operator=(const MainThreadJankMonitor&) = delete;
+
+  // Starts monitoring the main thread, if the kMainThreadJankMonitor feature
+  // is enabled. Must be called on the main thread.
+  void Start();
+
+  // Stops monitoring the main thread, e.g. while the application is in the
+  // background. Must be called on the main thread.
+  void Stop();
+
+  void AddObserver(Observer* observer);
+  void RemoveObserver(Observer* observer);
+
+  // The thresholds above which a task is a jank, in increasing order.
+  const std::vector<base::TimeDelta>& thresholds() const {
+    return thresholds_;
+  }
+
+ private:
+  friend class base::NoDestructor<MainThreadJankMonitor>;
+
+  MainThreadJankMonitor();
+  ~MainThreadJankMonitor();
+
+  // Called on the main thread for each activity of its run loop.
+  void OnRunLoopActivity(CFRunLoopActivity activity);
+
+  // Ends the current task of the main thread, reporting it if it was a jank.
+  void EndTask(base::TimeTicks now);
+
+  // Reports a jank which lasted |duration|, with the stacks |samples|.
+  void ReportJank(base::TimeDelta duration,
+                  const std::vector<std::vector<uintptr_t>>& samples);
+
+  // Checks the main thread on the watchdog queue, sampling its stack if the
+  // current task is a jank, then schedules the next check.
+  void CheckMainThread();
+
+  // Schedules a check of the main thread on the watchdog queue in |delay|.
+  void ScheduleCheck(base::TimeDelta delay);
+
+  std::vector<base::TimeDelta> thresholds_;
+  base::TimeDelta sampling_interval_;
+
+  // Start time of the current task, as microseconds since the TimeTicks origin,
+  // or 0 if the main thread is waiting. Written on the main thread only.
+  std::atomic<int64_t> task_start_us_{0};
+  // Identifier of the current task. Written on the main thread only.
+  std::atomic<uint64_t> task_id_{0};
+  // Whether the monitor is running.
+  std::atomic<bool> running_{false};
+
+  base::Lock lock_;
+  // Identifier of the task whose stacks are in |samples_|.
+  uint64_t sampled_task_id_ GUARDED_BY(lock_) = 0;
+  std::vector<std::vector<uintptr_t>> samples_ GUARDED_BY(lock_);
+
+  // Generation of the checks, increased when the monitor starts so that the
+  // checks scheduled before it was stopped end.
+  std::atomic<uint64_t> check_generation_{0};
+
+  std::unique_ptr<MainThreadStackSampler> stack_sampler_;
+  CFRunLoopObserverRef run_loop_observer_ = nullptr;
+  dispatch_queue_t watchdog_queue_;
+
+  // Used on the main thread only.
+  MainThreadJankAggregator aggregator_;
+  base::ObserverList<Observer, true> observers_;
+};
+
+#endif  // IOS_CHROME_BROWSER_CRASH_REPORT_MAIN_THREAD_JANK_MONITOR_H_
@@ -0,0 +1,254 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/crash_report/main_thread_jank_monitor.h"
+
+#import <Foundation/Foundation.h>
+#include <inttypes.h>
+
+#include <algorithm>
+
+#include "base/check.h"
+#include "base/debug/debugger.h"
+#include "base/metrics/field_trial_params.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+#include "ios/chrome/app/tests_hook.h"
+#import "ios/chrome/browser/crash_report/crash_keys_helper.h"
+#include "ios/chrome/browser/crash_report/features.h"
+#include "ios/chrome/browser/crash_report/main_thread_stack_sampler.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+// Parameters of the kMainThreadJankMonitor feature.
+const char kThresholdsParam[] = "thresholds_ms";
+const char kSamplingIntervalParam[] = "sampling_interval_ms";
+
+// Default values of the parameters.
+const char kDefaultThresholds[] = "100,500,2000";
+const int kDefaultSamplingIntervalMs = 50;
+
+// Maximum number of thresholds, bounding the
+// IOS.MainThreadJank.HighestThresholdExceeded histogram.
+const size_t kMaxThresholdCount = 10;
+
+// Returns the thresholds configured for the kMainThreadJankMonitor feature,
+// in increasing order.
+std::vector<base::TimeDelta> GetThresholds() {
+  std::string param = base::GetFieldTrialParamValueByFeature(
+      kMainThreadJankMonitor, kThresholdsParam);
+  if (param.empty())
+    param = kDefaultThresholds;
+
+  std::vector<base::TimeDelta> thresholds;
+  for (const base::StringPiece& value :
+       base::SplitStringPiece(param, ",", base::TRIM_WHITESPACE,
+                              base::SPLIT_WANT_NONEMPTY)) {
+    int milliseconds = 0;
+    if (base::StringToInt(value, &milliseconds) && milliseconds > 0)
+      thresholds.push_back(base::TimeDelta::FromMilliseconds(milliseconds));
+  }
+  std::sort(thresholds.begin(), thresholds.end());
+  thresholds.erase(std::unique(thresholds.begin(), thresholds.end()),
+                   thresholds.end());
+  if (thresholds.size() > kMaxThresholdCount)
+    thresholds.resize(kMaxThresholdCount);
+  return thresholds;
+}
+
+// Returns the current time, as microseconds since the TimeTicks origin.
+int64_t NowInMicroseconds() {
+  return (base::TimeTicks::Now() - base::TimeTicks()).InMicroseconds();
+}
+
+}  // namespace
+
+// static
+MainThreadJankMonitor* MainThreadJankMonitor::GetInstance() {
+  static base::NoDestructor<MainThreadJankMonitor> instance;
+  return instance.get();
+}
+
+MainThreadJankMonitor::MainThreadJankMonitor()
+    : watchdog_queue_(dispatch_queue_create("org.chromium.jank_monitor",
+                                            DISPATCH_QUEUE_SERIAL)) {}
+
+MainThreadJankMonitor::~MainThreadJankMonitor() = default;
+
+void MainThreadJankMonitor::Start() {
+  DCHECK([NSThread isMainThread]);
+  if (running_ || !base::FeatureList::IsEnabled(kMainThreadJankMonitor) ||
+      tests_hook::DisableMainThreadFreezeDetection() ||
+      base::debug::BeingDebugged()) {
+    return;
+  }
+
+  if (thresholds_.empty()) {
+    thresholds_ = GetThresholds();
+    if (thresholds_.empty())
+      return;
+    sampling_interval_ = base::TimeDelta::FromMilliseconds(
+        base::GetFieldTrialParamByFeatureAsInt(kMainThreadJankMonitor,
+                                               kSamplingIntervalParam,
+                                               kDefaultSamplingIntervalMs));
+    stack_sampler_ = std::make_unique<MainThreadStackSampler>();
+  }
+
+  MainThreadJankMonitor* monitor = this;
+  run_loop_observer_ = CFRunLoopObserverCreateWithHandler(
+      kCFAllocatorDefault,
+      kCFRunLoopBeforeTimers | kCFRunLoopBeforeSources |
+          kCFRunLoopBeforeWaiting | kCFRunLoopAfterWaiting,
+      /*repeats=*/true, /*order=*/LONG_MIN,
+      ^(CFRunLoopObserverRef observer, CFRunLoopActivity activity) {
+        monitor->OnRunLoopActivity(activity);
+      });
+  CFRunLoopAddObserver(CFRunLoopGetMain(), run_loop_observer_,
+                       kCFRunLoopCommonModes);
+
+  running_ = true;
+  check_generation_++;
+  ScheduleCheck(thresholds_.front());
+}
+
+void MainThreadJankMonitor::Stop() {
+  DCHECK([NSThread isMainThread]);
+  if (!running_)
+    return;
+  running_ = false;
+  CFRunLoopRemoveObserver(CFRunLoopGetMain(), run_loop_observer_,
+                          kCFRunLoopCommonModes);
+  CFRelease(run_loop_observer_);
+  run_loop_observer_ = nullptr;
+  task_start_us_ = 0;
+}
+
+void MainThreadJankMonitor::AddObserver(Observer* observer) {
+  DCHECK([NSThread isMainThread]);
+  observers_.AddObserver(observer);
+}
+
+void MainThreadJankMonitor::RemoveObserver(Observer* observer) {
+  DCHECK([NSThread isMainThread]);
+  observers_.RemoveObserver(observer);
+}
+
+void MainThreadJankMonitor::OnRunLoopActivity(CFRunLoopActivity activity) {
+  const int64_t now_us = NowInMicroseconds();
+  EndTask(base::TimeTicks() + base::TimeDelta::FromMicroseconds(now_us));
+  if (activity == kCFRunLoopBeforeWaiting) {
+    task_start_us_ = 0;
+    return;
+  }
+  task_id_++;
+  task_start_us_ = now_us;
+}
+
+void MainThreadJankMonitor::EndTask(base::TimeTicks now) {
+  const int64_t task_start_us = task_start_us_;
+  if (!task_start_us)
+    return;
+
+  const base::TimeDelta duration =
+      now - base::TimeTicks() -
+      base::TimeDelta::FromMicroseconds(task_start_us);
+  if (duration < thresholds_.front())
+    return;
+
+  std::vector<std::vector<uintptr_t>> samples;
+  {
+    base::AutoLock auto_lock(lock_);
+    if (sampled_task_id_ == task_id_)
+      samples.swap(samples_);
+  }
+  ReportJank(duration, samples);
+}
+
+void MainThreadJankMonitor::ReportJank(
+    base::TimeDelta duration,
+    const std::vector<std::vector<uintptr_t>>& samples) {
+  size_t threshold_index = 0;
+  while (threshold_index + 1 < thresholds_.size() &&
+         duration >= thresholds_[threshold_index + 1]) {
+    threshold_index++;
+  }
+
+  base::UmaHistogramCustomTimes("IOS.MainThreadJank.Duration", duration,
+                                base::TimeDelta::FromMilliseconds(50),
+                                base::TimeDelta::FromMinutes(1), 50);
+  base::UmaHistogramExactLinear("IOS.MainThreadJank.HighestThresholdExceeded",
+                                threshold_index, kMaxThresholdCount);
+  base::UmaHistogramCounts100("IOS.MainThreadJank.StackSamples",
+                              samples.size());
+
+  const std::string signature = aggregator_.AddJank(duration, samples);
+  if (!signature.empty()) {
+    std::string offenders;
+    for (const auto& offender :
+         aggregator_.GetTopOffenders(kReportedOffenderCount)) {
+      if (!offenders.empty())
+        offenders += " | ";
+      offenders += base::StringPrintf(
+          "%" PRId64 "ms/%d: %s", offender.jank_duration.InMilliseconds(),
+          offender.jank_count, offender.signature.c_str());
+    }
+    crash_keys::SetMainThreadJankOffenders(offenders);
+  }
+
+  for (auto& observer : observers_)
+    observer.OnMainThreadJank(duration, threshold_index, signature);
+}
+
+void MainThreadJankMonitor::CheckMainThread() {
+  if (!running_)
+    return;
+
+  base::TimeDelta delay = thresholds_.front();
+  const int64_t task_start_us = task_start_us_;
+  const uint64_t task_id = task_id_;
+  if (task_start_us) {
+    const base::TimeDelta elapsed =
+        base::TimeDelta::FromMicroseconds(NowInMicroseconds() - task_start_us);
+    if (elapsed < thresholds_.front()) {
+      // Check again when the task would become a jank.
+      delay = thresholds_.front() - elapsed;
+    } else {
+      bool should_sample = false;
+      {
+        base::AutoLock auto_lock(lock_);
+        if (sampled_task_id_ != task_id) {
+          sampled_task_id_ = task_id;
+          samples_.clear();
+        }
+        should_sample = samples_.size() < kMaxSamplesPerJank;
+      }
+      if (should_sample) {
+        std::vector<uintptr_t> stack = stack_sampler_->CaptureStack();
+        base::AutoLock auto_lock(lock_);
+        // Drop the stack if the task ended while it was captured.
+        if (sampled_task_id_ == task_id && task_id_ == task_id)
+          samples_.push_back(std::move(stack));
+      }
+      delay = sampling_interval_;
+    }
+  }
+  ScheduleCheck(delay);
+}
+
+void MainThreadJankMonitor::ScheduleCheck(base::TimeDelta delay) {
+  const uint64_t generation = check_generation_;
+  MainThreadJankMonitor* monitor = this;
+  dispatch_after(
+      dispatch_time(DISPATCH_TIME_NOW, delay.InNanoseconds()), watchdog_queue_,
+      ^{
+        if (generation == monitor->check_generation_)
+          monitor->CheckMainThread();
+      });
+}
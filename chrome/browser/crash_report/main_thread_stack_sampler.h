@@ -0,0 +1,48 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_CRASH_REPORT_MAIN_THREAD_STACK_SAMPLER_H_
+#define IOS_CHROME_BROWSER_CRASH_REPORT_MAIN_THREAD_STACK_SAMPLER_H_
+
+#include <mach/mach.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+// Captures the stack of the main thread from another thread, by briefly
+// suspending the main thread and walking its frame pointers. Only the program
+// counters are captured; symbolization happens after the main thread resumed,
+// as it may take locks held by the main thread.
+class MainThreadStackSampler {
+ public:
+  // Maximum number of frames captured.
+  static const size_t kMaxFrames = 32;
+
+  // Must be created on the main thread.
+  MainThreadStackSampler();
+
+  MainThreadStackSampler(const MainThreadStackSampler&) = delete;
+  MainThreadStackSampler& operator=(const MainThreadStackSampler&) = delete;
+
+  ~MainThreadStackSampler();
+
+  // Returns the program counters of the main thread, innermost frame first.
+  // Returns an empty vector if the stack could not be captured, or if the
+  // architecture is not supported. Must not be called on the main thread.
+  std::vector<uintptr_t> CaptureStack() const;
+
+ private:
+  // Walks the stack of the suspended main thread into |frames|, which can hold
+  // |kMaxFrames| values. Returns the number of frames captured. Must not
+  // allocate, as the main thread may hold the allocator lock.
+  size_t WalkSuspendedStack(uintptr_t* frames) const;
+
+  const mach_port_t main_thread_port_;
+  // Bounds of the main thread stack, which grows down from |stack_top_|.
+  uintptr_t stack_top_ = 0;
+  uintptr_t stack_bottom_ = 0;
+};
+
+#endif  // IOS_CHROME_BROWSER_CRASH_REPORT_MAIN_THREAD_STACK_SAMPLER_H_
@@ -0,0 +1,102 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/crash_report/main_thread_stack_sampler.h"
+
+#import <Foundation/Foundation.h>
+#include <pthread.h>
+
+#if __has_feature(ptrauth_calls)
+#include <ptrauth.h>
+#endif
+
+#include "base/check.h"
+#include "build/build_config.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+// Removes the pointer authentication code from |address|, if any.
+uintptr_t StripPointerAuthentication(uintptr_t address) {
+#if __has_feature(ptrauth_calls)
+  return reinterpret_cast<uintptr_t>(ptrauth_strip(
+      reinterpret_cast<void*>(address), ptrauth_key_return_address));
+#else
+  return address;
+#endif
+}
+
+}  // namespace
+
+MainThreadStackSampler::MainThreadStackSampler()
+    : main_thread_port_(pthread_mach_thread_np(pthread_self())) {
+  DCHECK([NSThread isMainThread]);
+  pthread_t main_thread = pthread_self();
+  stack_top_ =
+      reinterpret_cast<uintptr_t>(pthread_get_stackaddr_np(main_thread));
+  stack_bottom_ = stack_top_ - pthread_get_stacksize_np(main_thread);
+}
+
+MainThreadStackSampler::~MainThreadStackSampler() = default;
+
+std::vector<uintptr_t> MainThreadStackSampler::CaptureStack() const {
+  DCHECK(![NSThread isMainThread]);
+  uintptr_t frames[kMaxFrames];
+  if (thread_suspend(main_thread_port_) != KERN_SUCCESS)
+    return std::vector<uintptr_t>();
+  const size_t frame_count = WalkSuspendedStack(frames);
+  thread_resume(main_thread_port_);
+  return std::vector<uintptr_t>(frames, frames + frame_count);
+}
+
+size_t MainThreadStackSampler::WalkSuspendedStack(uintptr_t* frames) const {
+  uintptr_t pc = 0;
+  uintptr_t fp = 0;
+#if defined(ARCH_CPU_ARM64)
+  arm_thread_state64_t state;
+  mach_msg_type_number_t state_count = ARM_THREAD_STATE64_COUNT;
+  if (thread_get_state(main_thread_port_, ARM_THREAD_STATE64,
+                       reinterpret_cast<thread_state_t>(&state),
+                       &state_count) != KERN_SUCCESS) {
+    return 0;
+  }
+  pc = arm_thread_state64_get_pc(state);
+  fp = arm_thread_state64_get_fp(state);
+#elif defined(ARCH_CPU_X86_64)
+  x86_thread_state64_t state;
+  mach_msg_type_number_t state_count = x86_THREAD_STATE64_COUNT;
+  if (thread_get_state(main_thread_port_, x86_THREAD_STATE64,
+                       reinterpret_cast<thread_state_t>(&state),
+                       &state_count) != KERN_SUCCESS) {
+    return 0;
+  }
+  pc = state.__rip;
+  fp = state.__rbp;
+#else
+  return 0;
+#endif
+
+  size_t frame_count = 0;
+  frames[frame_count++] = StripPointerAuthentication(pc);
+
+  // Each frame record holds the previous frame pointer, followed by the return
+  // address. The records are only read within the bounds of the stack.
+  while (frame_count < kMaxFrames && fp % sizeof(uintptr_t) == 0 &&
+         fp >= stack_bottom_ && fp + 2 * sizeof(uintptr_t) <= stack_top_) {
+    const uintptr_t* record = reinterpret_cast<const uintptr_t*>(fp);
+    const uintptr_t next_fp = record[0];
+    const uintptr_t return_address = StripPointerAuthentication(record[1]);
+    if (!return_address)
+      break;
+    frames[frame_count++] = return_address;
+    // The stack grows down, so the caller's frame is at a higher address.
+    if (next_fp <= fp)
+      break;
+    fp = next_fp;
+  }
+  return frame_count;
+}
@@ -7,7 +7,7 @@
 
 #include "base/macros.h"
 #include "base/no_destructor.h"
-#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 class BrowserDownloadService;
 
@@ -17,7 +17,8 @@ class BrowserState;
 
 // Singleton that creates BrowserDownloadService and associates that service
 // with web::BrowserState.
-class BrowserDownloadServiceFactory : public BrowserStateKeyedServiceFactory {
+class BrowserDownloadServiceFactory
+    : public AuditedBrowserStateKeyedServiceFactory {
  public:
   static BrowserDownloadService* GetForBrowserState(
       web::BrowserState* browser_state);
@@ -29,8 +30,8 @@ class BrowserDownloadServiceFactory : public BrowserStateKeyedServiceFactory {
   BrowserDownloadServiceFactory();
   ~BrowserDownloadServiceFactory() override;
 
-  // BrowserStateKeyedServiceFactory overrides:
-  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+  // AuditedBrowserStateKeyedServiceFactory overrides:
+  std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* context) const override;
   bool ServiceIsCreatedWithBrowserState() const override;
   web::BrowserState* GetBrowserStateToUse(web::BrowserState*) const override;
@@ -28,14 +28,14 @@ BrowserDownloadServiceFactory* BrowserDownloadServiceFactory::GetInstance() {
 }
 
 BrowserDownloadServiceFactory::BrowserDownloadServiceFactory()
-    : BrowserStateKeyedServiceFactory(
+    : AuditedBrowserStateKeyedServiceFactory(
           "BrowserDownloadService",
           BrowserStateDependencyManager::GetInstance()) {}
 
 BrowserDownloadServiceFactory::~BrowserDownloadServiceFactory() = default;
 
 std::unique_ptr<KeyedService>
-BrowserDownloadServiceFactory::BuildServiceInstanceFor(
+BrowserDownloadServiceFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* browser_state) const {
   web::DownloadController* download_controller =
       web::DownloadController::FromBrowserState(browser_state);
@@ -43,6 +43,8 @@ BrowserDownloadServiceFactory::BuildServiceInstanceFor(
 }
 
 bool BrowserDownloadServiceFactory::ServiceIsCreatedWithBrowserState() const {
+  // The service must be the DownloadControllerDelegate of every browser state,
+  // including the off-the-record one, before the first download starts.
   return true;
 }
 
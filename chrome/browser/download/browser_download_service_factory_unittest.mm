@@ -4,6 +4,8 @@
 
 #include "ios/chrome/browser/download/browser_download_service_factory.h"
 
+#include "base/test/scoped_feature_list.h"
+#include "ios/chrome/browser/browser_state/keyed_service_startup_audit.h"
 #include "ios/chrome/browser/browser_state/test_chrome_browser_state.h"
 #include "ios/chrome/browser/download/browser_download_service.h"
 #import "ios/web/public/download/download_controller.h"
@@ -36,3 +38,26 @@ TEST_F(BrowserDownloadServiceFactoryTest, Delegate) {
       BrowserDownloadServiceFactory::GetForBrowserState(browser_state_.get());
   EXPECT_EQ(service, download_controller->GetDelegate());
 }
+
+// Tests that the off-the-record browser state gets its own
+// BrowserDownloadService as DownloadControllerDelegate when it is created, even
+// if the creation of deferrable keyed services is deferred, so that incognito
+// downloads are not dropped.
+TEST_F(BrowserDownloadServiceFactoryTest, OffTheRecordDelegateWithDeferral) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeature(kDeferKeyedServiceCreation);
+
+  ChromeBrowserState* otr_browser_state =
+      browser_state_->GetOffTheRecordChromeBrowserState();
+  web::DownloadController* download_controller =
+      web::DownloadController::FromBrowserState(otr_browser_state);
+  ASSERT_TRUE(download_controller);
+  ASSERT_TRUE(download_controller->GetDelegate());
+
+  BrowserDownloadService* service =
+      BrowserDownloadServiceFactory::GetForBrowserState(otr_browser_state);
+  EXPECT_EQ(service, download_controller->GetDelegate());
+  EXPECT_NE(service,
+            BrowserDownloadServiceFactory::GetForBrowserState(
+                browser_state_.get()));
+}
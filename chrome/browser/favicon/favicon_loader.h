@@ -20,11 +20,25 @@ class LargeIconService;
 
 // A class that manages asynchronously loading favicons or fallback attributes
 // from LargeIconService and caching them, given a URL.
+//
+// Identical lookups issued while a request is in flight are coalesced into a
+// single LargeIconService request. Results for page URLs are cached per page,
+// and a cached favicon is resized to serve requests for smaller sizes.
 class FaviconLoader : public KeyedService {
  public:
   // Type for completion block for FaviconForURL().
   typedef void (^FaviconAttributesCompletionBlock)(FaviconAttributes*);
 
+  // Counters describing the efficiency of the in-memory cache.
+  struct Stats {
+    // Number of lookups answered from |favicon_cache_|.
+    int cache_hits = 0;
+    // Number of lookups that were not in |favicon_cache_|.
+    int cache_misses = 0;
+    // Number of cache misses that joined an identical in-flight request.
+    int coalesced_requests = 0;
+  };
+
   explicit FaviconLoader(favicon::LargeIconService* large_icon_service);
   ~FaviconLoader() override;
 
@@ -74,7 +88,36 @@ class FaviconLoader : public KeyedService {
   // Cancel all incomplete requests.
   void CancellAllRequests();
 
+  const Stats& stats() const { return stats_; }
+
  private:
+  // Returns the attributes cached under |cache_key| that can be displayed at
+  // |size_in_points|, resizing the cached favicon if needed. Returns nil if
+  // there are none or if the cached favicon is smaller than
+  // |min_size_in_points|. In the latter case, the cached attributes are
+  // returned in |placeholder| if it is not null, to be displayed until the
+  // favicon is fetched at the requested size.
+  FaviconAttributes* GetCachedAttributes(NSString* cache_key,
+                                         float size_in_points,
+                                         float min_size_in_points,
+                                         FaviconAttributes** placeholder);
+
+  // Stores |attributes| under |cache_key|, replacing any cached attributes.
+  void CacheAttributes(NSString* cache_key, FaviconAttributes* attributes);
+
+  // Registers |block| as waiting for the result of |request_key|. Returns true
+  // if no identical request is in flight and a new one should be started.
+  bool AddPendingRequest(NSString* request_key,
+                         FaviconAttributesCompletionBlock block);
+
+  // Removes and returns the blocks waiting for the result of |request_key|.
+  NSArray<FaviconAttributesCompletionBlock>* TakePendingRequests(
+      NSString* request_key);
+
+  // Invokes and removes the blocks waiting for the result of |request_key|.
+  void CompletePendingRequests(NSString* request_key,
+                               FaviconAttributes* attributes);
+
   // The LargeIconService used to retrieve favicon.
   favicon::LargeIconService* large_icon_service_;
 
@@ -83,8 +126,15 @@ class FaviconLoader : public KeyedService {
   // Holds cached favicons. This NSCache is populated as favicons or fallback
   // attributes are retrieved from |large_icon_service_|. Contents will be
   // removed during low-memory conditions based on its inherent LRU removal
-  // algorithm. Keyed by NSString of URL (page URL or icon URL) spec.
+  // algorithm, and its cost is the estimated size in bytes of the decoded
+  // favicon. Keyed by the host of page URLs, or by the spec of icon URLs.
   NSCache<NSString*, FaviconAttributes*>* favicon_cache_;
+  // Blocks waiting for the result of in-flight requests, keyed by request.
+  NSMutableDictionary<NSString*,
+                      NSMutableArray<FaviconAttributesCompletionBlock>*>*
+      pending_requests_;
+
+  Stats stats_;
 
   DISALLOW_COPY_AND_ASSIGN(FaviconLoader);
 };
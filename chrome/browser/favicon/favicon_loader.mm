@@ -8,12 +8,14 @@
 
 #include "base/bind.h"
 #import "base/mac/foundation_util.h"
+#include "base/metrics/histogram_functions.h"
 #include "base/strings/sys_string_conversions.h"
 #include "components/favicon/core/fallback_url_util.h"
 #include "components/favicon/core/large_icon_service.h"
 #include "components/favicon_base/fallback_icon_style.h"
 #include "components/favicon_base/favicon_callback.h"
 #include "components/favicon_base/favicon_types.h"
+#import "ios/chrome/browser/ui/util/ui_util.h"
 #import "ios/chrome/browser/ui/util/uikit_ui_util.h"
 #import "ios/chrome/common/ui/favicon/favicon_attributes.h"
 #include "net/traffic_annotation/network_traffic_annotation.h"
@@ -27,6 +29,40 @@
 namespace {
 const CGFloat kFallbackIconDefaultTextColor = 0xAAAAAA;
 
+// Maximum estimated size in bytes of the decoded favicons kept in the cache.
+const NSUInteger kFaviconCacheByteBudget = 4 * 1024 * 1024;
+
+// Estimated cost in bytes of attributes that have no image.
+const NSUInteger kMonogramCost = 256;
+
+// Returns the estimated size in bytes of the decoded |attributes|.
+NSUInteger EstimatedCost(FaviconAttributes* attributes) {
+  UIImage* image = attributes.faviconImage;
+  if (!image)
+    return kMonogramCost;
+  const CGFloat scale = image.scale;
+  return static_cast<NSUInteger>(image.size.width * scale *
+                                 image.size.height * scale * 4);
+}
+
+// Returns the key used to cache the favicon of |page_url|. Pages of the same
+// host can have different favicons, so each page has its own entry.
+NSString* PageCacheKey(NSString* prefix, const GURL& page_url) {
+  return [NSString stringWithFormat:@"%@ %@", prefix,
+                                    base::SysUTF8ToNSString(page_url.spec())];
+}
+
+// Returns the key identifying a request to the LargeIconService.
+NSString* RequestKey(NSString* prefix,
+                     const GURL& url,
+                     float size_in_points,
+                     float min_size_in_points) {
+  return [NSString stringWithFormat:@"%@ %d %d %@", prefix,
+                                    (int)round(size_in_points),
+                                    (int)round(min_size_in_points),
+                                    base::SysUTF8ToNSString(url.spec())];
+}
+
 // NetworkTrafficAnnotationTag for fetching favicon from a Google server.
 const net::NetworkTrafficAnnotationTag kTrafficAnnotation =
     net::DefineNetworkTrafficAnnotation("favicon_loader_get_large_icon", R"(
@@ -49,7 +85,11 @@ const net::NetworkTrafficAnnotationTag kTrafficAnnotation =
 
 FaviconLoader::FaviconLoader(favicon::LargeIconService* large_icon_service)
     : large_icon_service_(large_icon_service),
-      favicon_cache_([[NSCache alloc] init]) {}
+      favicon_cache_([[NSCache alloc] init]),
+      pending_requests_([[NSMutableDictionary alloc] init]) {
+  favicon_cache_.totalCostLimit = kFaviconCacheByteBudget;
+}
+
 FaviconLoader::~FaviconLoader() {}
 
 // TODO(pinkerton): How do we update the favicon if it's changed on the web?
@@ -64,15 +104,27 @@ void FaviconLoader::FaviconForPageUrl(
                                      // return valid favicon.
     FaviconAttributesCompletionBlock faviconBlockHandler) {
   DCHECK(faviconBlockHandler);
-  NSString* key =
-      [NSString stringWithFormat:@"%d %@", (int)round(size_in_points),
-                                 base::SysUTF8ToNSString(page_url.spec())];
-  FaviconAttributes* value = [favicon_cache_ objectForKey:key];
+  NSString* key = PageCacheKey(@"page", page_url);
+  FaviconAttributes* placeholder = nil;
+  FaviconAttributes* value = GetCachedAttributes(
+      key, size_in_points, min_size_in_points, &placeholder);
   if (value) {
     faviconBlockHandler(value);
     return;
   }
 
+  // First, synchronously return the cached favicon which is too small, or a
+  // fallback image.
+  if (!placeholder)
+    placeholder = [FaviconAttributes attributesWithDefaultImage];
+  faviconBlockHandler(placeholder);
+
+  NSString* request_key =
+      RequestKey(fallback_to_google_server ? @"page server" : @"page",
+                 page_url, size_in_points, min_size_in_points);
+  if (!AddPendingRequest(request_key, faviconBlockHandler))
+    return;
+
   const CGFloat scale = UIScreen.mainScreen.scale;
   GURL block_page_url(page_url);
   auto favicon_block = ^(const favicon_base::LargeIconResult& result) {
@@ -87,11 +139,11 @@ void FaviconLoader::FaviconForPageUrl(
                   scale:scale];
       FaviconAttributes* attributes =
           [FaviconAttributes attributesWithImage:favicon];
-      [favicon_cache_ setObject:attributes forKey:key];
+      CacheAttributes(key, attributes);
 
       DCHECK(favicon.size.width <= size_in_points &&
              favicon.size.height <= size_in_points);
-      faviconBlockHandler(attributes);
+      CompletePendingRequests(request_key, attributes);
       return;
     } else if (fallback_to_google_server) {
       void (^favicon_loaded_from_server_block)(
@@ -101,12 +153,22 @@ void FaviconLoader::FaviconForPageUrl(
             // the automatic eviction of the favicon from the favicon database.
             large_icon_service_->TouchIconFromGoogleServer(block_page_url);
 
+            // The requests were cancelled while waiting for the server.
+            NSArray<FaviconAttributesCompletionBlock>* handlers =
+                TakePendingRequests(request_key);
+            if (!handlers.count)
+              return;
+
             // Favicon should be loaded to the db that backs LargeIconService
             // now.  Fetch it again. Even if the request was not successful, the
             // fallback style will be used.
             FaviconForPageUrl(
                 block_page_url, size_in_points, min_size_in_points,
-                /*continueToGoogleServer=*/false, faviconBlockHandler);
+                /*continueToGoogleServer=*/false,
+                ^(FaviconAttributes* attributes) {
+                  for (FaviconAttributesCompletionBlock handler in handlers)
+                    handler(attributes);
+                });
           };
 
       large_icon_service_
@@ -129,13 +191,10 @@ void FaviconLoader::FaviconForPageUrl(
         defaultBackgroundColor:result.fallback_icon_style->
                                is_default_background_color];
 
-    [favicon_cache_ setObject:attributes forKey:key];
-    faviconBlockHandler(attributes);
+    CacheAttributes(key, attributes);
+    CompletePendingRequests(request_key, attributes);
   };
 
-  // First, synchronously return a fallback image.
-  faviconBlockHandler([FaviconAttributes attributesWithDefaultImage]);
-
   // Now fetch the image synchronously.
   DCHECK(large_icon_service_);
   large_icon_service_->GetLargeIconRawBitmapOrFallbackStyleForPageUrl(
@@ -148,15 +207,23 @@ void FaviconLoader::FaviconForPageUrlOrHost(
     float size_in_points,
     FaviconAttributesCompletionBlock favicon_block_handler) {
   DCHECK(favicon_block_handler);
-  NSString* key = [NSString
-      stringWithFormat:@"%d %@ with fallback", (int)round(size_in_points),
-                       base::SysUTF8ToNSString(page_url.spec())];
-  FaviconAttributes* value = [favicon_cache_ objectForKey:key];
+  NSString* key = PageCacheKey(@"page or host", page_url);
+  FaviconAttributes* value =
+      GetCachedAttributes(key, size_in_points, /*min_size_in_points=*/0,
+                          /*placeholder=*/nullptr);
   if (value) {
     favicon_block_handler(value);
     return;
   }
 
+  // First, synchronously return a fallback image.
+  favicon_block_handler([FaviconAttributes attributesWithDefaultImage]);
+
+  NSString* request_key = RequestKey(@"page or host", page_url, size_in_points,
+                                     /*min_size_in_points=*/0);
+  if (!AddPendingRequest(request_key, favicon_block_handler))
+    return;
+
   const CGFloat scale = UIScreen.mainScreen.scale;
   GURL block_page_url(page_url);
   auto favicon_block = ^(const favicon_base::LargeIconResult& result) {
@@ -171,11 +238,11 @@ void FaviconLoader::FaviconForPageUrlOrHost(
                   scale:scale];
       FaviconAttributes* attributes =
           [FaviconAttributes attributesWithImage:favicon];
-      [favicon_cache_ setObject:attributes forKey:key];
+      CacheAttributes(key, attributes);
 
       DCHECK(favicon.size.width <= size_in_points &&
              favicon.size.height <= size_in_points);
-      favicon_block_handler(attributes);
+      CompletePendingRequests(request_key, attributes);
       return;
     }
 
@@ -190,13 +257,10 @@ void FaviconLoader::FaviconForPageUrlOrHost(
         defaultBackgroundColor:result.fallback_icon_style->
                                is_default_background_color];
 
-    [favicon_cache_ setObject:attributes forKey:key];
-    favicon_block_handler(attributes);
+    CacheAttributes(key, attributes);
+    CompletePendingRequests(request_key, attributes);
   };
 
-  // First, synchronously return a fallback image.
-  favicon_block_handler([FaviconAttributes attributesWithDefaultImage]);
-
   // Now fetch the image synchronously.
   DCHECK(large_icon_service_);
   large_icon_service_->GetIconRawBitmapOrFallbackStyleForPageUrl(
@@ -210,15 +274,29 @@ void FaviconLoader::FaviconForIconUrl(
     float min_size_in_points,
     FaviconAttributesCompletionBlock faviconBlockHandler) {
   DCHECK(faviconBlockHandler);
-  NSString* key =
-      [NSString stringWithFormat:@"%d %@", (int)round(size_in_points),
-                                 base::SysUTF8ToNSString(icon_url.spec())];
-  FaviconAttributes* value = [favicon_cache_ objectForKey:key];
+  NSString* key = [NSString
+      stringWithFormat:@"icon %@", base::SysUTF8ToNSString(icon_url.spec())];
+  FaviconAttributes* placeholder = nil;
+  FaviconAttributes* value = GetCachedAttributes(
+      key, size_in_points, min_size_in_points, &placeholder);
   if (value) {
     faviconBlockHandler(value);
     return;
   }
 
+  // First, return the cached favicon which is too small, or a fallback
+  // synchronously.
+  if (!placeholder) {
+    placeholder = [FaviconAttributes
+        attributesWithImage:[UIImage imageNamed:@"default_world_favicon"]];
+  }
+  faviconBlockHandler(placeholder);
+
+  NSString* request_key =
+      RequestKey(@"icon", icon_url, size_in_points, min_size_in_points);
+  if (!AddPendingRequest(request_key, faviconBlockHandler))
+    return;
+
   const CGFloat scale = UIScreen.mainScreen.scale;
   const CGFloat favicon_size_in_pixels = scale * size_in_points;
   const CGFloat min_favicon_size_in_pixels = scale * min_size_in_points;
@@ -235,8 +313,8 @@ void FaviconLoader::FaviconForIconUrl(
                   scale:scale];
       FaviconAttributes* attributes =
           [FaviconAttributes attributesWithImage:favicon];
-      [favicon_cache_ setObject:attributes forKey:key];
-      faviconBlockHandler(attributes);
+      CacheAttributes(key, attributes);
+      CompletePendingRequests(request_key, attributes);
       return;
     }
     // Did not get valid favicon back and are not attempting to retrieve one
@@ -250,14 +328,10 @@ void FaviconLoader::FaviconForIconUrl(
         defaultBackgroundColor:result.fallback_icon_style->
                                is_default_background_color];
 
-    [favicon_cache_ setObject:attributes forKey:key];
-    faviconBlockHandler(attributes);
+    CacheAttributes(key, attributes);
+    CompletePendingRequests(request_key, attributes);
   };
 
-  // First, return a fallback synchronously.
-  faviconBlockHandler([FaviconAttributes
-      attributesWithImage:[UIImage imageNamed:@"default_world_favicon"]]);
-
   // Now call the service for a better async icon.
   DCHECK(large_icon_service_);
   large_icon_service_->GetLargeIconRawBitmapOrFallbackStyleForIconUrl(
@@ -267,4 +341,82 @@ void FaviconLoader::FaviconForIconUrl(
 
 void FaviconLoader::CancellAllRequests() {
   cancelable_task_tracker_.TryCancelAll();
+  [pending_requests_ removeAllObjects];
+}
+
+FaviconAttributes* FaviconLoader::GetCachedAttributes(
+    NSString* cache_key,
+    float size_in_points,
+    float min_size_in_points,
+    FaviconAttributes** placeholder) {
+  FaviconAttributes* attributes = [favicon_cache_ objectForKey:cache_key];
+  UIImage* image = attributes.faviconImage;
+  if (image && MAX(image.size.width, image.size.height) < min_size_in_points) {
+    // The cached favicon is too small, but is closer to the page's favicon
+    // than a fallback image while the requested size is fetched.
+    if (placeholder)
+      *placeholder = attributes;
+    attributes = nil;
+  }
+
+  const bool cache_hit = attributes != nil;
+  base::UmaHistogramBoolean("IOS.FaviconLoader.CacheHit", cache_hit);
+  if (!cache_hit) {
+    ++stats_.cache_misses;
+    return nil;
+  }
+
+  ++stats_.cache_hits;
+  if (image.size.width <= size_in_points &&
+      image.size.height <= size_in_points) {
+    return attributes;
+  }
+
+  // Serve the smaller variant from the cached favicon instead of decoding it
+  // again.
+  UIImage* resized_image =
+      ResizeImage(image, CGSizeMake(size_in_points, size_in_points),
+                  ProjectionMode::kAspectFit);
+  return [FaviconAttributes attributesWithImage:resized_image];
+}
+
+void FaviconLoader::CacheAttributes(NSString* cache_key,
+                                    FaviconAttributes* attributes) {
+  // Always keep the most recent result, so that a favicon which changed on the
+  // web replaces the cached one.
+  [favicon_cache_ setObject:attributes
+                     forKey:cache_key
+                       cost:EstimatedCost(attributes)];
+}
+
+bool FaviconLoader::AddPendingRequest(NSString* request_key,
+                                      FaviconAttributesCompletionBlock block) {
+  NSMutableArray<FaviconAttributesCompletionBlock>* blocks =
+      pending_requests_[request_key];
+  const bool coalesced = blocks != nil;
+  base::UmaHistogramBoolean("IOS.FaviconLoader.RequestCoalesced", coalesced);
+  if (coalesced) {
+    ++stats_.coalesced_requests;
+    [blocks addObject:block];
+    return false;
+  }
+
+  pending_requests_[request_key] = [NSMutableArray arrayWithObject:block];
+  return true;
+}
+
+NSArray<FaviconLoader::FaviconAttributesCompletionBlock>*
+FaviconLoader::TakePendingRequests(NSString* request_key) {
+  NSArray<FaviconAttributesCompletionBlock>* blocks =
+      pending_requests_[request_key];
+  [pending_requests_ removeObjectForKey:request_key];
+  return blocks;
+}
+
+void FaviconLoader::CompletePendingRequests(NSString* request_key,
+                                            FaviconAttributes* attributes) {
+  for (FaviconAttributesCompletionBlock block in TakePendingRequests(
+           request_key)) {
+    block(attributes);
+  }
 }
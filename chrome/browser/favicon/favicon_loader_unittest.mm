@@ -4,6 +4,10 @@
 
 #import "ios/chrome/browser/favicon/favicon_loader.h"
 
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
 #include "components/favicon/core/large_icon_service_impl.h"
 #include "components/favicon_base/fallback_icon_style.h"
 #include "components/favicon_base/favicon_types.h"
@@ -47,7 +51,8 @@ class FakeLargeIconService : public favicon::LargeIconServiceImpl {
             /*google_server_client_param=*/"test_chrome") {}
 
   // Returns LargeIconResult with valid bitmap if |page_url| is
-  // |kTestFaviconURL|, or LargeIconResult with fallback style.
+  // |kTestFaviconURL|, or LargeIconResult with fallback style. The callback
+  // is delayed until RunPendingCallbacks() if |defer_callbacks_| is true.
   base::CancelableTaskTracker::TaskId
   GetLargeIconRawBitmapOrFallbackStyleForPageUrl(
       const GURL& page_url,
@@ -55,14 +60,64 @@ class FakeLargeIconService : public favicon::LargeIconServiceImpl {
       int desired_size_in_pixel,
       favicon_base::LargeIconCallback callback,
       base::CancelableTaskTracker* tracker) override {
-    if (page_url.spec() == kTestFaviconURL) {
+    ++request_count_;
+    if (defer_callbacks_) {
+      pending_callbacks_.push_back(base::BindOnce(
+          &FakeLargeIconService::RunCallback, base::Unretained(this), page_url,
+          desired_size_in_pixel, std::move(callback)));
+    } else {
+      RunCallback(page_url, desired_size_in_pixel, std::move(callback));
+    }
+    return 1;
+  }
+
+  // Answers all the requests received while |defer_callbacks_| was true.
+  void RunPendingCallbacks() {
+    std::vector<base::OnceClosure> callbacks;
+    std::swap(callbacks, pending_callbacks_);
+    for (auto& callback : callbacks)
+      std::move(callback).Run();
+  }
+
+  void set_defer_callbacks(bool defer_callbacks) {
+    defer_callbacks_ = defer_callbacks;
+  }
+
+  // Makes all the following requests return a fallback style, e.g. after the
+  // favicon of |kTestFaviconURL| was removed.
+  void set_favicons_available(bool favicons_available) {
+    favicons_available_ = favicons_available;
+  }
+
+  int request_count() const { return request_count_; }
+
+  // Returns the same as |GetLargeIconRawBitmapOrFallbackStyleForPageUrl|.
+  base::CancelableTaskTracker::TaskId
+  GetLargeIconRawBitmapOrFallbackStyleForIconUrl(
+      const GURL& icon_url,
+      int min_source_size_in_pixel,
+      int desired_size_in_pixel,
+      favicon_base::LargeIconCallback callback,
+      base::CancelableTaskTracker* tracker) override {
+    return GetLargeIconRawBitmapOrFallbackStyleForPageUrl(
+        icon_url, min_source_size_in_pixel, desired_size_in_pixel,
+        std::move(callback), tracker);
+  }
+
+ private:
+  // Runs |callback| with the result for |page_url|. Favicons are returned at
+  // |size_in_pixel|.
+  void RunCallback(const GURL& page_url,
+                   int size_in_pixel,
+                   favicon_base::LargeIconCallback callback) {
+    if (favicons_available_ && page_url.spec() == kTestFaviconURL) {
       favicon_base::FaviconRawBitmapResult bitmapResult;
       bitmapResult.expired = false;
 
       // Create bitmap.
       scoped_refptr<base::RefCountedBytes> data(new base::RefCountedBytes());
       SkBitmap bitmap;
-      bitmap.allocN32Pixels(30, 30);
+      bitmap.allocN32Pixels(size_in_pixel, size_in_pixel);
       gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &data->data());
       bitmapResult.bitmap_data = data;
 
@@ -75,22 +130,12 @@ class FakeLargeIconService : public favicon::LargeIconServiceImpl {
       fallback = NULL;
       std::move(callback).Run(result);
     }
-
-    return 1;
   }
 
-  // Returns the same as |GetLargeIconRawBitmapOrFallbackStyleForPageUrl|.
-  base::CancelableTaskTracker::TaskId
-  GetLargeIconRawBitmapOrFallbackStyleForIconUrl(
-      const GURL& icon_url,
-      int min_source_size_in_pixel,
-      int desired_size_in_pixel,
-      favicon_base::LargeIconCallback callback,
-      base::CancelableTaskTracker* tracker) override {
-    return GetLargeIconRawBitmapOrFallbackStyleForPageUrl(
-        icon_url, min_source_size_in_pixel, desired_size_in_pixel,
-        std::move(callback), tracker);
-  }
+  bool defer_callbacks_ = false;
+  bool favicons_available_ = true;
+  int request_count_ = 0;
+  std::vector<base::OnceClosure> pending_callbacks_;
 };
 
 class FaviconLoaderTest : public PlatformTest,
@@ -174,9 +219,166 @@ TEST_P(FaviconLoaderTest, Cache) {
   EXPECT_TRUE(faviconImage);
 }
 
+// Tests that identical lookups issued while a request is in flight are
+// answered by a single LargeIconService request.
+TEST_P(FaviconLoaderTest, CoalescesInFlightRequests) {
+  large_icon_service_.set_defer_callbacks(true);
+  __block int first_final_count = 0;
+  __block int second_final_count = 0;
+  FaviconForUrl(GURL(kTestFaviconURL), ^(FaviconAttributes* attributes) {
+    if (!attributes.usesDefaultImage && attributes.faviconImage)
+      ++first_final_count;
+  });
+  FaviconForUrl(GURL(kTestFaviconURL), ^(FaviconAttributes* attributes) {
+    if (!attributes.usesDefaultImage && attributes.faviconImage)
+      ++second_final_count;
+  });
+  EXPECT_EQ(1, large_icon_service_.request_count());
+  EXPECT_EQ(1, favicon_loader_.stats().coalesced_requests);
+
+  large_icon_service_.RunPendingCallbacks();
+  EXPECT_EQ(1, first_final_count);
+  EXPECT_EQ(1, second_final_count);
+}
+
+// Tests that cancelled requests are not coalesced with later ones.
+TEST_P(FaviconLoaderTest, CancelDropsPendingRequests) {
+  large_icon_service_.set_defer_callbacks(true);
+  FaviconForUrl(GURL(kTestFaviconURL), ^(FaviconAttributes* attributes){
+                });
+  favicon_loader_.CancellAllRequests();
+  FaviconForUrl(GURL(kTestFaviconURL), ^(FaviconAttributes* attributes){
+                });
+  EXPECT_EQ(2, large_icon_service_.request_count());
+  EXPECT_EQ(0, favicon_loader_.stats().coalesced_requests);
+}
+
+// Tests that a smaller size variant is served from the cached favicon
+// without a new LargeIconService request.
+TEST_P(FaviconLoaderTest, ServesSmallerSizeFromCache) {
+  FaviconForUrl(GURL(kTestFaviconURL), ^(FaviconAttributes* attributes){
+                });
+  ASSERT_EQ(1, large_icon_service_.request_count());
+
+  const CGFloat small_size = 4;
+  __block UIImage* small_image = nil;
+  auto completion = ^(FaviconAttributes* attributes) {
+    small_image = attributes.faviconImage;
+  };
+  if (GetParam() == TEST_PAGE_URL) {
+    favicon_loader_.FaviconForPageUrl(GURL(kTestFaviconURL), small_size,
+                                      small_size,
+                                      /*fallback_to_google_server=*/false,
+                                      completion);
+  } else {
+    favicon_loader_.FaviconForIconUrl(GURL(kTestFaviconURL), small_size,
+                                      small_size, completion);
+  }
+  EXPECT_EQ(1, large_icon_service_.request_count());
+  EXPECT_EQ(1, favicon_loader_.stats().cache_hits);
+  ASSERT_TRUE(small_image);
+  EXPECT_LE(small_image.size.width, small_size);
+  EXPECT_LE(small_image.size.height, small_size);
+}
+
+// Tests that a cached favicon smaller than the requested minimum size is
+// returned as a placeholder while the favicon is fetched at the requested
+// size.
+TEST_P(FaviconLoaderTest, ServesSmallerCachedFaviconAsPlaceholder) {
+  const CGFloat small_size = 4;
+  auto small_completion = ^(FaviconAttributes* attributes) {
+  };
+  if (GetParam() == TEST_PAGE_URL) {
+    favicon_loader_.FaviconForPageUrl(GURL(kTestFaviconURL), small_size,
+                                      small_size,
+                                      /*fallback_to_google_server=*/false,
+                                      small_completion);
+  } else {
+    favicon_loader_.FaviconForIconUrl(GURL(kTestFaviconURL), small_size,
+                                      small_size, small_completion);
+  }
+  ASSERT_EQ(1, large_icon_service_.request_count());
+
+  large_icon_service_.set_defer_callbacks(true);
+  NSMutableArray<UIImage*>* images = [NSMutableArray array];
+  FaviconForUrl(GURL(kTestFaviconURL), ^(FaviconAttributes* attributes) {
+    [images addObject:attributes.faviconImage];
+  });
+
+  // Verify that the small favicon is returned synchronously and that the
+  // favicon is fetched at the requested size.
+  EXPECT_EQ(2, large_icon_service_.request_count());
+  ASSERT_EQ(1U, images.count);
+  EXPECT_EQ(small_size, images[0].size.width);
+
+  large_icon_service_.RunPendingCallbacks();
+  ASSERT_EQ(2U, images.count);
+  EXPECT_EQ(kTestFaviconSize, images[1].size.width);
+}
+
+// Fixture for the tests that do not depend on the lookup method.
+class FaviconLoaderPageCacheTest : public PlatformTest {
+ protected:
+  FaviconLoaderPageCacheTest() : favicon_loader_(&large_icon_service_) {}
+
+  FakeLargeIconService large_icon_service_;
+  FaviconLoader favicon_loader_;
+};
+
 INSTANTIATE_TEST_SUITE_P(ProgrammaticFaviconLoaderTest,
                          FaviconLoaderTest,
                          ::testing::Values(FaviconUrlType::TEST_PAGE_URL,
                                            FaviconUrlType::TEST_ICON_URL));
 
+// Tests that the favicon of a page is not served to other pages of the same
+// host, as they can have a different favicon.
+TEST_F(FaviconLoaderPageCacheTest, CacheIsKeyedByPage) {
+  favicon_loader_.FaviconForPageUrl(GURL(kTestFaviconURL), kTestFaviconSize,
+                                    kTestFaviconSize,
+                                    /*fallback_to_google_server=*/false,
+                                    ^(FaviconAttributes* attributes){
+                                    });
+  ASSERT_EQ(1, large_icon_service_.request_count());
+
+  __block FaviconAttributes* last_attributes = nil;
+  favicon_loader_.FaviconForPageUrl(
+      GURL(kTestFallbackURL), kTestFaviconSize, kTestFaviconSize,
+      /*fallback_to_google_server=*/false, ^(FaviconAttributes* attributes) {
+        last_attributes = attributes;
+      });
+  EXPECT_EQ(2, large_icon_service_.request_count());
+  EXPECT_FALSE(last_attributes.faviconImage);
+  EXPECT_TRUE(last_attributes.monogramString);
+}
+
+// Tests that the most recent result replaces the cached favicon, even if it
+// is only a monogram.
+TEST_F(FaviconLoaderPageCacheTest, CachesMostRecentResult) {
+  favicon_loader_.FaviconForPageUrl(GURL(kTestFaviconURL), kTestFaviconSize,
+                                    kTestFaviconSize,
+                                    /*fallback_to_google_server=*/false,
+                                    ^(FaviconAttributes* attributes){
+                                    });
+  ASSERT_EQ(1, large_icon_service_.request_count());
+
+  // Requesting a larger favicon fetches it again, and the favicon is gone.
+  large_icon_service_.set_favicons_available(false);
+  favicon_loader_.FaviconForPageUrl(GURL(kTestFaviconURL), 2 * kTestFaviconSize,
+                                    2 * kTestFaviconSize,
+                                    /*fallback_to_google_server=*/false,
+                                    ^(FaviconAttributes* attributes){
+                                    });
+  ASSERT_EQ(2, large_icon_service_.request_count());
+
+  __block FaviconAttributes* cached_attributes = nil;
+  favicon_loader_.FaviconForPageUrl(
+      GURL(kTestFaviconURL), kTestFaviconSize, /*min_size_in_points=*/0,
+      /*fallback_to_google_server=*/false, ^(FaviconAttributes* attributes) {
+        cached_attributes = attributes;
+      });
+  EXPECT_EQ(2, large_icon_service_.request_count());
+  EXPECT_FALSE(cached_attributes.faviconImage);
+  EXPECT_TRUE(cached_attributes.monogramString);
+}
+
 }  // namespace
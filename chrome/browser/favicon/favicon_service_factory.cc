@@ -58,7 +58,7 @@ FaviconServiceFactory::GetDefaultFactory() {
 }
 
 FaviconServiceFactory::FaviconServiceFactory()
-    : BrowserStateKeyedServiceFactory(
+    : AuditedBrowserStateKeyedServiceFactory(
           "FaviconService",
           BrowserStateDependencyManager::GetInstance()) {
   DependsOn(ios::HistoryServiceFactory::GetInstance());
@@ -67,7 +67,8 @@ FaviconServiceFactory::FaviconServiceFactory()
 FaviconServiceFactory::~FaviconServiceFactory() {
 }
 
-std::unique_ptr<KeyedService> FaviconServiceFactory::BuildServiceInstanceFor(
+std::unique_ptr<KeyedService>
+FaviconServiceFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* context) const {
   return BuildFaviconService(context);
 }
@@ -9,7 +9,7 @@
 
 #include "base/macros.h"
 #include "base/no_destructor.h"
-#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 class ChromeBrowserState;
 enum class ServiceAccessType;
@@ -21,7 +21,7 @@ class FaviconService;
 namespace ios {
 // Singleton that owns all FaviconServices and associates them with
 // ChromeBrowserState.
-class FaviconServiceFactory : public BrowserStateKeyedServiceFactory {
+class FaviconServiceFactory : public AuditedBrowserStateKeyedServiceFactory {
  public:
   static favicon::FaviconService* GetForBrowserState(
       ChromeBrowserState* browser_state,
@@ -37,8 +37,8 @@ class FaviconServiceFactory : public BrowserStateKeyedServiceFactory {
   FaviconServiceFactory();
   ~FaviconServiceFactory() override;
 
-  // BrowserStateKeyedServiceFactory implementation.
-  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+  // AuditedBrowserStateKeyedServiceFactory implementation.
+  std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* context) const override;
   bool ServiceIsNULLWhileTesting() const override;
 
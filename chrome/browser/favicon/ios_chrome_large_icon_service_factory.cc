@@ -60,7 +60,7 @@ IOSChromeLargeIconServiceFactory::GetDefaultFactory() {
 }
 
 IOSChromeLargeIconServiceFactory::IOSChromeLargeIconServiceFactory()
-    : BrowserStateKeyedServiceFactory(
+    : AuditedBrowserStateKeyedServiceFactory(
           "LargeIconService",
           BrowserStateDependencyManager::GetInstance()) {
   DependsOn(ios::FaviconServiceFactory::GetInstance());
@@ -69,7 +69,7 @@ IOSChromeLargeIconServiceFactory::IOSChromeLargeIconServiceFactory()
 IOSChromeLargeIconServiceFactory::~IOSChromeLargeIconServiceFactory() {}
 
 std::unique_ptr<KeyedService>
-IOSChromeLargeIconServiceFactory::BuildServiceInstanceFor(
+IOSChromeLargeIconServiceFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* context) const {
   return BuildLargeIconService(context);
 }
@@ -9,7 +9,7 @@
 
 #include "base/macros.h"
 #include "base/no_destructor.h"
-#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 class ChromeBrowserState;
 class KeyedService;
@@ -21,7 +21,7 @@ class LargeIconService;
 // Singleton that owns all LargeIconService and associates them with
 // ChromeBrowserState.
 class IOSChromeLargeIconServiceFactory
-    : public BrowserStateKeyedServiceFactory {
+    : public AuditedBrowserStateKeyedServiceFactory {
  public:
   static favicon::LargeIconService* GetForBrowserState(
       ChromeBrowserState* browser_state);
@@ -38,8 +38,8 @@ class IOSChromeLargeIconServiceFactory
   IOSChromeLargeIconServiceFactory();
   ~IOSChromeLargeIconServiceFactory() override;
 
-  // BrowserStateKeyedServiceFactory implementation.
-  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+  // AuditedBrowserStateKeyedServiceFactory implementation.
+  std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* context) const override;
   web::BrowserState* GetBrowserStateToUse(
       web::BrowserState* context) const override;
@@ -4,13 +4,14 @@
 
 #include "ios/chrome/browser/favicon/large_icon_cache.h"
 
+#include "base/metrics/histogram_functions.h"
 #include "components/favicon_base/fallback_icon_style.h"
 #include "components/favicon_base/favicon_types.h"
 #include "url/gurl.h"
 
 namespace {
 
-const int kMaxCacheSize = 12;
+const size_t kMaxCacheSizeInBytes = 512 * 1024;
 
 }  // namespace
 
@@ -19,9 +20,17 @@ struct LargeIconCacheEntry {
   ~LargeIconCacheEntry() {}
 
   std::unique_ptr<favicon_base::LargeIconResult> result;
+
+  // Estimated size in bytes of the entry.
+  size_t size_in_bytes = 0;
 };
 
-LargeIconCache::LargeIconCache() : cache_(kMaxCacheSize) {}
+LargeIconCache::LargeIconCache() : LargeIconCache(kMaxCacheSizeInBytes) {}
+
+LargeIconCache::LargeIconCache(size_t max_size_in_bytes)
+    : cache_(base::MRUCache<GURL, std::unique_ptr<LargeIconCacheEntry>>::
+                 NO_AUTO_EVICT),
+      max_size_in_bytes_(max_size_in_bytes) {}
 
 LargeIconCache::~LargeIconCache() {}
 
@@ -30,17 +39,33 @@ void LargeIconCache::SetCachedResult(
     const favicon_base::LargeIconResult& result) {
   std::unique_ptr<LargeIconCacheEntry> entry(new LargeIconCacheEntry);
   entry->result = CloneLargeIconResult(result);
+  entry->size_in_bytes = sizeof(LargeIconCacheEntry) + url.spec().size();
+  if (result.bitmap.is_valid())
+    entry->size_in_bytes += result.bitmap.bitmap_data->size();
+
+  auto iter = cache_.Peek(url);
+  if (iter != cache_.end()) {
+    size_in_bytes_ -= iter->second->size_in_bytes;
+    cache_.Erase(iter);
+  }
+
+  size_in_bytes_ += entry->size_in_bytes;
   cache_.Put(url, std::move(entry));
+  EvictToBudget();
 }
 
 std::unique_ptr<favicon_base::LargeIconResult> LargeIconCache::GetCachedResult(
     const GURL& url) {
   auto iter = cache_.Get(url);
-  if (iter != cache_.end()) {
+  const bool cache_hit = iter != cache_.end();
+  base::UmaHistogramBoolean("IOS.LargeIconCache.Hit", cache_hit);
+  if (cache_hit) {
+    ++hit_count_;
     DCHECK(iter->second->result);
     return CloneLargeIconResult(*iter->second->result.get());
   }
 
+  ++miss_count_;
   return nullptr;
 }
 
@@ -57,3 +82,13 @@ LargeIconCache::CloneLargeIconResult(
   }
   return clone;
 }
+
+void LargeIconCache::EvictToBudget() {
+  // The most recently inserted result is always kept, even if it alone
+  // exceeds the budget.
+  while (size_in_bytes_ > max_size_in_bytes_ && cache_.size() > 1) {
+    auto oldest = cache_.rbegin();
+    size_in_bytes_ -= oldest->second->size_in_bytes;
+    cache_.Erase(oldest);
+  }
+}
@@ -5,6 +5,8 @@
 #ifndef IOS_CHROME_BROWSER_FAVICON_LARGE_ICON_CACHE_H_
 #define IOS_CHROME_BROWSER_FAVICON_LARGE_ICON_CACHE_H_
 
+#include <stddef.h>
+
 #include <memory>
 
 #include "base/containers/mru_cache.h"
@@ -18,7 +20,8 @@ namespace favicon_base {
 struct LargeIconResult;
 }
 
-// Provides a cache of most recently used LargeIconResult.
+// Provides a cache of most recently used LargeIconResult. The cache is bounded
+// by the size in bytes of the cached results rather than by their number.
 //
 // Example usage:
 //   LargeIconCache* large_icon_cache =
@@ -29,6 +32,8 @@ struct LargeIconResult;
 class LargeIconCache : public KeyedService {
  public:
   LargeIconCache();
+  // Creates a cache holding at most |max_size_in_bytes| of results.
+  explicit LargeIconCache(size_t max_size_in_bytes);
   ~LargeIconCache() override;
 
   // |LargeIconService| does everything on callbacks, and iOS needs to load the
@@ -40,13 +45,31 @@ class LargeIconCache : public KeyedService {
   std::unique_ptr<favicon_base::LargeIconResult> GetCachedResult(
       const GURL& url);
 
+  // Returns the estimated size in bytes of the cached results.
+  size_t size_in_bytes() const { return size_in_bytes_; }
+
+  // Returns the number of GetCachedResult() calls that found a result, and
+  // the number that did not.
+  int hit_count() const { return hit_count_; }
+  int miss_count() const { return miss_count_; }
+
  private:
   // Clones a LargeIconResult.
   std::unique_ptr<favicon_base::LargeIconResult> CloneLargeIconResult(
       const favicon_base::LargeIconResult& large_icon_result);
 
+  // Evicts the least recently used results until the cache fits in
+  // |max_size_in_bytes_|.
+  void EvictToBudget();
+
   base::MRUCache<GURL, std::unique_ptr<LargeIconCacheEntry>> cache_;
 
+  const size_t max_size_in_bytes_;
+  size_t size_in_bytes_ = 0;
+
+  int hit_count_ = 0;
+  int miss_count_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(LargeIconCache);
 };
 
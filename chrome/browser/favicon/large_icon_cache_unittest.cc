@@ -5,6 +5,7 @@
 #include "ios/chrome/browser/favicon/large_icon_cache.h"
 
 #include "base/macros.h"
+#include "base/strings/string_number_conversions.h"
 #include "components/favicon_base/fallback_icon_style.h"
 #include "components/favicon_base/favicon_types.h"
 #include "skia/ext/skia_utils_ios.h"
@@ -100,4 +101,50 @@ TEST_F(LargeIconCacheTest, RetreiveItem) {
   EXPECT_FALSE(result2->fallback_icon_style->is_default_background_color);
 }
 
+// Tests that hits and misses are counted.
+TEST_F(LargeIconCacheTest, CountsHitsAndMisses) {
+  large_icon_cache_->SetCachedResult(
+      GURL(kDummyUrl), favicon_base::LargeIconResult(expected_bitmap_));
+
+  EXPECT_TRUE(large_icon_cache_->GetCachedResult(GURL(kDummyUrl)));
+  EXPECT_FALSE(large_icon_cache_->GetCachedResult(GURL(kDummyUrl2)));
+  EXPECT_TRUE(large_icon_cache_->GetCachedResult(GURL(kDummyUrl)));
+  EXPECT_EQ(2, large_icon_cache_->hit_count());
+  EXPECT_EQ(1, large_icon_cache_->miss_count());
+}
+
+// Tests that the least recently used results are evicted once the cache
+// exceeds its byte budget, regardless of the number of entries.
+TEST_F(LargeIconCacheTest, EvictsToByteBudget) {
+  favicon_base::FaviconRawBitmapResult large_bitmap =
+      CreateTestBitmap(256, 256, kTestColor);
+  const size_t budget = large_bitmap.bitmap_data->size() * 5 / 2;
+  LargeIconCache large_icon_cache(budget);
+
+  large_icon_cache.SetCachedResult(GURL(kDummyUrl),
+                                   favicon_base::LargeIconResult(large_bitmap));
+  large_icon_cache.SetCachedResult(GURL(kDummyUrl2),
+                                   favicon_base::LargeIconResult(large_bitmap));
+  EXPECT_LE(large_icon_cache.size_in_bytes(), budget);
+
+  // Touch kDummyUrl so that kDummyUrl2 is the least recently used.
+  EXPECT_TRUE(large_icon_cache.GetCachedResult(GURL(kDummyUrl)));
+  large_icon_cache.SetCachedResult(GURL("http://www.example3.com"),
+                                   favicon_base::LargeIconResult(large_bitmap));
+  EXPECT_LE(large_icon_cache.size_in_bytes(), budget);
+  EXPECT_TRUE(large_icon_cache.GetCachedResult(GURL(kDummyUrl)));
+  EXPECT_FALSE(large_icon_cache.GetCachedResult(GURL(kDummyUrl2)));
+
+  // Small fallback results are not bounded by a count.
+  LargeIconCache fallback_cache;
+  for (int i = 0; i < 100; ++i) {
+    fallback_cache.SetCachedResult(
+        GURL("http://www.example.com/" + base::NumberToString(i)),
+        favicon_base::LargeIconResult(new favicon_base::FallbackIconStyle(
+            *expected_fallback_icon_style_)));
+  }
+  EXPECT_TRUE(
+      fallback_cache.GetCachedResult(GURL("http://www.example.com/0")));
+}
+
 }  // namespace
@@ -7,7 +7,7 @@
 
 #include "base/macros.h"
 #include "base/no_destructor.h"
-#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 class ChromeBrowserState;
 
@@ -18,7 +18,7 @@ class Tracker;
 // feature_engagement component. It uses the KeyedService API to
 // expose functions to associate and retrieve a feature_engagement::Tracker
 // object with a given ChromeBrowserState object.
-class TrackerFactory : public BrowserStateKeyedServiceFactory {
+class TrackerFactory : public AuditedBrowserStateKeyedServiceFactory {
  public:
   // Returns the TrackerFactory singleton object.
   static TrackerFactory* GetInstance();
@@ -28,8 +28,8 @@ class TrackerFactory : public BrowserStateKeyedServiceFactory {
   static Tracker* GetForBrowserState(ChromeBrowserState* browser_state);
 
  protected:
-  // BrowserStateKeyedServiceFactory implementation.
-  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+  // AuditedBrowserStateKeyedServiceFactory implementation.
+  std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* context) const override;
   web::BrowserState* GetBrowserStateToUse(
       web::BrowserState* context) const override;
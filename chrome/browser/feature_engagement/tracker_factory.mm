@@ -31,13 +31,13 @@ feature_engagement::Tracker* TrackerFactory::GetForBrowserState(
 }
 
 TrackerFactory::TrackerFactory()
-    : BrowserStateKeyedServiceFactory(
+    : AuditedBrowserStateKeyedServiceFactory(
           "feature_engagement::Tracker",
           BrowserStateDependencyManager::GetInstance()) {}
 
 TrackerFactory::~TrackerFactory() = default;
 
-std::unique_ptr<KeyedService> TrackerFactory::BuildServiceInstanceFor(
+std::unique_ptr<KeyedService> TrackerFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* context) const {
   return CreateFeatureEngagementTracker(context);
 }
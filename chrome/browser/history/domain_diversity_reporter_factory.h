@@ -8,7 +8,7 @@
 #include <memory>
 
 #include "base/no_destructor.h"
-#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 class DomainDiversityReporter;
 
@@ -22,7 +22,8 @@ class BrowserState;
 
 // Singleton that creates all DomainDiversityReporter instances and associates
 // them with BrowserState.
-class DomainDiversityReporterFactory : public BrowserStateKeyedServiceFactory {
+class DomainDiversityReporterFactory
+    : public AuditedBrowserStateKeyedServiceFactory {
  public:
   static DomainDiversityReporter* GetForBrowserState(
       web::BrowserState* browser_state);
@@ -35,11 +36,11 @@ class DomainDiversityReporterFactory : public BrowserStateKeyedServiceFactory {
   DomainDiversityReporterFactory();
   ~DomainDiversityReporterFactory() override;
 
-  // BrowserStateKeyedServiceFactory implementation
+  // AuditedBrowserStateKeyedServiceFactory implementation
   void RegisterBrowserStatePrefs(
       user_prefs::PrefRegistrySyncable* registry) override;
 
-  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+  std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* browser_state) const override;
 
   web::BrowserState* GetBrowserStateToUse(
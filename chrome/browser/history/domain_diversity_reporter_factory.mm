@@ -14,6 +14,7 @@
 #import "components/prefs/pref_service.h"
 #import "ios/chrome/browser/browser_state/browser_state_otr_helper.h"
 #import "ios/chrome/browser/browser_state/chrome_browser_state.h"
+#import "ios/chrome/browser/browser_state/keyed_service_startup_audit.h"
 #import "ios/chrome/browser/history/history_service_factory.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
@@ -34,7 +35,7 @@ DomainDiversityReporterFactory* DomainDiversityReporterFactory::GetInstance() {
 }
 
 DomainDiversityReporterFactory::DomainDiversityReporterFactory()
-    : BrowserStateKeyedServiceFactory(
+    : AuditedBrowserStateKeyedServiceFactory(
           "DomainDiversityReporter",
           BrowserStateDependencyManager::GetInstance()) {
   DependsOn(ios::HistoryServiceFactory::GetInstance());
@@ -43,7 +44,7 @@ DomainDiversityReporterFactory::DomainDiversityReporterFactory()
 DomainDiversityReporterFactory::~DomainDiversityReporterFactory() = default;
 
 std::unique_ptr<KeyedService>
-DomainDiversityReporterFactory::BuildServiceInstanceFor(
+DomainDiversityReporterFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* browser_state) const {
   ChromeBrowserState* chrome_browser_state =
       ChromeBrowserState::FromBrowserState(browser_state);
@@ -78,5 +79,5 @@ bool DomainDiversityReporterFactory::ServiceIsNULLWhileTesting() const {
 }
 
 bool DomainDiversityReporterFactory::ServiceIsCreatedWithBrowserState() const {
-  return true;
+  return ShouldCreateDeferrableServicesWithBrowserState();
 }
@@ -0,0 +1,15 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_HISTORY_FEATURES_H_
+#define IOS_CHROME_BROWSER_HISTORY_FEATURES_H_
+
+#include "base/feature_list.h"
+
+// Feature flag to route HistoryTabHelper writes through the per-browser-state
+// HistoryWriteCoalescer instead of sending them to the HistoryService
+// immediately.
+extern const base::Feature kHistoryWriteCoalescing;
+
+#endif  // IOS_CHROME_BROWSER_HISTORY_FEATURES_H_
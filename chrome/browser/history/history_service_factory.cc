@@ -59,7 +59,7 @@ HistoryServiceFactory* HistoryServiceFactory::GetInstance() {
 }
 
 HistoryServiceFactory::HistoryServiceFactory()
-    : BrowserStateKeyedServiceFactory(
+    : AuditedBrowserStateKeyedServiceFactory(
           "HistoryService",
           BrowserStateDependencyManager::GetInstance()) {
   DependsOn(ios::BookmarkModelFactory::GetInstance());
@@ -68,7 +68,8 @@ HistoryServiceFactory::HistoryServiceFactory()
 HistoryServiceFactory::~HistoryServiceFactory() {
 }
 
-std::unique_ptr<KeyedService> HistoryServiceFactory::BuildServiceInstanceFor(
+std::unique_ptr<KeyedService>
+HistoryServiceFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* context) const {
   ChromeBrowserState* browser_state =
       ChromeBrowserState::FromBrowserState(context);
@@ -14,6 +14,8 @@
 #include "ios/web/public/web_state_observer.h"
 #import "ios/web/public/web_state_user_data.h"
 
+class HistoryWriteCoalescer;
+
 namespace history {
 class HistoryService;
 }  // namespace history
@@ -49,6 +51,7 @@ class HistoryTabHelper : public history::Context,
   explicit HistoryTabHelper(web::WebState* web_state);
 
   // web::WebStateObserver implementation.
+  EventMask GetObservedEvents() const override;
   void DidFinishNavigation(web::WebState* web_state,
                            web::NavigationContext* navigation_context) override;
   void PageLoaded(
@@ -60,6 +63,10 @@ class HistoryTabHelper : public history::Context,
   // Helper function to return the history service. May return null.
   history::HistoryService* GetHistoryService();
 
+  // Helper function to return the HistoryWriteCoalescer. Returns null if
+  // writes must be sent to the history service directly.
+  HistoryWriteCoalescer* GetHistoryWriteCoalescer();
+
   // The WebState this instance is observing. Will be null after
   // WebStateDestroyed has been called.
   web::WebState* web_state_ = nullptr;
@@ -13,6 +13,8 @@
 #include "ios/chrome/browser/browser_state/chrome_browser_state.h"
 #include "ios/chrome/browser/chrome_url_constants.h"
 #include "ios/chrome/browser/history/history_service_factory.h"
+#include "ios/chrome/browser/history/history_write_coalescer.h"
+#include "ios/chrome/browser/history/history_write_coalescer_factory.h"
 #import "ios/web/public/navigation/navigation_context.h"
 #import "ios/web/public/navigation/navigation_item.h"
 #import "ios/web/public/navigation/navigation_manager.h"
@@ -52,7 +54,13 @@ void HistoryTabHelper::UpdateHistoryPageTitle(const web::NavigationItem& item) {
   }
 
   history::HistoryService* history_service = GetHistoryService();
-  if (history_service) {
+  if (!history_service) {
+    return;
+  }
+
+  if (HistoryWriteCoalescer* coalescer = GetHistoryWriteCoalescer()) {
+    coalescer->SetPageTitle(item.GetVirtualURL(), title.value());
+  } else {
     history_service->SetPageTitle(item.GetVirtualURL(), title.value());
   }
 }
@@ -66,8 +74,13 @@ void HistoryTabHelper::SetDelayHistoryServiceNotification(
 
   history::HistoryService* history_service = GetHistoryService();
   if (history_service) {
+    HistoryWriteCoalescer* coalescer = GetHistoryWriteCoalescer();
     for (const auto& add_page_args : recorded_navigations_) {
-      history_service->AddPage(add_page_args);
+      if (coalescer) {
+        coalescer->AddPage(add_page_args);
+      } else {
+        history_service->AddPage(add_page_args);
+      }
     }
   }
 
@@ -86,6 +99,11 @@ HistoryTabHelper::HistoryTabHelper(web::WebState* web_state)
   web_state_->AddObserver(this);
 }
 
+web::WebStateObserver::EventMask HistoryTabHelper::GetObservedEvents() const {
+  return EventBit(Event::kDidFinishNavigation) | EventBit(Event::kPageLoaded) |
+         EventBit(Event::kTitleWasSet);
+}
+
 void HistoryTabHelper::DidFinishNavigation(
     web::WebState* web_state,
     web::NavigationContext* navigation_context) {
@@ -188,7 +206,11 @@ void HistoryTabHelper::DidFinishNavigation(
 
     history::HistoryService* history_service = GetHistoryService();
     if (history_service) {
-      history_service->AddPage(add_page_args);
+      if (HistoryWriteCoalescer* coalescer = GetHistoryWriteCoalescer()) {
+        coalescer->AddPage(add_page_args);
+      } else {
+        history_service->AddPage(add_page_args);
+      }
       UpdateHistoryPageTitle(*last_committed_item);
     }
   }
@@ -228,6 +250,13 @@ void HistoryTabHelper::TitleWasSet(web::WebState* web_state) {
 
 void HistoryTabHelper::WebStateDestroyed(web::WebState* web_state) {
   DCHECK_EQ(web_state_, web_state);
+  // The pending visits of this tab reference this object as their
+  // history::Context, so they must reach the HistoryService before it is
+  // destroyed.
+  if (HistoryWriteCoalescer* coalescer = GetHistoryWriteCoalescer()) {
+    coalescer->FlushContext(this);
+  }
+
   web_state_->RemoveObserver(this);
   web_state_ = nullptr;
 }
@@ -242,4 +271,13 @@ history::HistoryService* HistoryTabHelper::GetHistoryService() {
       browser_state, ServiceAccessType::IMPLICIT_ACCESS);
 }
 
+HistoryWriteCoalescer* HistoryTabHelper::GetHistoryWriteCoalescer() {
+  ChromeBrowserState* browser_state =
+      ChromeBrowserState::FromBrowserState(web_state_->GetBrowserState());
+  if (browser_state->IsOffTheRecord())
+    return nullptr;
+
+  return HistoryWriteCoalescerFactory::GetForBrowserState(browser_state);
+}
+
 WEB_STATE_USER_DATA_KEY_IMPL(HistoryTabHelper)
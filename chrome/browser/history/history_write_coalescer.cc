@@ -0,0 +1,190 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/history/history_write_coalescer.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/check_op.h"
+#include "base/metrics/histogram_functions.h"
+#include "components/history/core/browser/history_service.h"
+#include "ui/base/page_transition_types.h"
+
+// static
+constexpr base::TimeDelta HistoryWriteCoalescer::kFlushDelay;
+
+HistoryWriteCoalescer::HistoryWriteCoalescer(
+    history::HistoryService* history_service)
+    : history_service_(history_service) {
+  DCHECK(history_service_);
+}
+
+HistoryWriteCoalescer::~HistoryWriteCoalescer() {
+  DCHECK(!HasPendingWrites());
+}
+
+void HistoryWriteCoalescer::AddPage(
+    const history::HistoryAddPageArgs& add_page_args) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  ++stats_.pages_received;
+
+  // The HistoryService is gone, there is nothing to write to.
+  if (!history_service_)
+    return;
+
+  history::HistoryAddPageArgs* target = FindMergeTarget(add_page_args);
+  if (!target) {
+    pending_pages_.push_back(add_page_args);
+    ScheduleFlush();
+    return;
+  }
+
+  ++stats_.writes_saved;
+  ++writes_saved_since_flush_;
+
+  // |add_page_args| is the next hop of the redirect chain ending at the
+  // pending visit. Record a single visit for the whole chain, originating
+  // from the first hop's referrer.
+  history::RedirectList redirects = std::move(target->redirects);
+  if (redirects.empty())
+    redirects.push_back(target->url);
+  DCHECK_EQ(redirects.back(), add_page_args.redirects.front());
+  redirects.insert(redirects.end(), add_page_args.redirects.begin() + 1,
+                   add_page_args.redirects.end());
+
+  GURL referrer = std::move(target->referrer);
+  *target = add_page_args;
+  target->redirects = std::move(redirects);
+  target->referrer = std::move(referrer);
+}
+
+void HistoryWriteCoalescer::SetPageTitle(const GURL& url,
+                                         const std::u16string& title) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  ++stats_.titles_received;
+
+  // The HistoryService is gone, there is nothing to write to.
+  if (!history_service_)
+    return;
+
+  auto iter = pending_titles_.find(url);
+  if (iter != pending_titles_.end()) {
+    ++stats_.writes_saved;
+    ++writes_saved_since_flush_;
+    iter->second = title;
+    return;
+  }
+
+  pending_titles_.insert(std::make_pair(url, title));
+  ScheduleFlush();
+}
+
+void HistoryWriteCoalescer::Flush() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  flush_timer_.Stop();
+  if (!HasPendingWrites())
+    return;
+
+  std::vector<history::HistoryAddPageArgs> pages;
+  std::swap(pages, pending_pages_);
+  std::map<GURL, std::u16string> titles;
+  std::swap(titles, pending_titles_);
+
+  const int writes_saved = writes_saved_since_flush_;
+  writes_saved_since_flush_ = 0;
+
+  if (!history_service_)
+    return;
+
+  // Titles are written after the visits so that they apply to rows created
+  // by the same batch.
+  WritePages(pages);
+  for (const auto& pair : titles)
+    history_service_->SetPageTitle(pair.first, pair.second);
+
+  const int writes_issued = static_cast<int>(pages.size() + titles.size());
+  stats_.writes_issued += static_cast<int>(titles.size());
+
+  base::UmaHistogramCounts1000("History.WriteCoalescer.WritesIssuedPerFlush",
+                               writes_issued);
+  base::UmaHistogramCounts1000("History.WriteCoalescer.WritesSavedPerFlush",
+                               writes_saved);
+}
+
+void HistoryWriteCoalescer::FlushContext(history::ContextID context_id) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  std::vector<history::HistoryAddPageArgs> pages;
+  auto iter = pending_pages_.begin();
+  while (iter != pending_pages_.end()) {
+    if (iter->context_id == context_id) {
+      pages.push_back(std::move(*iter));
+      iter = pending_pages_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  if (!HasPendingWrites())
+    flush_timer_.Stop();
+
+  // Pending titles are keyed by URL and do not reference |context_id|, so they
+  // are left for the next flush.
+  if (history_service_)
+    WritePages(pages);
+}
+
+bool HistoryWriteCoalescer::HasPendingWrites() const {
+  return !pending_pages_.empty() || !pending_titles_.empty();
+}
+
+void HistoryWriteCoalescer::Shutdown() {
+  Flush();
+  history_service_ = nullptr;
+}
+
+void HistoryWriteCoalescer::ScheduleFlush() {
+  if (flush_timer_.IsRunning())
+    return;
+
+  flush_timer_.Start(FROM_HERE, kFlushDelay,
+                     base::BindOnce(&HistoryWriteCoalescer::Flush,
+                                    base::Unretained(this)));
+}
+
+void HistoryWriteCoalescer::WritePages(
+    const std::vector<history::HistoryAddPageArgs>& pages) {
+  DCHECK(history_service_);
+  for (const history::HistoryAddPageArgs& add_page_args : pages)
+    history_service_->AddPage(add_page_args);
+  stats_.writes_issued += static_cast<int>(pages.size());
+}
+
+history::HistoryAddPageArgs* HistoryWriteCoalescer::FindMergeTarget(
+    const history::HistoryAddPageArgs& add_page_args) {
+  // Only the last pending visit of the same context can be merged, so that
+  // visits are never reordered within a tab.
+  for (auto iter = pending_pages_.rbegin(); iter != pending_pages_.rend();
+       ++iter) {
+    if (iter->context_id != add_page_args.context_id)
+      continue;
+
+    // Only redirect hops are folded into the visit they originate from. Any
+    // other navigation, e.g. following a link or reloading the page, is a
+    // visit of its own, even if it commits the same item again, so that the
+    // visit counts used for ranking are preserved.
+    if (ui::PageTransitionCoreTypeIs(add_page_args.transition,
+                                     ui::PAGE_TRANSITION_RELOAD)) {
+      return nullptr;
+    }
+    if (ui::PageTransitionIsRedirect(add_page_args.transition) &&
+        !add_page_args.redirects.empty() &&
+        add_page_args.redirects.front() == iter->url) {
+      return &*iter;
+    }
+
+    return nullptr;
+  }
+  return nullptr;
+}
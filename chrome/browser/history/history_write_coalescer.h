@@ -0,0 +1,114 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_HISTORY_HISTORY_WRITE_COALESCER_H_
+#define IOS_CHROME_BROWSER_HISTORY_HISTORY_WRITE_COALESCER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/sequence_checker.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "components/history/core/browser/history_types.h"
+#include "components/keyed_service/core/keyed_service.h"
+#include "url/gurl.h"
+
+namespace history {
+class HistoryService;
+}  // namespace history
+
+// HistoryWriteCoalescer buffers the page visits and title updates produced by
+// the HistoryTabHelpers of a browser state and forwards them to the
+// HistoryService in batches. Consecutive hops of a redirect chain coming from
+// the same tab are merged into a single visit, and rapid title updates for the
+// same page are collapsed to the last one. Any other navigation, including a
+// reload, is recorded as a visit of its own.
+//
+// Pending writes are flushed after |kFlushDelay|, when the application is
+// backgrounded and when the service is shut down. The visits of a tab are
+// flushed when the tab is closed. Writes received after shutdown are
+// dropped.
+class HistoryWriteCoalescer : public KeyedService {
+ public:
+  // Counters describing the amount of work saved by the coalescer.
+  struct Stats {
+    // Number of AddPage() calls received.
+    int pages_received = 0;
+    // Number of SetPageTitle() calls received.
+    int titles_received = 0;
+    // Number of calls forwarded to the HistoryService.
+    int writes_issued = 0;
+    // Number of calls that were merged and never reached the HistoryService.
+    int writes_saved = 0;
+  };
+
+  // Delay between the first buffered write and the flush.
+  static constexpr base::TimeDelta kFlushDelay =
+      base::TimeDelta::FromMilliseconds(500);
+
+  explicit HistoryWriteCoalescer(history::HistoryService* history_service);
+  ~HistoryWriteCoalescer() override;
+
+  // Buffers a page visit. If |add_page_args| is a redirect continuing the
+  // redirect chain of the last pending visit of the same context, it replaces
+  // the pending visit.
+  void AddPage(const history::HistoryAddPageArgs& add_page_args);
+
+  // Buffers a title update for |url|. Only the last title buffered for a given
+  // URL is written.
+  void SetPageTitle(const GURL& url, const std::u16string& title);
+
+  // Forwards all pending writes to the HistoryService.
+  void Flush();
+
+  // Forwards the pending visits of |context_id| to the HistoryService, e.g.
+  // before the context is destroyed. The writes of other contexts stay
+  // pending.
+  void FlushContext(history::ContextID context_id);
+
+  // Returns whether there are writes waiting to be flushed.
+  bool HasPendingWrites() const;
+
+  const Stats& stats() const { return stats_; }
+
+  // KeyedService implementation.
+  void Shutdown() override;
+
+ private:
+  // Starts the flush timer if it is not already running.
+  void ScheduleFlush();
+
+  // Forwards |pages| to the HistoryService.
+  void WritePages(const std::vector<history::HistoryAddPageArgs>& pages);
+
+  // Returns the pending visit that |add_page_args| should be merged into, or
+  // null if it should be recorded as a new visit.
+  history::HistoryAddPageArgs* FindMergeTarget(
+      const history::HistoryAddPageArgs& add_page_args);
+
+  // The HistoryService receiving the writes. Null after Shutdown().
+  history::HistoryService* history_service_;
+
+  // Visits waiting to be written, in the order they were received.
+  std::vector<history::HistoryAddPageArgs> pending_pages_;
+
+  // Titles waiting to be written, keyed by page URL.
+  std::map<GURL, std::u16string> pending_titles_;
+
+  // Number of writes saved since the last flush.
+  int writes_saved_since_flush_ = 0;
+
+  Stats stats_;
+
+  base::OneShotTimer flush_timer_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  DISALLOW_COPY_AND_ASSIGN(HistoryWriteCoalescer);
+};
+
+#endif  // IOS_CHROME_BROWSER_HISTORY_HISTORY_WRITE_COALESCER_H_
@@ -0,0 +1,64 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/history/history_write_coalescer_factory.h"
+
+#include "base/feature_list.h"
+#include "components/keyed_service/core/service_access_type.h"
+#include "components/keyed_service/ios/browser_state_dependency_manager.h"
+#include "ios/chrome/browser/browser_state/chrome_browser_state.h"
+#include "ios/chrome/browser/history/features.h"
+#include "ios/chrome/browser/history/history_service_factory.h"
+#include "ios/chrome/browser/history/history_write_coalescer.h"
+
+// static
+HistoryWriteCoalescer* HistoryWriteCoalescerFactory::GetForBrowserState(
+    ChromeBrowserState* browser_state) {
+  return static_cast<HistoryWriteCoalescer*>(
+      GetInstance()->GetServiceForBrowserState(browser_state, true));
+}
+
+// static
+HistoryWriteCoalescer*
+HistoryWriteCoalescerFactory::GetForBrowserStateIfExists(
+    ChromeBrowserState* browser_state) {
+  return static_cast<HistoryWriteCoalescer*>(
+      GetInstance()->GetServiceForBrowserState(browser_state, false));
+}
+
+// static
+HistoryWriteCoalescerFactory* HistoryWriteCoalescerFactory::GetInstance() {
+  static base::NoDestructor<HistoryWriteCoalescerFactory> instance;
+  return instance.get();
+}
+
+HistoryWriteCoalescerFactory::HistoryWriteCoalescerFactory()
+    : BrowserStateKeyedServiceFactory(
+          "HistoryWriteCoalescer",
+          BrowserStateDependencyManager::GetInstance()) {
+  DependsOn(ios::HistoryServiceFactory::GetInstance());
+}
+
+HistoryWriteCoalescerFactory::~HistoryWriteCoalescerFactory() = default;
+
+std::unique_ptr<KeyedService>
+HistoryWriteCoalescerFactory::BuildServiceInstanceFor(
+    web::BrowserState* context) const {
+  if (!base::FeatureList::IsEnabled(kHistoryWriteCoalescing))
+    return nullptr;
+
+  ChromeBrowserState* browser_state =
+      ChromeBrowserState::FromBrowserState(context);
+  history::HistoryService* history_service =
+      ios::HistoryServiceFactory::GetForBrowserState(
+          browser_state, ServiceAccessType::EXPLICIT_ACCESS);
+  if (!history_service)
+    return nullptr;
+
+  return std::make_unique<HistoryWriteCoalescer>(history_service);
+}
+
+bool HistoryWriteCoalescerFactory::ServiceIsNULLWhileTesting() const {
+  return true;
+}
@@ -0,0 +1,42 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_HISTORY_HISTORY_WRITE_COALESCER_FACTORY_H_
+#define IOS_CHROME_BROWSER_HISTORY_HISTORY_WRITE_COALESCER_FACTORY_H_
+
+#include <memory>
+
+#include "base/macros.h"
+#include "base/no_destructor.h"
+#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+
+class ChromeBrowserState;
+class HistoryWriteCoalescer;
+
+// Singleton that owns all HistoryWriteCoalescers and associates them with
+// ChromeBrowserState. Returns null for off-the-record browser states and when
+// kHistoryWriteCoalescing is disabled.
+class HistoryWriteCoalescerFactory : public BrowserStateKeyedServiceFactory {
+ public:
+  static HistoryWriteCoalescer* GetForBrowserState(
+      ChromeBrowserState* browser_state);
+  static HistoryWriteCoalescer* GetForBrowserStateIfExists(
+      ChromeBrowserState* browser_state);
+  static HistoryWriteCoalescerFactory* GetInstance();
+
+ private:
+  friend class base::NoDestructor<HistoryWriteCoalescerFactory>;
+
+  HistoryWriteCoalescerFactory();
+  ~HistoryWriteCoalescerFactory() override;
+
+  // BrowserStateKeyedServiceFactory implementation.
+  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+      web::BrowserState* context) const override;
+  bool ServiceIsNULLWhileTesting() const override;
+
+  DISALLOW_COPY_AND_ASSIGN(HistoryWriteCoalescerFactory);
+};
+
+#endif  // IOS_CHROME_BROWSER_HISTORY_HISTORY_WRITE_COALESCER_FACTORY_H_
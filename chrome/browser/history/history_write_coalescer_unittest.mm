@@ -0,0 +1,252 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/history/history_write_coalescer.h"
+
+#include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "components/history/core/browser/history_service.h"
+#include "components/keyed_service/core/service_access_type.h"
+#include "ios/chrome/browser/browser_state/test_chrome_browser_state.h"
+#include "ios/chrome/browser/history/history_service_factory.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+#include "ui/base/page_transition_types.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+// Number of navigations or title changes generated by the storm tests.
+const int kStormSize = 100;
+
+class HistoryWriteCoalescerTest : public PlatformTest {
+ public:
+  void SetUp() override {
+    PlatformTest::SetUp();
+    TestChromeBrowserState::Builder test_cbs_builder;
+    chrome_browser_state_ = test_cbs_builder.Build();
+    ASSERT_TRUE(chrome_browser_state_->CreateHistoryService());
+    coalescer_ = std::make_unique<HistoryWriteCoalescer>(history_service());
+  }
+
+  void TearDown() override {
+    coalescer_->Shutdown();
+    PlatformTest::TearDown();
+  }
+
+  history::HistoryService* history_service() {
+    return ios::HistoryServiceFactory::GetForBrowserState(
+        chrome_browser_state_.get(), ServiceAccessType::EXPLICIT_ACCESS);
+  }
+
+  // Returns the arguments of a navigation to |url| in the tab identified by
+  // |context_id|.
+  history::HistoryAddPageArgs PageArgs(
+      const GURL& url,
+      history::ContextID context_id,
+      int nav_entry_id,
+      const history::RedirectList& redirects,
+      ui::PageTransition transition = ui::PAGE_TRANSITION_TYPED) {
+    return history::HistoryAddPageArgs(
+        url, base::Time::Now(), context_id, nav_entry_id, GURL(), redirects,
+        transition, /*hidden=*/false, history::SOURCE_BROWSED,
+        /*did_replace_entry=*/false, /*consider_for_ntp_most_visited=*/true,
+        /*floc_allowed=*/false, /*title=*/absl::nullopt);
+  }
+
+  // Queries the history service for |url|. Spins the runloop until a response
+  // is received.
+  history::QueryURLResult QueryURL(const GURL& url) {
+    history::QueryURLResult query_result;
+    base::RunLoop loop;
+    history_service()->QueryURL(
+        url, /*want_visits=*/true,
+        base::BindLambdaForTesting([&](history::QueryURLResult result) {
+          query_result = std::move(result);
+          loop.Quit();
+        }),
+        &tracker_);
+    loop.Run();
+    return query_result;
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  std::unique_ptr<TestChromeBrowserState> chrome_browser_state_;
+  std::unique_ptr<HistoryWriteCoalescer> coalescer_;
+  base::CancelableTaskTracker tracker_;
+  int first_tab_ = 0;
+  int second_tab_ = 0;
+};
+
+// Transition of a client redirect.
+const ui::PageTransition kClientRedirect = ui::PageTransitionFromInt(
+    ui::PAGE_TRANSITION_LINK | ui::PAGE_TRANSITION_CLIENT_REDIRECT);
+
+}  // namespace
+
+// Tests that writes are held until the flush delay expires.
+TEST_F(HistoryWriteCoalescerTest, FlushesAfterDelay) {
+  const GURL url("https://www.example.com/");
+  coalescer_->AddPage(PageArgs(url, &first_tab_, 1, {}));
+  EXPECT_TRUE(coalescer_->HasPendingWrites());
+  EXPECT_FALSE(QueryURL(url).success);
+
+  task_environment_.FastForwardBy(HistoryWriteCoalescer::kFlushDelay);
+  EXPECT_FALSE(coalescer_->HasPendingWrites());
+  history::QueryURLResult result = QueryURL(url);
+  EXPECT_TRUE(result.success);
+  EXPECT_EQ(1, result.row.visit_count());
+  EXPECT_EQ(1, coalescer_->stats().writes_issued);
+  EXPECT_EQ(0, coalescer_->stats().writes_saved);
+}
+
+// Tests that a storm of client redirects in one tab results in a single
+// write to the history service.
+TEST_F(HistoryWriteCoalescerTest, MergesRedirectChain) {
+  GURL previous_url("https://www.example.com/0");
+  coalescer_->AddPage(PageArgs(previous_url, &first_tab_, 0, {}));
+  for (int i = 1; i < kStormSize; ++i) {
+    const GURL url(base::StringPrintf("https://www.example.com/%d", i));
+    coalescer_->AddPage(
+        PageArgs(url, &first_tab_, i, {previous_url, url}, kClientRedirect));
+    previous_url = url;
+  }
+  coalescer_->Flush();
+
+  EXPECT_EQ(kStormSize, coalescer_->stats().pages_received);
+  EXPECT_EQ(1, coalescer_->stats().writes_issued);
+  EXPECT_EQ(kStormSize - 1, coalescer_->stats().writes_saved);
+
+  history::QueryURLResult result = QueryURL(previous_url);
+  EXPECT_TRUE(result.success);
+  EXPECT_EQ(1, result.row.visit_count());
+  EXPECT_TRUE(QueryURL(GURL("https://www.example.com/0")).success);
+}
+
+// Tests that navigations from different tabs are never merged together.
+TEST_F(HistoryWriteCoalescerTest, DoesNotMergeAcrossContexts) {
+  const GURL first_url("https://first.example.com/");
+  const GURL second_url("https://second.example.com/");
+  coalescer_->AddPage(PageArgs(first_url, &first_tab_, 1, {}));
+  coalescer_->AddPage(PageArgs(second_url, &second_tab_, 1,
+                               {first_url, second_url}, kClientRedirect));
+  coalescer_->Flush();
+
+  EXPECT_EQ(2, coalescer_->stats().writes_issued);
+  EXPECT_EQ(0, coalescer_->stats().writes_saved);
+  EXPECT_TRUE(QueryURL(first_url).success);
+  EXPECT_TRUE(QueryURL(second_url).success);
+}
+
+// Tests that following a link is recorded as a visit of its own, even if it
+// carries a redirect chain starting at the previous page.
+TEST_F(HistoryWriteCoalescerTest, DoesNotMergeLinkNavigation) {
+  const GURL first_url("https://www.example.com/first");
+  const GURL second_url("https://www.example.com/second");
+  coalescer_->AddPage(PageArgs(first_url, &first_tab_, 1, {}));
+  coalescer_->AddPage(PageArgs(second_url, &first_tab_, 2,
+                               {first_url, second_url},
+                               ui::PAGE_TRANSITION_LINK));
+  coalescer_->Flush();
+
+  EXPECT_EQ(2, coalescer_->stats().writes_issued);
+  EXPECT_EQ(0, coalescer_->stats().writes_saved);
+  EXPECT_EQ(1, QueryURL(first_url).row.visit_count());
+  EXPECT_EQ(1, QueryURL(second_url).row.visit_count());
+}
+
+// Tests that committing the same item twice, e.g. when reloading it, is
+// recorded as two visits.
+TEST_F(HistoryWriteCoalescerTest, DoesNotMergeSameNavigation) {
+  const GURL url("https://www.example.com/");
+  coalescer_->AddPage(PageArgs(url, &first_tab_, 1, {}));
+  coalescer_->AddPage(PageArgs(url, &first_tab_, 1, {}));
+  coalescer_->AddPage(
+      PageArgs(url, &first_tab_, 1, {}, ui::PAGE_TRANSITION_RELOAD));
+  coalescer_->Flush();
+
+  EXPECT_EQ(3, coalescer_->stats().writes_issued);
+  EXPECT_EQ(0, coalescer_->stats().writes_saved);
+  EXPECT_EQ(3, QueryURL(url).row.visit_count());
+}
+
+// Tests that a reload is not merged into the visit it redirects from.
+TEST_F(HistoryWriteCoalescerTest, DoesNotMergeRedirectingReload) {
+  const GURL first_url("https://www.example.com/first");
+  const GURL second_url("https://www.example.com/second");
+  coalescer_->AddPage(PageArgs(first_url, &first_tab_, 1, {}));
+  coalescer_->AddPage(PageArgs(
+      second_url, &first_tab_, 1, {first_url, second_url},
+      ui::PageTransitionFromInt(ui::PAGE_TRANSITION_RELOAD |
+                                ui::PAGE_TRANSITION_SERVER_REDIRECT)));
+  coalescer_->Flush();
+
+  EXPECT_EQ(2, coalescer_->stats().writes_issued);
+  EXPECT_EQ(0, coalescer_->stats().writes_saved);
+}
+
+// Tests that a storm of title updates only writes the last title.
+TEST_F(HistoryWriteCoalescerTest, CollapsesTitleUpdates) {
+  const GURL url("https://www.example.com/");
+  coalescer_->AddPage(PageArgs(url, &first_tab_, 1, {}));
+  for (int i = 0; i < kStormSize; ++i) {
+    coalescer_->SetPageTitle(
+        url, base::UTF8ToUTF16(base::StringPrintf("Title %d", i)));
+  }
+  task_environment_.FastForwardBy(HistoryWriteCoalescer::kFlushDelay);
+
+  EXPECT_EQ(kStormSize, coalescer_->stats().titles_received);
+  EXPECT_EQ(2, coalescer_->stats().writes_issued);
+  EXPECT_EQ(kStormSize - 1, coalescer_->stats().writes_saved);
+  EXPECT_EQ(base::UTF8ToUTF16(base::StringPrintf("Title %d", kStormSize - 1)),
+            QueryURL(url).row.title());
+}
+
+// Tests that flushing a context only writes the visits of that context.
+TEST_F(HistoryWriteCoalescerTest, FlushContext) {
+  const GURL first_url("https://first.example.com/");
+  const GURL second_url("https://second.example.com/");
+  coalescer_->AddPage(PageArgs(first_url, &first_tab_, 1, {}));
+  coalescer_->AddPage(PageArgs(second_url, &second_tab_, 1, {}));
+  coalescer_->FlushContext(&first_tab_);
+
+  EXPECT_EQ(1, coalescer_->stats().writes_issued);
+  EXPECT_TRUE(coalescer_->HasPendingWrites());
+  EXPECT_TRUE(QueryURL(first_url).success);
+  EXPECT_FALSE(QueryURL(second_url).success);
+
+  // The visits of the other context are still flushed after the delay.
+  task_environment_.FastForwardBy(HistoryWriteCoalescer::kFlushDelay);
+  EXPECT_FALSE(coalescer_->HasPendingWrites());
+  EXPECT_TRUE(QueryURL(second_url).success);
+}
+
+// Tests that pending writes are sent to the history service on shutdown.
+TEST_F(HistoryWriteCoalescerTest, FlushesOnShutdown) {
+  const GURL url("https://www.example.com/");
+  coalescer_->AddPage(PageArgs(url, &first_tab_, 1, {}));
+  coalescer_->Shutdown();
+
+  EXPECT_FALSE(coalescer_->HasPendingWrites());
+  EXPECT_TRUE(QueryURL(url).success);
+}
+
+// Tests that writes received after shutdown are dropped.
+TEST_F(HistoryWriteCoalescerTest, DropsWritesAfterShutdown) {
+  const GURL url("https://www.example.com/");
+  coalescer_->Shutdown();
+  coalescer_->AddPage(PageArgs(url, &first_tab_, 1, {}));
+  coalescer_->SetPageTitle(url, u"Title");
+
+  EXPECT_FALSE(coalescer_->HasPendingWrites());
+  EXPECT_EQ(0, coalescer_->stats().writes_issued);
+}
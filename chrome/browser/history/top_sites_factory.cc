@@ -35,7 +35,7 @@ TopSitesFactory* TopSitesFactory::GetInstance() {
 }
 
 TopSitesFactory::TopSitesFactory()
-    : RefcountedBrowserStateKeyedServiceFactory(
+    : AuditedRefcountedBrowserStateKeyedServiceFactory(
           "TopSites",
           BrowserStateDependencyManager::GetInstance()) {
   DependsOn(ios::HistoryServiceFactory::GetInstance());
@@ -44,7 +44,8 @@ TopSitesFactory::TopSitesFactory()
 TopSitesFactory::~TopSitesFactory() {
 }
 
-scoped_refptr<RefcountedKeyedService> TopSitesFactory::BuildServiceInstanceFor(
+scoped_refptr<RefcountedKeyedService>
+TopSitesFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* context) const {
   ChromeBrowserState* browser_state =
       ChromeBrowserState::FromBrowserState(context);
@@ -8,7 +8,7 @@
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/no_destructor.h"
-#include "components/keyed_service/ios/refcounted_browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 class ChromeBrowserState;
 
@@ -19,7 +19,8 @@ class TopSites;
 namespace ios {
 // TopSitesFactory is a singleton that associates history::TopSites instance to
 // ChromeBrowserState.
-class TopSitesFactory : public RefcountedBrowserStateKeyedServiceFactory {
+class TopSitesFactory
+    : public AuditedRefcountedBrowserStateKeyedServiceFactory {
  public:
   static scoped_refptr<history::TopSites> GetForBrowserState(
       ChromeBrowserState* browser_state);
@@ -31,8 +32,8 @@ class TopSitesFactory : public RefcountedBrowserStateKeyedServiceFactory {
   TopSitesFactory();
   ~TopSitesFactory() override;
 
-  // RefcountedBrowserStateKeyedServiceFactory implementation.
-  scoped_refptr<RefcountedKeyedService> BuildServiceInstanceFor(
+  // AuditedRefcountedBrowserStateKeyedServiceFactory implementation.
+  scoped_refptr<RefcountedKeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* context) const override;
   void RegisterBrowserStatePrefs(
       user_prefs::PrefRegistrySyncable* registry) override;
@@ -51,9 +51,11 @@
 #include "ios/chrome/browser/install_time_util.h"
 #include "ios/chrome/browser/metrics/ios_chrome_metrics_service_accessor.h"
 #include "ios/chrome/browser/metrics/ios_expired_histograms_array.h"
+#include "ios/chrome/browser/metrics/startup_tracer.h"
 #include "ios/chrome/browser/open_from_clipboard/create_clipboard_recent_content.h"
 #include "ios/chrome/browser/policy/browser_policy_connector_ios.h"
 #include "ios/chrome/browser/pref_names.h"
+#include "ios/chrome/browser/prefs/pref_file_prefetcher.h"
 #include "ios/chrome/browser/safe_browsing/safe_browsing_service.h"
 #include "ios/chrome/browser/translate/translate_service_ios.h"
 #include "ios/public/provider/chrome/browser/chrome_browser_provider.h"
@@ -151,6 +153,7 @@ void IOSChromeMainParts::PreCreateThreads() {
   // Calls in this function should not post tasks or create threads as
   // components used to handle those tasks are not yet available. This work
   // should be deferred to PreMainMessageLoopRunImpl.
+  StartupTracer::ScopedSpan startup_span("PreCreateThreads");
 
   // The initial read is done synchronously, the TaskPriority is thus only used
   // for flushes to disks and BACKGROUND is therefore appropriate. Priority of
@@ -198,6 +201,10 @@ void IOSChromeMainParts::PreCreateThreads() {
   // after setting up field trials.
   crash_helper::SyncCrashpadEnabledOnNextRun();
 
+  // The preference files are prefetched before the feature list is
+  // initialized, so the feature state only applies to the next run.
+  PrefFilePrefetcher::GetInstance()->SyncEnabledOnNextRun();
+
 #if BUILDFLAG(USE_ALLOCATOR_SHIM)
   // Do not install allocator shim on iOS 13.4 due to high crash volume on this
   // particular version of OS. TODO(crbug.com/1108219): Remove this workaround
@@ -241,6 +248,7 @@ void IOSChromeMainParts::PreCreateThreads() {
 }
 
 void IOSChromeMainParts::PreMainMessageLoopRun() {
+  StartupTracer::ScopedSpan startup_span("PreMainMessageLoopRun");
   application_context_->PreMainMessageLoopRun();
 
   // ContentSettingsPattern need to be initialized before creating the
@@ -251,11 +259,14 @@ void IOSChromeMainParts::PreMainMessageLoopRun() {
   ClipboardRecentContent::SetInstance(CreateClipboardRecentContentIOS());
 
   // Ensure that the browser state is initialized.
-  EnsureBrowserStateKeyedServiceFactoriesBuilt();
-  ios::ChromeBrowserStateManager* browser_state_manager =
-      application_context_->GetChromeBrowserStateManager();
-  ChromeBrowserState* last_used_browser_state =
-      browser_state_manager->GetLastUsedBrowserState();
+  ChromeBrowserState* last_used_browser_state = nullptr;
+  {
+    StartupTracer::ScopedSpan browser_state_span("CreateBrowserState");
+    EnsureBrowserStateKeyedServiceFactoriesBuilt();
+    ios::ChromeBrowserStateManager* browser_state_manager =
+        application_context_->GetChromeBrowserStateManager();
+    last_used_browser_state = browser_state_manager->GetLastUsedBrowserState();
+  }
 
   // This must occur at PreMainMessageLoopRun because |SetupMetrics()| uses the
   // blocking pool, which is disabled until the CreateThreads phase of startup.
@@ -0,0 +1,112 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/language/language_detection_cache.h"
+
+#include <algorithm>
+
+#include "base/metrics/histogram_functions.h"
+#include "base/strings/string_util.h"
+
+// static
+const int LanguageDetectionCache::kMinConfirmations = 2;
+// static
+const int LanguageDetectionCache::kMaxUsesWithoutConfirmation = 20;
+// static
+const int LanguageDetectionCache::kLookupsPerHitRateSample = 100;
+// static
+const size_t LanguageDetectionCache::kMaxHosts = 500;
+
+LanguageDetectionCache::LanguageDetectionCache() : hosts_(kMaxHosts) {}
+
+LanguageDetectionCache::~LanguageDetectionCache() = default;
+
+bool LanguageDetectionCache::DeclaredLanguageInfo::IsTrusted() const {
+  return confirmations >= kMinConfirmations &&
+         uses_since_confirmation < kMaxUsesWithoutConfirmation;
+}
+
+// static
+std::string LanguageDetectionCache::GetPrimaryLanguage(
+    const std::string& language) {
+  std::string primary_language =
+      language.substr(0, language.find_first_of("-_,; "));
+  return base::ToLowerASCII(primary_language);
+}
+
+std::vector<std::string> LanguageDetectionCache::GetTrustedLanguages(
+    const std::string& host) {
+  std::vector<std::string> trusted_languages;
+  LookupResult result = LookupResult::kMiss;
+  auto it = hosts_.Get(host);
+  if (it != hosts_.end()) {
+    for (const auto& pair : it->second) {
+      if (pair.second.IsTrusted())
+        trusted_languages.push_back(pair.first);
+    }
+    result = trusted_languages.empty() ? LookupResult::kUnconfirmed
+                                       : LookupResult::kHit;
+  }
+
+  ++lookup_count_;
+  if (result == LookupResult::kHit)
+    ++hit_count_;
+  base::UmaHistogramEnumeration("IOS.Translate.LanguageDetectionCache.Lookup",
+                                result);
+  if (lookup_count_ == kLookupsPerHitRateSample) {
+    base::UmaHistogramPercentage("IOS.Translate.LanguageDetectionCache.HitRate",
+                                 hit_count_ * 100 / lookup_count_);
+    lookup_count_ = 0;
+    hit_count_ = 0;
+  }
+  return trusted_languages;
+}
+
+void LanguageDetectionCache::OnLanguageDetected(
+    const std::string& host,
+    const std::string& declared_language,
+    const std::string& detected_language,
+    bool reliable) {
+  if (host.empty() || declared_language.empty())
+    return;
+
+  std::string declared = GetPrimaryLanguage(declared_language);
+  auto it = hosts_.Get(host);
+  if (!reliable) {
+    // The text of a page declaring a trusted language is not extracted.
+    if (it == hosts_.end())
+      return;
+    auto info_it = it->second.find(declared);
+    if (info_it != it->second.end() && info_it->second.IsTrusted())
+      ++info_it->second.uses_since_confirmation;
+    return;
+  }
+
+  bool matches_declared = declared == GetPrimaryLanguage(detected_language);
+  if (it != hosts_.end() && it->second.count(declared)) {
+    base::UmaHistogramBoolean(
+        "IOS.Translate.LanguageDetectionCache.DeclaredLanguageConfirmed",
+        matches_declared);
+  }
+
+  if (!matches_declared) {
+    // The declared language is contradicted by the content of the page.
+    if (it == hosts_.end())
+      return;
+    it->second.erase(declared);
+    if (it->second.empty())
+      hosts_.Erase(it);
+    return;
+  }
+
+  if (it == hosts_.end())
+    it = hosts_.Put(host, HostInfo());
+  DeclaredLanguageInfo& info = it->second[declared];
+  info.confirmations = std::min(info.confirmations + 1, kMinConfirmations);
+  info.uses_since_confirmation = 0;
+}
+
+void LanguageDetectionCache::Clear() {
+  hosts_.Clear();
+}
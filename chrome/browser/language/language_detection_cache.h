@@ -0,0 +1,102 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_LANGUAGE_LANGUAGE_DETECTION_CACHE_H_
+#define IOS_CHROME_BROWSER_LANGUAGE_LANGUAGE_DETECTION_CACHE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/containers/mru_cache.h"
+#include "components/keyed_service/core/keyed_service.h"
+
+// Caches, for each host and language declared by its pages, whether the
+// language detected on these pages matched the declared one. All the tabs of a
+// browser state share the cache, so that the text of the pages of a host that
+// reliably declares its language only has to be extracted and detected a few
+// times. Languages are compared by their primary subtag, e.g. "en" for
+// "en-US".
+class LanguageDetectionCache : public KeyedService {
+ public:
+  // Result of a lookup. These values are persisted to logs. Entries should not
+  // be renumbered and numeric values should never be reused.
+  enum class LookupResult {
+    // No page of the host was detected.
+    kMiss = 0,
+    // Some languages declared by the host are trusted.
+    kHit = 1,
+    // Pages of the host were detected, but the languages they declare are not
+    // confirmed enough times, or need to be confirmed again.
+    kUnconfirmed = 2,
+    kMaxValue = kUnconfirmed,
+  };
+
+  // Number of detections matching a declared language after which it is
+  // trusted.
+  static const int kMinConfirmations;
+
+  // Number of pages whose detection was skipped because they declared a
+  // trusted language, after which the language has to be confirmed by a new
+  // detection, so that the cache follows sites changing their content.
+  static const int kMaxUsesWithoutConfirmation;
+
+  // Number of lookups after which the hit rate is recorded.
+  static const int kLookupsPerHitRateSample;
+
+  // Maximum number of hosts in the cache.
+  static const size_t kMaxHosts;
+
+  LanguageDetectionCache();
+  LanguageDetectionCache(const LanguageDetectionCache&) = delete;
+  LanguageDetectionCache& operator=(const LanguageDetectionCache&) = delete;
+  ~LanguageDetectionCache() override;
+
+  // Returns the primary subtag of |language|, in lower case.
+  static std::string GetPrimaryLanguage(const std::string& language);
+
+  // Returns the languages that the pages of |host| can be trusted to declare,
+  // i.e. whose text does not need to be extracted and detected when they
+  // declare one of them.
+  std::vector<std::string> GetTrustedLanguages(const std::string& host);
+
+  // Updates the cache with the detection of |detected_language| on a page of
+  // |host| declaring |declared_language|, which may be empty. A reliable
+  // detection contradicting a declared language invalidates it. Detections
+  // that are not |reliable| do not confirm anything; if the declared language
+  // is trusted, the text was not extracted and the detection counts as a use
+  // of the language.
+  void OnLanguageDetected(const std::string& host,
+                          const std::string& declared_language,
+                          const std::string& detected_language,
+                          bool reliable);
+
+  // Removes all the entries.
+  void Clear();
+
+ private:
+  // Confidence in a language declared by the pages of a host.
+  struct DeclaredLanguageInfo {
+    // Number of detections that matched the declared language.
+    int confirmations = 0;
+    // Number of pages whose detection was skipped for the language since
+    // its last confirmation.
+    int uses_since_confirmation = 0;
+
+    // Whether the language can be trusted for the pages declaring it.
+    bool IsTrusted() const;
+  };
+
+  // Declared languages of a host, keyed by their primary subtag.
+  using HostInfo = std::map<std::string, DeclaredLanguageInfo>;
+
+  base::MRUCache<std::string, HostInfo> hosts_;
+
+  // Number of lookups and of lookups with a hit since the hit rate was last
+  // recorded.
+  int lookup_count_ = 0;
+  int hit_count_ = 0;
+};
+
+#endif  // IOS_CHROME_BROWSER_LANGUAGE_LANGUAGE_DETECTION_CACHE_H_
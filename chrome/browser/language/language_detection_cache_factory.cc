@@ -0,0 +1,41 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/language/language_detection_cache_factory.h"
+
+#include "components/keyed_service/ios/browser_state_dependency_manager.h"
+#include "ios/chrome/browser/browser_state/browser_state_otr_helper.h"
+#include "ios/chrome/browser/browser_state/chrome_browser_state.h"
+#include "ios/chrome/browser/language/language_detection_cache.h"
+
+// static
+LanguageDetectionCacheFactory* LanguageDetectionCacheFactory::GetInstance() {
+  static base::NoDestructor<LanguageDetectionCacheFactory> instance;
+  return instance.get();
+}
+
+// static
+LanguageDetectionCache* LanguageDetectionCacheFactory::GetForBrowserState(
+    ChromeBrowserState* browser_state) {
+  return static_cast<LanguageDetectionCache*>(
+      GetInstance()->GetServiceForBrowserState(browser_state, true));
+}
+
+LanguageDetectionCacheFactory::LanguageDetectionCacheFactory()
+    : BrowserStateKeyedServiceFactory(
+          "LanguageDetectionCache",
+          BrowserStateDependencyManager::GetInstance()) {}
+
+LanguageDetectionCacheFactory::~LanguageDetectionCacheFactory() = default;
+
+std::unique_ptr<KeyedService>
+LanguageDetectionCacheFactory::BuildServiceInstanceFor(
+    web::BrowserState* context) const {
+  return std::make_unique<LanguageDetectionCache>();
+}
+
+web::BrowserState* LanguageDetectionCacheFactory::GetBrowserStateToUse(
+    web::BrowserState* context) const {
+  return GetBrowserStateOwnInstanceInIncognito(context);
+}
@@ -0,0 +1,42 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_LANGUAGE_LANGUAGE_DETECTION_CACHE_FACTORY_H_
+#define IOS_CHROME_BROWSER_LANGUAGE_LANGUAGE_DETECTION_CACHE_FACTORY_H_
+
+#include <memory>
+
+#include "base/no_destructor.h"
+#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+
+class ChromeBrowserState;
+class KeyedService;
+class LanguageDetectionCache;
+
+// Singleton that owns all LanguageDetectionCaches and associates them with
+// ChromeBrowserState. Off the record browser states have their own cache.
+class LanguageDetectionCacheFactory : public BrowserStateKeyedServiceFactory {
+ public:
+  static LanguageDetectionCacheFactory* GetInstance();
+  static LanguageDetectionCache* GetForBrowserState(
+      ChromeBrowserState* browser_state);
+
+  LanguageDetectionCacheFactory(const LanguageDetectionCacheFactory&) = delete;
+  LanguageDetectionCacheFactory& operator=(
+      const LanguageDetectionCacheFactory&) = delete;
+
+ private:
+  friend class base::NoDestructor<LanguageDetectionCacheFactory>;
+
+  LanguageDetectionCacheFactory();
+  ~LanguageDetectionCacheFactory() override;
+
+  // BrowserStateKeyedServiceFactory implementation.
+  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+      web::BrowserState* context) const override;
+  web::BrowserState* GetBrowserStateToUse(
+      web::BrowserState* context) const override;
+};
+
+#endif  // IOS_CHROME_BROWSER_LANGUAGE_LANGUAGE_DETECTION_CACHE_FACTORY_H_
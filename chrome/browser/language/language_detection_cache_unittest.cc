@@ -0,0 +1,131 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/language/language_detection_cache.h"
+
+#include "base/test/metrics/histogram_tester.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace {
+
+const char kHost[] = "www.example.com";
+const char kLookupHistogram[] = "IOS.Translate.LanguageDetectionCache.Lookup";
+
+}  // namespace
+
+class LanguageDetectionCacheTest : public PlatformTest {
+ protected:
+  // Confirms |language| as declared by the pages of kHost.
+  void Confirm(const std::string& language) {
+    for (int i = 0; i < LanguageDetectionCache::kMinConfirmations; ++i)
+      cache_.OnLanguageDetected(kHost, language, language, /*reliable=*/true);
+  }
+
+  LanguageDetectionCache cache_;
+  base::HistogramTester histogram_tester_;
+};
+
+// Tests that a declared language is trusted once confirmed enough times, and
+// that languages are compared by their primary subtag.
+TEST_F(LanguageDetectionCacheTest, TrustsConfirmedLanguage) {
+  EXPECT_THAT(cache_.GetTrustedLanguages(kHost), IsEmpty());
+  histogram_tester_.ExpectBucketCount(
+      kLookupHistogram, LanguageDetectionCache::LookupResult::kMiss, 1);
+
+  cache_.OnLanguageDetected(kHost, "fr-FR", "fr", /*reliable=*/true);
+  EXPECT_THAT(cache_.GetTrustedLanguages(kHost), IsEmpty());
+  histogram_tester_.ExpectBucketCount(
+      kLookupHistogram, LanguageDetectionCache::LookupResult::kUnconfirmed, 1);
+
+  cache_.OnLanguageDetected(kHost, "FR", "fr", /*reliable=*/true);
+  EXPECT_THAT(cache_.GetTrustedLanguages(kHost), ElementsAre("fr"));
+  histogram_tester_.ExpectBucketCount(
+      kLookupHistogram, LanguageDetectionCache::LookupResult::kHit, 1);
+
+  EXPECT_THAT(cache_.GetTrustedLanguages("other.example.com"), IsEmpty());
+}
+
+// Tests that unreliable detections and pages without declared language are
+// ignored.
+TEST_F(LanguageDetectionCacheTest, IgnoresUnreliableDetections) {
+  for (int i = 0; i < LanguageDetectionCache::kMinConfirmations; ++i) {
+    cache_.OnLanguageDetected(kHost, "fr", "fr", /*reliable=*/false);
+    cache_.OnLanguageDetected(kHost, "", "de", /*reliable=*/true);
+  }
+  EXPECT_THAT(cache_.GetTrustedLanguages(kHost), IsEmpty());
+
+  Confirm("fr");
+  cache_.OnLanguageDetected(kHost, "fr", "de", /*reliable=*/false);
+  EXPECT_THAT(cache_.GetTrustedLanguages(kHost), ElementsAre("fr"));
+}
+
+// Tests that a reliable detection contradicting a declared language
+// invalidates it, without affecting the other languages of the host.
+TEST_F(LanguageDetectionCacheTest, InvalidatesContradictedLanguage) {
+  Confirm("fr");
+  Confirm("de");
+  EXPECT_THAT(cache_.GetTrustedLanguages(kHost), ElementsAre("de", "fr"));
+
+  cache_.OnLanguageDetected(kHost, "fr", "en", /*reliable=*/true);
+  EXPECT_THAT(cache_.GetTrustedLanguages(kHost), ElementsAre("de"));
+  histogram_tester_.ExpectBucketCount(
+      "IOS.Translate.LanguageDetectionCache.DeclaredLanguageConfirmed", false,
+      1);
+}
+
+// Tests that a trusted language has to be confirmed again after the detection
+// of kMaxUsesWithoutConfirmation pages declaring it was skipped, and that
+// lookups do not count as uses.
+TEST_F(LanguageDetectionCacheTest, RequiresPeriodicConfirmation) {
+  Confirm("fr");
+  for (int i = 0; i < LanguageDetectionCache::kMaxUsesWithoutConfirmation;
+       ++i) {
+    EXPECT_THAT(cache_.GetTrustedLanguages(kHost), ElementsAre("fr"));
+    cache_.OnLanguageDetected(kHost, "fr", "", /*reliable=*/false);
+  }
+  EXPECT_THAT(cache_.GetTrustedLanguages(kHost), IsEmpty());
+
+  cache_.OnLanguageDetected(kHost, "fr", "fr", /*reliable=*/true);
+  EXPECT_THAT(cache_.GetTrustedLanguages(kHost), ElementsAre("fr"));
+}
+
+// Tests that skipped detections only count as uses of the language declared by
+// the page.
+TEST_F(LanguageDetectionCacheTest, CountsUsesOfDeclaredLanguage) {
+  Confirm("fr");
+  Confirm("de");
+  for (int i = 0; i < LanguageDetectionCache::kMaxUsesWithoutConfirmation;
+       ++i) {
+    cache_.OnLanguageDetected(kHost, "de", "", /*reliable=*/false);
+  }
+  EXPECT_THAT(cache_.GetTrustedLanguages(kHost), ElementsAre("fr"));
+}
+
+// Tests that the hit rate is recorded every kLookupsPerHitRateSample lookups.
+TEST_F(LanguageDetectionCacheTest, RecordsHitRate) {
+  Confirm("fr");
+  for (int i = 0; i < LanguageDetectionCache::kLookupsPerHitRateSample / 2;
+       ++i) {
+    cache_.GetTrustedLanguages(kHost);
+    cache_.GetTrustedLanguages("other.example.com");
+  }
+  histogram_tester_.ExpectUniqueSample(
+      "IOS.Translate.LanguageDetectionCache.HitRate", 50, 1);
+
+  cache_.GetTrustedLanguages(kHost);
+  histogram_tester_.ExpectTotalCount(
+      "IOS.Translate.LanguageDetectionCache.HitRate", 1);
+}
+
+// Tests that Clear() removes the trusted languages.
+TEST_F(LanguageDetectionCacheTest, Clear) {
+  Confirm("fr");
+  cache_.Clear();
+  EXPECT_THAT(cache_.GetTrustedLanguages(kHost), IsEmpty());
+}
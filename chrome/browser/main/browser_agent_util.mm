@@ -25,6 +25,8 @@
 #import "ios/chrome/browser/url_loading/url_loading_notifier_browser_agent.h"
 #import "ios/chrome/browser/web/web_navigation_browser_agent.h"
 #include "ios/chrome/browser/web_state_list/session_metrics.h"
+#include "ios/chrome/browser/web_state_list/memory_tiering/features.h"
+#import "ios/chrome/browser/web_state_list/memory_tiering/web_state_memory_tiering_browser_agent.h"
 #import "ios/chrome/browser/web_state_list/tab_insertion_browser_agent.h"
 #import "ios/chrome/browser/web_state_list/web_state_list_metrics_browser_agent.h"
 #import "ios/chrome/browser/web_state_list/web_usage_enabler/web_usage_enabler_browser_agent.h"
@@ -56,6 +58,10 @@ void AttachBrowserAgents(Browser* browser) {
   if (!browser->GetBrowserState()->IsOffTheRecord())
     SendTabToSelfBrowserAgent::CreateForBrowser(browser);
 
+  // WebStateMemoryTieringBrowserAgent requires WebUsageEnablerBrowserAgent.
+  if (base::FeatureList::IsEnabled(kWebStateMemoryTiering))
+    WebStateMemoryTieringBrowserAgent::CreateForBrowser(browser);
+
   // UrlLoadingBrowserAgent requires UrlLoadingNotifierBrowserAgent.
   UrlLoadingBrowserAgent::CreateForBrowser(browser);
 
@@ -0,0 +1,15 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/memory/memory_attribution_provider.h"
+
+int64_t MemoryAttributionProvider::EstimateWebStateBytes(
+    Browser* browser,
+    web::WebState* web_state) const {
+  return 0;
+}
+
+int64_t MemoryAttributionProvider::EstimateSharedBytes() const {
+  return 0;
+}
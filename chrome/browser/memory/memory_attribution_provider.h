@@ -0,0 +1,36 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_MEMORY_MEMORY_ATTRIBUTION_PROVIDER_H_
+#define IOS_CHROME_BROWSER_MEMORY_MEMORY_ATTRIBUTION_PROVIDER_H_
+
+#include <stdint.h>
+
+class Browser;
+
+namespace web {
+class WebState;
+}
+
+// Interface of the subsystems reporting their estimated memory cost to the
+// MemoryAttributionSampler. Estimates must be cheap to compute, as they are
+// collected periodically on the main thread.
+class MemoryAttributionProvider {
+ public:
+  virtual ~MemoryAttributionProvider() = default;
+
+  // Name of the subsystem. Used as a histogram suffix, so must not change.
+  virtual const char* GetName() const = 0;
+
+  // Returns the estimated number of bytes used by the subsystem for
+  // |web_state|, which is in |browser|.
+  virtual int64_t EstimateWebStateBytes(Browser* browser,
+                                        web::WebState* web_state) const;
+
+  // Returns the estimated number of bytes used by the subsystem for the
+  // browser state, and not attributable to a single WebState.
+  virtual int64_t EstimateSharedBytes() const;
+};
+
+#endif  // IOS_CHROME_BROWSER_MEMORY_MEMORY_ATTRIBUTION_PROVIDER_H_
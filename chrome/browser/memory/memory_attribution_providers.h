@@ -0,0 +1,26 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_MEMORY_MEMORY_ATTRIBUTION_PROVIDERS_H_
+#define IOS_CHROME_BROWSER_MEMORY_MEMORY_ATTRIBUTION_PROVIDERS_H_
+
+#include <memory>
+#include <vector>
+
+class ChromeBrowserState;
+class MemoryAttributionProvider;
+
+// Returns the providers estimating the memory cost of the snapshots, the large
+// icon cache, the navigation history, the web frames and the overlays of
+// |browser_state|.
+//
+// The memory of the web content itself is out of scope. WKWebView renders and
+// runs the pages in the WebContent and Networking processes. The browser
+// process cannot measure them per WebState, and they are not part of its own
+// footprint. The providers only count the browser process objects backing a
+// WebState, measured from the data exposed by their public API.
+std::vector<std::unique_ptr<MemoryAttributionProvider>>
+CreateDefaultMemoryAttributionProviders(ChromeBrowserState* browser_state);
+
+#endif  // IOS_CHROME_BROWSER_MEMORY_MEMORY_ATTRIBUTION_PROVIDERS_H_
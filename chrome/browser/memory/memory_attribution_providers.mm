@@ -0,0 +1,177 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/memory/memory_attribution_providers.h"
+
+#include <string>
+
+#include "base/trace_event/memory_usage_estimator.h"
+#include "ios/chrome/browser/browser_state/chrome_browser_state.h"
+#include "ios/chrome/browser/favicon/ios_chrome_large_icon_cache_factory.h"
+#include "ios/chrome/browser/favicon/large_icon_cache.h"
+#include "ios/chrome/browser/memory/memory_attribution_provider.h"
+#include "ios/chrome/browser/overlays/overlay_request_impl.h"
+#import "ios/chrome/browser/overlays/overlay_request_queue_impl.h"
+#include "ios/chrome/browser/overlays/public/overlay_modality.h"
+#import "ios/chrome/browser/snapshots/snapshot_browser_agent.h"
+#import "ios/chrome/browser/snapshots/snapshot_cache.h"
+#import "ios/chrome/browser/web/tab_id_tab_helper.h"
+#include "ios/web/public/js_messaging/web_frame.h"
+#include "ios/web/public/js_messaging/web_frames_manager.h"
+#import "ios/web/public/navigation/navigation_item.h"
+#import "ios/web/public/navigation/navigation_manager.h"
+#import "ios/web/public/web_state.h"
+#include "url/gurl.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+// Returns the memory used by |url|, including its heap allocations.
+int64_t GetURLBytes(const GURL& url) {
+  return sizeof(GURL) + base::trace_event::EstimateMemoryUsage(url);
+}
+
+// Returns the memory used by |string|, including its heap allocations.
+template <class StringType>
+int64_t GetStringBytes(const StringType& string) {
+  return sizeof(StringType) + base::trace_event::EstimateMemoryUsage(string);
+}
+
+// The modalities whose queues are attributed to the WebStates.
+const OverlayModality kOverlayModalities[] = {
+    OverlayModality::kWebContentArea,
+    OverlayModality::kInfobarBanner,
+    OverlayModality::kInfobarModal,
+};
+
+// Attributes the images of the SnapshotCache held in memory to their
+// WebState.
+class SnapshotMemoryAttributionProvider : public MemoryAttributionProvider {
+ public:
+  const char* GetName() const override { return "Snapshots"; }
+
+  int64_t EstimateWebStateBytes(Browser* browser,
+                                web::WebState* web_state) const override {
+    SnapshotBrowserAgent* agent = SnapshotBrowserAgent::FromBrowser(browser);
+    TabIdTabHelper* tab_id_helper = TabIdTabHelper::FromWebState(web_state);
+    if (!agent || !agent->snapshot_cache() || !tab_id_helper)
+      return 0;
+    return [agent->snapshot_cache()
+        memoryCostForSnapshotID:tab_id_helper->tab_id()];
+  }
+};
+
+// Attributes the LargeIconCache to the browser state.
+class LargeIconMemoryAttributionProvider : public MemoryAttributionProvider {
+ public:
+  explicit LargeIconMemoryAttributionProvider(
+      ChromeBrowserState* browser_state)
+      : browser_state_(browser_state) {}
+
+  const char* GetName() const override { return "LargeIcons"; }
+
+  int64_t EstimateSharedBytes() const override {
+    LargeIconCache* cache =
+        IOSChromeLargeIconCacheFactory::GetForBrowserState(browser_state_);
+    return cache ? cache->size_in_bytes() : 0;
+  }
+
+ private:
+  ChromeBrowserState* browser_state_;
+};
+
+// Attributes the NavigationItems of a WebState to it. Only the URLs and title
+// of the items are counted, as the other members are not exposed by the public
+// API of //ios/web.
+class NavigationMemoryAttributionProvider : public MemoryAttributionProvider {
+ public:
+  const char* GetName() const override { return "NavigationHistory"; }
+
+  int64_t EstimateWebStateBytes(Browser* browser,
+                                web::WebState* web_state) const override {
+    const web::NavigationManager* navigation_manager =
+        web_state->GetNavigationManager();
+    if (!navigation_manager)
+      return 0;
+
+    int64_t bytes = 0;
+    const int item_count = navigation_manager->GetItemCount();
+    for (int index = 0; index < item_count; ++index) {
+      web::NavigationItem* item = navigation_manager->GetItemAtIndex(index);
+      if (!item)
+        continue;
+      bytes += GetURLBytes(item->GetURL()) +
+               GetURLBytes(item->GetVirtualURL()) +
+               GetURLBytes(item->GetReferrer().url) +
+               GetStringBytes(item->GetTitle());
+    }
+    return bytes;
+  }
+};
+
+// Attributes the WebFrames of a WebState to it. Only the identifier and origin
+// of the frames are counted, as the other members are not exposed by the public
+// API of //ios/web.
+class WebFramesMemoryAttributionProvider : public MemoryAttributionProvider {
+ public:
+  const char* GetName() const override { return "WebFrames"; }
+
+  int64_t EstimateWebStateBytes(Browser* browser,
+                                web::WebState* web_state) const override {
+    web::WebFramesManager* frames_manager = web_state->GetWebFramesManager();
+    if (!frames_manager)
+      return 0;
+    int64_t bytes = 0;
+    for (web::WebFrame* frame : frames_manager->GetAllWebFrames()) {
+      bytes += GetStringBytes(frame->GetFrameId()) +
+               GetURLBytes(frame->GetSecurityOrigin());
+    }
+    return bytes;
+  }
+};
+
+// Attributes the pending OverlayRequests of a WebState to it. The configs of
+// the requests are opaque user data, so only the requests themselves are
+// counted.
+class OverlayMemoryAttributionProvider : public MemoryAttributionProvider {
+ public:
+  const char* GetName() const override { return "Overlays"; }
+
+  int64_t EstimateWebStateBytes(Browser* browser,
+                                web::WebState* web_state) const override {
+    // The queues are looked up without being created, so that sampling does
+    // not allocate queues for the WebStates that never had overlays.
+    OverlayRequestQueueImpl::Container* container =
+        OverlayRequestQueueImpl::Container::FromWebState(web_state);
+    if (!container)
+      return 0;
+    int64_t bytes = 0;
+    for (OverlayModality modality : kOverlayModalities) {
+      OverlayRequestQueueImpl* queue =
+          container->GetExistingQueueForModality(modality);
+      if (queue)
+        bytes += queue->size() * sizeof(OverlayRequestImpl);
+    }
+    return bytes;
+  }
+};
+
+}  // namespace
+
+std::vector<std::unique_ptr<MemoryAttributionProvider>>
+CreateDefaultMemoryAttributionProviders(ChromeBrowserState* browser_state) {
+  std::vector<std::unique_ptr<MemoryAttributionProvider>> providers;
+  providers.push_back(std::make_unique<SnapshotMemoryAttributionProvider>());
+  providers.push_back(
+      std::make_unique<LargeIconMemoryAttributionProvider>(browser_state));
+  providers.push_back(std::make_unique<NavigationMemoryAttributionProvider>());
+  providers.push_back(std::make_unique<WebFramesMemoryAttributionProvider>());
+  providers.push_back(std::make_unique<OverlayMemoryAttributionProvider>());
+  // The web content of the WebStates is not covered: it lives in the WebKit
+  // processes, whose memory WKWebView does not expose per page.
+  return providers;
+}
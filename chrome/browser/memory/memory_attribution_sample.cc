@@ -0,0 +1,69 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/memory/memory_attribution_sample.h"
+
+#include <utility>
+
+#include "base/strings/string_number_conversions.h"
+
+namespace {
+
+// Returns |bytes_by_subsystem| as a dictionary. The sizes are converted to
+// strings, as base::Value can't hold 64-bit integers.
+base::Value BytesBySubsystemToValue(
+    const std::map<std::string, int64_t>& bytes_by_subsystem) {
+  base::Value value(base::Value::Type::DICTIONARY);
+  for (const auto& pair : bytes_by_subsystem)
+    value.SetStringKey(pair.first, base::NumberToString(pair.second));
+  return value;
+}
+
+}  // namespace
+
+MemoryAttributionSample::WebStateCost::WebStateCost() = default;
+
+MemoryAttributionSample::WebStateCost::WebStateCost(const WebStateCost&) =
+    default;
+
+MemoryAttributionSample::WebStateCost::~WebStateCost() = default;
+
+MemoryAttributionSample::MemoryAttributionSample() = default;
+
+MemoryAttributionSample::MemoryAttributionSample(
+    const MemoryAttributionSample&) = default;
+
+MemoryAttributionSample::MemoryAttributionSample(MemoryAttributionSample&&) =
+    default;
+
+MemoryAttributionSample& MemoryAttributionSample::operator=(
+    const MemoryAttributionSample&) = default;
+
+MemoryAttributionSample& MemoryAttributionSample::operator=(
+    MemoryAttributionSample&&) = default;
+
+MemoryAttributionSample::~MemoryAttributionSample() = default;
+
+base::Value MemoryAttributionSample::ToValue() const {
+  base::Value web_state_list(base::Value::Type::LIST);
+  for (const WebStateCost& web_state : web_states) {
+    base::Value web_state_value(base::Value::Type::DICTIONARY);
+    web_state_value.SetStringKey("url", web_state.visible_url.spec());
+    web_state_value.SetStringKey("total_bytes",
+                                 base::NumberToString(web_state.total_bytes));
+    web_state_value.SetKey(
+        "bytes_by_subsystem",
+        BytesBySubsystemToValue(web_state.bytes_by_subsystem));
+    web_state_list.Append(std::move(web_state_value));
+  }
+
+  base::Value value(base::Value::Type::DICTIONARY);
+  value.SetStringKey("total_bytes", base::NumberToString(total_bytes));
+  value.SetKey("bytes_by_subsystem",
+               BytesBySubsystemToValue(bytes_by_subsystem));
+  value.SetKey("shared_bytes_by_subsystem",
+               BytesBySubsystemToValue(shared_bytes_by_subsystem));
+  value.SetKey("web_states", std::move(web_state_list));
+  return value;
+}
@@ -0,0 +1,50 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_MEMORY_MEMORY_ATTRIBUTION_SAMPLE_H_
+#define IOS_CHROME_BROWSER_MEMORY_MEMORY_ATTRIBUTION_SAMPLE_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/values.h"
+#include "url/gurl.h"
+
+// Estimated memory cost of the subsystems of a browser state, at a given
+// time, as reported by the MemoryAttributionProviders.
+struct MemoryAttributionSample {
+  // Estimated memory cost of a WebState.
+  struct WebStateCost {
+    WebStateCost();
+    WebStateCost(const WebStateCost&);
+    ~WebStateCost();
+
+    GURL visible_url;
+    // Bytes attributed to the WebState, keyed by subsystem name.
+    std::map<std::string, int64_t> bytes_by_subsystem;
+    int64_t total_bytes = 0;
+  };
+
+  MemoryAttributionSample();
+  MemoryAttributionSample(const MemoryAttributionSample&);
+  MemoryAttributionSample(MemoryAttributionSample&&);
+  MemoryAttributionSample& operator=(const MemoryAttributionSample&);
+  MemoryAttributionSample& operator=(MemoryAttributionSample&&);
+  ~MemoryAttributionSample();
+
+  // Returns the sample as a dictionary, for debug pages.
+  base::Value ToValue() const;
+
+  std::vector<WebStateCost> web_states;
+  // Bytes not attributable to a single WebState, keyed by subsystem name.
+  std::map<std::string, int64_t> shared_bytes_by_subsystem;
+  // Bytes of the WebStates and shared bytes, keyed by subsystem name.
+  std::map<std::string, int64_t> bytes_by_subsystem;
+  int64_t total_bytes = 0;
+};
+
+#endif  // IOS_CHROME_BROWSER_MEMORY_MEMORY_ATTRIBUTION_SAMPLE_H_
@@ -0,0 +1,70 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_MEMORY_MEMORY_ATTRIBUTION_SAMPLER_H_
+#define IOS_CHROME_BROWSER_MEMORY_MEMORY_ATTRIBUTION_SAMPLER_H_
+
+#include <memory>
+#include <vector>
+
+#include "base/feature_list.h"
+#include "base/sequence_checker.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "components/keyed_service/core/keyed_service.h"
+#include "ios/chrome/browser/memory/memory_attribution_sample.h"
+
+class ChromeBrowserState;
+class MemoryAttributionProvider;
+
+// Feature enabling the periodic sampling of the estimated memory cost of the
+// WebStates and subsystems.
+extern const base::Feature kMemoryAttributionSampling;
+
+// Periodically collects the memory cost estimated by the registered
+// MemoryAttributionProviders for each WebState of the browsers of a browser
+// state, and reports it to UMA. The last sample is shown on
+// chrome://memory-internals.
+class MemoryAttributionSampler : public KeyedService {
+ public:
+  // Interval between two samples.
+  static const base::TimeDelta kSamplingInterval;
+
+  explicit MemoryAttributionSampler(ChromeBrowserState* browser_state);
+
+  MemoryAttributionSampler(const MemoryAttributionSampler&) = delete;
+  MemoryAttributionSampler& operator=(const MemoryAttributionSampler&) =
+      delete;
+
+  ~MemoryAttributionSampler() override;
+
+  // Registers |provider|. Must be called before sampling starts.
+  void AddProvider(std::unique_ptr<MemoryAttributionProvider> provider);
+
+  // Starts taking and recording a sample every |kSamplingInterval|.
+  void StartSampling();
+
+  // Collects the estimates of the providers for the browsers of the browser
+  // state.
+  MemoryAttributionSample TakeSample() const;
+
+  // Returns the last sample recorded, or an empty one if none was.
+  const MemoryAttributionSample& last_sample() const { return last_sample_; }
+
+  // KeyedService:
+  void Shutdown() override;
+
+ private:
+  // Takes a sample, records it to UMA and keeps it as |last_sample_|.
+  void TakeAndRecordSample();
+
+  ChromeBrowserState* browser_state_;
+  std::vector<std::unique_ptr<MemoryAttributionProvider>> providers_;
+  MemoryAttributionSample last_sample_;
+  base::RepeatingTimer timer_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+#endif  // IOS_CHROME_BROWSER_MEMORY_MEMORY_ATTRIBUTION_SAMPLER_H_
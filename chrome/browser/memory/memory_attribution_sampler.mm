@@ -0,0 +1,122 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/memory/memory_attribution_sampler.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/check.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/strings/strcat.h"
+#include "ios/chrome/browser/browser_state/chrome_browser_state.h"
+#import "ios/chrome/browser/main/browser.h"
+#import "ios/chrome/browser/main/browser_list.h"
+#import "ios/chrome/browser/main/browser_list_factory.h"
+#include "ios/chrome/browser/memory/memory_attribution_provider.h"
+#import "ios/chrome/browser/web_state_list/web_state_list.h"
+#import "ios/web/public/web_state.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+const base::Feature kMemoryAttributionSampling{
+    "MemoryAttributionSampling", base::FEATURE_DISABLED_BY_DEFAULT};
+
+// static
+const base::TimeDelta MemoryAttributionSampler::kSamplingInterval =
+    base::TimeDelta::FromMinutes(5);
+
+MemoryAttributionSampler::MemoryAttributionSampler(
+    ChromeBrowserState* browser_state)
+    : browser_state_(browser_state) {
+  DCHECK(browser_state_);
+}
+
+MemoryAttributionSampler::~MemoryAttributionSampler() = default;
+
+void MemoryAttributionSampler::AddProvider(
+    std::unique_ptr<MemoryAttributionProvider> provider) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  DCHECK(!timer_.IsRunning());
+  providers_.push_back(std::move(provider));
+}
+
+void MemoryAttributionSampler::StartSampling() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (timer_.IsRunning())
+    return;
+  timer_.Start(FROM_HERE, kSamplingInterval,
+               base::BindRepeating(
+                   &MemoryAttributionSampler::TakeAndRecordSample,
+                   base::Unretained(this)));
+}
+
+MemoryAttributionSample MemoryAttributionSampler::TakeSample() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  MemoryAttributionSample sample;
+
+  BrowserList* browser_list =
+      BrowserListFactory::GetForBrowserState(browser_state_);
+  const std::set<Browser*> browsers =
+      browser_state_->IsOffTheRecord() ? browser_list->AllIncognitoBrowsers()
+                                       : browser_list->AllRegularBrowsers();
+  for (Browser* browser : browsers) {
+    WebStateList* web_state_list = browser->GetWebStateList();
+    for (int index = 0; index < web_state_list->count(); ++index) {
+      web::WebState* web_state = web_state_list->GetWebStateAt(index);
+      MemoryAttributionSample::WebStateCost cost;
+      cost.visible_url = web_state->GetVisibleURL();
+      for (const auto& provider : providers_) {
+        const int64_t bytes =
+            provider->EstimateWebStateBytes(browser, web_state);
+        cost.bytes_by_subsystem[provider->GetName()] = bytes;
+        cost.total_bytes += bytes;
+        sample.bytes_by_subsystem[provider->GetName()] += bytes;
+      }
+      sample.total_bytes += cost.total_bytes;
+      sample.web_states.push_back(std::move(cost));
+    }
+  }
+
+  for (const auto& provider : providers_) {
+    const int64_t bytes = provider->EstimateSharedBytes();
+    sample.shared_bytes_by_subsystem[provider->GetName()] = bytes;
+    sample.bytes_by_subsystem[provider->GetName()] += bytes;
+    sample.total_bytes += bytes;
+  }
+  return sample;
+}
+
+void MemoryAttributionSampler::Shutdown() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  timer_.Stop();
+  providers_.clear();
+}
+
+void MemoryAttributionSampler::TakeAndRecordSample() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  last_sample_ = TakeSample();
+
+  for (const auto& pair : last_sample_.bytes_by_subsystem) {
+    base::UmaHistogramMemoryKB(
+        base::StrCat({"IOS.MemoryAttribution.", pair.first}),
+        pair.second / 1024);
+  }
+  base::UmaHistogramMemoryKB("IOS.MemoryAttribution.Total",
+                             last_sample_.total_bytes / 1024);
+
+  int64_t largest_web_state_bytes = 0;
+  for (const auto& cost : last_sample_.web_states) {
+    largest_web_state_bytes =
+        std::max(largest_web_state_bytes, cost.total_bytes);
+  }
+  if (!last_sample_.web_states.empty()) {
+    base::UmaHistogramMemoryKB("IOS.MemoryAttribution.LargestWebState",
+                               largest_web_state_bytes / 1024);
+  }
+}
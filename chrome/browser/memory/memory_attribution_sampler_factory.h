@@ -0,0 +1,40 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_MEMORY_MEMORY_ATTRIBUTION_SAMPLER_FACTORY_H_
+#define IOS_CHROME_BROWSER_MEMORY_MEMORY_ATTRIBUTION_SAMPLER_FACTORY_H_
+
+#include <memory>
+
+#include "base/no_destructor.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
+
+class ChromeBrowserState;
+class MemoryAttributionSampler;
+
+// Singleton that creates all MemoryAttributionSampler instances and associates
+// them with ChromeBrowserState. Incognito browser states have their own
+// sampler, covering the incognito browsers.
+class MemoryAttributionSamplerFactory
+    : public AuditedBrowserStateKeyedServiceFactory {
+ public:
+  static MemoryAttributionSampler* GetForBrowserState(
+      ChromeBrowserState* browser_state);
+
+  static MemoryAttributionSamplerFactory* GetInstance();
+
+ private:
+  friend class base::NoDestructor<MemoryAttributionSamplerFactory>;
+
+  MemoryAttributionSamplerFactory();
+  ~MemoryAttributionSamplerFactory() override;
+
+  // AuditedBrowserStateKeyedServiceFactory implementation.
+  std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
+      web::BrowserState* context) const override;
+  web::BrowserState* GetBrowserStateToUse(
+      web::BrowserState* context) const override;
+};
+
+#endif  // IOS_CHROME_BROWSER_MEMORY_MEMORY_ATTRIBUTION_SAMPLER_FACTORY_H_
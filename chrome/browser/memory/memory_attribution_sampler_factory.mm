@@ -0,0 +1,60 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/memory/memory_attribution_sampler_factory.h"
+
+#include <utility>
+
+#include "components/keyed_service/ios/browser_state_dependency_manager.h"
+#include "ios/chrome/browser/browser_state/browser_state_otr_helper.h"
+#include "ios/chrome/browser/browser_state/chrome_browser_state.h"
+#include "ios/chrome/browser/favicon/ios_chrome_large_icon_cache_factory.h"
+#import "ios/chrome/browser/main/browser_list_factory.h"
+#include "ios/chrome/browser/memory/memory_attribution_provider.h"
+#import "ios/chrome/browser/memory/memory_attribution_providers.h"
+#import "ios/chrome/browser/memory/memory_attribution_sampler.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+// static
+MemoryAttributionSampler* MemoryAttributionSamplerFactory::GetForBrowserState(
+    ChromeBrowserState* browser_state) {
+  return static_cast<MemoryAttributionSampler*>(
+      GetInstance()->GetServiceForBrowserState(browser_state, true));
+}
+
+// static
+MemoryAttributionSamplerFactory*
+MemoryAttributionSamplerFactory::GetInstance() {
+  static base::NoDestructor<MemoryAttributionSamplerFactory> instance;
+  return instance.get();
+}
+
+MemoryAttributionSamplerFactory::MemoryAttributionSamplerFactory()
+    : AuditedBrowserStateKeyedServiceFactory(
+          "MemoryAttributionSampler",
+          BrowserStateDependencyManager::GetInstance()) {
+  DependsOn(BrowserListFactory::GetInstance());
+  DependsOn(IOSChromeLargeIconCacheFactory::GetInstance());
+}
+
+MemoryAttributionSamplerFactory::~MemoryAttributionSamplerFactory() = default;
+
+std::unique_ptr<KeyedService>
+MemoryAttributionSamplerFactory::BuildAuditedServiceInstanceFor(
+    web::BrowserState* context) const {
+  ChromeBrowserState* browser_state =
+      ChromeBrowserState::FromBrowserState(context);
+  auto sampler = std::make_unique<MemoryAttributionSampler>(browser_state);
+  for (auto& provider : CreateDefaultMemoryAttributionProviders(browser_state))
+    sampler->AddProvider(std::move(provider));
+  return sampler;
+}
+
+web::BrowserState* MemoryAttributionSamplerFactory::GetBrowserStateToUse(
+    web::BrowserState* context) const {
+  return GetBrowserStateOwnInstanceInContext(context);
+}
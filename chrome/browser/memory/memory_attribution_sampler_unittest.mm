@@ -0,0 +1,201 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/memory/memory_attribution_sampler.h"
+
+#include <string>
+#include <vector>
+
+#include "base/test/metrics/histogram_tester.h"
+#include "base/test/task_environment.h"
+#include "ios/chrome/browser/browser_state/test_chrome_browser_state.h"
+#import "ios/chrome/browser/main/browser_list.h"
+#import "ios/chrome/browser/main/browser_list_factory.h"
+#import "ios/chrome/browser/main/test_browser.h"
+#include "ios/chrome/browser/memory/memory_attribution_provider.h"
+#include "ios/chrome/browser/memory/memory_attribution_providers.h"
+#import "ios/chrome/browser/overlays/overlay_request_queue_impl.h"
+#include "ios/chrome/browser/overlays/public/overlay_request.h"
+#import "ios/chrome/browser/overlays/public/overlay_request_queue.h"
+#include "ios/chrome/browser/overlays/test/fake_overlay_user_data.h"
+#import "ios/chrome/browser/web_state_list/web_state_list.h"
+#import "ios/chrome/browser/web_state_list/web_state_opener.h"
+#import "ios/web/public/test/fakes/fake_web_state.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+// A provider attributing a fixed cost to each WebState, and to the browser
+// state.
+class FakeMemoryAttributionProvider : public MemoryAttributionProvider {
+ public:
+  FakeMemoryAttributionProvider(const char* name,
+                                int64_t web_state_bytes,
+                                int64_t shared_bytes)
+      : name_(name),
+        web_state_bytes_(web_state_bytes),
+        shared_bytes_(shared_bytes) {}
+
+  const char* GetName() const override { return name_; }
+
+  int64_t EstimateWebStateBytes(Browser* browser,
+                                web::WebState* web_state) const override {
+    return web_state_bytes_;
+  }
+
+  int64_t EstimateSharedBytes() const override { return shared_bytes_; }
+
+ private:
+  const char* name_;
+  const int64_t web_state_bytes_;
+  const int64_t shared_bytes_;
+};
+
+}  // namespace
+
+class MemoryAttributionSamplerTest : public PlatformTest {
+ protected:
+  MemoryAttributionSamplerTest() {
+    browser_state_ = TestChromeBrowserState::Builder().Build();
+    browser_list_ =
+        BrowserListFactory::GetForBrowserState(browser_state_.get());
+  }
+
+  // Returns a sampler for |browser_state| with two fake providers.
+  std::unique_ptr<MemoryAttributionSampler> CreateSampler(
+      ChromeBrowserState* browser_state) {
+    auto sampler = std::make_unique<MemoryAttributionSampler>(browser_state);
+    sampler->AddProvider(
+        std::make_unique<FakeMemoryAttributionProvider>("A", 1024, 0));
+    sampler->AddProvider(
+        std::make_unique<FakeMemoryAttributionProvider>("B", 2048, 4096));
+    return sampler;
+  }
+
+  void AppendWebState(Browser* browser, const GURL& url) {
+    auto web_state = std::make_unique<web::FakeWebState>();
+    web_state->SetVisibleURL(url);
+    browser->GetWebStateList()->InsertWebState(
+        WebStateList::kInvalidIndex, std::move(web_state),
+        WebStateList::INSERT_NO_FLAGS, WebStateOpener());
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  std::unique_ptr<TestChromeBrowserState> browser_state_;
+  BrowserList* browser_list_;
+};
+
+// Tests that the estimates are aggregated per WebState and per subsystem,
+// across the regular browsers.
+TEST_F(MemoryAttributionSamplerTest, TakeSample) {
+  TestBrowser browser_1(browser_state_.get());
+  TestBrowser browser_2(browser_state_.get());
+  browser_list_->AddBrowser(&browser_1);
+  browser_list_->AddBrowser(&browser_2);
+  AppendWebState(&browser_1, GURL("https://a.test/"));
+  AppendWebState(&browser_2, GURL("https://b.test/"));
+
+  std::unique_ptr<MemoryAttributionSampler> sampler =
+      CreateSampler(browser_state_.get());
+  MemoryAttributionSample sample = sampler->TakeSample();
+
+  ASSERT_EQ(2u, sample.web_states.size());
+  for (const auto& cost : sample.web_states) {
+    EXPECT_EQ(1024, cost.bytes_by_subsystem.at("A"));
+    EXPECT_EQ(2048, cost.bytes_by_subsystem.at("B"));
+    EXPECT_EQ(3072, cost.total_bytes);
+  }
+  EXPECT_EQ(4096, sample.shared_bytes_by_subsystem.at("B"));
+  EXPECT_EQ(2048, sample.bytes_by_subsystem.at("A"));
+  EXPECT_EQ(8192, sample.bytes_by_subsystem.at("B"));
+  EXPECT_EQ(10240, sample.total_bytes);
+
+  sampler->Shutdown();
+}
+
+// Tests that the sampler of the incognito browser state only covers the
+// incognito browsers.
+TEST_F(MemoryAttributionSamplerTest, IncognitoBrowsers) {
+  ChromeBrowserState* incognito_browser_state =
+      browser_state_->GetOffTheRecordChromeBrowserState();
+  TestBrowser regular_browser(browser_state_.get());
+  TestBrowser incognito_browser(incognito_browser_state);
+  browser_list_->AddBrowser(&regular_browser);
+  browser_list_->AddIncognitoBrowser(&incognito_browser);
+  AppendWebState(&regular_browser, GURL("https://a.test/"));
+  AppendWebState(&incognito_browser, GURL("https://b.test/"));
+
+  std::unique_ptr<MemoryAttributionSampler> sampler =
+      CreateSampler(incognito_browser_state);
+  MemoryAttributionSample sample = sampler->TakeSample();
+
+  ASSERT_EQ(1u, sample.web_states.size());
+  EXPECT_EQ(GURL("https://b.test/"), sample.web_states[0].visible_url);
+
+  sampler->Shutdown();
+}
+
+// Tests that the samples are recorded periodically once sampling starts.
+TEST_F(MemoryAttributionSamplerTest, RecordsPeriodically) {
+  TestBrowser browser(browser_state_.get());
+  browser_list_->AddBrowser(&browser);
+  AppendWebState(&browser, GURL("https://a.test/"));
+
+  base::HistogramTester histogram_tester;
+  std::unique_ptr<MemoryAttributionSampler> sampler =
+      CreateSampler(browser_state_.get());
+  sampler->StartSampling();
+  EXPECT_TRUE(sampler->last_sample().web_states.empty());
+
+  task_environment_.FastForwardBy(MemoryAttributionSampler::kSamplingInterval);
+  EXPECT_EQ(1u, sampler->last_sample().web_states.size());
+  histogram_tester.ExpectUniqueSample("IOS.MemoryAttribution.A", 1, 1);
+  histogram_tester.ExpectUniqueSample("IOS.MemoryAttribution.B", 6, 1);
+  histogram_tester.ExpectUniqueSample("IOS.MemoryAttribution.Total", 7, 1);
+  histogram_tester.ExpectUniqueSample("IOS.MemoryAttribution.LargestWebState",
+                                      3, 1);
+
+  task_environment_.FastForwardBy(MemoryAttributionSampler::kSamplingInterval);
+  histogram_tester.ExpectTotalCount("IOS.MemoryAttribution.Total", 2);
+
+  sampler->Shutdown();
+  task_environment_.FastForwardBy(MemoryAttributionSampler::kSamplingInterval);
+  histogram_tester.ExpectTotalCount("IOS.MemoryAttribution.Total", 2);
+}
+
+// Tests that the default providers do not create the overlay queues of the
+// WebStates they sample, but attribute the requests of the existing queues.
+TEST_F(MemoryAttributionSamplerTest, DefaultProvidersDoNotCreateOverlayQueues) {
+  TestBrowser browser(browser_state_.get());
+  web::FakeWebState web_state;
+  std::vector<std::unique_ptr<MemoryAttributionProvider>> providers =
+      CreateDefaultMemoryAttributionProviders(browser_state_.get());
+  for (const auto& provider : providers)
+    EXPECT_EQ(0, provider->EstimateWebStateBytes(&browser, &web_state));
+  EXPECT_FALSE(OverlayRequestQueueImpl::Container::FromWebState(&web_state));
+
+  OverlayRequestQueue::FromWebState(&web_state, OverlayModality::kInfobarBanner)
+      ->AddRequest(OverlayRequest::CreateWithConfig<FakeOverlayUserData>());
+  int64_t overlay_bytes = 0;
+  for (const auto& provider : providers) {
+    if (std::string(provider->GetName()) == "Overlays")
+      overlay_bytes = provider->EstimateWebStateBytes(&browser, &web_state);
+  }
+  EXPECT_GT(overlay_bytes, 0);
+
+  // Verify that only the queue of the banner modality was created.
+  OverlayRequestQueueImpl::Container* container =
+      OverlayRequestQueueImpl::Container::FromWebState(&web_state);
+  ASSERT_TRUE(container);
+  EXPECT_FALSE(container->GetExistingQueueForModality(
+      OverlayModality::kWebContentArea));
+  EXPECT_FALSE(
+      container->GetExistingQueueForModality(OverlayModality::kInfobarModal));
+}
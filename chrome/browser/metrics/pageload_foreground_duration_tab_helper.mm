@@ -7,6 +7,7 @@
 #import <UIKit/UIKit.h>
 
 #include "components/ukm/ios/ukm_url_recorder.h"
+#include "ios/chrome/browser/metrics/startup_tracer.h"
 #import "ios/web/public/navigation/navigation_context.h"
 #include "services/metrics/public/cpp/ukm_builders.h"
 
@@ -104,6 +105,16 @@ void PageloadForegroundDurationTabHelper::DidFinishNavigation(
   }
 }
 
+void PageloadForegroundDurationTabHelper::PageLoaded(
+    web::WebState* web_state,
+    web::PageLoadCompletionStatus load_completion_status) {
+  DCHECK_EQ(web_state_, web_state);
+  // The first page loaded in a visible tab ends the cold start.
+  if (!web_state_->IsVisible())
+    return;
+  StartupTracer::GetInstance()->CompleteStartup("FirstWebStateLoad");
+}
+
 void PageloadForegroundDurationTabHelper::RenderProcessGone(
     web::WebState* web_state) {
   DCHECK_EQ(web_state_, web_state);
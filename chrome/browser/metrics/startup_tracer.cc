@@ -0,0 +1,204 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/metrics/startup_tracer.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/check_op.h"
+#include "base/files/file_util.h"
+#include "base/json/json_writer.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/no_destructor.h"
+#include "base/process/process_handle.h"
+#include "base/strings/string_util.h"
+#include "base/task/thread_pool.h"
+#include "base/values.h"
+
+namespace {
+
+// Category of the exported trace events.
+const char kTraceEventCategory[] = "startup";
+
+// Prefix of the histograms recording the duration of each span.
+const char kPhaseHistogramPrefix[] = "IOS.Startup.Phase.";
+
+// Phases whose spans are reported to UMA. The other spans, such as the ones of
+// deferred initialization blocks and keyed services, are named at runtime, so
+// they are only exported in the trace to keep the set of histograms bounded.
+const char* const kReportedPhases[] = {
+    "PreCreateThreads",        "PreMainMessageLoopRun", "CreateBrowserState",
+    "DeserializeWebStateList", "FirstWebStateLoad",
+};
+
+// Whether the spans named |name| are reported to UMA.
+bool IsReportedPhase(const char* name) {
+  return std::any_of(
+      std::begin(kReportedPhases), std::end(kReportedPhases),
+      [name](const char* phase) { return strcmp(phase, name) == 0; });
+}
+
+// Writes |json| to |path|. Runs on a background sequence.
+void WriteTraceToFile(const base::FilePath& path, const std::string& json) {
+  base::WriteFile(path, json);
+}
+
+}  // namespace
+
+// static
+constexpr size_t StartupTracer::kMaxSpans;
+// static
+constexpr size_t StartupTracer::kMaxNameLength;
+
+StartupTracer::ScopedSpan::ScopedSpan(const char* name)
+    : name_(name), start_(base::TimeTicks::Now()) {}
+
+StartupTracer::ScopedSpan::~ScopedSpan() {
+  StartupTracer::GetInstance()->RecordSpan(name_, start_,
+                                           base::TimeTicks::Now());
+}
+
+StartupTracer::StartupTracer() : process_start_time_(base::TimeTicks::Now()) {}
+
+StartupTracer::~StartupTracer() = default;
+
+// static
+StartupTracer* StartupTracer::GetInstance() {
+  static base::NoDestructor<StartupTracer> instance;
+  return instance.get();
+}
+
+void StartupTracer::SetProcessStartTime(base::TimeTicks process_start_time) {
+  base::AutoLock auto_lock(lock_);
+  process_start_time_ = process_start_time;
+}
+
+void StartupTracer::SetExportPath(const base::FilePath& path) {
+  base::AutoLock auto_lock(lock_);
+  export_path_ = path;
+}
+
+void StartupTracer::RecordSpan(const char* name,
+                               base::TimeTicks start,
+                               base::TimeTicks end) {
+  DCHECK(name);
+  DCHECK_LE(start, end);
+  if (startup_complete_.load(std::memory_order_relaxed))
+    return;
+
+  base::AutoLock auto_lock(lock_);
+  if (span_count_ == kMaxSpans) {
+    ++dropped_span_count_;
+    return;
+  }
+
+  Span& span = spans_[span_count_++];
+  base::strlcpy(span.name, name, kMaxNameLength);
+  span.thread_id = base::PlatformThread::CurrentId();
+  span.start = start;
+  span.end = end;
+}
+
+void StartupTracer::CompleteStartup(const char* name) {
+  if (IsStartupComplete())
+    return;
+
+  base::TimeTicks process_start_time;
+  {
+    base::AutoLock auto_lock(lock_);
+    process_start_time = process_start_time_;
+  }
+  RecordSpan(name, process_start_time, base::TimeTicks::Now());
+  if (startup_complete_.exchange(true))
+    return;
+
+  ReportSpansToUma();
+
+  base::FilePath export_path;
+  std::vector<base::OnceClosure> callbacks;
+  {
+    base::AutoLock auto_lock(lock_);
+    export_path = export_path_;
+    std::swap(callbacks, startup_complete_callbacks_);
+  }
+
+  if (!export_path.empty()) {
+    base::ThreadPool::PostTask(
+        FROM_HERE, {base::MayBlock(), base::TaskPriority::BEST_EFFORT},
+        base::BindOnce(&WriteTraceToFile, export_path,
+                       ExportAsTraceEventJson()));
+  }
+
+  for (base::OnceClosure& callback : callbacks)
+    std::move(callback).Run();
+}
+
+bool StartupTracer::IsStartupComplete() const {
+  return startup_complete_.load();
+}
+
+void StartupTracer::AddStartupCompleteCallback(base::OnceClosure callback) {
+  {
+    base::AutoLock auto_lock(lock_);
+    if (!IsStartupComplete()) {
+      startup_complete_callbacks_.push_back(std::move(callback));
+      return;
+    }
+  }
+  std::move(callback).Run();
+}
+
+std::vector<StartupTracer::Span> StartupTracer::GetSpans() const {
+  base::AutoLock auto_lock(lock_);
+  return std::vector<Span>(spans_.begin(), spans_.begin() + span_count_);
+}
+
+size_t StartupTracer::GetDroppedSpanCount() const {
+  base::AutoLock auto_lock(lock_);
+  return dropped_span_count_;
+}
+
+std::string StartupTracer::ExportAsTraceEventJson() const {
+  const int process_id = static_cast<int>(base::GetCurrentProcId());
+
+  base::Value trace_events(base::Value::Type::LIST);
+  for (const Span& span : GetSpans()) {
+    base::Value event(base::Value::Type::DICTIONARY);
+    event.SetStringKey("name", span.name);
+    event.SetStringKey("cat", kTraceEventCategory);
+    // Complete event, with both a timestamp and a duration.
+    event.SetStringKey("ph", "X");
+    event.SetDoubleKey(
+        "ts", (span.start - base::TimeTicks()).InMicrosecondsF());
+    event.SetDoubleKey("dur", (span.end - span.start).InMicrosecondsF());
+    event.SetIntKey("pid", process_id);
+    event.SetIntKey("tid", static_cast<int>(span.thread_id));
+    trace_events.Append(std::move(event));
+  }
+
+  base::Value trace(base::Value::Type::DICTIONARY);
+  trace.SetKey("traceEvents", std::move(trace_events));
+  trace.SetStringKey("displayTimeUnit", "ms");
+
+  std::string json;
+  base::JSONWriter::Write(trace, &json);
+  return json;
+}
+
+void StartupTracer::ReportSpansToUma() const {
+  // Percentiles of each phase are computed server side from these samples.
+  for (const Span& span : GetSpans()) {
+    if (!IsReportedPhase(span.name))
+      continue;
+    base::UmaHistogramTimes(std::string(kPhaseHistogramPrefix) + span.name,
+                            span.end - span.start);
+  }
+  base::UmaHistogramCounts100("IOS.Startup.DroppedSpans",
+                              static_cast<int>(GetDroppedSpanCount()));
+}
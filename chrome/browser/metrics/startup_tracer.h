@@ -0,0 +1,118 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_METRICS_STARTUP_TRACER_H_
+#define IOS_CHROME_BROWSER_METRICS_STARTUP_TRACER_H_
+
+#include <stddef.h>
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+
+// Records named spans covering the phases of a cold start, from any thread,
+// into a buffer allocated once. When startup completes, the duration of the
+// spans of a fixed set of phases is reported to UMA under
+// "IOS.Startup.Phase.<name>", and all the spans can be exported in the Chrome
+// trace event JSON format to be loaded in chrome://tracing or Perfetto.
+class StartupTracer {
+ public:
+  // Maximum number of spans recorded. Further spans are dropped.
+  static constexpr size_t kMaxSpans = 128;
+
+  // Maximum length of a span name, including the terminating null character.
+  // Longer names are truncated.
+  static constexpr size_t kMaxNameLength = 64;
+
+  struct Span {
+    char name[kMaxNameLength] = {};
+    base::PlatformThreadId thread_id = base::kInvalidThreadId;
+    base::TimeTicks start;
+    base::TimeTicks end;
+  };
+
+  // Records a span covering its own lifetime.
+  class ScopedSpan {
+   public:
+    explicit ScopedSpan(const char* name);
+    ~ScopedSpan();
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+   private:
+    const char* const name_;
+    const base::TimeTicks start_;
+  };
+
+  StartupTracer();
+  ~StartupTracer();
+
+  StartupTracer(const StartupTracer&) = delete;
+  StartupTracer& operator=(const StartupTracer&) = delete;
+
+  // Returns the tracer used for the current process.
+  static StartupTracer* GetInstance();
+
+  // Sets the time at which the process started. Defaults to the time the
+  // tracer was created.
+  void SetProcessStartTime(base::TimeTicks process_start_time);
+
+  // Sets the file to which the trace is written when startup completes. The
+  // trace is not written if |path| is empty.
+  void SetExportPath(const base::FilePath& path);
+
+  // Records a span for |name| between |start| and |end| on the calling thread.
+  // Does nothing once startup has completed.
+  void RecordSpan(const char* name, base::TimeTicks start, base::TimeTicks end);
+
+  // Records a span for |name| from the process start time until now, then
+  // marks startup as completed: spans are reported to UMA, the trace is
+  // written to the export path, and no further span is recorded. Does nothing
+  // if startup already completed.
+  void CompleteStartup(const char* name);
+
+  // Whether |CompleteStartup()| has been called.
+  bool IsStartupComplete() const;
+
+  // Adds |callback| to be run on the thread calling |CompleteStartup()| once
+  // startup completes. Runs |callback| immediately if startup already
+  // completed.
+  void AddStartupCompleteCallback(base::OnceClosure callback);
+
+  // Returns a copy of the spans recorded so far.
+  std::vector<Span> GetSpans() const;
+
+  // Number of spans dropped because the buffer was full.
+  size_t GetDroppedSpanCount() const;
+
+  // Returns the recorded spans as a trace event JSON object.
+  std::string ExportAsTraceEventJson() const;
+
+ private:
+  // Reports the duration of the recorded spans of the reported phases to UMA.
+  void ReportSpansToUma() const;
+
+  // Set once startup has completed. Read without holding |lock_| so that
+  // recording spans after startup is cheap.
+  std::atomic<bool> startup_complete_{false};
+
+  mutable base::Lock lock_;
+  base::TimeTicks process_start_time_ GUARDED_BY(lock_);
+  base::FilePath export_path_ GUARDED_BY(lock_);
+  std::array<Span, kMaxSpans> spans_ GUARDED_BY(lock_);
+  size_t span_count_ GUARDED_BY(lock_) = 0;
+  size_t dropped_span_count_ GUARDED_BY(lock_) = 0;
+  std::vector<base::OnceClosure> startup_complete_callbacks_ GUARDED_BY(lock_);
+};
+
+#endif  // IOS_CHROME_BROWSER_METRICS_STARTUP_TRACER_H_
@@ -0,0 +1,90 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/metrics/startup_tracer.h"
+
+#include <string>
+
+#include "base/json/json_reader.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+using StartupTracerTest = PlatformTest;
+
+// Tests that spans are recorded with the calling thread id.
+TEST_F(StartupTracerTest, RecordSpan) {
+  StartupTracer tracer;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  const base::TimeTicks end = start + base::TimeDelta::FromMilliseconds(5);
+  tracer.RecordSpan("PreCreateThreads", start, end);
+
+  std::vector<StartupTracer::Span> spans = tracer.GetSpans();
+  ASSERT_EQ(1U, spans.size());
+  EXPECT_EQ(std::string("PreCreateThreads"), spans[0].name);
+  EXPECT_EQ(base::PlatformThread::CurrentId(), spans[0].thread_id);
+  EXPECT_EQ(start, spans[0].start);
+  EXPECT_EQ(end, spans[0].end);
+}
+
+// Tests that spans are dropped once the buffer is full.
+TEST_F(StartupTracerTest, DropsSpansWhenFull) {
+  StartupTracer tracer;
+  const base::TimeTicks now = base::TimeTicks::Now();
+  for (size_t i = 0; i < StartupTracer::kMaxSpans + 3; ++i)
+    tracer.RecordSpan("Phase", now, now);
+
+  EXPECT_EQ(StartupTracer::kMaxSpans, tracer.GetSpans().size());
+  EXPECT_EQ(3U, tracer.GetDroppedSpanCount());
+}
+
+// Tests that completing startup reports the spans of the known phases to UMA
+// and stops recording.
+TEST_F(StartupTracerTest, CompleteStartup) {
+  base::HistogramTester histogram_tester;
+  StartupTracer tracer;
+  const base::TimeTicks start = base::TimeTicks::Now();
+  tracer.SetProcessStartTime(start - base::TimeDelta::FromSeconds(1));
+  tracer.RecordSpan("PreCreateThreads", start,
+                    start + base::TimeDelta::FromMilliseconds(20));
+  tracer.RecordSpan("Deferred.Block", start, start);
+
+  tracer.CompleteStartup("FirstWebStateLoad");
+  EXPECT_TRUE(tracer.IsStartupComplete());
+  histogram_tester.ExpectUniqueTimeSample(
+      "IOS.Startup.Phase.PreCreateThreads",
+      base::TimeDelta::FromMilliseconds(20), 1);
+  histogram_tester.ExpectTotalCount("IOS.Startup.Phase.FirstWebStateLoad", 1);
+  histogram_tester.ExpectTotalCount("IOS.Startup.Phase.Deferred.Block", 0);
+
+  tracer.RecordSpan("Late", start, start);
+  tracer.CompleteStartup("FirstWebStateLoad");
+  EXPECT_EQ(3U, tracer.GetSpans().size());
+  histogram_tester.ExpectTotalCount("IOS.Startup.Phase.FirstWebStateLoad", 1);
+}
+
+// Tests that the exported trace uses the trace event format.
+TEST_F(StartupTracerTest, ExportAsTraceEventJson) {
+  StartupTracer tracer;
+  const base::TimeTicks start = base::TimeTicks() +
+                                base::TimeDelta::FromMicroseconds(1000);
+  tracer.RecordSpan("DeserializeWebStateList", start,
+                    start + base::TimeDelta::FromMicroseconds(250));
+
+  absl::optional<base::Value> trace =
+      base::JSONReader::Read(tracer.ExportAsTraceEventJson());
+  ASSERT_TRUE(trace && trace->is_dict());
+  const base::Value* events = trace->FindListKey("traceEvents");
+  ASSERT_TRUE(events);
+  ASSERT_EQ(1U, events->GetList().size());
+
+  const base::Value& event = events->GetList()[0];
+  EXPECT_EQ("DeserializeWebStateList", *event.FindStringKey("name"));
+  EXPECT_EQ("X", *event.FindStringKey("ph"));
+  EXPECT_EQ(1000, *event.FindDoubleKey("ts"));
+  EXPECT_EQ(250, *event.FindDoubleKey("dur"));
+  EXPECT_EQ(static_cast<int>(base::PlatformThread::CurrentId()),
+            *event.FindIntKey("tid"));
+}
@@ -5,7 +5,9 @@
 #ifndef IOS_CHROME_BROWSER_OVERLAYS_OVERLAY_PRESENTER_IMPL_H_
 #define IOS_CHROME_BROWSER_OVERLAYS_OVERLAY_PRESENTER_IMPL_H_
 
+#include <memory>
 #include <set>
+#include <vector>
 
 #include "base/memory/weak_ptr.h"
 #include "base/scoped_observation.h"
@@ -126,6 +128,9 @@ class OverlayPresenterImpl : public BrowserObserver,
   void OverlayRequestRemoved(OverlayRequestQueueImpl* queue,
                              std::unique_ptr<OverlayRequest> request,
                              bool cancelled) override;
+  void OverlayRequestsCancelled(
+      OverlayRequestQueueImpl* queue,
+      std::vector<std::unique_ptr<OverlayRequest>> requests) override;
   void OverlayRequestQueueWillReplaceDelegate(
       OverlayRequestQueueImpl* queue) override;
 
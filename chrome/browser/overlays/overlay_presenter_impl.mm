@@ -417,6 +417,24 @@ void OverlayPresenterImpl::OverlayRequestRemoved(
     CancelOverlayUIForRequest(removed_request);
 }
 
+void OverlayPresenterImpl::OverlayRequestsCancelled(
+    OverlayRequestQueueImpl* queue,
+    std::vector<std::unique_ptr<OverlayRequest>> requests) {
+  // Only the former front request, at the back of |requests|, or a request
+  // whose UI is still being dismissed can have overlay UI.  The other requests
+  // were never presented, so they are destroyed without cancelling their UI.
+  OverlayRequest* former_front_request =
+      requests.empty() ? nullptr : requests.back().get();
+  for (auto& request : requests) {
+    if (request.get() == former_front_request ||
+        request.get() == presented_request_) {
+      OverlayRequestRemoved(queue, std::move(request), /*cancelled=*/true);
+    } else {
+      request.reset();
+    }
+  }
+}
+
 void OverlayPresenterImpl::OverlayRequestQueueWillReplaceDelegate(
     OverlayRequestQueueImpl* queue) {
   if (!presented_request_ || presented_request_ != queue->front_request())
@@ -11,7 +11,8 @@ std::unique_ptr<OverlayRequest> OverlayRequest::Create() {
   return std::make_unique<OverlayRequestImpl>();
 }
 
-OverlayRequestImpl::OverlayRequestImpl() {}
+OverlayRequestImpl::OverlayRequestImpl()
+    : config_types_(OverlayUserDataTypeSet::TrackTypes(this)) {}
 
 OverlayRequestImpl::~OverlayRequestImpl() {
   callback_manager_.ExecuteCompletionCallbacks();
@@ -25,6 +26,10 @@ web::WebState* OverlayRequestImpl::GetQueueWebState() {
   return queue_web_state_;
 }
 
+const OverlayUserDataTypeSet& OverlayRequestImpl::GetConfigTypes() {
+  return *config_types_;
+}
+
 base::SupportsUserData* OverlayRequestImpl::data() {
   return this;
 }
@@ -19,6 +19,7 @@ class OverlayRequestImpl : public OverlayRequest,
   // OverlayRequest:
   OverlayCallbackManager* GetCallbackManager() override;
   web::WebState* GetQueueWebState() override;
+  const OverlayUserDataTypeSet& GetConfigTypes() override;
   base::SupportsUserData* data() override;
 
  private:
@@ -31,6 +32,9 @@ class OverlayRequestImpl : public OverlayRequest,
   }
 
   web::WebState* queue_web_state_ = nullptr;
+  // The types of the configs added to the request's user data, owned by the
+  // user data.
+  const OverlayUserDataTypeSet* config_types_ = nullptr;
   OverlayCallbackManagerImpl callback_manager_;
 };
 
@@ -7,16 +7,22 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 
 #include "base/containers/circular_deque.h"
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
 #include "base/observer_list_types.h"
+#include "base/time/time.h"
 #include "ios/chrome/browser/overlays/public/overlay_modality.h"
 #import "ios/chrome/browser/overlays/public/overlay_request_queue.h"
 #include "ios/web/public/web_state_observer.h"
 #import "ios/web/public/web_state_user_data.h"
 
+namespace base {
+class TickClock;
+}
+
 // Mutable implementation of OverlayRequestQueue.
 class OverlayRequestQueueImpl : public OverlayRequestQueue {
  public:
@@ -31,6 +37,10 @@ class OverlayRequestQueueImpl : public OverlayRequestQueue {
     ~Container() override;
     // Returns the request queue for |modality|.
     OverlayRequestQueueImpl* QueueForModality(OverlayModality modality);
+    // Returns the request queue for |modality| if it was already created, or
+    // nullptr otherwise.  Used by clients that must not create queues.
+    OverlayRequestQueueImpl* GetExistingQueueForModality(
+        OverlayModality modality) const;
 
    private:
     friend class web::WebStateUserData<Container>;
@@ -50,6 +60,13 @@ class OverlayRequestQueueImpl : public OverlayRequestQueue {
     virtual void OverlayRequestRemoved(OverlayRequestQueueImpl* queue,
                                        std::unique_ptr<OverlayRequest> request,
                                        bool cancelled) = 0;
+    // Called when |requests| are removed together from |queue| by
+    // CancelAllRequests(), ordered from the back of the queue to its front.
+    // The queue is already empty when this is called.  The default
+    // implementation calls OverlayRequestRemoved() for each request.
+    virtual void OverlayRequestsCancelled(
+        OverlayRequestQueueImpl* queue,
+        std::vector<std::unique_ptr<OverlayRequest>> requests);
     // Called when the queue is about to replace the existing delegate.
     virtual void OverlayRequestQueueWillReplaceDelegate(
         OverlayRequestQueueImpl* queue) = 0;
@@ -85,6 +102,9 @@ class OverlayRequestQueueImpl : public OverlayRequestQueue {
   // request to queue's delegate.  Must be called on a non-empty queue.
   void PopFrontRequest();
 
+  // Sets the clock used to enforce the rate limit.
+  void SetTickClockForTesting(const base::TickClock* tick_clock);
+
   // OverlayRequestQueue:
   size_t size() const override;
   OverlayRequest* front_request() const override;
@@ -96,8 +116,18 @@ class OverlayRequestQueueImpl : public OverlayRequestQueue {
                      std::unique_ptr<OverlayRequest> request,
                      std::unique_ptr<OverlayRequestCancelHandler>
                          cancel_handler = nullptr) override;
+  void AddRequestWithPriority(std::unique_ptr<OverlayRequest> request,
+                              Priority priority,
+                              std::unique_ptr<OverlayRequestCancelHandler>
+                                  cancel_handler = nullptr) override;
   void CancelAllRequests() override;
+  void SetRateLimit(size_t max_requests, base::TimeDelta interval) override;
   void CancelRequest(OverlayRequest* request) override;
+  void AddOrReplaceRequestWithConfig(
+      const void* config_key,
+      std::unique_ptr<OverlayRequest> request,
+      Priority priority,
+      std::unique_ptr<OverlayRequestCancelHandler> cancel_handler) override;
 
  private:
   // Helper object that stores OverlayRequests along with their cancellation
@@ -105,12 +135,14 @@ class OverlayRequestQueueImpl : public OverlayRequestQueue {
   struct OverlayRequestStorage {
     OverlayRequestStorage(
         std::unique_ptr<OverlayRequest> request,
-        std::unique_ptr<OverlayRequestCancelHandler> cancel_handler);
+        std::unique_ptr<OverlayRequestCancelHandler> cancel_handler,
+        Priority priority);
     OverlayRequestStorage(OverlayRequestStorage&& storage);
     ~OverlayRequestStorage();
 
     std::unique_ptr<OverlayRequest> request;
     std::unique_ptr<OverlayRequestCancelHandler> cancel_handler;
+    Priority priority;
   };
 
   // Private constructor called by container.
@@ -121,12 +153,36 @@ class OverlayRequestQueueImpl : public OverlayRequestQueue {
   // handler or by a call to CancelAllRequests().
   void RemoveRequest(size_t index, bool cancelled);
 
+  // Returns the index closest to |preferred_index| at which a request of
+  // |priority| keeps the waiting requests sorted by decreasing priority.  The
+  // returned index is never 0 on a non-empty queue.
+  size_t GetInsertionIndex(Priority priority, size_t preferred_index) const;
+
+  // Inserts |request| at |index| with |priority| and notifies the observers.
+  // |index| must keep the waiting requests sorted.
+  void InsertRequestWithPriority(
+      size_t index,
+      std::unique_ptr<OverlayRequest> request,
+      std::unique_ptr<OverlayRequestCancelHandler> cancel_handler,
+      Priority priority);
+
+  // Returns whether a request of |priority| added to the queue is within the
+  // rate limit, counting it as added if so.
+  bool ConsumeRateLimit(Priority priority);
+
   web::WebState* web_state_ = nullptr;
   Delegate* delegate_ = nullptr;
   base::ObserverList<Observer, /* check_empty= */ true> observers_;
   // The queue used to hold the received requests.  Stored as a circular dequeue
   // to allow performant pop events from the front of the queue.
   base::circular_deque<OverlayRequestStorage> request_storages_;
+  // The rate limit of the queue, disabled if |max_requests_per_interval_| is 0,
+  // and the number of requests added since the start of the current interval.
+  size_t max_requests_per_interval_ = 0;
+  base::TimeDelta rate_limit_interval_;
+  base::TimeTicks rate_limit_interval_start_;
+  size_t requests_in_interval_ = 0;
+  const base::TickClock* tick_clock_ = nullptr;
   base::WeakPtrFactory<OverlayRequestQueueImpl> weak_factory_;
 };
 
@@ -4,10 +4,12 @@
 
 #import "ios/chrome/browser/overlays/overlay_request_queue_impl.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "base/check_op.h"
 #include "base/memory/ptr_util.h"
+#include "base/time/default_tick_clock.h"
 #import "ios/chrome/browser/overlays/default_overlay_request_cancel_handler.h"
 #include "ios/chrome/browser/overlays/overlay_request_impl.h"
 #include "ios/chrome/browser/overlays/public/overlay_request.h"
@@ -41,6 +43,13 @@ OverlayRequestQueueImpl* OverlayRequestQueueImpl::Container::QueueForModality(
   return queue.get();
 }
 
+OverlayRequestQueueImpl*
+OverlayRequestQueueImpl::Container::GetExistingQueueForModality(
+    OverlayModality modality) const {
+  auto iter = queues_.find(modality);
+  return iter == queues_.end() ? nullptr : iter->second.get();
+}
+
 #pragma mark - OverlayRequestQueueImpl
 
 OverlayRequestQueueImpl* OverlayRequestQueueImpl::FromWebState(
@@ -52,7 +61,9 @@ OverlayRequestQueueImpl* OverlayRequestQueueImpl::FromWebState(
 }
 
 OverlayRequestQueueImpl::OverlayRequestQueueImpl(web::WebState* web_state)
-    : web_state_(web_state), weak_factory_(this) {}
+    : web_state_(web_state),
+      tick_clock_(base::DefaultTickClock::GetInstance()),
+      weak_factory_(this) {}
 
 OverlayRequestQueueImpl::~OverlayRequestQueueImpl() {
   for (auto& observer : observers_) {
@@ -87,6 +98,11 @@ void OverlayRequestQueueImpl::PopFrontRequest() {
   RemoveRequest(/*index=*/0, /*cancelled=*/false);
 }
 
+void OverlayRequestQueueImpl::SetTickClockForTesting(
+    const base::TickClock* tick_clock) {
+  tick_clock_ = tick_clock;
+}
+
 #pragma mark OverlayRequestQueue
 
 size_t OverlayRequestQueueImpl::size() const {
@@ -105,7 +121,8 @@ OverlayRequest* OverlayRequestQueueImpl::GetRequest(size_t index) const {
 void OverlayRequestQueueImpl::AddRequest(
     std::unique_ptr<OverlayRequest> request,
     std::unique_ptr<OverlayRequestCancelHandler> cancel_handler) {
-  InsertRequest(size(), std::move(request), std::move(cancel_handler));
+  AddRequestWithPriority(std::move(request), Priority::kDefault,
+                         std::move(cancel_handler));
 }
 
 void OverlayRequestQueueImpl::InsertRequest(
@@ -114,27 +131,60 @@ void OverlayRequestQueueImpl::InsertRequest(
     std::unique_ptr<OverlayRequestCancelHandler> cancel_handler) {
   DCHECK_LE(index, size());
   DCHECK(request.get());
-  // Create the cancel handler if necessary.
-  if (!cancel_handler) {
-    cancel_handler = std::make_unique<DefaultOverlayRequestCancelHandler>(
-        request.get(), this, web_state_);
-  }
-  static_cast<OverlayRequestImpl*>(request.get())
-      ->set_queue_web_state(web_state_);
-  request_storages_.emplace(request_storages_.begin() + index,
-                            std::move(request), std::move(cancel_handler));
-  for (auto& observer : observers_) {
-    observer.RequestAddedToQueue(this, request_storages_[index].request.get(),
-                                 index);
+  if (!ConsumeRateLimit(Priority::kDefault))
+    return;
+  // The caller picks the position of the request, so its priority is adjusted
+  // to the requests around |index| to keep the waiting requests sorted.
+  Priority priority = Priority::kDefault;
+  if (index == 0 && size() > 1) {
+    // The front request is about to wait behind |request|, ahead of the other
+    // waiting requests.
+    OverlayRequestStorage& front_storage = request_storages_[0];
+    front_storage.priority =
+        std::max(front_storage.priority, request_storages_[1].priority);
   }
+  if (index > 0 && index < size())
+    priority = std::max(priority, request_storages_[index].priority);
+  if (index > 1)
+    priority = std::min(priority, request_storages_[index - 1].priority);
+  InsertRequestWithPriority(index, std::move(request),
+                            std::move(cancel_handler), priority);
+}
+
+void OverlayRequestQueueImpl::AddRequestWithPriority(
+    std::unique_ptr<OverlayRequest> request,
+    Priority priority,
+    std::unique_ptr<OverlayRequestCancelHandler> cancel_handler) {
+  DCHECK(request.get());
+  if (!ConsumeRateLimit(priority))
+    return;
+  InsertRequestWithPriority(GetInsertionIndex(priority, size()),
+                            std::move(request), std::move(cancel_handler),
+                            priority);
 }
 
 void OverlayRequestQueueImpl::CancelAllRequests() {
-  while (size()) {
-    // Requests are cancelled in reverse order to prevent attempting to present
-    // subsequent requests after the dismissal of the front request's UI.
-    RemoveRequest(/*index=*/size() - 1, /*cancelled=*/true);
+  if (!size())
+    return;
+  // Requests are cancelled in reverse order to prevent attempting to present
+  // subsequent requests after the dismissal of the front request's UI.  The
+  // queue is emptied before the delegate is notified once for all requests.
+  std::vector<std::unique_ptr<OverlayRequest>> requests;
+  requests.reserve(size());
+  for (auto iter = request_storages_.rbegin(); iter != request_storages_.rend();
+       ++iter) {
+    requests.push_back(std::move(iter->request));
   }
+  request_storages_.clear();
+  if (delegate_)
+    delegate_->OverlayRequestsCancelled(this, std::move(requests));
+}
+
+void OverlayRequestQueueImpl::SetRateLimit(size_t max_requests,
+                                           base::TimeDelta interval) {
+  DCHECK(!max_requests || interval > base::TimeDelta());
+  max_requests_per_interval_ = max_requests;
+  rate_limit_interval_ = interval;
 }
 
 void OverlayRequestQueueImpl::CancelRequest(OverlayRequest* request) {
@@ -146,6 +196,32 @@ void OverlayRequestQueueImpl::CancelRequest(OverlayRequest* request) {
   }
 }
 
+void OverlayRequestQueueImpl::AddOrReplaceRequestWithConfig(
+    const void* config_key,
+    std::unique_ptr<OverlayRequest> request,
+    Priority priority,
+    std::unique_ptr<OverlayRequestCancelHandler> cancel_handler) {
+  DCHECK(request.get());
+  // The front request is never replaced, as its UI may be presented.
+  for (size_t index = 1; index < size(); ++index) {
+    OverlayRequest* queued_request = request_storages_[index].request.get();
+    if (!static_cast<OverlayRequestImpl*>(queued_request)
+             ->data()
+             ->GetUserData(config_key)) {
+      continue;
+    }
+    // The replacement does not grow the queue, so it is not counted against
+    // the rate limit.
+    RemoveRequest(index, /*cancelled=*/true);
+    InsertRequestWithPriority(GetInsertionIndex(priority, index),
+                              std::move(request), std::move(cancel_handler),
+                              priority);
+    return;
+  }
+  AddRequestWithPriority(std::move(request), priority,
+                         std::move(cancel_handler));
+}
+
 #pragma mark Private
 
 void OverlayRequestQueueImpl::RemoveRequest(size_t index, bool cancelled) {
@@ -157,16 +233,81 @@ void OverlayRequestQueueImpl::RemoveRequest(size_t index, bool cancelled) {
     delegate_->OverlayRequestRemoved(this, std::move(request), cancelled);
 }
 
+size_t OverlayRequestQueueImpl::GetInsertionIndex(
+    Priority priority,
+    size_t preferred_index) const {
+  size_t index = std::min(preferred_index, size());
+  // Requests are never inserted ahead of the front request.
+  if (!index && size())
+    index = 1;
+  while (index > 1 && request_storages_[index - 1].priority < priority)
+    --index;
+  while (index < size() && request_storages_[index].priority > priority)
+    ++index;
+  return index;
+}
+
+void OverlayRequestQueueImpl::InsertRequestWithPriority(
+    size_t index,
+    std::unique_ptr<OverlayRequest> request,
+    std::unique_ptr<OverlayRequestCancelHandler> cancel_handler,
+    Priority priority) {
+  DCHECK_LE(index, size());
+  DCHECK(request.get());
+  // Create the cancel handler if necessary.
+  if (!cancel_handler) {
+    cancel_handler = std::make_unique<DefaultOverlayRequestCancelHandler>(
+        request.get(), this, web_state_);
+  }
+  static_cast<OverlayRequestImpl*>(request.get())
+      ->set_queue_web_state(web_state_);
+  request_storages_.emplace(request_storages_.begin() + index,
+                            std::move(request), std::move(cancel_handler),
+                            priority);
+  for (auto& observer : observers_) {
+    observer.RequestAddedToQueue(this, request_storages_[index].request.get(),
+                                 index);
+  }
+}
+
+bool OverlayRequestQueueImpl::ConsumeRateLimit(Priority priority) {
+  if (!max_requests_per_interval_ || priority == Priority::kHigh)
+    return true;
+  base::TimeTicks now = tick_clock_->NowTicks();
+  if (now - rate_limit_interval_start_ >= rate_limit_interval_) {
+    rate_limit_interval_start_ = now;
+    requests_in_interval_ = 0;
+  }
+  if (requests_in_interval_ == max_requests_per_interval_)
+    return false;
+  ++requests_in_interval_;
+  return true;
+}
+
+#pragma mark OverlayRequestQueueImpl::Delegate
+
+void OverlayRequestQueueImpl::Delegate::OverlayRequestsCancelled(
+    OverlayRequestQueueImpl* queue,
+    std::vector<std::unique_ptr<OverlayRequest>> requests) {
+  for (auto& request : requests) {
+    OverlayRequestRemoved(queue, std::move(request), /*cancelled=*/true);
+  }
+}
+
 #pragma mark OverlayRequestStorage
 
 OverlayRequestQueueImpl::OverlayRequestStorage::OverlayRequestStorage(
     std::unique_ptr<OverlayRequest> request,
-    std::unique_ptr<OverlayRequestCancelHandler> cancel_handler)
-    : request(std::move(request)), cancel_handler(std::move(cancel_handler)) {}
+    std::unique_ptr<OverlayRequestCancelHandler> cancel_handler,
+    Priority priority)
+    : request(std::move(request)),
+      cancel_handler(std::move(cancel_handler)),
+      priority(priority) {}
 
 OverlayRequestQueueImpl::OverlayRequestStorage::OverlayRequestStorage(
     OverlayRequestQueueImpl::OverlayRequestStorage&& storage)
     : request(std::move(storage.request)),
-      cancel_handler(std::move(storage.cancel_handler)) {}
+      cancel_handler(std::move(storage.cancel_handler)),
+      priority(storage.priority) {}
 
 OverlayRequestQueueImpl::OverlayRequestStorage::~OverlayRequestStorage() {}
@@ -6,10 +6,14 @@
 
 #include <vector>
 
+#include "base/bind.h"
+#include "base/test/simple_test_tick_clock.h"
+#include "ios/chrome/browser/overlays/public/overlay_callback_manager.h"
 #include "ios/chrome/browser/overlays/public/overlay_request.h"
 #import "ios/chrome/browser/overlays/public/overlay_request_cancel_handler.h"
 #include "ios/chrome/browser/overlays/test/fake_overlay_request_cancel_handler.h"
 #include "ios/chrome/browser/overlays/test/fake_overlay_user_data.h"
+#include "ios/chrome/browser/overlays/test/overlay_test_macros.h"
 #import "ios/web/public/test/fakes/fake_web_state.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/platform_test.h"
@@ -18,7 +22,15 @@
 #error "This file requires ARC support."
 #endif
 
+using testing::_;
+
 namespace {
+// Number of requests added by the stress tests, e.g. by an abusive page.
+const size_t kStressRequestCount = 10000;
+
+// Config used to test the coalescing of requests.
+DEFINE_TEST_OVERLAY_REQUEST_CONFIG(CoalescedConfig);
+
 // Fake queue delegate.  Keeps ownership of all requests removed from a queue,
 // recording whether the requests were removed for cancellation.
 class FakeOverlayRequestQueueImplDelegate
@@ -31,6 +43,16 @@ class FakeOverlayRequestQueueImplDelegate
                              std::unique_ptr<OverlayRequest> request,
                              bool cancelled) override {
     removed_requests_.emplace_back(std::move(request), cancelled);
+    if (cancelled)
+      ++cancelled_request_count_;
+  }
+
+  void OverlayRequestsCancelled(
+      OverlayRequestQueueImpl* queue,
+      std::vector<std::unique_ptr<OverlayRequest>> requests) override {
+    ++bulk_cancellation_count_;
+    OverlayRequestQueueImpl::Delegate::OverlayRequestsCancelled(
+        queue, std::move(requests));
   }
 
   void OverlayRequestQueueWillReplaceDelegate(
@@ -47,6 +69,12 @@ class FakeOverlayRequestQueueImplDelegate
     return storage && storage->cancelled;
   }
 
+  // The number of requests removed from the queue for cancellation.
+  size_t cancelled_request_count() const { return cancelled_request_count_; }
+
+  // The number of calls to OverlayRequestsCancelled().
+  size_t bulk_cancellation_count() const { return bulk_cancellation_count_; }
+
  private:
   // Stores the removed requests and whether the requests were cancelled.
   struct RemovedRequestStorage {
@@ -75,6 +103,8 @@ class FakeOverlayRequestQueueImplDelegate
   // delegated.  Keeps ownership of removed requests and whether they were
   // cancelled.
   std::vector<RemovedRequestStorage> removed_requests_;
+  size_t cancelled_request_count_ = 0;
+  size_t bulk_cancellation_count_ = 0;
 };
 // Mock queue observer.
 class MockOverlayRequestQueueImplObserver
@@ -97,6 +127,10 @@ class NoOpCancelHandler : public OverlayRequestCancelHandler {
       : OverlayRequestCancelHandler(request, queue) {}
   ~NoOpCancelHandler() override = default;
 };
+// Completion callback setting |*completed| to true.
+void SetCompleted(bool* completed, OverlayResponse* response) {
+  *completed = true;
+}
 }  // namespace
 
 // Test fixture for RequestQueueImpl.
@@ -132,6 +166,47 @@ class OverlayRequestQueueImplTest : public PlatformTest {
     return request;
   }
 
+  // Adds a request without checking the observer callbacks.
+  OverlayRequest* AddUncheckedRequest() {
+    std::unique_ptr<OverlayRequest> passed_request =
+        OverlayRequest::CreateWithConfig<FakeOverlayUserData>();
+    OverlayRequest* request = passed_request.get();
+    queue()->AddRequest(std::move(passed_request));
+    return request;
+  }
+
+  // Adds a request with |priority| without checking the observer callbacks.
+  OverlayRequest* AddRequestWithPriority(
+      OverlayRequestQueue::Priority priority) {
+    std::unique_ptr<OverlayRequest> passed_request =
+        OverlayRequest::CreateWithConfig<FakeOverlayUserData>();
+    OverlayRequest* request = passed_request.get();
+    queue()->AddRequestWithPriority(std::move(passed_request), priority);
+    return request;
+  }
+
+  // Inserts a request at |index| without checking the observer callbacks.
+  OverlayRequest* InsertUncheckedRequest(size_t index) {
+    std::unique_ptr<OverlayRequest> passed_request =
+        OverlayRequest::CreateWithConfig<FakeOverlayUserData>();
+    OverlayRequest* request = passed_request.get();
+    queue()->InsertRequest(index, std::move(passed_request));
+    return request;
+  }
+
+  // Adds a request configured with a CoalescedConfig through
+  // AddOrReplaceRequest() without checking the observer callbacks.
+  OverlayRequest* AddOrReplaceRequest(
+      OverlayRequestQueue::Priority priority =
+          OverlayRequestQueue::Priority::kDefault) {
+    std::unique_ptr<OverlayRequest> passed_request =
+        OverlayRequest::CreateWithConfig<CoalescedConfig>();
+    OverlayRequest* request = passed_request.get();
+    queue()->AddOrReplaceRequest<CoalescedConfig>(std::move(passed_request),
+                                                  priority);
+    return request;
+  }
+
  protected:
   FakeOverlayRequestQueueImplDelegate delegate_;
   MockOverlayRequestQueueImplObserver observer_;
@@ -217,6 +292,238 @@ TEST_F(OverlayRequestQueueImplTest, CancelAllRequests) {
   EXPECT_EQ(0U, queue()->size());
   EXPECT_TRUE(delegate_.WasRequestCancelled(first_request));
   EXPECT_TRUE(delegate_.WasRequestCancelled(second_request));
+  // Verify that the delegate was notified once for both requests.
+  EXPECT_EQ(1U, delegate_.bulk_cancellation_count());
+}
+
+// Tests that requests added with a priority are queued behind the requests of
+// the same or higher priorities, without preempting the front request.
+TEST_F(OverlayRequestQueueImplTest, AddRequestWithPriority) {
+  EXPECT_CALL(observer(), RequestAddedToQueue(queue(), _, _)).Times(5);
+  OverlayRequest* front_request =
+      AddRequestWithPriority(OverlayRequestQueue::Priority::kLow);
+  OverlayRequest* low_request =
+      AddRequestWithPriority(OverlayRequestQueue::Priority::kLow);
+  OverlayRequest* default_request =
+      AddRequestWithPriority(OverlayRequestQueue::Priority::kDefault);
+  OverlayRequest* first_high_request =
+      AddRequestWithPriority(OverlayRequestQueue::Priority::kHigh);
+  OverlayRequest* second_high_request =
+      AddRequestWithPriority(OverlayRequestQueue::Priority::kHigh);
+
+  ASSERT_EQ(5U, queue()->size());
+  EXPECT_EQ(front_request, queue()->GetRequest(0));
+  EXPECT_EQ(first_high_request, queue()->GetRequest(1));
+  EXPECT_EQ(second_high_request, queue()->GetRequest(2));
+  EXPECT_EQ(default_request, queue()->GetRequest(3));
+  EXPECT_EQ(low_request, queue()->GetRequest(4));
+}
+
+// Tests that InsertRequest() keeps the waiting requests sorted by priority,
+// including when the front request is moved behind the inserted one.
+TEST_F(OverlayRequestQueueImplTest, InsertRequestKeepsPriorityOrder) {
+  EXPECT_CALL(observer(), RequestAddedToQueue(queue(), _, _)).Times(7);
+  OverlayRequest* front_request =
+      AddRequestWithPriority(OverlayRequestQueue::Priority::kLow);
+  OverlayRequest* first_high_request =
+      AddRequestWithPriority(OverlayRequestQueue::Priority::kHigh);
+  OverlayRequest* low_request =
+      AddRequestWithPriority(OverlayRequestQueue::Priority::kLow);
+
+  // The request inserted between a high and a low priority request takes the
+  // default priority, so a default priority request is added behind it.
+  OverlayRequest* inserted_request = InsertUncheckedRequest(2);
+  OverlayRequest* default_request =
+      AddRequestWithPriority(OverlayRequestQueue::Priority::kDefault);
+
+  // The former front request stays ahead of the waiting requests.
+  OverlayRequest* new_front_request = InsertUncheckedRequest(0);
+  OverlayRequest* second_high_request =
+      AddRequestWithPriority(OverlayRequestQueue::Priority::kHigh);
+
+  ASSERT_EQ(7U, queue()->size());
+  EXPECT_EQ(new_front_request, queue()->GetRequest(0));
+  EXPECT_EQ(front_request, queue()->GetRequest(1));
+  EXPECT_EQ(first_high_request, queue()->GetRequest(2));
+  EXPECT_EQ(second_high_request, queue()->GetRequest(3));
+  EXPECT_EQ(inserted_request, queue()->GetRequest(4));
+  EXPECT_EQ(default_request, queue()->GetRequest(5));
+  EXPECT_EQ(low_request, queue()->GetRequest(6));
+}
+
+// Tests that AddOrReplaceRequest() replaces the waiting request with the same
+// config, but not the front request.
+TEST_F(OverlayRequestQueueImplTest, AddOrReplaceRequest) {
+  EXPECT_CALL(observer(), RequestAddedToQueue(queue(), _, _)).Times(4);
+  OverlayRequest* front_request = AddOrReplaceRequest();
+  OverlayRequest* replaced_request = AddOrReplaceRequest();
+  OverlayRequest* other_request = AddUncheckedRequest();
+  ASSERT_EQ(3U, queue()->size());
+  ASSERT_EQ(replaced_request, queue()->GetRequest(1));
+
+  OverlayRequest* request = AddOrReplaceRequest();
+  EXPECT_EQ(3U, queue()->size());
+  EXPECT_EQ(front_request, queue()->GetRequest(0));
+  EXPECT_EQ(request, queue()->GetRequest(1));
+  EXPECT_EQ(other_request, queue()->GetRequest(2));
+  EXPECT_TRUE(delegate_.WasRequestCancelled(replaced_request));
+  EXPECT_FALSE(delegate_.WasRequestRemoved(front_request));
+}
+
+// Tests that the requests added or replacing a waiting request through
+// AddOrReplaceRequest() are queued according to their priority.
+TEST_F(OverlayRequestQueueImplTest, AddOrReplaceRequestKeepsPriorityOrder) {
+  EXPECT_CALL(observer(), RequestAddedToQueue(queue(), _, _)).Times(5);
+  OverlayRequest* front_request = AddUncheckedRequest();
+  OverlayRequest* low_request =
+      AddRequestWithPriority(OverlayRequestQueue::Priority::kLow);
+
+  // Verify that a request that replaces nothing is queued ahead of the
+  // waiting requests of lower priorities.
+  OverlayRequest* replaced_request = AddOrReplaceRequest();
+  OverlayRequest* default_request = AddUncheckedRequest();
+  ASSERT_EQ(4U, queue()->size());
+  EXPECT_EQ(replaced_request, queue()->GetRequest(1));
+  EXPECT_EQ(default_request, queue()->GetRequest(2));
+  EXPECT_EQ(low_request, queue()->GetRequest(3));
+
+  // Verify that a replacing request of lower priority moves behind the
+  // requests of higher priority.
+  OverlayRequest* request =
+      AddOrReplaceRequest(OverlayRequestQueue::Priority::kLow);
+  ASSERT_EQ(4U, queue()->size());
+  EXPECT_EQ(front_request, queue()->GetRequest(0));
+  EXPECT_EQ(default_request, queue()->GetRequest(1));
+  EXPECT_EQ(request, queue()->GetRequest(2));
+  EXPECT_EQ(low_request, queue()->GetRequest(3));
+  EXPECT_TRUE(delegate_.WasRequestCancelled(replaced_request));
+}
+
+// Tests that the requests added beyond the rate limit are dropped, except
+// those of high priority, until the next interval.
+TEST_F(OverlayRequestQueueImplTest, RateLimit) {
+  base::SimpleTestTickClock clock;
+  clock.SetNowTicks(base::TimeTicks::Now());
+  queue()->SetTickClockForTesting(&clock);
+  queue()->SetRateLimit(/*max_requests=*/2, base::TimeDelta::FromSeconds(1));
+
+  EXPECT_CALL(observer(), RequestAddedToQueue(queue(), _, _)).Times(4);
+  AddRequestWithPriority(OverlayRequestQueue::Priority::kDefault);
+  AddRequestWithPriority(OverlayRequestQueue::Priority::kDefault);
+
+  // Verify that the next request is dropped, executing its completion
+  // callbacks.
+  bool dropped_request_completed = false;
+  std::unique_ptr<OverlayRequest> dropped_request =
+      OverlayRequest::CreateWithConfig<FakeOverlayUserData>();
+  dropped_request->GetCallbackManager()->AddCompletionCallback(
+      base::BindOnce(&SetCompleted, &dropped_request_completed));
+  queue()->AddRequest(std::move(dropped_request));
+  EXPECT_EQ(2U, queue()->size());
+  EXPECT_TRUE(dropped_request_completed);
+
+  // Verify that high priority requests are not limited.
+  AddRequestWithPriority(OverlayRequestQueue::Priority::kHigh);
+  EXPECT_EQ(3U, queue()->size());
+
+  // Verify that requests can be added again after the interval.
+  clock.Advance(base::TimeDelta::FromSeconds(1));
+  AddRequestWithPriority(OverlayRequestQueue::Priority::kLow);
+  EXPECT_EQ(4U, queue()->size());
+}
+
+// Tests that the requests replacing a waiting request are not counted against
+// the rate limit.
+TEST_F(OverlayRequestQueueImplTest, RateLimitIgnoresReplacements) {
+  base::SimpleTestTickClock clock;
+  clock.SetNowTicks(base::TimeTicks::Now());
+  queue()->SetTickClockForTesting(&clock);
+  queue()->SetRateLimit(/*max_requests=*/2, base::TimeDelta::FromSeconds(1));
+
+  EXPECT_CALL(observer(), RequestAddedToQueue(queue(), _, _)).Times(4);
+  AddOrReplaceRequest();
+  AddOrReplaceRequest();
+  OverlayRequest* request = AddOrReplaceRequest();
+  OverlayRequest* last_request = AddOrReplaceRequest();
+  ASSERT_EQ(2U, queue()->size());
+  EXPECT_EQ(last_request, queue()->GetRequest(1));
+  EXPECT_TRUE(delegate_.WasRequestCancelled(request));
+
+  // Verify that requests growing the queue are still limited.
+  AddUncheckedRequest();
+  EXPECT_EQ(2U, queue()->size());
+}
+
+// Tests that a burst of requests of mixed priorities is ordered by priority and
+// cancelled with a single delegate notification.
+TEST_F(OverlayRequestQueueImplTest, StressPriorities) {
+  EXPECT_CALL(observer(), RequestAddedToQueue(queue(), _, _))
+      .Times(kStressRequestCount);
+  const OverlayRequestQueue::Priority kPriorities[] = {
+      OverlayRequestQueue::Priority::kLow,
+      OverlayRequestQueue::Priority::kDefault,
+      OverlayRequestQueue::Priority::kHigh};
+  std::vector<OverlayRequest*> high_requests;
+  for (size_t i = 0; i < kStressRequestCount; ++i) {
+    OverlayRequestQueue::Priority priority = kPriorities[i % 3];
+    OverlayRequest* request = AddRequestWithPriority(priority);
+    if (priority == OverlayRequestQueue::Priority::kHigh)
+      high_requests.push_back(request);
+  }
+  ASSERT_EQ(kStressRequestCount, queue()->size());
+  // Verify that the high priority requests are queued in order right behind
+  // the front request.
+  for (size_t i = 0; i < high_requests.size(); ++i)
+    EXPECT_EQ(high_requests[i], queue()->GetRequest(i + 1));
+
+  queue()->CancelAllRequests();
+  EXPECT_EQ(0U, queue()->size());
+  EXPECT_EQ(kStressRequestCount, delegate_.cancelled_request_count());
+  EXPECT_EQ(1U, delegate_.bulk_cancellation_count());
+}
+
+// Tests that a burst of coalesced requests keeps a single waiting request.
+TEST_F(OverlayRequestQueueImplTest, StressCoalescing) {
+  EXPECT_CALL(observer(), RequestAddedToQueue(queue(), _, _))
+      .Times(kStressRequestCount);
+  OverlayRequest* last_request = nullptr;
+  for (size_t i = 0; i < kStressRequestCount; ++i)
+    last_request = AddOrReplaceRequest();
+
+  EXPECT_EQ(2U, queue()->size());
+  EXPECT_EQ(last_request, queue()->GetRequest(1));
+  EXPECT_EQ(kStressRequestCount - 2, delegate_.cancelled_request_count());
+}
+
+// Tests that a burst of requests is capped by the rate limit.
+TEST_F(OverlayRequestQueueImplTest, StressRateLimit) {
+  const size_t kMaxRequests = 100;
+  base::SimpleTestTickClock clock;
+  clock.SetNowTicks(base::TimeTicks::Now());
+  queue()->SetTickClockForTesting(&clock);
+  queue()->SetRateLimit(kMaxRequests, base::TimeDelta::FromSeconds(1));
+
+  EXPECT_CALL(observer(), RequestAddedToQueue(queue(), _, _))
+      .Times(kMaxRequests);
+  for (size_t i = 0; i < kStressRequestCount; ++i)
+    AddRequestWithPriority(OverlayRequestQueue::Priority::kDefault);
+  EXPECT_EQ(kMaxRequests, queue()->size());
+}
+
+// Tests that a burst of coalesced requests is not capped by the rate limit.
+TEST_F(OverlayRequestQueueImplTest, StressRateLimitWithCoalescing) {
+  base::SimpleTestTickClock clock;
+  clock.SetNowTicks(base::TimeTicks::Now());
+  queue()->SetTickClockForTesting(&clock);
+  queue()->SetRateLimit(/*max_requests=*/2, base::TimeDelta::FromSeconds(1));
+
+  EXPECT_CALL(observer(), RequestAddedToQueue(queue(), _, _))
+      .Times(kStressRequestCount);
+  OverlayRequest* last_request = nullptr;
+  for (size_t i = 0; i < kStressRequestCount; ++i)
+    last_request = AddOrReplaceRequest();
+  EXPECT_EQ(2U, queue()->size());
+  EXPECT_EQ(last_request, queue()->GetRequest(1));
 }
 
 // Tests that a cancellation via a cancel handler correctly updates state and
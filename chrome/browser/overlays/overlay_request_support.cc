@@ -14,25 +14,40 @@ class UniversalOverlayRequestSupport : public OverlayRequestSupport {
     return true;
   }
 };
-// OverlayRequestSupport that always returns false for IsRequestSupported().
+// OverlayRequestSupport that does not support any config type.
 class DisabledOverlayRequestSupport : public OverlayRequestSupport {
  public:
-  bool IsRequestSupported(OverlayRequest* request) const override {
-    return false;
-  }
+  DisabledOverlayRequestSupport()
+      : OverlayRequestSupport(OverlayUserDataTypeSet()) {}
 };
 }  // namespace
 
 OverlayRequestSupport::OverlayRequestSupport(
-    const std::vector<const OverlayRequestSupport*>& supports)
-    : aggregated_support_(supports) {}
+    const std::vector<const OverlayRequestSupport*>& supports) {
+  for (const OverlayRequestSupport* support : supports) {
+    if (support->overrides_support_) {
+      overriding_supports_.push_back(support);
+      continue;
+    }
+    supported_config_types_.AddAll(support->supported_config_types_);
+    overriding_supports_.insert(overriding_supports_.end(),
+                                support->overriding_supports_.begin(),
+                                support->overriding_supports_.end());
+  }
+}
 
-OverlayRequestSupport::OverlayRequestSupport() = default;
+OverlayRequestSupport::OverlayRequestSupport() : overrides_support_(true) {}
+
+OverlayRequestSupport::OverlayRequestSupport(
+    const OverlayUserDataTypeSet& config_types)
+    : supported_config_types_(config_types) {}
 
 OverlayRequestSupport::~OverlayRequestSupport() = default;
 
 bool OverlayRequestSupport::IsRequestSupported(OverlayRequest* request) const {
-  for (const OverlayRequestSupport* support : aggregated_support_) {
+  if (request->GetConfigTypes().Intersects(supported_config_types_))
+    return true;
+  for (const OverlayRequestSupport* support : overriding_supports_) {
     if (support->IsRequestSupported(request))
       return true;
   }
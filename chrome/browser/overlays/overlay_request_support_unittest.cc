@@ -12,6 +12,15 @@ namespace {
 DEFINE_TEST_OVERLAY_REQUEST_CONFIG(FirstConfig);
 DEFINE_TEST_OVERLAY_REQUEST_CONFIG(SecondConfig);
 DEFINE_TEST_OVERLAY_REQUEST_CONFIG(ThirdConfig);
+
+// OverlayRequestSupport overriding IsRequestSupported() to support requests
+// configured with a ThirdConfig.
+class OverridingSupport : public OverlayRequestSupport {
+ public:
+  bool IsRequestSupported(OverlayRequest* request) const override {
+    return !!request->GetConfig<ThirdConfig>();
+  }
+};
 }  // namespace
 
 using OverlayRequestSupportTest = PlatformTest;
@@ -77,3 +86,29 @@ TEST_F(OverlayRequestSupportTest, AggregateSupport) {
       OverlayRequest::CreateWithConfig<ThirdConfig>();
   EXPECT_FALSE(support.IsRequestSupported(unsupported_request.get()));
 }
+
+// Tests that aggregated support combines the supports described by config
+// types with the supports overriding IsRequestSupported(), including those of
+// nested aggregated supports.
+TEST_F(OverlayRequestSupportTest, AggregateOverridingSupport) {
+  OverridingSupport overriding_support;
+  OverlayRequestSupport nested_support(
+      {SecondConfig::RequestSupport(), &overriding_support});
+  OverlayRequestSupport support(
+      {FirstConfig::RequestSupport(), &nested_support});
+
+  std::unique_ptr<OverlayRequest> first_request =
+      OverlayRequest::CreateWithConfig<FirstConfig>();
+  EXPECT_TRUE(support.IsRequestSupported(first_request.get()));
+  std::unique_ptr<OverlayRequest> second_request =
+      OverlayRequest::CreateWithConfig<SecondConfig>();
+  EXPECT_TRUE(support.IsRequestSupported(second_request.get()));
+  std::unique_ptr<OverlayRequest> third_request =
+      OverlayRequest::CreateWithConfig<ThirdConfig>();
+  EXPECT_TRUE(support.IsRequestSupported(third_request.get()));
+
+  // Verify that aggregating None() does not add support.
+  OverlayRequestSupport none_support(
+      {FirstConfig::RequestSupport(), OverlayRequestSupport::None()});
+  EXPECT_FALSE(none_support.IsRequestSupported(second_request.get()));
+}
@@ -4,9 +4,27 @@
 
 #include "ios/chrome/browser/overlays/public/overlay_request.h"
 
+#include "ios/chrome/browser/overlays/public/overlay_request_config.h"
 #include "ios/chrome/browser/overlays/test/fake_overlay_user_data.h"
+#include "ios/chrome/browser/overlays/test/overlay_test_macros.h"
 #include "testing/platform_test.h"
 
+namespace {
+// Config added as auxiliary data by AuxiliaryDataConfig.
+DEFINE_TEST_OVERLAY_REQUEST_CONFIG(AuxiliaryConfig);
+
+// Config adding an AuxiliaryConfig to the requests it configures.
+class AuxiliaryDataConfig : public OverlayRequestConfig<AuxiliaryDataConfig> {
+ private:
+  OVERLAY_USER_DATA_SETUP(AuxiliaryDataConfig);
+
+  void CreateAuxiliaryData(base::SupportsUserData* user_data) override {
+    AuxiliaryConfig::CreateForUserData(user_data);
+  }
+};
+OVERLAY_USER_DATA_SETUP_IMPL(AuxiliaryDataConfig);
+}  // namespace
+
 using OverlayRequestTest = PlatformTest;
 
 // Tests that OverlayRequests can be created.
@@ -18,3 +36,14 @@ TEST_F(OverlayRequestTest, CreateWithConfig) {
   ASSERT_TRUE(config);
   EXPECT_EQ(config->value(), &value);
 }
+
+// Tests that the config types of a request include its auxiliary configs.
+TEST_F(OverlayRequestTest, GetConfigTypes) {
+  std::unique_ptr<OverlayRequest> request =
+      OverlayRequest::CreateWithConfig<AuxiliaryDataConfig>();
+  const OverlayUserDataTypeSet& config_types = request->GetConfigTypes();
+  EXPECT_TRUE(config_types.Contains(AuxiliaryDataConfig::TypeId()));
+  EXPECT_TRUE(config_types.Contains(AuxiliaryConfig::TypeId()));
+  EXPECT_FALSE(config_types.Contains(FakeOverlayUserData::TypeId()));
+  EXPECT_NE(AuxiliaryDataConfig::TypeId(), AuxiliaryConfig::TypeId());
+}
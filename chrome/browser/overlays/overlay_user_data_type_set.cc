@@ -0,0 +1,62 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/overlays/public/overlay_user_data_type_set.h"
+
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "base/check.h"
+#include "base/check_op.h"
+#include "base/no_destructor.h"
+#include "base/supports_user_data.h"
+
+namespace {
+// The key under which the tracked types are stored in a user data container.
+const int kTrackedTypesUserDataKey = 0;
+
+// The user data holding the tracked types of a user data container.
+class TrackedTypes : public base::SupportsUserData::Data {
+ public:
+  OverlayUserDataTypeSet types;
+};
+}  // namespace
+
+OverlayUserDataTypeSet::OverlayUserDataTypeSet() = default;
+
+OverlayUserDataTypeSet::OverlayUserDataTypeSet(
+    const OverlayUserDataTypeSet& other) = default;
+
+OverlayUserDataTypeSet& OverlayUserDataTypeSet::operator=(
+    const OverlayUserDataTypeSet& other) = default;
+
+OverlayUserDataTypeSet::~OverlayUserDataTypeSet() = default;
+
+// static
+size_t OverlayUserDataTypeSet::GetTypeId(const void* user_data_key) {
+  static base::NoDestructor<std::map<const void*, size_t>> type_ids;
+  auto inserted = type_ids->emplace(user_data_key, type_ids->size());
+  size_t type_id = inserted.first->second;
+  CHECK_LT(type_id, kMaxTypeCount);
+  return type_id;
+}
+
+// static
+const OverlayUserDataTypeSet* OverlayUserDataTypeSet::TrackTypes(
+    base::SupportsUserData* user_data) {
+  DCHECK(!GetTrackedTypes(user_data));
+  auto tracked_types = std::make_unique<TrackedTypes>();
+  const OverlayUserDataTypeSet* types = &tracked_types->types;
+  user_data->SetUserData(&kTrackedTypesUserDataKey, std::move(tracked_types));
+  return types;
+}
+
+// static
+OverlayUserDataTypeSet* OverlayUserDataTypeSet::GetTrackedTypes(
+    base::SupportsUserData* user_data) {
+  TrackedTypes* tracked_types = static_cast<TrackedTypes*>(
+      user_data->GetUserData(&kTrackedTypesUserDataKey));
+  return tracked_types ? &tracked_types->types : nullptr;
+}
@@ -8,6 +8,7 @@
 #include <memory>
 
 #include "base/supports_user_data.h"
+#include "ios/chrome/browser/overlays/public/overlay_user_data_type_set.h"
 
 class OverlayCallbackManager;
 namespace web {
@@ -53,6 +54,10 @@ class OverlayRequest {
   // lifetime.
   virtual web::WebState* GetQueueWebState() = 0;
 
+  // Returns the types of the configs of the request, including the auxiliary
+  // configs added by its ConfigType.
+  virtual const OverlayUserDataTypeSet& GetConfigTypes() = 0;
+
  protected:
   OverlayRequest() = default;
 
@@ -6,8 +6,10 @@
 #define IOS_CHROME_BROWSER_OVERLAYS_PUBLIC_OVERLAY_REQUEST_QUEUE_H_
 
 #include <memory>
+#include <utility>
 
 #include "base/macros.h"
+#include "base/time/time.h"
 #include "ios/chrome/browser/overlays/public/overlay_modality.h"
 #import "ios/chrome/browser/overlays/public/overlay_request_cancel_handler.h"
 
@@ -19,6 +21,17 @@ class WebState;
 // A queue of OverlayRequests for a specific WebState.
 class OverlayRequestQueue {
  public:
+  // Priority classes of the requests in the queue.  The requests waiting
+  // behind the front request are kept sorted by decreasing priority, and
+  // requests of the same priority are kept in the order they were added.
+  // Requests never preempt the front request, whose UI may already be
+  // presented.
+  enum class Priority {
+    kLow = 0,
+    kDefault,
+    kHigh,
+  };
+
   virtual ~OverlayRequestQueue() = default;
 
   // Returns the request queue for |web_state| at |modality|.
@@ -46,12 +59,39 @@ class OverlayRequestQueue {
                           std::unique_ptr<OverlayRequestCancelHandler>
                               cancel_handler = nullptr) = 0;
 
+  // Adds |request| like AddRequest(), but ahead of the waiting requests of
+  // lower priorities than |priority|.  AddRequest() uses Priority::kDefault.
+  virtual void AddRequestWithPriority(
+      std::unique_ptr<OverlayRequest> request,
+      Priority priority,
+      std::unique_ptr<OverlayRequestCancelHandler> cancel_handler =
+          nullptr) = 0;
+
+  // Adds |request| like AddRequestWithPriority(), unless a request configured
+  // with a ConfigType is already waiting behind the front request.  |request|
+  // then replaces that request, which is cancelled.  |request| takes the
+  // position of the replaced request if |priority| allows it, and is otherwise
+  // queued like AddRequestWithPriority().  Used to coalesce bursts of
+  // equivalent requests.
+  template <class ConfigType>
+  void AddOrReplaceRequest(
+      std::unique_ptr<OverlayRequest> request,
+      Priority priority = Priority::kDefault,
+      std::unique_ptr<OverlayRequestCancelHandler> cancel_handler = nullptr) {
+    AddOrReplaceRequestWithConfig(ConfigType::UserDataKey(),
+                                  std::move(request), priority,
+                                  std::move(cancel_handler));
+  }
+
   // Inserts |request| into the queue at |index|.  |index| must be less than or
   // equal to the queue's size.  |cancel_handler| may be used to cancel the
   // request.  If |cancel_handler| is not provided, the request will be
   // cancelled by default for committed, document-changing navigations.
   // Inserting at index 0 will dismiss the currently visible overlay UI if it is
-  // presented for that request.
+  // presented for that request.  The inserted request takes the default
+  // priority, raised or lowered to the priorities of the requests around
+  // |index| so that the waiting requests stay sorted.  A front request moved
+  // behind |request| stays ahead of the other waiting requests.
   virtual void InsertRequest(size_t index,
                              std::unique_ptr<OverlayRequest> request,
                              std::unique_ptr<OverlayRequestCancelHandler>
@@ -60,6 +100,14 @@ class OverlayRequestQueue {
   // Cancels the UI for all requests in the queue then empties the queue.
   virtual void CancelAllRequests() = 0;
 
+  // Limits the number of requests added to the queue to |max_requests| per
+  // |interval|.  The requests added beyond the limit, except those of high
+  // priority, are dropped without being presented: they are destroyed, so
+  // their completion callbacks are executed without a response.  Requests
+  // replacing a waiting request through AddOrReplaceRequest() do not grow the
+  // queue and are not counted.  A |max_requests| of 0 removes the limit.
+  virtual void SetRateLimit(size_t max_requests, base::TimeDelta interval) = 0;
+
  protected:
   OverlayRequestQueue() = default;
 
@@ -69,6 +117,13 @@ class OverlayRequestQueue {
 
   // Called by cancellation handlers to cancel |request|.
   virtual void CancelRequest(OverlayRequest* request) = 0;
+
+  // Called by AddOrReplaceRequest() with the user data key of the config type.
+  virtual void AddOrReplaceRequestWithConfig(
+      const void* config_key,
+      std::unique_ptr<OverlayRequest> request,
+      Priority priority,
+      std::unique_ptr<OverlayRequestCancelHandler> cancel_handler) = 0;
 };
 
 #endif  // IOS_CHROME_BROWSER_OVERLAYS_PUBLIC_OVERLAY_REQUEST_QUEUE_H_
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "ios/chrome/browser/overlays/public/overlay_request.h"
+#include "ios/chrome/browser/overlays/public/overlay_user_data_type_set.h"
 
 // Helper object that allows objects to specify support for a subset of
 // OverlayRequest types.
@@ -23,9 +24,9 @@ class OverlayRequestSupport {
   virtual ~OverlayRequestSupport();
 
   // Whether |request| is supported by this instance.  The default
-  // implementation returns true is any OverlayRequestSupport in
-  // |aggregated_support_| returns true, or false if |aggregated_support_| is
-  // empty.
+  // implementation returns true if |request| has one of the supported config
+  // types, or if any aggregated OverlayRequestSupport that overrides this
+  // function returns true.
   virtual bool IsRequestSupported(OverlayRequest* request) const;
 
   // Returns an OverlayRequestSupport that supports all requests.
@@ -35,11 +36,23 @@ class OverlayRequestSupport {
   static const OverlayRequestSupport* None();
 
  protected:
+  // Constructor for subclasses overriding IsRequestSupported().
   OverlayRequestSupport();
 
-  // The OverlayRequestSupports to aggregate.  Empty for OverlayRequestSupports
-  // created with the default constructor.
-  const std::vector<const OverlayRequestSupport*> aggregated_support_;
+  // Creates an OverlayRequestSupport that supports the requests configured
+  // with any of |config_types|.
+  explicit OverlayRequestSupport(const OverlayUserDataTypeSet& config_types);
+
+ private:
+  // Whether the support is implemented by a subclass overriding
+  // IsRequestSupported(), rather than described by config types.
+  const bool overrides_support_ = false;
+  // The supported config types, merged from the aggregated supports so that
+  // checking them is a bit test.
+  OverlayUserDataTypeSet supported_config_types_;
+  // The aggregated supports overriding IsRequestSupported(), which must be
+  // called for each request.
+  std::vector<const OverlayRequestSupport*> overriding_supports_;
 };
 
 // Template used to create OverlayRequestSupports that only support
@@ -47,10 +60,8 @@ class OverlayRequestSupport {
 template <class ConfigType>
 class SupportsOverlayRequest : public OverlayRequestSupport {
  public:
-  SupportsOverlayRequest() = default;
-  bool IsRequestSupported(OverlayRequest* request) const override {
-    return !!request->GetConfig<ConfigType>();
-  }
+  SupportsOverlayRequest()
+      : OverlayRequestSupport(OverlayUserDataTypeSet::Of<ConfigType>()) {}
 };
 
 #endif  // IOS_CHROME_BROWSER_OVERLAYS_PUBLIC_OVERLAY_REQUEST_SUPPORT_H_
@@ -7,6 +7,7 @@
 
 #include "base/memory/ptr_util.h"
 #include "base/supports_user_data.h"
+#include "ios/chrome/browser/overlays/public/overlay_user_data_type_set.h"
 
 // Macro for OverlayUserData setup [add to .h file]:
 // - Declares a static variable inside subclasses.  The address of this static
@@ -59,6 +60,10 @@ class OverlayUserData : public base::SupportsUserData::Data {
           base::WrapUnique(new DataType(std::forward<Args>(args)...));
       data->CreateAuxiliaryData(user_data);
       user_data->SetUserData(UserDataKey(), std::move(data));
+      OverlayUserDataTypeSet* types =
+          OverlayUserDataTypeSet::GetTrackedTypes(user_data);
+      if (types)
+        types->Add(TypeId());
     }
   }
 
@@ -75,6 +80,13 @@ class OverlayUserData : public base::SupportsUserData::Data {
   // The key under which to store the user data.
   static const void* UserDataKey() { return &DataType::kUserDataKey; }
 
+  // The dense id of DataType, used to index OverlayUserDataTypeSets.
+  static size_t TypeId() {
+    static const size_t type_id =
+        OverlayUserDataTypeSet::GetTypeId(UserDataKey());
+    return type_id;
+  }
+
  protected:
   // Adds auxilliary OverlayUserData to |data|.  Used to allow multiple
   // OverlayUserData templates to share common functionality in a separate data
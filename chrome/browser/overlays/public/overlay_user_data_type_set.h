@@ -0,0 +1,73 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_OVERLAYS_PUBLIC_OVERLAY_USER_DATA_TYPE_SET_H_
+#define IOS_CHROME_BROWSER_OVERLAYS_PUBLIC_OVERLAY_USER_DATA_TYPE_SET_H_
+
+#include <stddef.h>
+
+#include <bitset>
+
+namespace base {
+class SupportsUserData;
+}
+
+// A set of OverlayUserData types, stored as a bitset indexed by dense ids that
+// are allocated to the types on first use.  Used to check the config types of
+// OverlayRequests with bit operations rather than with a user data lookup per
+// type.  Like the rest of the overlay code, must be used on the main thread.
+class OverlayUserDataTypeSet {
+ public:
+  // The maximum number of OverlayUserData types that can be allocated an id.
+  static constexpr size_t kMaxTypeCount = 256;
+
+  OverlayUserDataTypeSet();
+  OverlayUserDataTypeSet(const OverlayUserDataTypeSet& other);
+  OverlayUserDataTypeSet& operator=(const OverlayUserDataTypeSet& other);
+  ~OverlayUserDataTypeSet();
+
+  // Returns a set holding the OverlayUserData type DataType.
+  template <class DataType>
+  static OverlayUserDataTypeSet Of() {
+    OverlayUserDataTypeSet types;
+    types.Add(DataType::TypeId());
+    return types;
+  }
+
+  // Returns the id of the OverlayUserData type stored under |user_data_key|,
+  // allocating the next free id on the first call for that type.
+  static size_t GetTypeId(const void* user_data_key);
+
+  // Starts tracking the types of the OverlayUserData added to |user_data|, and
+  // returns the set holding them.  The set is owned by |user_data|.
+  static const OverlayUserDataTypeSet* TrackTypes(
+      base::SupportsUserData* user_data);
+
+  // Returns the set holding the types of the OverlayUserData added to
+  // |user_data|, or nullptr if they are not tracked.
+  static OverlayUserDataTypeSet* GetTrackedTypes(
+      base::SupportsUserData* user_data);
+
+  // Adds the type with |type_id| to the set.
+  void Add(size_t type_id) { bits_.set(type_id); }
+
+  // Adds all the types of |types| to the set.
+  void AddAll(const OverlayUserDataTypeSet& types) { bits_ |= types.bits_; }
+
+  // Returns whether the set holds the type with |type_id|.
+  bool Contains(size_t type_id) const { return bits_.test(type_id); }
+
+  // Returns whether the set holds any of the types of |types|.
+  bool Intersects(const OverlayUserDataTypeSet& types) const {
+    return (bits_ & types.bits_).any();
+  }
+
+  // Returns whether the set holds no type.
+  bool empty() const { return bits_.none(); }
+
+ private:
+  std::bitset<kMaxTypeCount> bits_;
+};
+
+#endif  // IOS_CHROME_BROWSER_OVERLAYS_PUBLIC_OVERLAY_USER_DATA_TYPE_SET_H_
@@ -67,7 +67,7 @@ void IOSChromePasswordStoreFactory::OnPasswordsSyncedStatePotentiallyChanged(
 }
 
 IOSChromePasswordStoreFactory::IOSChromePasswordStoreFactory()
-    : RefcountedBrowserStateKeyedServiceFactory(
+    : AuditedRefcountedBrowserStateKeyedServiceFactory(
           "PasswordStore",
           BrowserStateDependencyManager::GetInstance()) {
   DependsOn(ios::WebDataServiceFactory::GetInstance());
@@ -76,7 +76,7 @@ IOSChromePasswordStoreFactory::IOSChromePasswordStoreFactory()
 IOSChromePasswordStoreFactory::~IOSChromePasswordStoreFactory() {}
 
 scoped_refptr<RefcountedKeyedService>
-IOSChromePasswordStoreFactory::BuildServiceInstanceFor(
+IOSChromePasswordStoreFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* context) const {
   std::unique_ptr<password_manager::LoginDatabase> login_db(
       password_manager::CreateLoginDatabaseForProfileStorage(
@@ -8,7 +8,7 @@
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/no_destructor.h"
-#include "components/keyed_service/ios/refcounted_browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 class ChromeBrowserState;
 enum class ServiceAccessType;
@@ -20,7 +20,7 @@ class PasswordStore;
 // Singleton that owns all PasswordStores and associates them with
 // ChromeBrowserState.
 class IOSChromePasswordStoreFactory
-    : public RefcountedBrowserStateKeyedServiceFactory {
+    : public AuditedRefcountedBrowserStateKeyedServiceFactory {
  public:
   static scoped_refptr<password_manager::PasswordStore> GetForBrowserState(
       ChromeBrowserState* browser_state,
@@ -40,7 +40,7 @@ class IOSChromePasswordStoreFactory
   ~IOSChromePasswordStoreFactory() override;
 
   // BrowserStateKeyedServiceFactory:
-  scoped_refptr<RefcountedKeyedService> BuildServiceInstanceFor(
+  scoped_refptr<RefcountedKeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* context) const override;
   web::BrowserState* GetBrowserStateToUse(
       web::BrowserState* context) const override;
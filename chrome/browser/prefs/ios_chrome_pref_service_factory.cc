@@ -11,6 +11,7 @@
 #include "base/feature_list.h"
 #include "base/memory/ptr_util.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/time/time.h"
 #include "components/policy/core/browser/browser_policy_connector.h"
 #include "components/policy/core/common/policy_service.h"
 #include "components/prefs/json_pref_store.h"
@@ -24,6 +25,7 @@
 #include "ios/chrome/browser/application_context.h"
 #include "ios/chrome/browser/policy/policy_features.h"
 #include "ios/chrome/browser/prefs/ios_chrome_pref_model_associator_client.h"
+#include "ios/chrome/browser/prefs/pref_file_prefetcher.h"
 
 namespace {
 
@@ -57,6 +59,14 @@ void PrepareFactory(sync_preferences::PrefServiceSyncableFactory* factory,
       IOSChromePrefModelAssociatorClient::GetInstance());
 }
 
+// Prepares the synchronous load of |pref_filename| by consuming its prefetch,
+// if any, and schedules its prefetch on the next run.
+void PrepareLoad(const base::FilePath& pref_filename) {
+  PrefFilePrefetcher* prefetcher = PrefFilePrefetcher::GetInstance();
+  prefetcher->ConsumePrefetch(pref_filename);
+  prefetcher->RecordPrefFileForNextRun(pref_filename);
+}
+
 }  // namespace
 
 std::unique_ptr<PrefService> CreateLocalState(
@@ -65,10 +75,16 @@ std::unique_ptr<PrefService> CreateLocalState(
     const scoped_refptr<PrefRegistry>& pref_registry,
     policy::PolicyService* policy_service,
     policy::BrowserPolicyConnector* policy_connector) {
+  PrepareLoad(pref_filename);
   sync_preferences::PrefServiceSyncableFactory factory;
   PrepareFactory(&factory, pref_filename, pref_io_task_runner, policy_service,
                  policy_connector);
-  return factory.Create(pref_registry.get());
+  const base::TimeTicks load_start_time = base::TimeTicks::Now();
+  std::unique_ptr<PrefService> local_state =
+      factory.Create(pref_registry.get());
+  UMA_HISTOGRAM_TIMES("IOS.Prefs.LocalState.LoadTime",
+                      base::TimeTicks::Now() - load_start_time);
+  return local_state;
 }
 
 std::unique_ptr<sync_preferences::PrefServiceSyncable> CreateBrowserStatePrefs(
@@ -82,11 +98,17 @@ std::unique_ptr<sync_preferences::PrefServiceSyncable> CreateBrowserStatePrefs(
   // preference modifications (as applications are sand-boxed), it can use a
   // simple JsonPrefStore to store them (which is what PrefStoreManager uses
   // on platforms that do not track preference modifications).
+  const base::FilePath pref_filename =
+      browser_state_path.Append(kPreferencesFilename);
+  PrepareLoad(pref_filename);
   sync_preferences::PrefServiceSyncableFactory factory;
-  PrepareFactory(&factory, browser_state_path.Append(kPreferencesFilename),
-                 pref_io_task_runner, policy_service, policy_connector);
+  PrepareFactory(&factory, pref_filename, pref_io_task_runner, policy_service,
+                 policy_connector);
+  const base::TimeTicks load_start_time = base::TimeTicks::Now();
   std::unique_ptr<sync_preferences::PrefServiceSyncable> pref_service =
       factory.CreateSyncable(pref_registry.get());
+  UMA_HISTOGRAM_TIMES("IOS.Prefs.BrowserState.LoadTime",
+                      base::TimeTicks::Now() - load_start_time);
   return pref_service;
 }
 
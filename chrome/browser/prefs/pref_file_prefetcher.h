@@ -0,0 +1,91 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_PREFS_PREF_FILE_PREFETCHER_H_
+#define IOS_CHROME_BROWSER_PREFS_PREF_FILE_PREFETCHER_H_
+
+#include <map>
+
+#include "base/callback.h"
+#include "base/feature_list.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+// Feature to read the preference files loaded during startup on a background
+// queue as soon as the path provider is registered. As the feature list is
+// only initialized after local state is loaded, the state of the feature is
+// applied on the next run.
+extern const base::Feature kPrefetchPrefFiles;
+
+// Reads preference files on a background queue ahead of their synchronous
+// load by JsonPrefStore, so that their contents are in the file system cache
+// by the time the store reads and parses them on the main thread. The main
+// thread never waits for a prefetch: a file whose prefetch has not completed
+// by the time it is loaded is read by the store itself.
+class PrefFilePrefetcher {
+ public:
+  // Result of the prefetch of a file at the time of its load. These values are
+  // persisted to logs. Entries should not be renumbered and numeric values
+  // should never be reused.
+  enum class PrefetchResult {
+    // The file was read ahead of its load.
+    kHit = 0,
+    // The file was still being read when it was loaded.
+    kInFlight = 1,
+    // The file did not exist when it was prefetched.
+    kFileMissing = 2,
+    kMaxValue = kFileMissing,
+  };
+
+  // Posts |task| to run on a background queue.
+  using TaskPoster = base::RepeatingCallback<void(base::OnceClosure task)>;
+
+  // Returns the prefetcher used for the current process.
+  static PrefFilePrefetcher* GetInstance();
+
+  PrefFilePrefetcher();
+  // Creates a prefetcher running the reads with |task_poster|. The task
+  // runners are not created yet when the prefetch starts, so the default
+  // prefetcher posts the reads to a dispatch queue.
+  explicit PrefFilePrefetcher(TaskPoster task_poster);
+  ~PrefFilePrefetcher();
+
+  PrefFilePrefetcher(const PrefFilePrefetcher&) = delete;
+  PrefFilePrefetcher& operator=(const PrefFilePrefetcher&) = delete;
+
+  // Starts prefetching the files recorded by |RecordPrefFileForNextRun()|
+  // during the previous run, if |kPrefetchPrefFiles| was enabled. Must be
+  // called once the ios::DIR_USER_DATA path provider is registered.
+  void StartIfEnabled();
+
+  // Starts reading |path| on a background queue. Does nothing if |path| is
+  // already being prefetched.
+  void Prefetch(const base::FilePath& path);
+
+  // Stops tracking the prefetch of |path| without waiting for it, records its
+  // result and returns it. Returns nullopt if |path| is not being prefetched.
+  // Must be called before the synchronous load of |path|.
+  absl::optional<PrefetchResult> ConsumePrefetch(const base::FilePath& path);
+
+  // Records that |path| is loaded during startup, so that it is prefetched on
+  // the next run. Only paths inside ios::DIR_USER_DATA are supported.
+  void RecordPrefFileForNextRun(const base::FilePath& path);
+
+  // Stores the state of |kPrefetchPrefFiles| to apply it on the next run.
+  // Must be called after the feature list is initialized.
+  void SyncEnabledOnNextRun();
+
+ private:
+  struct PendingRead;
+
+  const TaskPoster task_poster_;
+  base::Lock lock_;
+  std::map<base::FilePath, scoped_refptr<PendingRead>> pending_reads_
+      GUARDED_BY(lock_);
+};
+
+#endif  // IOS_CHROME_BROWSER_PREFS_PREF_FILE_PREFETCHER_H_
@@ -0,0 +1,198 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/prefs/pref_file_prefetcher.h"
+
+#import <Foundation/Foundation.h>
+
+#include <atomic>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/check.h"
+#include "base/files/file.h"
+#include "base/memory/ref_counted.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/no_destructor.h"
+#include "base/path_service.h"
+#include "base/strings/sys_string_conversions.h"
+#include "base/time/time.h"
+#include "ios/chrome/browser/chrome_paths.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+const base::Feature kPrefetchPrefFiles{"PrefetchPrefFiles",
+                                       base::FEATURE_DISABLED_BY_DEFAULT};
+
+namespace {
+
+// NSUserDefaults key for whether the prefetch is enabled on the next run.
+NSString* const kPrefetchPrefFilesOnNextRun = @"PrefetchPrefFilesOnNextRun";
+
+// NSUserDefaults key for the paths of the files to prefetch, relative to
+// ios::DIR_USER_DATA as the application container may move between runs.
+NSString* const kPrefFilesToPrefetch = @"PrefFilesToPrefetch";
+
+// Size of the buffer used to read the files.
+const int kReadBufferSize = 64 * 1024;
+
+// Reads |path| to the end, discarding its contents. Returns the number of
+// bytes read, or nullopt if |path| cannot be opened.
+absl::optional<int64_t> ReadWholeFile(const base::FilePath& path) {
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ |
+                            base::File::FLAG_SEQUENTIAL_SCAN);
+  if (!file.IsValid())
+    return absl::nullopt;
+
+  std::unique_ptr<char[]> buffer(new char[kReadBufferSize]);
+  int64_t total_bytes_read = 0;
+  int bytes_read = 0;
+  while ((bytes_read = file.ReadAtCurrentPos(buffer.get(), kReadBufferSize)) >
+         0) {
+    total_bytes_read += bytes_read;
+  }
+  return total_bytes_read;
+}
+
+// Posts |task| to a background dispatch queue.
+void PostToBackgroundQueue(base::OnceClosure task) {
+  __block base::OnceClosure block_task = std::move(task);
+  dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+    std::move(block_task).Run();
+  });
+}
+
+}  // namespace
+
+// A read shared between the prefetcher and its background task, so that the
+// prefetcher can stop tracking it before it completes.
+struct PrefFilePrefetcher::PendingRead
+    : public base::RefCountedThreadSafe<PendingRead> {
+  // Reads |path| and marks the read as done.
+  void Read(const base::FilePath& path) {
+    const base::TimeTicks start_time = base::TimeTicks::Now();
+    size = ReadWholeFile(path);
+    read_duration = base::TimeTicks::Now() - start_time;
+    done.store(true, std::memory_order_release);
+  }
+
+  // Set once |read_duration| and |size| are written.
+  std::atomic<bool> done{false};
+  base::TimeDelta read_duration;
+  // Size of the file, or nullopt if it could not be opened.
+  absl::optional<int64_t> size;
+
+ private:
+  friend class base::RefCountedThreadSafe<PendingRead>;
+  ~PendingRead() = default;
+};
+
+// static
+PrefFilePrefetcher* PrefFilePrefetcher::GetInstance() {
+  static base::NoDestructor<PrefFilePrefetcher> instance;
+  return instance.get();
+}
+
+PrefFilePrefetcher::PrefFilePrefetcher()
+    : PrefFilePrefetcher(base::BindRepeating(&PostToBackgroundQueue)) {}
+
+PrefFilePrefetcher::PrefFilePrefetcher(TaskPoster task_poster)
+    : task_poster_(std::move(task_poster)) {
+  DCHECK(task_poster_);
+}
+
+PrefFilePrefetcher::~PrefFilePrefetcher() = default;
+
+void PrefFilePrefetcher::StartIfEnabled() {
+  NSUserDefaults* defaults = [NSUserDefaults standardUserDefaults];
+  if (![defaults boolForKey:kPrefetchPrefFilesOnNextRun])
+    return;
+
+  base::FilePath user_data_path;
+  if (!base::PathService::Get(ios::DIR_USER_DATA, &user_data_path))
+    return;
+
+  for (NSString* relative_path in [defaults arrayForKey:kPrefFilesToPrefetch]) {
+    if (![relative_path isKindOfClass:[NSString class]])
+      continue;
+    const base::FilePath path =
+        user_data_path.Append(base::SysNSStringToUTF8(relative_path));
+    // Ignore paths that would escape the user data directory.
+    if (path.ReferencesParent())
+      continue;
+    Prefetch(path);
+  }
+}
+
+void PrefFilePrefetcher::Prefetch(const base::FilePath& path) {
+  scoped_refptr<PendingRead> pending_read;
+  {
+    base::AutoLock auto_lock(lock_);
+    scoped_refptr<PendingRead>& entry = pending_reads_[path];
+    if (entry)
+      return;
+    entry = base::MakeRefCounted<PendingRead>();
+    pending_read = entry;
+  }
+  task_poster_.Run(
+      base::BindOnce(&PendingRead::Read, std::move(pending_read), path));
+}
+
+absl::optional<PrefFilePrefetcher::PrefetchResult>
+PrefFilePrefetcher::ConsumePrefetch(const base::FilePath& path) {
+  scoped_refptr<PendingRead> pending_read;
+  {
+    base::AutoLock auto_lock(lock_);
+    auto iter = pending_reads_.find(path);
+    if (iter == pending_reads_.end())
+      return absl::nullopt;
+    pending_read = std::move(iter->second);
+    pending_reads_.erase(iter);
+  }
+
+  // A read still in flight is left to complete on its own rather than
+  // blocking the load, which then reads the file itself.
+  PrefetchResult result = PrefetchResult::kInFlight;
+  if (pending_read->done.load(std::memory_order_acquire)) {
+    if (pending_read->size) {
+      result = PrefetchResult::kHit;
+      base::UmaHistogramTimes("IOS.Prefs.Prefetch.ReadTime",
+                              pending_read->read_duration);
+      base::UmaHistogramMemoryKB(
+          "IOS.Prefs.Prefetch.FileSize",
+          static_cast<int>(*pending_read->size / 1024));
+    } else {
+      result = PrefetchResult::kFileMissing;
+    }
+  }
+  base::UmaHistogramEnumeration("IOS.Prefs.Prefetch.Result", result);
+  return result;
+}
+
+void PrefFilePrefetcher::RecordPrefFileForNextRun(const base::FilePath& path) {
+  base::FilePath user_data_path;
+  if (!base::PathService::Get(ios::DIR_USER_DATA, &user_data_path))
+    return;
+
+  base::FilePath relative_path;
+  if (!user_data_path.AppendRelativePath(path, &relative_path))
+    return;
+
+  NSUserDefaults* defaults = [NSUserDefaults standardUserDefaults];
+  NSString* relative_path_string =
+      base::SysUTF8ToNSString(relative_path.value());
+  NSArray* paths = [defaults arrayForKey:kPrefFilesToPrefetch] ?: @[];
+  if ([paths containsObject:relative_path_string])
+    return;
+  [defaults setObject:[paths arrayByAddingObject:relative_path_string]
+               forKey:kPrefFilesToPrefetch];
+}
+
+void PrefFilePrefetcher::SyncEnabledOnNextRun() {
+  const bool enabled = base::FeatureList::IsEnabled(kPrefetchPrefFiles);
+  [[NSUserDefaults standardUserDefaults] setBool:enabled ? YES : NO
+                                          forKey:kPrefetchPrefFilesOnNextRun];
+}
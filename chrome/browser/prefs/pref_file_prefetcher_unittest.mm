@@ -0,0 +1,107 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/prefs/pref_file_prefetcher.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+const char kResultHistogram[] = "IOS.Prefs.Prefetch.Result";
+}  // namespace
+
+class PrefFilePrefetcherTest : public PlatformTest {
+ protected:
+  PrefFilePrefetcherTest()
+      : prefetcher_(base::BindRepeating(&PrefFilePrefetcherTest::PostTask,
+                                        base::Unretained(this))) {}
+
+  void SetUp() override {
+    PlatformTest::SetUp();
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().Append("Preferences");
+  }
+
+  // Keeps |task| until RunPostedTasks() is called.
+  void PostTask(base::OnceClosure task) {
+    posted_tasks_.push_back(std::move(task));
+  }
+
+  // Runs the reads posted by the prefetcher.
+  void RunPostedTasks() {
+    std::vector<base::OnceClosure> tasks = std::move(posted_tasks_);
+    for (base::OnceClosure& task : tasks)
+      std::move(task).Run();
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath path_;
+  std::vector<base::OnceClosure> posted_tasks_;
+  base::HistogramTester histogram_tester_;
+  PrefFilePrefetcher prefetcher_;
+};
+
+// Tests that a completed prefetch is reported as a hit.
+TEST_F(PrefFilePrefetcherTest, Hit) {
+  ASSERT_TRUE(base::WriteFile(path_, "{}"));
+  prefetcher_.Prefetch(path_);
+  // Prefetching the same file again does not read it twice.
+  prefetcher_.Prefetch(path_);
+  EXPECT_EQ(1U, posted_tasks_.size());
+  RunPostedTasks();
+
+  EXPECT_EQ(PrefFilePrefetcher::PrefetchResult::kHit,
+            prefetcher_.ConsumePrefetch(path_));
+  histogram_tester_.ExpectUniqueSample(
+      kResultHistogram, PrefFilePrefetcher::PrefetchResult::kHit, 1);
+  histogram_tester_.ExpectTotalCount("IOS.Prefs.Prefetch.ReadTime", 1);
+
+  // The prefetch is only consumed once.
+  EXPECT_FALSE(prefetcher_.ConsumePrefetch(path_));
+}
+
+// Tests that consuming a prefetch which has not completed does not wait for
+// it, and that the read can still complete afterwards.
+TEST_F(PrefFilePrefetcherTest, InFlight) {
+  ASSERT_TRUE(base::WriteFile(path_, "{}"));
+  prefetcher_.Prefetch(path_);
+
+  EXPECT_EQ(PrefFilePrefetcher::PrefetchResult::kInFlight,
+            prefetcher_.ConsumePrefetch(path_));
+  histogram_tester_.ExpectUniqueSample(
+      kResultHistogram, PrefFilePrefetcher::PrefetchResult::kInFlight, 1);
+
+  RunPostedTasks();
+  histogram_tester_.ExpectTotalCount("IOS.Prefs.Prefetch.ReadTime", 0);
+  EXPECT_FALSE(prefetcher_.ConsumePrefetch(path_));
+}
+
+// Tests that the prefetch of a file which does not exist is reported as such.
+TEST_F(PrefFilePrefetcherTest, MissingFile) {
+  prefetcher_.Prefetch(path_);
+  RunPostedTasks();
+
+  EXPECT_EQ(PrefFilePrefetcher::PrefetchResult::kFileMissing,
+            prefetcher_.ConsumePrefetch(path_));
+  histogram_tester_.ExpectUniqueSample(
+      kResultHistogram, PrefFilePrefetcher::PrefetchResult::kFileMissing, 1);
+  histogram_tester_.ExpectTotalCount("IOS.Prefs.Prefetch.FileSize", 0);
+}
+
+// Tests that a file which is not prefetched is not reported.
+TEST_F(PrefFilePrefetcherTest, NotPrefetched) {
+  EXPECT_FALSE(prefetcher_.ConsumePrefetch(path_));
+  histogram_tester_.ExpectTotalCount(kResultHistogram, 0);
+}
@@ -46,7 +46,7 @@ ReadingListModelFactory* ReadingListModelFactory::GetInstance() {
 }
 
 ReadingListModelFactory::ReadingListModelFactory()
-    : BrowserStateKeyedServiceFactory(
+    : AuditedBrowserStateKeyedServiceFactory(
           "ReadingListModel",
           BrowserStateDependencyManager::GetInstance()) {
   DependsOn(ModelTypeStoreServiceFactory::GetInstance());
@@ -61,7 +61,8 @@ void ReadingListModelFactory::RegisterBrowserStatePrefs(
       PrefRegistry::NO_REGISTRATION_FLAGS);
 }
 
-std::unique_ptr<KeyedService> ReadingListModelFactory::BuildServiceInstanceFor(
+std::unique_ptr<KeyedService>
+ReadingListModelFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* context) const {
   ChromeBrowserState* chrome_browser_state =
       ChromeBrowserState::FromBrowserState(context);
@@ -8,14 +8,14 @@
 #include <memory>
 
 #include "base/no_destructor.h"
-#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 class ChromeBrowserState;
 class ReadingListModel;
 
 // Singleton that creates the ReadingListModel and associates that service with
 // ChromeBrowserState.
-class ReadingListModelFactory : public BrowserStateKeyedServiceFactory {
+class ReadingListModelFactory : public AuditedBrowserStateKeyedServiceFactory {
  public:
   static ReadingListModel* GetForBrowserState(
       ChromeBrowserState* browser_state);
@@ -31,8 +31,8 @@ class ReadingListModelFactory : public BrowserStateKeyedServiceFactory {
   ReadingListModelFactory();
   ~ReadingListModelFactory() override;
 
-  // BrowserStateKeyedServiceFactory implementation.
-  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+  // AuditedBrowserStateKeyedServiceFactory implementation.
+  std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* context) const override;
   web::BrowserState* GetBrowserStateToUse(
       web::BrowserState* context) const override;
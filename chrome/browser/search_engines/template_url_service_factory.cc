@@ -74,7 +74,7 @@ TemplateURLServiceFactory::GetDefaultFactory() {
 }
 
 TemplateURLServiceFactory::TemplateURLServiceFactory()
-    : BrowserStateKeyedServiceFactory(
+    : AuditedBrowserStateKeyedServiceFactory(
           "TemplateURLService",
           BrowserStateDependencyManager::GetInstance()) {
   DependsOn(ios::HistoryServiceFactory::GetInstance());
@@ -90,7 +90,7 @@ void TemplateURLServiceFactory::RegisterBrowserStatePrefs(
 }
 
 std::unique_ptr<KeyedService>
-TemplateURLServiceFactory::BuildServiceInstanceFor(
+TemplateURLServiceFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* context) const {
   return BuildTemplateURLService(context);
 }
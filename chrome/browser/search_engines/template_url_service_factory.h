@@ -9,7 +9,7 @@
 
 #include "base/macros.h"
 #include "base/no_destructor.h"
-#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 class ChromeBrowserState;
 class TemplateURLService;
@@ -17,7 +17,8 @@ class TemplateURLService;
 namespace ios {
 // Singleton that owns all TemplateURLServices and associates them with
 // ChromeBrowserState.
-class TemplateURLServiceFactory : public BrowserStateKeyedServiceFactory {
+class TemplateURLServiceFactory
+    : public AuditedBrowserStateKeyedServiceFactory {
  public:
   static TemplateURLService* GetForBrowserState(
       ChromeBrowserState* browser_state);
@@ -34,10 +35,10 @@ class TemplateURLServiceFactory : public BrowserStateKeyedServiceFactory {
   TemplateURLServiceFactory();
   ~TemplateURLServiceFactory() override;
 
-  // BrowserStateKeyedServiceFactory implementation.
+  // AuditedBrowserStateKeyedServiceFactory implementation.
   void RegisterBrowserStatePrefs(
       user_prefs::PrefRegistrySyncable* registry) override;
-  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+  std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* context) const override;
   web::BrowserState* GetBrowserStateToUse(
       web::BrowserState* context) const override;
@@ -12,6 +12,7 @@
 #include "ios/chrome/browser/browser_state/chrome_browser_state.h"
 #include "ios/chrome/browser/chrome_url_constants.h"
 #import "ios/chrome/browser/main/browser.h"
+#include "ios/chrome/browser/metrics/startup_tracer.h"
 #import "ios/chrome/browser/sessions/session_ios.h"
 #import "ios/chrome/browser/sessions/session_ios_factory.h"
 #import "ios/chrome/browser/sessions/session_restoration_observer.h"
@@ -107,6 +108,7 @@ bool SessionRestorationBrowserAgent::RestoreSessionWindow(
         web_enabler_->TriggersInitialLoad();
     web_enabler_->SetTriggersInitialLoad(false);
     web::WebState::CreateParams createParams(browser_state_);
+    StartupTracer::ScopedSpan startup_span("DeserializeWebStateList");
     DeserializeWebStateList(
         web_state_list, window,
         base::BindRepeating(&web::WebState::CreateWithStorageSession,
@@ -9,7 +9,7 @@
 
 #include "base/macros.h"
 #include "base/no_destructor.h"
-#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 namespace user_prefs {
 class PrefRegistrySyncable;
@@ -22,7 +22,8 @@ class ChromeBrowserState;
 // Singleton that owns all |AuthenticationServices| and associates them with
 // browser states. Listens for the |BrowserState|'s destruction notification and
 // cleans up the associated |AuthenticationService|.
-class AuthenticationServiceFactory : public BrowserStateKeyedServiceFactory {
+class AuthenticationServiceFactory
+    : public AuditedBrowserStateKeyedServiceFactory {
  public:
   static AuthenticationService* GetForBrowserState(
       ChromeBrowserState* browser_state);
@@ -45,8 +46,8 @@ class AuthenticationServiceFactory : public BrowserStateKeyedServiceFactory {
   AuthenticationServiceFactory();
   ~AuthenticationServiceFactory() override;
 
-  // BrowserStateKeyedServiceFactory implementation.
-  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+  // AuditedBrowserStateKeyedServiceFactory implementation.
+  std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* context) const override;
   void RegisterBrowserStatePrefs(
       user_prefs::PrefRegistrySyncable* registry) override;
@@ -67,7 +67,7 @@ AuthenticationServiceFactory::GetDefaultFactory() {
 }
 
 AuthenticationServiceFactory::AuthenticationServiceFactory()
-    : BrowserStateKeyedServiceFactory(
+    : AuditedBrowserStateKeyedServiceFactory(
           "AuthenticationService",
           BrowserStateDependencyManager::GetInstance()) {
   DependsOn(IdentityManagerFactory::GetInstance());
@@ -78,7 +78,7 @@ AuthenticationServiceFactory::AuthenticationServiceFactory()
 AuthenticationServiceFactory::~AuthenticationServiceFactory() {}
 
 std::unique_ptr<KeyedService>
-AuthenticationServiceFactory::BuildServiceInstanceFor(
+AuthenticationServiceFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* context) const {
   return BuildAuthenticationService(context);
 }
@@ -6,7 +6,7 @@
 #define IOS_CHROME_BROWSER_SIGNIN_CHROME_ACCOUNT_MANAGER_SERVICE_FACTORY_H_
 
 #include "base/no_destructor.h"
-#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 class ChromeBrowserState;
 class ChromeAccountManagerService;
@@ -14,7 +14,7 @@ class ChromeAccountManagerService;
 // Singleton that owns all ChromeAccountManagerServices and associates them with
 // ChromeBrowserState.
 class ChromeAccountManagerServiceFactory
-    : public BrowserStateKeyedServiceFactory {
+    : public AuditedBrowserStateKeyedServiceFactory {
  public:
   ChromeAccountManagerServiceFactory(const BrowserStateKeyedServiceFactory&) =
       delete;
@@ -32,7 +32,7 @@ class ChromeAccountManagerServiceFactory
   ~ChromeAccountManagerServiceFactory() override;
 
   // ChromeAccountManagerServiceFactory implementation.
-  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+  std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* context) const override;
 };
 
@@ -26,7 +26,7 @@ ChromeAccountManagerServiceFactory::GetInstance() {
 }
 
 ChromeAccountManagerServiceFactory::ChromeAccountManagerServiceFactory()
-    : BrowserStateKeyedServiceFactory(
+    : AuditedBrowserStateKeyedServiceFactory(
           "ChromeAccountManagerService",
           BrowserStateDependencyManager::GetInstance()) {}
 
@@ -34,7 +34,7 @@ ChromeAccountManagerServiceFactory::~ChromeAccountManagerServiceFactory() =
     default;
 
 std::unique_ptr<KeyedService>
-ChromeAccountManagerServiceFactory::BuildServiceInstanceFor(
+ChromeAccountManagerServiceFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* context) const {
   ChromeBrowserState* browser_state =
       ChromeBrowserState::FromBrowserState(context);
@@ -27,7 +27,7 @@ void IdentityManagerFactory::RegisterBrowserStatePrefs(
 }
 
 IdentityManagerFactory::IdentityManagerFactory()
-    : BrowserStateKeyedServiceFactory(
+    : AuditedBrowserStateKeyedServiceFactory(
           "IdentityManager",
           BrowserStateDependencyManager::GetInstance()) {
   DependsOn(SigninClientFactory::GetInstance());
@@ -65,7 +65,8 @@ void IdentityManagerFactory::RemoveObserver(
   observer_list_.RemoveObserver(observer);
 }
 
-std::unique_ptr<KeyedService> IdentityManagerFactory::BuildServiceInstanceFor(
+std::unique_ptr<KeyedService>
+IdentityManagerFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* context) const {
   ChromeBrowserState* browser_state =
       ChromeBrowserState::FromBrowserState(context);
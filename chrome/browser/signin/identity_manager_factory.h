@@ -8,7 +8,7 @@
 #include "base/macros.h"
 #include "base/no_destructor.h"
 #include "base/observer_list.h"
-#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 class ChromeBrowserState;
 class IdentityManagerFactoryObserver;
@@ -19,7 +19,7 @@ class IdentityManager;
 
 // Singleton that owns all IdentityManager instances and associates them with
 // BrowserStates.
-class IdentityManagerFactory : public BrowserStateKeyedServiceFactory {
+class IdentityManagerFactory : public AuditedBrowserStateKeyedServiceFactory {
  public:
   static signin::IdentityManager* GetForBrowserState(
       ChromeBrowserState* browser_state);
@@ -46,8 +46,8 @@ class IdentityManagerFactory : public BrowserStateKeyedServiceFactory {
                      /*allow_reentrancy=*/false>
       observer_list_;
 
-  // BrowserStateKeyedServiceFactory:
-  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+  // AuditedBrowserStateKeyedServiceFactory:
+  std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* context) const override;
   void RegisterBrowserStatePrefs(
       user_prefs::PrefRegistrySyncable* registry) override;
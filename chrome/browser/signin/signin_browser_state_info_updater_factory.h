@@ -7,13 +7,13 @@
 
 #include "base/macros.h"
 #include "base/no_destructor.h"
-#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 class ChromeBrowserState;
 class SigninBrowserStateInfoUpdater;
 
 class SigninBrowserStateInfoUpdaterFactory
-    : public BrowserStateKeyedServiceFactory {
+    : public AuditedBrowserStateKeyedServiceFactory {
  public:
   // Returns nullptr if this browser state cannot have a
   // SigninBrowserStateInfoUpdater (for example, if it is incognito).
@@ -29,8 +29,8 @@ class SigninBrowserStateInfoUpdaterFactory
   SigninBrowserStateInfoUpdaterFactory();
   ~SigninBrowserStateInfoUpdaterFactory() override;
 
-  // BrowserStateKeyedServiceFactory:
-  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+  // AuditedBrowserStateKeyedServiceFactory:
+  std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* state) const override;
   bool ServiceIsCreatedWithBrowserState() const override;
 
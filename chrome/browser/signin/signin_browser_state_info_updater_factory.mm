@@ -10,6 +10,7 @@
 
 #include "components/keyed_service/ios/browser_state_dependency_manager.h"
 #include "ios/chrome/browser/browser_state/chrome_browser_state.h"
+#include "ios/chrome/browser/browser_state/keyed_service_startup_audit.h"
 #include "ios/chrome/browser/signin/identity_manager_factory.h"
 #include "ios/chrome/browser/signin/signin_browser_state_info_updater.h"
 #include "ios/chrome/browser/signin/signin_error_controller_factory.h"
@@ -30,7 +31,7 @@ SigninBrowserStateInfoUpdaterFactory::GetInstance() {
 }
 
 SigninBrowserStateInfoUpdaterFactory::SigninBrowserStateInfoUpdaterFactory()
-    : BrowserStateKeyedServiceFactory(
+    : AuditedBrowserStateKeyedServiceFactory(
           "SigninBrowserStateInfoUpdater",
           BrowserStateDependencyManager::GetInstance()) {
   DependsOn(IdentityManagerFactory::GetInstance());
@@ -40,7 +41,7 @@ SigninBrowserStateInfoUpdaterFactory::SigninBrowserStateInfoUpdaterFactory()
 SigninBrowserStateInfoUpdaterFactory::~SigninBrowserStateInfoUpdaterFactory() {}
 
 std::unique_ptr<KeyedService>
-SigninBrowserStateInfoUpdaterFactory::BuildServiceInstanceFor(
+SigninBrowserStateInfoUpdaterFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* state) const {
   ChromeBrowserState* chrome_browser_state =
       ChromeBrowserState::FromBrowserState(state);
@@ -53,5 +54,5 @@ SigninBrowserStateInfoUpdaterFactory::BuildServiceInstanceFor(
 
 bool SigninBrowserStateInfoUpdaterFactory::ServiceIsCreatedWithBrowserState()
     const {
-  return true;
+  return ShouldCreateDeferrableServicesWithBrowserState();
 }
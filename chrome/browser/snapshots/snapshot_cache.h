@@ -53,6 +53,13 @@ class Time;
 // Removes the image from both the LRU and disk.
 - (void)removeImageWithSnapshotID:(NSString*)snapshotID;
 
+// Removes the color and grey images from memory, keeping them on disk.
+- (void)removeImageFromMemoryWithSnapshotID:(NSString*)snapshotID;
+
+// Returns the number of bytes used by the decoded images held in memory for
+// |snapshotID|.
+- (NSUInteger)memoryCostForSnapshotID:(NSString*)snapshotID;
+
 // Removes all images from the LRU and disk.
 - (void)removeAllImages;
 
@@ -64,7 +71,9 @@ class Time;
 
 // Purge the cache of snapshots that are older than |date|. The snapshots for
 // |liveSnapshotIDs| will be kept. This will be done asynchronously on a
-// background thread.
+// background thread. The snapshots to purge are found from a manifest of the
+// saved snapshots, and the cache directory is only enumerated when the
+// manifest is missing or outdated.
 - (void)purgeCacheOlderThan:(const base::Time&)date
                     keeping:(NSSet*)liveSnapshotIDs;
 
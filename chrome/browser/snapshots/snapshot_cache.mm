@@ -7,9 +7,15 @@
 
 #import <UIKit/UIKit.h>
 
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
 #include "base/base_paths.h"
 #include "base/bind.h"
 #include "base/containers/contains.h"
+#include "base/files/file.h"
 #include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
@@ -24,9 +30,11 @@
 #include "base/task/thread_pool.h"
 #include "base/task_runner_util.h"
 #include "base/threading/scoped_blocking_call.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "base/time/time.h"
 #import "ios/chrome/browser/snapshots/snapshot_cache_observer.h"
 #import "ios/chrome/browser/snapshots/snapshot_lru_cache.h"
+#import "ios/chrome/browser/snapshots/snapshot_storage_manifest.h"
 #include "ios/chrome/browser/ui/util/ui_util.h"
 #import "ios/chrome/browser/ui/util/uikit_ui_util.h"
 
@@ -74,6 +82,10 @@ const CGFloat kJPEGImageQuality = 1.0;  // Highest quality. No compression.
 // starting to evict elements.
 const NSUInteger kLRUCacheMaxCapacity = 6;
 
+// Number of orphan snapshots deleted by each task when purging the cache, so
+// that the purge does not delay the other tasks of the cache's sequence.
+const size_t kOrphanSnapshotsDeletedPerTask = 10;
+
 // Returns the path of the image for |snapshot_id|, in |cache_directory|,
 // of type |image_type| and scale |image_scale|.
 base::FilePath ImagePath(NSString* snapshot_id,
@@ -266,7 +278,78 @@ void RemoveAllImages(const base::FilePath& cache_directory) {
   }
 }
 
-void PurgeCacheOlderThan(const base::FilePath& cache_directory,
+void AddSnapshotsToManifest(scoped_refptr<SnapshotStorageManifest> manifest,
+                           NSSet<NSString*>* snapshot_ids) {
+  for (NSString* snapshot_id in snapshot_ids)
+    manifest->AddSnapshot(base::SysNSStringToUTF8(snapshot_id));
+}
+
+// Records the outcome of a purge of the cache.
+void RecordPurgeResult(int64_t bytes_reclaimed, int orphan_count) {
+  base::UmaHistogramMemoryKB("IOS.Snapshots.Purge.BytesReclaimed",
+                             bytes_reclaimed / 1024);
+  base::UmaHistogramCounts1000("IOS.Snapshots.Purge.OrphanCount",
+                               orphan_count);
+}
+
+// Deletes the snapshots for |orphan_ids|, starting at |next_index|, unless
+// they were modified after |threshold_date|. Only deletes a few snapshots,
+// then posts a task to delete the next ones.
+void DeleteOrphanSnapshots(scoped_refptr<SnapshotStorageManifest> manifest,
+                           const base::FilePath& cache_directory,
+                           const base::Time& threshold_date,
+                           ImageScale snapshot_scale,
+                           std::vector<std::string> orphan_ids,
+                           size_t next_index,
+                           int64_t bytes_reclaimed,
+                           int orphan_count) {
+  base::ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                                base::BlockingType::WILL_BLOCK);
+
+  const size_t end_index = std::min(
+      orphan_ids.size(), next_index + kOrphanSnapshotsDeletedPerTask);
+  for (; next_index < end_index; ++next_index) {
+    const std::string& orphan_id = orphan_ids[next_index];
+    NSString* snapshot_id = base::SysUTF8ToNSString(orphan_id);
+    bool keep = false;
+    for (const ImageType image_type : kImageTypes) {
+      const base::FilePath image_path =
+          ImagePath(snapshot_id, image_type, snapshot_scale, cache_directory);
+      base::File::Info file_info;
+      if (!base::GetFileInfo(image_path, &file_info))
+        continue;
+      if (file_info.last_modified > threshold_date) {
+        keep = true;
+        continue;
+      }
+      if (base::DeleteFile(image_path))
+        bytes_reclaimed += file_info.size;
+    }
+    if (!keep) {
+      manifest->RemoveSnapshot(orphan_id);
+      ++orphan_count;
+    }
+  }
+
+  if (next_index < orphan_ids.size()) {
+    base::SequencedTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE,
+        base::BindOnce(&DeleteOrphanSnapshots, manifest, cache_directory,
+                       threshold_date, snapshot_scale, std::move(orphan_ids),
+                       next_index, bytes_reclaimed, orphan_count));
+    return;
+  }
+
+  RecordPurgeResult(bytes_reclaimed, orphan_count);
+  manifest->SaveIfNeeded();
+}
+
+// Deletes the snapshots which are not for |keep_alive_snapshot_ids| and were
+// not modified after |threshold_date|. The snapshots to delete are found from
+// |manifest| if it is authoritative, otherwise by enumerating the directory,
+// which also rebuilds the manifest.
+void PurgeCacheOlderThan(scoped_refptr<SnapshotStorageManifest> manifest,
+                         const base::FilePath& cache_directory,
                          const base::Time& threshold_date,
                          NSSet<NSString*>* keep_alive_snapshot_ids,
                          ImageScale snapshot_scale) {
@@ -276,6 +359,23 @@ void PurgeCacheOlderThan(const base::FilePath& cache_directory,
   if (!base::DirectoryExists(cache_directory))
     return;
 
+  const bool use_manifest = manifest->IsAuthoritative();
+  base::UmaHistogramBoolean("IOS.Snapshots.Purge.ManifestUsed", use_manifest);
+  if (use_manifest) {
+    base::UmaHistogramTimes("IOS.Snapshots.Purge.ScanTimeAvoided",
+                            manifest->last_scan_duration());
+    std::set<std::string> live_ids;
+    for (NSString* snapshot_id in keep_alive_snapshot_ids)
+      live_ids.insert(base::SysNSStringToUTF8(snapshot_id));
+    DeleteOrphanSnapshots(manifest, cache_directory, threshold_date,
+                          snapshot_scale,
+                          manifest->GetOrphanSnapshotIDs(live_ids),
+                          /*next_index=*/0, /*bytes_reclaimed=*/0,
+                          /*orphan_count=*/0);
+    return;
+  }
+
+  const base::TimeTicks scan_start = base::TimeTicks::Now();
   std::set<base::FilePath> files_to_keep;
   for (NSString* snapshot_id in keep_alive_snapshot_ids) {
     for (const ImageType image_type : kImageTypes) {
@@ -286,18 +386,35 @@ void PurgeCacheOlderThan(const base::FilePath& cache_directory,
   base::FileEnumerator enumerator(cache_directory, false,
                                   base::FileEnumerator::FILES);
 
+  std::set<std::string> remaining_ids;
+  std::set<std::string> deleted_ids;
+  int64_t bytes_reclaimed = 0;
   for (base::FilePath current_file = enumerator.Next(); !current_file.empty();
        current_file = enumerator.Next()) {
-    if (current_file.Extension() != ".jpg")
-      continue;
-    if (base::Contains(files_to_keep, current_file))
+    const std::string snapshot_id =
+        SnapshotStorageManifest::SnapshotIDFromFileName(current_file);
+    if (snapshot_id.empty())
       continue;
     base::FileEnumerator::FileInfo file_info = enumerator.GetInfo();
-    if (file_info.GetLastModifiedTime() > threshold_date)
+    if (base::Contains(files_to_keep, current_file) ||
+        file_info.GetLastModifiedTime() > threshold_date) {
+      remaining_ids.insert(snapshot_id);
       continue;
+    }
 
-    base::DeleteFile(current_file);
+    if (base::DeleteFile(current_file)) {
+      bytes_reclaimed += file_info.GetSize();
+      deleted_ids.insert(snapshot_id);
+    } else {
+      remaining_ids.insert(snapshot_id);
+    }
   }
+  const base::TimeDelta scan_duration = base::TimeTicks::Now() - scan_start;
+
+  base::UmaHistogramTimes("IOS.Snapshots.Purge.ScanTime", scan_duration);
+  RecordPurgeResult(bytes_reclaimed, static_cast<int>(deleted_ids.size()));
+  manifest->ResetFromScan(remaining_ids, scan_duration);
+  manifest->SaveIfNeeded();
 }
 
 void CreateCacheDirectory(const base::FilePath& cache_directory) {
@@ -325,6 +442,14 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
   return GreyImage(image);
 }
 
+// Returns the number of bytes used by the decoded bitmap of |image|.
+NSUInteger MemoryCostForImage(UIImage* image) {
+  if (!image)
+    return 0;
+  return CGImageGetBytesPerRow(image.CGImage) *
+         CGImageGetHeight(image.CGImage);
+}
+
 }  // anonymous namespace
 
 @implementation SnapshotCache {
@@ -354,6 +479,10 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
   // Directory where the thumbnails are saved.
   base::FilePath _cacheDirectory;
 
+  // Records the snapshots saved in |_cacheDirectory|. Only used on
+  // |_taskRunner|.
+  scoped_refptr<SnapshotStorageManifest> _manifest;
+
   // Task runner used to run tasks in the background. Will be invalidated when
   // -shutdown is invoked. Code should support this value to be null (generally
   // by not posting the task).
@@ -369,6 +498,7 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
     _lruCache =
         [[SnapshotLRUCache alloc] initWithCacheSize:kLRUCacheMaxCapacity];
     _cacheDirectory = storagePath;
+    _manifest = base::MakeRefCounted<SnapshotStorageManifest>(storagePath);
     _snapshotsScale = ImageScaleForDevice();
 
     _taskRunner = base::ThreadPool::CreateSequencedTaskRunner(
@@ -466,6 +596,10 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
       FROM_HERE, base::BindOnce(&WriteImageToDisk, image,
                                 ImagePath(snapshotID, IMAGE_TYPE_COLOR,
                                           _snapshotsScale, _cacheDirectory)));
+  _taskRunner->PostTask(
+      FROM_HERE,
+      base::BindOnce(&SnapshotStorageManifest::AddSnapshot, _manifest,
+                     base::SysNSStringToUTF8(snapshotID)));
 }
 
 - (void)removeImageWithSnapshotID:(NSString*)snapshotID {
@@ -481,6 +615,33 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
   _taskRunner->PostTask(
       FROM_HERE, base::BindOnce(&DeleteImageWithSnapshotID, _cacheDirectory,
                                 snapshotID, _snapshotsScale));
+  _taskRunner->PostTask(
+      FROM_HERE,
+      base::BindOnce(&SnapshotStorageManifest::RemoveSnapshot, _manifest,
+                     base::SysNSStringToUTF8(snapshotID)));
+}
+
+- (void)removeImageFromMemoryWithSnapshotID:(NSString*)snapshotID {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
+
+  [_lruCache removeObjectForKey:snapshotID];
+  [_greyImageDictionary removeObjectForKey:snapshotID];
+  if ([_backgroundingSnapshotID isEqualToString:snapshotID])
+    _backgroundingColorImage = nil;
+}
+
+- (NSUInteger)memoryCostForSnapshotID:(NSString*)snapshotID {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
+
+  // Peek so that measuring the cost does not change the eviction order.
+  UIImage* image = [_lruCache peekObjectForKey:snapshotID];
+  NSUInteger cost = MemoryCostForImage(image) +
+                    MemoryCostForImage(_greyImageDictionary[snapshotID]);
+  if ([_backgroundingSnapshotID isEqualToString:snapshotID] &&
+      _backgroundingColorImage != image) {
+    cost += MemoryCostForImage(_backgroundingColorImage);
+  }
+  return cost;
 }
 
 - (void)removeAllImages {
@@ -493,6 +654,9 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
 
   _taskRunner->PostTask(FROM_HERE,
                         base::BindOnce(&RemoveAllImages, _cacheDirectory));
+  _taskRunner->PostTask(
+      FROM_HERE,
+      base::BindOnce(&SnapshotStorageManifest::RemoveAllSnapshots, _manifest));
 }
 
 - (base::FilePath)imagePathForSnapshotID:(NSString*)snapshotID {
@@ -514,6 +678,8 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
   _taskRunner->PostTask(
       FROM_HERE, base::BindOnce(&MigrateSnapshotsWithIDs, sourcePath,
                                 _cacheDirectory, snapshotIDs, _snapshotsScale));
+  _taskRunner->PostTask(FROM_HERE, base::BindOnce(&AddSnapshotsToManifest,
+                                                  _manifest, snapshotIDs));
 }
 
 - (void)purgeCacheOlderThan:(const base::Time&)date
@@ -524,8 +690,9 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
     return;
 
   _taskRunner->PostTask(
-      FROM_HERE, base::BindOnce(&PurgeCacheOlderThan, _cacheDirectory, date,
-                                liveSnapshotIDs, _snapshotsScale));
+      FROM_HERE,
+      base::BindOnce(&PurgeCacheOlderThan, _manifest, _cacheDirectory, date,
+                     liveSnapshotIDs, _snapshotsScale));
 }
 
 - (void)willBeSavedGreyWhenBackgrounding:(NSString*)snapshotID {
@@ -552,10 +719,11 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
                   forKey:snapshotID];
 }
 
-// Remove all UIImages from |lruCache_|.
+// Remove all UIImages from |lruCache_| and save the manifest.
 - (void)handleEnterBackground {
   DCHECK_CALLED_ON_VALID_SEQUENCE(_sequenceChecker);
   [_lruCache removeAllObjects];
+  [self saveManifest];
 }
 
 // Restore adjacent UIImages to |lruCache_|.
@@ -705,6 +873,7 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
 }
 
 - (void)shutdown {
+  [self saveManifest];
   _taskRunner = nullptr;
 }
 
@@ -719,12 +888,22 @@ UIImage* GreyImageFromCachedImage(const base::FilePath& cache_directory,
                         base::BindOnce(CreateCacheDirectory, _cacheDirectory));
 }
 
+// Writes the manifest to disk, if it changed since it was last written.
+- (void)saveManifest {
+  if (!_taskRunner)
+    return;
+
+  _taskRunner->PostTask(
+      FROM_HERE,
+      base::BindOnce(&SnapshotStorageManifest::SaveIfNeeded, _manifest));
+}
+
 @end
 
 @implementation SnapshotCache (TestingAdditions)
 
 - (BOOL)hasImageInMemory:(NSString*)snapshotID {
-  return [_lruCache objectForKey:snapshotID] != nil;
+  return [_lruCache peekObjectForKey:snapshotID] != nil;
 }
 
 - (BOOL)hasGreyImageInMemory:(NSString*)snapshotID {
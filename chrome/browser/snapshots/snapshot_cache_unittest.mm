@@ -15,6 +15,7 @@
 #include "base/run_loop.h"
 #include "base/strings/sys_string_conversions.h"
 #include "base/task/thread_pool/thread_pool_instance.h"
+#include "base/test/metrics/histogram_tester.h"
 #include "base/time/time.h"
 #import "ios/chrome/browser/snapshots/snapshot_cache_internal.h"
 #import "ios/chrome/browser/snapshots/snapshot_cache_observer.h"
@@ -426,6 +427,43 @@ TEST_F(SnapshotCacheTest, Purge) {
   }
 }
 
+// Tests that once the cache directory has been scanned, the snapshots to purge
+// are found from the manifest.
+TEST_F(SnapshotCacheTest, PurgeUsesManifest) {
+  SnapshotCache* cache = GetSnapshotCache();
+  LoadAllColorImagesIntoCache(true);
+
+  NSSet* liveSnapshotIDs = [NSSet setWithObject:snapshotIDs_[0]];
+  base::HistogramTester histogram_tester;
+
+  // The first purge scans the directory, and keeps the recent snapshots.
+  [cache purgeCacheOlderThan:(base::Time::Now() - base::TimeDelta::FromHours(1))
+                     keeping:liveSnapshotIDs];
+  FlushRunLoops();
+  histogram_tester.ExpectUniqueSample("IOS.Snapshots.Purge.ManifestUsed",
+                                      false, 1);
+
+  // A snapshot written behind the cache's back is not in the manifest.
+  base::FilePath unknownPath = [cache imagePathForSnapshotID:@"unknown"];
+  ASSERT_TRUE(base::CopyFile([cache imagePathForSnapshotID:snapshotIDs_[1]],
+                             unknownPath));
+
+  // The second purge uses the manifest, so it only deletes the snapshots it
+  // knows about.
+  [cache purgeCacheOlderThan:base::Time::Now() keeping:liveSnapshotIDs];
+  FlushRunLoops();
+  histogram_tester.ExpectBucketCount("IOS.Snapshots.Purge.ManifestUsed", true,
+                                     1);
+  histogram_tester.ExpectBucketCount("IOS.Snapshots.Purge.OrphanCount",
+                                     kSnapshotCount - 1, 1);
+
+  EXPECT_TRUE(base::PathExists([cache imagePathForSnapshotID:snapshotIDs_[0]]));
+  for (NSUInteger i = 1; i < kSnapshotCount; ++i)
+    EXPECT_FALSE(
+        base::PathExists([cache imagePathForSnapshotID:snapshotIDs_[i]]));
+  EXPECT_TRUE(base::PathExists(unknownPath));
+}
+
 // Loads the color images into the cache, and pins two of them.  Ensures that
 // only the two pinned IDs remain in memory after a memory warning.
 TEST_F(SnapshotCacheTest, HandleMemoryWarning) {
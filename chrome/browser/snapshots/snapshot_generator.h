@@ -56,6 +56,9 @@ class WebState;
 // Requests deletion of the current page snapshot from disk and memory.
 - (void)removeSnapshot;
 
+// Requests deletion of the current page snapshot from memory only.
+- (void)removeSnapshotFromMemory;
+
 // The SnapshotGenerator delegate.
 @property(nonatomic, weak) id<SnapshotGeneratorDelegate> delegate;
 
@@ -180,6 +180,10 @@ BOOL ViewHierarchyContainsWKWebView(UIView* view) {
   [self.snapshotCache removeImageWithSnapshotID:self.tabID];
 }
 
+- (void)removeSnapshotFromMemory {
+  [self.snapshotCache removeImageFromMemoryWithSnapshotID:self.tabID];
+}
+
 #pragma mark - Private methods
 
 // Returns NO if WebState or the view is not ready for snapshot.
@@ -30,6 +30,10 @@
 // is no item corresponding to that key.
 - (id)objectForKey:(id<NSObject>)key;
 
+// Same as -objectForKey:, but does not mark the item as recently used, so the
+// eviction order is unchanged.
+- (id)peekObjectForKey:(id<NSObject>)key;
+
 // Adds the pair |key|, |obj| to the cache. If the value of the maxCacheSize
 // property is non zero, the cache may evict an elements if the maximum cache
 // size is reached. If the |key| is already present in the cache, the value for
@@ -63,6 +63,13 @@ using NSObjectMRUCache = base::MRUCacheBase<id<NSObject>,
   return it->second;
 }
 
+- (id)peekObjectForKey:(id<NSObject>)key {
+  auto it = _cache->Peek(key);
+  if (it == _cache->end())
+    return nil;
+  return it->second;
+}
+
 - (void)setObject:(id<NSObject>)value forKey:(NSObject*)key {
   _cache->Put([key copy], value);
 }
@@ -48,4 +48,23 @@ TEST_F(SnapshotLRUCacheTest, Basic) {
   EXPECT_TRUE([cache isEmpty]);
 }
 
+// Tests that peeking at an item does not protect it from eviction.
+TEST_F(SnapshotLRUCacheTest, PeekDoesNotUpdateRecency) {
+  SnapshotLRUCache* cache = [[SnapshotLRUCache alloc] initWithCacheSize:2];
+
+  NSString* value1 = @"Value 1";
+  NSString* value2 = @"Value 2";
+  NSString* value3 = @"Value 3";
+
+  [cache setObject:value1 forKey:@"VALUE 1"];
+  [cache setObject:value2 forKey:@"VALUE 2"];
+  EXPECT_TRUE([cache peekObjectForKey:@"VALUE 1"] == value1);
+  EXPECT_TRUE([cache peekObjectForKey:@"XXX"] == nil);
+
+  // The least recently used item is still evicted despite being peeked at.
+  [cache setObject:value3 forKey:@"VALUE 3"];
+  EXPECT_TRUE([cache peekObjectForKey:@"VALUE 1"] == nil);
+  EXPECT_TRUE([cache peekObjectForKey:@"VALUE 2"] == value2);
+}
+
 }  // namespace
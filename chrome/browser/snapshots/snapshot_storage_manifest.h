@@ -0,0 +1,90 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_SNAPSHOTS_SNAPSHOT_STORAGE_MANIFEST_H_
+#define IOS_CHROME_BROWSER_SNAPSHOTS_SNAPSHOT_STORAGE_MANIFEST_H_
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/sequence_checker.h"
+#include "base/time/time.h"
+
+// Records the IDs of the snapshots stored in a snapshot cache directory, in a
+// file kept in that directory, so that the snapshots which are no longer used
+// by any tab can be found without enumerating the directory.
+//
+// The manifest is only authoritative once it has been loaded from a recent
+// file or rebuilt from an enumeration of the directory. Snapshots written
+// while the manifest was not saved (e.g. if the application crashed) are
+// missed until the next enumeration, which is forced once the manifest is
+// older than a week.
+//
+// Created on any sequence, then must only be used on the sequence accessing
+// the snapshot files.
+class SnapshotStorageManifest
+    : public base::RefCountedThreadSafe<SnapshotStorageManifest> {
+ public:
+  explicit SnapshotStorageManifest(const base::FilePath& cache_directory);
+
+  SnapshotStorageManifest(const SnapshotStorageManifest&) = delete;
+  SnapshotStorageManifest& operator=(const SnapshotStorageManifest&) = delete;
+
+  // Whether the manifest lists all the snapshots of the directory. Loads the
+  // manifest file if needed.
+  bool IsAuthoritative();
+
+  // Records that the snapshot for |snapshot_id| has been written.
+  void AddSnapshot(const std::string& snapshot_id);
+
+  // Records that the snapshot for |snapshot_id| has been deleted.
+  void RemoveSnapshot(const std::string& snapshot_id);
+
+  // Records that all the snapshots have been deleted.
+  void RemoveAllSnapshots();
+
+  // Replaces the content of the manifest with |snapshot_ids|, found by
+  // enumerating the directory in |scan_duration|. The manifest becomes
+  // authoritative.
+  void ResetFromScan(const std::set<std::string>& snapshot_ids,
+                     base::TimeDelta scan_duration);
+
+  // Returns the recorded snapshot IDs which are not in |live_snapshot_ids|.
+  std::vector<std::string> GetOrphanSnapshotIDs(
+      const std::set<std::string>& live_snapshot_ids);
+
+  // Time spent enumerating the directory the last time the manifest was
+  // rebuilt.
+  base::TimeDelta last_scan_duration() const;
+
+  // Writes the manifest to disk if it changed since it was last written.
+  void SaveIfNeeded();
+
+  // Returns the ID of the snapshot stored in the file named |file_name|, or an
+  // empty string if |file_name| is not a snapshot file.
+  static std::string SnapshotIDFromFileName(const base::FilePath& file_name);
+
+ private:
+  friend class base::RefCountedThreadSafe<SnapshotStorageManifest>;
+
+  ~SnapshotStorageManifest();
+
+  // Reads the manifest file the first time it is called.
+  void LoadIfNeeded();
+
+  const base::FilePath manifest_path_;
+  std::set<std::string> snapshot_ids_;
+  base::Time last_scan_time_;
+  base::TimeDelta last_scan_duration_;
+  bool loaded_ = false;
+  bool authoritative_ = false;
+  bool dirty_ = false;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+#endif  // IOS_CHROME_BROWSER_SNAPSHOTS_SNAPSHOT_STORAGE_MANIFEST_H_
@@ -0,0 +1,194 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/snapshots/snapshot_storage_manifest.h"
+
+#import <Foundation/Foundation.h>
+
+#include "base/check.h"
+#include "base/logging.h"
+#include "base/strings/string_util.h"
+#include "base/strings/sys_string_conversions.h"
+#include "base/threading/scoped_blocking_call.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+// Name of the manifest file in the snapshot cache directory.
+const base::FilePath::CharType kManifestFileName[] =
+    FILE_PATH_LITERAL("SnapshotManifest.plist");
+
+// Keys of the manifest file.
+NSString* const kVersionKey = @"Version";
+NSString* const kSnapshotIDsKey = @"SnapshotIDs";
+NSString* const kLastScanTimeKey = @"LastScanTime";
+NSString* const kLastScanDurationKey = @"LastScanDuration";
+
+// Version of the manifest file format.
+const NSInteger kManifestVersion = 1;
+
+// Age after which the manifest is no longer trusted and the directory is
+// enumerated again.
+const base::TimeDelta kMaxManifestAge = base::TimeDelta::FromDays(7);
+
+// Suffixes appended to the snapshot IDs to build the file names.
+const char kGreySuffix[] = "Grey";
+const char* const kScaleSuffixes[] = {"@2x", "@3x"};
+
+}  // namespace
+
+SnapshotStorageManifest::SnapshotStorageManifest(
+    const base::FilePath& cache_directory)
+    : manifest_path_(cache_directory.Append(kManifestFileName)) {
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+SnapshotStorageManifest::~SnapshotStorageManifest() = default;
+
+bool SnapshotStorageManifest::IsAuthoritative() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  LoadIfNeeded();
+  return authoritative_;
+}
+
+void SnapshotStorageManifest::AddSnapshot(const std::string& snapshot_id) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  LoadIfNeeded();
+  dirty_ |= snapshot_ids_.insert(snapshot_id).second;
+}
+
+void SnapshotStorageManifest::RemoveSnapshot(const std::string& snapshot_id) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  LoadIfNeeded();
+  dirty_ |= snapshot_ids_.erase(snapshot_id) > 0;
+}
+
+void SnapshotStorageManifest::RemoveAllSnapshots() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  LoadIfNeeded();
+  snapshot_ids_.clear();
+  // The directory is now known to be empty.
+  authoritative_ = true;
+  last_scan_time_ = base::Time::Now();
+  dirty_ = true;
+}
+
+void SnapshotStorageManifest::ResetFromScan(
+    const std::set<std::string>& snapshot_ids,
+    base::TimeDelta scan_duration) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  loaded_ = true;
+  authoritative_ = true;
+  snapshot_ids_ = snapshot_ids;
+  last_scan_time_ = base::Time::Now();
+  last_scan_duration_ = scan_duration;
+  dirty_ = true;
+}
+
+std::vector<std::string> SnapshotStorageManifest::GetOrphanSnapshotIDs(
+    const std::set<std::string>& live_snapshot_ids) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  LoadIfNeeded();
+  std::vector<std::string> orphan_ids;
+  for (const std::string& snapshot_id : snapshot_ids_) {
+    if (live_snapshot_ids.find(snapshot_id) == live_snapshot_ids.end())
+      orphan_ids.push_back(snapshot_id);
+  }
+  return orphan_ids;
+}
+
+base::TimeDelta SnapshotStorageManifest::last_scan_duration() const {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  return last_scan_duration_;
+}
+
+void SnapshotStorageManifest::SaveIfNeeded() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!dirty_)
+    return;
+  dirty_ = false;
+
+  NSMutableArray<NSString*>* snapshot_ids =
+      [NSMutableArray arrayWithCapacity:snapshot_ids_.size()];
+  for (const std::string& snapshot_id : snapshot_ids_)
+    [snapshot_ids addObject:base::SysUTF8ToNSString(snapshot_id)];
+
+  // A manifest which is not authoritative is still worth saving to keep track
+  // of the changes, but it must not become authoritative when loaded.
+  NSDictionary* manifest = @{
+    kVersionKey : @(kManifestVersion),
+    kSnapshotIDsKey : snapshot_ids,
+    kLastScanTimeKey : @(authoritative_ ? last_scan_time_.ToDoubleT() : 0),
+    kLastScanDurationKey : @(last_scan_duration_.InSecondsF()),
+  };
+
+  base::ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                                base::BlockingType::MAY_BLOCK);
+  NSURL* url = [NSURL
+      fileURLWithPath:base::SysUTF8ToNSString(manifest_path_.AsUTF8Unsafe())];
+  NSError* error = nil;
+  if (![manifest writeToURL:url error:&error]) {
+    DLOG(ERROR) << "Error writing snapshot manifest "
+                << base::SysNSStringToUTF8([error description]);
+  }
+}
+
+// static
+std::string SnapshotStorageManifest::SnapshotIDFromFileName(
+    const base::FilePath& file_name) {
+  if (file_name.Extension() != ".jpg")
+    return std::string();
+
+  std::string snapshot_id =
+      file_name.BaseName().RemoveExtension().AsUTF8Unsafe();
+  for (const char* scale_suffix : kScaleSuffixes) {
+    if (base::EndsWith(snapshot_id, scale_suffix)) {
+      snapshot_id.resize(snapshot_id.size() - strlen(scale_suffix));
+      break;
+    }
+  }
+  if (base::EndsWith(snapshot_id, kGreySuffix))
+    snapshot_id.resize(snapshot_id.size() - strlen(kGreySuffix));
+  return snapshot_id;
+}
+
+void SnapshotStorageManifest::LoadIfNeeded() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (loaded_)
+    return;
+  loaded_ = true;
+
+  base::ScopedBlockingCall scoped_blocking_call(FROM_HERE,
+                                                base::BlockingType::MAY_BLOCK);
+  NSURL* url = [NSURL
+      fileURLWithPath:base::SysUTF8ToNSString(manifest_path_.AsUTF8Unsafe())];
+  NSDictionary* manifest = [NSDictionary dictionaryWithContentsOfURL:url
+                                                               error:nil];
+  if (![manifest[kVersionKey] isEqual:@(kManifestVersion)])
+    return;
+
+  NSArray* snapshot_ids = manifest[kSnapshotIDsKey];
+  NSNumber* last_scan_time = manifest[kLastScanTimeKey];
+  NSNumber* last_scan_duration = manifest[kLastScanDurationKey];
+  if (![snapshot_ids isKindOfClass:[NSArray class]] ||
+      ![last_scan_time isKindOfClass:[NSNumber class]] ||
+      ![last_scan_duration isKindOfClass:[NSNumber class]]) {
+    return;
+  }
+
+  for (NSString* snapshot_id in snapshot_ids) {
+    if ([snapshot_id isKindOfClass:[NSString class]])
+      snapshot_ids_.insert(base::SysNSStringToUTF8(snapshot_id));
+  }
+  last_scan_time_ = base::Time::FromDoubleT(last_scan_time.doubleValue);
+  last_scan_duration_ =
+      base::TimeDelta::FromSecondsD(last_scan_duration.doubleValue);
+
+  const base::Time now = base::Time::Now();
+  authoritative_ = !last_scan_time_.is_null() && last_scan_time_ <= now &&
+                   now - last_scan_time_ < kMaxManifestAge;
+}
@@ -0,0 +1,87 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/snapshots/snapshot_storage_manifest.h"
+
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+class SnapshotStorageManifestTest : public PlatformTest {
+ protected:
+  void SetUp() override {
+    PlatformTest::SetUp();
+    ASSERT_TRUE(scoped_temp_directory_.CreateUniqueTempDir());
+  }
+
+  // Returns a manifest for the temporary directory, as if the application was
+  // restarted.
+  scoped_refptr<SnapshotStorageManifest> CreateManifest() {
+    return base::MakeRefCounted<SnapshotStorageManifest>(
+        scoped_temp_directory_.GetPath());
+  }
+
+  base::ScopedTempDir scoped_temp_directory_;
+};
+
+// Tests that the snapshot IDs are extracted from the snapshot file names.
+TEST_F(SnapshotStorageManifestTest, SnapshotIDFromFileName) {
+  EXPECT_EQ("tab1", SnapshotStorageManifest::SnapshotIDFromFileName(
+                        base::FilePath("tab1.jpg")));
+  EXPECT_EQ("tab1", SnapshotStorageManifest::SnapshotIDFromFileName(
+                        base::FilePath("tab1@2x.jpg")));
+  EXPECT_EQ("tab1", SnapshotStorageManifest::SnapshotIDFromFileName(
+                        base::FilePath("tab1Grey@3x.jpg")));
+  EXPECT_EQ("", SnapshotStorageManifest::SnapshotIDFromFileName(
+                    base::FilePath("SnapshotManifest.plist")));
+}
+
+// Tests that a manifest is not authoritative until the directory is scanned.
+TEST_F(SnapshotStorageManifestTest, NotAuthoritativeWithoutScan) {
+  scoped_refptr<SnapshotStorageManifest> manifest = CreateManifest();
+  manifest->AddSnapshot("tab1");
+  manifest->SaveIfNeeded();
+  EXPECT_FALSE(manifest->IsAuthoritative());
+
+  EXPECT_FALSE(CreateManifest()->IsAuthoritative());
+}
+
+// Tests that the orphan snapshots are found from a saved manifest.
+TEST_F(SnapshotStorageManifestTest, OrphansFromSavedManifest) {
+  scoped_refptr<SnapshotStorageManifest> manifest = CreateManifest();
+  manifest->ResetFromScan({"tab1", "tab2"},
+                          base::TimeDelta::FromMilliseconds(30));
+  manifest->AddSnapshot("tab3");
+  manifest->RemoveSnapshot("tab2");
+  manifest->SaveIfNeeded();
+
+  scoped_refptr<SnapshotStorageManifest> loaded_manifest = CreateManifest();
+  EXPECT_TRUE(loaded_manifest->IsAuthoritative());
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(30),
+            loaded_manifest->last_scan_duration());
+  EXPECT_EQ(std::vector<std::string>({"tab3"}),
+            loaded_manifest->GetOrphanSnapshotIDs({"tab1"}));
+}
+
+// Tests that removing all the snapshots makes the manifest authoritative.
+TEST_F(SnapshotStorageManifestTest, RemoveAllSnapshots) {
+  scoped_refptr<SnapshotStorageManifest> manifest = CreateManifest();
+  manifest->AddSnapshot("tab1");
+  manifest->RemoveAllSnapshots();
+  manifest->SaveIfNeeded();
+
+  scoped_refptr<SnapshotStorageManifest> loaded_manifest = CreateManifest();
+  EXPECT_TRUE(loaded_manifest->IsAuthoritative());
+  EXPECT_TRUE(loaded_manifest->GetOrphanSnapshotIDs({}).empty());
+}
+
+}  // namespace
@@ -67,6 +67,10 @@ class SnapshotTabHelper : public web::WebStateObserver,
   // Requests deletion of the current page snapshot from disk and memory.
   void RemoveSnapshot();
 
+  // Requests deletion of the current page snapshot from memory, keeping it on
+  // disk.
+  void RemoveSnapshotFromMemory();
+
   // Instructs the helper not to snapshot content for the next page load event.
   void IgnoreNextLoad();
 
@@ -97,6 +97,10 @@ void SnapshotTabHelper::RemoveSnapshot() {
   [snapshot_generator_ removeSnapshot];
 }
 
+void SnapshotTabHelper::RemoveSnapshotFromMemory() {
+  [snapshot_generator_ removeSnapshotFromMemory];
+}
+
 void SnapshotTabHelper::IgnoreNextLoad() {
   ignore_next_load_ = true;
 }
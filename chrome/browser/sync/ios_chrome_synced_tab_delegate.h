@@ -5,25 +5,51 @@
 #ifndef IOS_CHROME_BROWSER_SYNC_IOS_CHROME_SYNCED_TAB_DELEGATE_H_
 #define IOS_CHROME_BROWSER_SYNC_IOS_CHROME_SYNCED_TAB_DELEGATE_H_
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "base/compiler_specific.h"
 #include "base/macros.h"
+#include "base/scoped_observation.h"
+#include "components/sessions/core/serialized_navigation_entry.h"
 #include "components/sessions/core/session_id.h"
 #include "components/sync_sessions/synced_tab_delegate.h"
+#include "ios/web/public/web_state_observer.h"
 #import "ios/web/public/web_state_user_data.h"
 
 @class CRWSessionStorage;
 class IOSTaskTabHelper;
 
+// The SyncedTabDelegate of a WebState. The serialized navigation entries of
+// the committed items are cached until a navigation is committed or the title
+// of the page changes, so that a sync cycle only serializes the entries of the
+// tabs which changed. The favicon URL is set by the favicon driver after the
+// page loads, so it is not cached but read from the item each time.
 class IOSChromeSyncedTabDelegate
     : public sync_sessions::SyncedTabDelegate,
+      public web::WebStateObserver,
       public web::WebStateUserData<IOSChromeSyncedTabDelegate> {
  public:
+  // Number of serialized navigation entries requested by sync, by whether
+  // they were built or taken from the cache.
+  struct SerializationCounts {
+    int rebuilt = 0;
+    int reused = 0;
+  };
+
   ~IOSChromeSyncedTabDelegate() override;
 
+  // Returns the serialization counts of the tab since the last call, and
+  // resets them.
+  SerializationCounts TakeSerializationCounts();
+
+  // Whether the session data of the tab changed since the last call to
+  // ClearDirty().
+  bool IsDirty() const { return dirty_; }
+  void ClearDirty() { dirty_ = false; }
+
   // SyncedTabDelegate:
   SessionID GetWindowId() const override;
   SessionID GetSessionId() const override;
@@ -53,6 +79,19 @@ class IOSChromeSyncedTabDelegate
   const IOSTaskTabHelper* ios_task_tab_helper() const;
   friend class web::WebStateUserData<IOSChromeSyncedTabDelegate>;
 
+  // web::WebStateObserver:
+  EventMask GetObservedEvents() const override;
+  void DidFinishNavigation(web::WebState* web_state,
+                           web::NavigationContext* navigation_context) override;
+  void TitleWasSet(web::WebState* web_state) override;
+  void FaviconUrlUpdated(
+      web::WebState* web_state,
+      const std::vector<web::FaviconURL>& candidates) override;
+  void WebStateDestroyed(web::WebState* web_state) override;
+
+  // Drops the cached serialized entries and marks the tab as dirty.
+  void InvalidateSerializedEntries();
+
   // Whether navigation data should be taken from session storage.
   // Storage must be used if slim navigation is enabled and the tab has not be
   // displayed.
@@ -63,6 +102,20 @@ class IOSChromeSyncedTabDelegate
   web::WebState* web_state_;
   mutable CRWSessionStorage* session_storage_;
 
+  // Serialized entries of the committed items, by index.
+  mutable std::map<int, sessions::SerializedNavigationEntry>
+      serialized_entries_;
+
+  // Serialization counts since the last call to TakeSerializationCounts().
+  mutable SerializationCounts serialization_counts_;
+
+  // Whether the session data changed since the last call to ClearDirty(). A
+  // new tab has never been synced.
+  bool dirty_ = true;
+
+  base::ScopedObservation<web::WebState, web::WebStateObserver>
+      web_state_observation_{this};
+
   WEB_STATE_USER_DATA_KEY_DECL();
 
   DISALLOW_COPY_AND_ASSIGN(IOSChromeSyncedTabDelegate);
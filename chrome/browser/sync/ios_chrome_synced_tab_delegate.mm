@@ -13,6 +13,7 @@
 #import "ios/chrome/browser/complex_tasks/ios_task_tab_helper.h"
 #include "ios/chrome/browser/sessions/ios_chrome_session_tab_helper.h"
 #include "ios/web/public/favicon/favicon_status.h"
+#include "ios/web/public/navigation/navigation_context.h"
 #include "ios/web/public/navigation/navigation_item.h"
 #import "ios/web/public/navigation/navigation_manager.h"
 #include "ios/web/public/session/crw_navigation_item_storage.h"
@@ -44,10 +45,18 @@ NavigationItem* GetPossiblyPendingItemAtIndex(web::WebState* web_state, int i) {
 IOSChromeSyncedTabDelegate::IOSChromeSyncedTabDelegate(web::WebState* web_state)
     : web_state_(web_state) {
   DCHECK(web_state);
+  web_state_observation_.Observe(web_state_);
 }
 
 IOSChromeSyncedTabDelegate::~IOSChromeSyncedTabDelegate() {}
 
+IOSChromeSyncedTabDelegate::SerializationCounts
+IOSChromeSyncedTabDelegate::TakeSerializationCounts() {
+  SerializationCounts counts = serialization_counts_;
+  serialization_counts_ = SerializationCounts();
+  return counts;
+}
+
 SessionID IOSChromeSyncedTabDelegate::GetWindowId() const {
   return IOSChromeSessionTabHelper::FromWebState(web_state_)->window_id();
 }
@@ -140,7 +149,13 @@ std::string IOSChromeSyncedTabDelegate::GetPageLanguageAtIndex(int i) const {
 void IOSChromeSyncedTabDelegate::GetSerializedNavigationAtIndex(
     int i,
     sessions::SerializedNavigationEntry* serialized_entry) const {
+  auto cached_entry = serialized_entries_.find(i);
   if (GetSessionStorageIfNeeded()) {
+    if (cached_entry != serialized_entries_.end()) {
+      serialization_counts_.reused++;
+      *serialized_entry = cached_entry->second;
+      return;
+    }
     NSArray* item_storages = session_storage_.itemStorages;
     DCHECK_GE(i, 0);
     DCHECK_LT(i, static_cast<int>(item_storages.count));
@@ -148,13 +163,28 @@ void IOSChromeSyncedTabDelegate::GetSerializedNavigationAtIndex(
     *serialized_entry =
         sessions::IOSSerializedNavigationBuilder::FromNavigationStorageItem(
             i, item);
+    serialization_counts_.rebuilt++;
+    serialized_entries_[i] = *serialized_entry;
     return;
   }
   NavigationItem* item = GetPossiblyPendingItemAtIndex(web_state_, i);
-  if (item) {
-    *serialized_entry =
-        sessions::IOSSerializedNavigationBuilder::FromNavigationItem(i, *item);
+  if (!item)
+    return;
+  // The entry is only reused if it was built for the same item, in case sync
+  // asks for it before this delegate is notified of a committed navigation.
+  if (cached_entry != serialized_entries_.end() &&
+      cached_entry->second.unique_id() == item->GetUniqueID()) {
+    serialization_counts_.reused++;
+    *serialized_entry = cached_entry->second;
+    serialized_entry->set_favicon_url(item->GetFavicon().url);
+    return;
   }
+  *serialized_entry =
+      sessions::IOSSerializedNavigationBuilder::FromNavigationItem(i, *item);
+  serialization_counts_.rebuilt++;
+  // The pending item may change without a navigation being committed.
+  if (i != web_state_->GetNavigationManager()->GetPendingItemIndex())
+    serialized_entries_[i] = *serialized_entry;
 }
 
 bool IOSChromeSyncedTabDelegate::ProfileIsSupervised() const {
@@ -233,9 +263,15 @@ const IOSTaskTabHelper* IOSChromeSyncedTabDelegate::ios_task_tab_helper()
 
 bool IOSChromeSyncedTabDelegate::GetSessionStorageIfNeeded() const {
   // With slim navigation, the navigation manager is only restored when the tab
-  // is displayed. Before restoration, the session storage must be used.
+  // is displayed. Before restoration, the session storage must be used. A
+  // lazily restored session has items but none is committed until its last
+  // committed item is loaded again, so the storage is used until then too.
+  web::NavigationManager* navigation_manager =
+      web_state_->GetNavigationManager();
   bool should_use_storage =
-      web_state_->GetNavigationManager()->IsRestoreSessionInProgress();
+      navigation_manager->IsRestoreSessionInProgress() ||
+      (navigation_manager->GetItemCount() > 0 &&
+       navigation_manager->GetLastCommittedItemIndex() == -1);
   bool storage_has_navigation_items = false;
   if (should_use_storage) {
     if (!session_storage_) {
@@ -253,4 +289,42 @@ bool IOSChromeSyncedTabDelegate::GetSessionStorageIfNeeded() const {
   return should_use_storage && storage_has_navigation_items;
 }
 
+web::WebStateObserver::EventMask
+IOSChromeSyncedTabDelegate::GetObservedEvents() const {
+  return EventBit(Event::kDidFinishNavigation) |
+         EventBit(Event::kTitleWasSet) | EventBit(Event::kFaviconUrlUpdated);
+}
+
+void IOSChromeSyncedTabDelegate::DidFinishNavigation(
+    web::WebState* web_state,
+    web::NavigationContext* navigation_context) {
+  if (!navigation_context->HasCommitted())
+    return;
+  // The session storage is only used until the navigation manager is restored,
+  // which is done by the time a navigation is committed.
+  session_storage_ = nil;
+  InvalidateSerializedEntries();
+}
+
+void IOSChromeSyncedTabDelegate::TitleWasSet(web::WebState* web_state) {
+  InvalidateSerializedEntries();
+}
+
+void IOSChromeSyncedTabDelegate::FaviconUrlUpdated(
+    web::WebState* web_state,
+    const std::vector<web::FaviconURL>& candidates) {
+  // The favicon URL is not cached, but the tab needs to be synced again.
+  dirty_ = true;
+}
+
+void IOSChromeSyncedTabDelegate::WebStateDestroyed(web::WebState* web_state) {
+  DCHECK_EQ(web_state_, web_state);
+  web_state_observation_.Reset();
+}
+
+void IOSChromeSyncedTabDelegate::InvalidateSerializedEntries() {
+  serialized_entries_.clear();
+  dirty_ = true;
+}
+
 WEB_STATE_USER_DATA_KEY_IMPL(IOSChromeSyncedTabDelegate)
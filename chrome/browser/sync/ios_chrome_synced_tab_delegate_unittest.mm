@@ -6,6 +6,10 @@
 
 #include <memory>
 
+#include "components/sessions/core/serialized_navigation_entry.h"
+#include "ios/web/public/favicon/favicon_status.h"
+#include "ios/web/public/navigation/navigation_item.h"
+#import "ios/web/public/test/fakes/fake_navigation_context.h"
 #import "ios/web/public/test/fakes/fake_navigation_manager.h"
 #import "ios/web/public/test/fakes/fake_web_state.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -43,4 +47,132 @@ TEST_F(IOSChromeSyncedTabDelegateTest, ShouldHandleNullItem) {
   EXPECT_TRUE(tab_delegate->GetPageLanguageAtIndex(0).empty());
 }
 
+// Tests that the serialized entries are cached until a navigation is
+// committed.
+TEST_F(IOSChromeSyncedTabDelegateTest, CachesSerializedEntries) {
+  auto navigation_manager = std::make_unique<web::FakeNavigationManager>();
+  navigation_manager->AddItem(GURL("http://first.test/"),
+                              ui::PAGE_TRANSITION_TYPED);
+  navigation_manager->AddItem(GURL("http://second.test/"),
+                              ui::PAGE_TRANSITION_LINK);
+  navigation_manager->SetLastCommittedItemIndex(1);
+
+  web::FakeWebState web_state;
+  web_state.SetNavigationManager(std::move(navigation_manager));
+  IOSChromeSyncedTabDelegate::CreateForWebState(&web_state);
+  IOSChromeSyncedTabDelegate* tab_delegate =
+      IOSChromeSyncedTabDelegate::FromWebState(&web_state);
+
+  // A new tab has not been synced yet.
+  EXPECT_TRUE(tab_delegate->IsDirty());
+  tab_delegate->ClearDirty();
+
+  sessions::SerializedNavigationEntry entry;
+  tab_delegate->GetSerializedNavigationAtIndex(1, &entry);
+  EXPECT_EQ(GURL("http://second.test/"), entry.virtual_url());
+  tab_delegate->GetSerializedNavigationAtIndex(1, &entry);
+  EXPECT_EQ(GURL("http://second.test/"), entry.virtual_url());
+  IOSChromeSyncedTabDelegate::SerializationCounts counts =
+      tab_delegate->TakeSerializationCounts();
+  EXPECT_EQ(1, counts.rebuilt);
+  EXPECT_EQ(1, counts.reused);
+
+  // A navigation which is not committed does not invalidate the cache.
+  web::FakeNavigationContext uncommitted_context;
+  web_state.OnNavigationFinished(&uncommitted_context);
+  EXPECT_FALSE(tab_delegate->IsDirty());
+  tab_delegate->GetSerializedNavigationAtIndex(1, &entry);
+  counts = tab_delegate->TakeSerializationCounts();
+  EXPECT_EQ(0, counts.rebuilt);
+  EXPECT_EQ(1, counts.reused);
+
+  // A committed navigation invalidates the cache.
+  web::FakeNavigationContext committed_context;
+  committed_context.SetHasCommitted(true);
+  web_state.OnNavigationFinished(&committed_context);
+  EXPECT_TRUE(tab_delegate->IsDirty());
+  tab_delegate->GetSerializedNavigationAtIndex(1, &entry);
+  counts = tab_delegate->TakeSerializationCounts();
+  EXPECT_EQ(1, counts.rebuilt);
+  EXPECT_EQ(0, counts.reused);
+}
+
+// Tests that the favicon URL of a cached entry is the current one.
+TEST_F(IOSChromeSyncedTabDelegateTest, DoesNotCacheFaviconURL) {
+  auto navigation_manager = std::make_unique<web::FakeNavigationManager>();
+  navigation_manager->AddItem(GURL("http://first.test/"),
+                              ui::PAGE_TRANSITION_TYPED);
+  navigation_manager->SetLastCommittedItemIndex(0);
+  web::NavigationItem* item = navigation_manager->GetItemAtIndex(0);
+
+  web::FakeWebState web_state;
+  web_state.SetNavigationManager(std::move(navigation_manager));
+  IOSChromeSyncedTabDelegate::CreateForWebState(&web_state);
+  IOSChromeSyncedTabDelegate* tab_delegate =
+      IOSChromeSyncedTabDelegate::FromWebState(&web_state);
+
+  sessions::SerializedNavigationEntry entry;
+  tab_delegate->GetSerializedNavigationAtIndex(0, &entry);
+  EXPECT_EQ(GURL(), entry.favicon_url());
+
+  // The favicon driver sets the favicon of the item once it is fetched, after
+  // the favicon URL candidates are received.
+  const GURL favicon_url("http://first.test/favicon.ico");
+  item->GetFavicon().url = favicon_url;
+  item->GetFavicon().valid = true;
+
+  tab_delegate->GetSerializedNavigationAtIndex(0, &entry);
+  EXPECT_EQ(favicon_url, entry.favicon_url());
+  IOSChromeSyncedTabDelegate::SerializationCounts counts =
+      tab_delegate->TakeSerializationCounts();
+  EXPECT_EQ(1, counts.rebuilt);
+  EXPECT_EQ(1, counts.reused);
+}
+
+// Tests that all the items of a lazily restored session are synced once its
+// last committed item is loaded, including those not loaded in the web view.
+TEST_F(IOSChromeSyncedTabDelegateTest, SyncsLazilyRestoredItems) {
+  auto navigation_manager = std::make_unique<web::FakeNavigationManager>();
+  navigation_manager->AddItem(GURL("http://first.test/"),
+                              ui::PAGE_TRANSITION_TYPED);
+  navigation_manager->AddItem(GURL("http://second.test/"),
+                              ui::PAGE_TRANSITION_LINK);
+  navigation_manager->AddItem(GURL("http://third.test/"),
+                              ui::PAGE_TRANSITION_LINK);
+  navigation_manager->SetLastCommittedItemIndex(1);
+
+  web::FakeWebState web_state;
+  web_state.SetNavigationManager(std::move(navigation_manager));
+  IOSChromeSyncedTabDelegate::CreateForWebState(&web_state);
+  IOSChromeSyncedTabDelegate* tab_delegate =
+      IOSChromeSyncedTabDelegate::FromWebState(&web_state);
+
+  EXPECT_EQ(3, tab_delegate->GetEntryCount());
+  EXPECT_EQ(1, tab_delegate->GetCurrentEntryIndex());
+  EXPECT_EQ(GURL("http://first.test/"), tab_delegate->GetVirtualURLAtIndex(0));
+  EXPECT_EQ(GURL("http://third.test/"), tab_delegate->GetVirtualURLAtIndex(2));
+}
+
+// Tests that the session storage is synced while a lazily restored session
+// has items but none of them is committed.
+TEST_F(IOSChromeSyncedTabDelegateTest, SyncsStorageBeforeLazyRestoreCommits) {
+  auto navigation_manager = std::make_unique<web::FakeNavigationManager>();
+  navigation_manager->AddItem(GURL("http://first.test/"),
+                              ui::PAGE_TRANSITION_TYPED);
+  navigation_manager->AddItem(GURL("http://third.test/"),
+                              ui::PAGE_TRANSITION_LINK);
+  navigation_manager->SetLastCommittedItemIndex(-1);
+
+  web::FakeWebState web_state;
+  web_state.SetNavigationManager(std::move(navigation_manager));
+  IOSChromeSyncedTabDelegate::CreateForWebState(&web_state);
+  IOSChromeSyncedTabDelegate* tab_delegate =
+      IOSChromeSyncedTabDelegate::FromWebState(&web_state);
+
+  // FakeWebState builds a session storage with a single item.
+  EXPECT_FALSE(tab_delegate->IsInitialBlankNavigation());
+  EXPECT_EQ(1, tab_delegate->GetEntryCount());
+  EXPECT_EQ(0, tab_delegate->GetCurrentEntryIndex());
+}
+
 }  // namespace
@@ -12,8 +12,10 @@
 
 #include "base/callback_list.h"
 #include "base/macros.h"
+#include "base/timer/timer.h"
 #include "components/sync/model/syncable_service.h"
 #include "components/sync_sessions/local_session_event_router.h"
+#include "ios/chrome/browser/sync/ios_chrome_synced_tab_delegate.h"
 #include "ios/chrome/browser/web_state_list/web_state_list_observer.h"
 #include "ios/web/public/web_state_observer.h"
 
@@ -95,6 +97,22 @@ class IOSChromeLocalSessionEventRouter
   // Called on observation of a change in |web_state|.
   void OnWebStateChange(web::WebState* web_state);
 
+  // Called on observation of an event which only matters to sync if the
+  // session data of |web_state| changed since it was last synced.
+  void OnWebStateChangeIfDirty(web::WebState* web_state);
+
+  // Adds the serialization counts of |tab| to the ones of the current sync
+  // cycle.
+  void TakeSerializationCounts(IOSChromeSyncedTabDelegate* tab);
+
+  // Adds the serialization counts of all the tabs to the ones of the current
+  // sync cycle.
+  void TakeAllSerializationCounts();
+
+  // Records the number of serialized navigation entries rebuilt and reused by
+  // the sync cycle which just ended.
+  void RecordSerializationCounts();
+
   sync_sessions::LocalSessionEventHandler* handler_;
   sync_sessions::SyncSessionsClient* const sessions_client_;
   syncer::SyncableService::StartSyncFlare flare_;
@@ -105,6 +123,12 @@ class IOSChromeLocalSessionEventRouter
   // operation.
   int batch_in_progress_ = 0;
 
+  // Serialization counts of the current sync cycle. The local changes are
+  // committed together after the commit delay of sessions, so the counts are
+  // recorded once per delay.
+  IOSChromeSyncedTabDelegate::SerializationCounts serialization_counts_;
+  base::OneShotTimer record_serialization_counts_timer_;
+
   DISALLOW_COPY_AND_ASSIGN(IOSChromeLocalSessionEventRouter);
 };
 
@@ -8,10 +8,13 @@
 
 #include "base/bind.h"
 #include "base/check.h"
+#include "base/metrics/histogram_functions.h"
 #include "components/history/core/browser/history_service.h"
 #include "components/keyed_service/core/service_access_type.h"
 #include "components/sync_sessions/sync_sessions_client.h"
 #include "components/sync_sessions/synced_tab_delegate.h"
+#include "components/sync_sessions/synced_window_delegate.h"
+#include "components/sync_sessions/synced_window_delegates_getter.h"
 #include "ios/chrome/browser/browser_state/chrome_browser_state.h"
 #include "ios/chrome/browser/history/history_service_factory.h"
 #import "ios/chrome/browser/main/all_web_state_list_observation_registrar.h"
@@ -26,9 +29,13 @@
 
 namespace {
 
-sync_sessions::SyncedTabDelegate* GetSyncedTabDelegateFromWebState(
+// Default commit delay of the sessions data type. The local changes routed
+// within this delay are committed by the same sync cycle.
+constexpr base::TimeDelta kSyncCycleDelay = base::TimeDelta::FromSeconds(11);
+
+IOSChromeSyncedTabDelegate* GetSyncedTabDelegateFromWebState(
     web::WebState* web_state) {
-  sync_sessions::SyncedTabDelegate* delegate =
+  IOSChromeSyncedTabDelegate* delegate =
       IOSChromeSyncedTabDelegate::FromWebState(web_state);
   return delegate;
 }
@@ -99,12 +106,12 @@ void IOSChromeLocalSessionEventRouter::Observer::DidFinishNavigation(
 void IOSChromeLocalSessionEventRouter::Observer::PageLoaded(
     web::WebState* web_state,
     web::PageLoadCompletionStatus load_completion_status) {
-  router_->OnWebStateChange(web_state);
+  router_->OnWebStateChangeIfDirty(web_state);
 }
 
 void IOSChromeLocalSessionEventRouter::Observer::DidChangeBackForwardState(
     web::WebState* web_state) {
-  router_->OnWebStateChange(web_state);
+  router_->OnWebStateChangeIfDirty(web_state);
 }
 
 void IOSChromeLocalSessionEventRouter::Observer::WebStateDestroyed(
@@ -138,8 +145,10 @@ void IOSChromeLocalSessionEventRouter::OnSessionEventEnded() {
     return;
   // Batch operations are only used for restoration, close all tabs or undo
   // close all tabs. In any case, a full sync is necessary after this.
-  if (handler_)
+  if (handler_) {
     handler_->OnSessionRestoreComplete();
+    TakeAllSerializationCounts();
+  }
   if (!flare_.is_null()) {
     flare_.Run(syncer::SESSIONS);
     flare_.Reset();
@@ -150,12 +159,14 @@ void IOSChromeLocalSessionEventRouter::OnWebStateChange(
     web::WebState* web_state) {
   if (batch_in_progress_)
     return;
-  sync_sessions::SyncedTabDelegate* tab =
-      GetSyncedTabDelegateFromWebState(web_state);
+  IOSChromeSyncedTabDelegate* tab = GetSyncedTabDelegateFromWebState(web_state);
   if (!tab)
     return;
-  if (handler_)
+  if (handler_) {
     handler_->OnLocalTabModified(tab);
+    tab->ClearDirty();
+    TakeSerializationCounts(tab);
+  }
   if (!tab->ShouldSync(sessions_client_))
     return;
 
@@ -165,6 +176,50 @@ void IOSChromeLocalSessionEventRouter::OnWebStateChange(
   }
 }
 
+void IOSChromeLocalSessionEventRouter::OnWebStateChangeIfDirty(
+    web::WebState* web_state) {
+  IOSChromeSyncedTabDelegate* tab = GetSyncedTabDelegateFromWebState(web_state);
+  if (tab && !tab->IsDirty())
+    return;
+  OnWebStateChange(web_state);
+}
+
+void IOSChromeLocalSessionEventRouter::TakeSerializationCounts(
+    IOSChromeSyncedTabDelegate* tab) {
+  IOSChromeSyncedTabDelegate::SerializationCounts counts =
+      tab->TakeSerializationCounts();
+  serialization_counts_.rebuilt += counts.rebuilt;
+  serialization_counts_.reused += counts.reused;
+  if (!record_serialization_counts_timer_.IsRunning()) {
+    record_serialization_counts_timer_.Start(
+        FROM_HERE, kSyncCycleDelay,
+        base::BindOnce(
+            &IOSChromeLocalSessionEventRouter::RecordSerializationCounts,
+            base::Unretained(this)));
+  }
+}
+
+void IOSChromeLocalSessionEventRouter::TakeAllSerializationCounts() {
+  for (const auto& iter : sessions_client_->GetSyncedWindowDelegatesGetter()
+                              ->GetSyncedWindowDelegates()) {
+    const sync_sessions::SyncedWindowDelegate* window = iter.second;
+    for (int i = 0; i < window->GetTabCount(); ++i) {
+      // All the tabs of the windows are backed by WebStates.
+      auto* tab = static_cast<IOSChromeSyncedTabDelegate*>(window->GetTabAt(i));
+      if (tab)
+        TakeSerializationCounts(tab);
+    }
+  }
+}
+
+void IOSChromeLocalSessionEventRouter::RecordSerializationCounts() {
+  base::UmaHistogramCounts1000("IOS.Sync.Sessions.EntriesRebuiltPerCycle",
+                               serialization_counts_.rebuilt);
+  base::UmaHistogramCounts1000("IOS.Sync.Sessions.EntriesReusedPerCycle",
+                               serialization_counts_.reused);
+  serialization_counts_ = IOSChromeSyncedTabDelegate::SerializationCounts();
+}
+
 void IOSChromeLocalSessionEventRouter::StartRoutingTo(
     sync_sessions::LocalSessionEventHandler* handler) {
   DCHECK(!handler_);
@@ -110,7 +110,7 @@ SyncServiceFactory::GetAsSyncServiceImplForBrowserStateIfExists(
 }
 
 SyncServiceFactory::SyncServiceFactory()
-    : BrowserStateKeyedServiceFactory(
+    : AuditedBrowserStateKeyedServiceFactory(
           "SyncService",
           BrowserStateDependencyManager::GetInstance()) {
   // The SyncService depends on various SyncableServices being around
@@ -139,7 +139,8 @@ SyncServiceFactory::SyncServiceFactory()
 
 SyncServiceFactory::~SyncServiceFactory() {}
 
-std::unique_ptr<KeyedService> SyncServiceFactory::BuildServiceInstanceFor(
+std::unique_ptr<KeyedService>
+SyncServiceFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* context) const {
   ChromeBrowserState* browser_state =
       ChromeBrowserState::FromBrowserState(context);
@@ -9,7 +9,7 @@
 
 #include "base/macros.h"
 #include "base/no_destructor.h"
-#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 class ChromeBrowserState;
 
@@ -20,7 +20,7 @@ class SyncService;
 
 // Singleton that owns all SyncServices and associates them with
 // ChromeBrowserState.
-class SyncServiceFactory : public BrowserStateKeyedServiceFactory {
+class SyncServiceFactory : public AuditedBrowserStateKeyedServiceFactory {
  public:
   static syncer::SyncService* GetForBrowserState(
       ChromeBrowserState* browser_state);
@@ -42,8 +42,8 @@ class SyncServiceFactory : public BrowserStateKeyedServiceFactory {
   SyncServiceFactory();
   ~SyncServiceFactory() override;
 
-  // BrowserStateKeyedServiceFactory implementation.
-  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+  // AuditedBrowserStateKeyedServiceFactory implementation.
+  std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* context) const override;
 };
 
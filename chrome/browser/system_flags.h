@@ -69,6 +69,10 @@ bool MustClearApplicationGroupSandbox();
 // Whether the DCheckIsFatal feature should be disabled.
 bool AreDCHECKCrashesDisabled();
 
+// Whether the startup trace should be written to the Documents directory once
+// the first page is loaded.
+bool ShouldExportStartupTrace();
+
 }  // namespace experimental_flags
 
 #endif  // IOS_CHROME_BROWSER_SYSTEM_FLAGS_H_
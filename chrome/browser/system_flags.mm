@@ -37,6 +37,7 @@ NSString* const kAlternateDiscoverFeedServerURL =
     @"AlternateDiscoverFeedServerURL";
 NSString* const kDisableDCHECKCrashes = @"DisableDCHECKCrashes";
 NSString* const kEnableStartupCrash = @"EnableStartupCrash";
+NSString* const kExportStartupTrace = @"ExportStartupTrace";
 NSString* const kFirstRunForceEnabled = @"FirstRunForceEnabled";
 NSString* const kGaiaEnvironment = @"GAIAEnvironment";
 NSString* const kOriginServerHost = @"AlternateOriginServerHost";
@@ -114,6 +115,10 @@ bool AreDCHECKCrashesDisabled() {
       [[NSUserDefaults standardUserDefaults] boolForKey:kDisableDCHECKCrashes];
 }
 
+bool ShouldExportStartupTrace() {
+  return [[NSUserDefaults standardUserDefaults] boolForKey:kExportStartupTrace];
+}
+
 bool MustClearApplicationGroupSandbox() {
   bool value =
       [[NSUserDefaults standardUserDefaults] boolForKey:kClearApplicationGroup];
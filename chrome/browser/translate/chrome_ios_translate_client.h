@@ -11,6 +11,8 @@
 #include <string>
 
 #include "base/macros.h"
+#include "base/scoped_observation.h"
+#include "components/language/ios/browser/ios_language_detection_tab_helper.h"
 #include "components/translate/core/browser/translate_client.h"
 #include "components/translate/core/browser/translate_step.h"
 #include "components/translate/core/common/translate_errors.h"
@@ -27,6 +29,7 @@ class TranslateManager;
 }  // namespace translate
 
 namespace web {
+class WebFrame;
 class WebState;
 }  // namespace web
 
@@ -37,6 +40,7 @@ class WebState;
 class ChromeIOSTranslateClient
     : public translate::TranslateClient,
       public web::WebStateObserver,
+      public language::IOSLanguageDetectionTabHelper::Observer,
       public web::WebStateUserData<ChromeIOSTranslateClient> {
  public:
   ~ChromeIOSTranslateClient() override;
@@ -101,12 +105,24 @@ class ChromeIOSTranslateClient
 
   // web::WebStateObserver implementation.
   void DidStartLoading(web::WebState* web_state) override;
+  void WebFrameDidBecomeAvailable(web::WebState* web_state,
+                                  web::WebFrame* web_frame) override;
   void WebStateDestroyed(web::WebState* web_state) override;
 
+  // language::IOSLanguageDetectionTabHelper::Observer implementation.
+  void OnLanguageDetermined(
+      const translate::LanguageDetectionDetails& details) override;
+  void IOSLanguageDetectionTabHelperWasDestroyed(
+      language::IOSLanguageDetectionTabHelper* tab_helper) override;
+
   // The WebState this instance is observing. Will be null after
   // WebStateDestroyed has been called.
   web::WebState* web_state_ = nullptr;
 
+  base::ScopedObservation<language::IOSLanguageDetectionTabHelper,
+                          language::IOSLanguageDetectionTabHelper::Observer>
+      language_detection_observation_{this};
+
   std::unique_ptr<translate::TranslateManager> translate_manager_;
   translate::IOSTranslateDriver translate_driver_;
   __weak id<LanguageSelectionHandler> language_selection_handler_;
@@ -25,7 +25,11 @@
 #include "ios/chrome/browser/infobars/infobar_controller.h"
 #include "ios/chrome/browser/infobars/infobar_ios.h"
 #include "ios/chrome/browser/infobars/infobar_manager_impl.h"
+#include "ios/chrome/browser/language/language_detection_cache.h"
+#include "ios/chrome/browser/language/language_detection_cache_factory.h"
 #include "ios/chrome/browser/language/language_model_manager_factory.h"
+#include "ios/chrome/browser/translate/features.h"
+#import "ios/chrome/browser/translate/language_detection_sampling_java_script_feature.h"
 #import "ios/chrome/browser/translate/language_selection_handler.h"
 #include "ios/chrome/browser/translate/translate_accept_languages_factory.h"
 #import "ios/chrome/browser/translate/translate_infobar_controller.h"
@@ -37,6 +41,7 @@
 #import "ios/chrome/browser/ui/translate/translate_notification_handler.h"
 #include "ios/chrome/grit/ios_theme_resources.h"
 #include "ios/web/public/browser_state.h"
+#import "ios/web/public/js_messaging/web_frame.h"
 #include "ios/web/public/navigation/navigation_item.h"
 #include "ios/web/public/navigation/navigation_manager.h"
 #import "ios/web/public/web_state.h"
@@ -72,6 +77,11 @@ ChromeIOSTranslateClient::ChromeIOSTranslateClient(web::WebState* web_state)
                         web_state->GetNavigationManager(),
                         translate_manager_.get()) {
   web_state_->AddObserver(this);
+  // The language detection helper is created before the translate client.
+  if (auto* language_detection_tab_helper =
+          language::IOSLanguageDetectionTabHelper::FromWebState(web_state)) {
+    language_detection_observation_.Observe(language_detection_tab_helper);
+  }
 }
 
 ChromeIOSTranslateClient::~ChromeIOSTranslateClient() {
@@ -177,6 +187,21 @@ void ChromeIOSTranslateClient::DidStartLoading(web::WebState* web_state) {
   [translate_notification_handler_ dismissNotification];
 }
 
+void ChromeIOSTranslateClient::WebFrameDidBecomeAvailable(
+    web::WebState* web_state,
+    web::WebFrame* web_frame) {
+  if (!web_frame->IsMainFrame() ||
+      !base::FeatureList::IsEnabled(kBudgetedLanguageDetection)) {
+    return;
+  }
+  LanguageDetectionCache* cache = LanguageDetectionCacheFactory::
+      GetForBrowserState(ChromeBrowserState::FromBrowserState(
+          web_state->GetBrowserState()));
+  LanguageDetectionSamplingJavaScriptFeature::GetInstance()->ConfigureFrame(
+      web_frame,
+      cache->GetTrustedLanguages(web_frame->GetSecurityOrigin().host()));
+}
+
 void ChromeIOSTranslateClient::WebStateDestroyed(web::WebState* web_state) {
   DCHECK_EQ(web_state_, web_state);
   web_state_->RemoveObserver(this);
@@ -192,4 +217,22 @@ void ChromeIOSTranslateClient::WebStateDestroyed(web::WebState* web_state) {
   translate_manager_.reset();
 }
 
+void ChromeIOSTranslateClient::OnLanguageDetermined(
+    const translate::LanguageDetectionDetails& details) {
+  if (!web_state_)
+    return;
+  const std::string& declared_language = details.content_language.empty()
+                                             ? details.html_root_language
+                                             : details.content_language;
+  LanguageDetectionCacheFactory::GetForBrowserState(
+      ChromeBrowserState::FromBrowserState(web_state_->GetBrowserState()))
+      ->OnLanguageDetected(details.url.host(), declared_language,
+                           details.cld_language, details.is_cld_reliable);
+}
+
+void ChromeIOSTranslateClient::IOSLanguageDetectionTabHelperWasDestroyed(
+    language::IOSLanguageDetectionTabHelper* tab_helper) {
+  language_detection_observation_.Reset();
+}
+
 WEB_STATE_USER_DATA_KEY_IMPL(ChromeIOSTranslateClient)
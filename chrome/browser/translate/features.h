@@ -0,0 +1,15 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_TRANSLATE_FEATURES_H_
+#define IOS_CHROME_BROWSER_TRANSLATE_FEATURES_H_
+
+#include "base/feature_list.h"
+
+// Feature flag to sample the text of the page used to detect its language up
+// to a length cap, and to skip the extraction when the language declared by
+// the page matches the one detected on previous pages of its host.
+extern const base::Feature kBudgetedLanguageDetection;
+
+#endif  // IOS_CHROME_BROWSER_TRANSLATE_FEATURES_H_
@@ -0,0 +1,55 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_TRANSLATE_LANGUAGE_DETECTION_SAMPLING_JAVA_SCRIPT_FEATURE_H_
+#define IOS_CHROME_BROWSER_TRANSLATE_LANGUAGE_DETECTION_SAMPLING_JAVA_SCRIPT_FEATURE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/no_destructor.h"
+#import "ios/web/public/js_messaging/java_script_feature.h"
+
+namespace web {
+class WebFrame;
+}  // namespace web
+
+// A feature replacing the extraction of the text used to detect the language
+// of the page by a budgeted one. The text is sampled in representative blocks
+// up to a length cap, and is not extracted at all when the page declares a
+// language trusted for its host. The length and duration of each extraction
+// are recorded.
+class LanguageDetectionSamplingJavaScriptFeature
+    : public web::JavaScriptFeature {
+ public:
+  // Maximum number of characters of the sampled text.
+  static const int kMaxTextLength;
+
+  static LanguageDetectionSamplingJavaScriptFeature* GetInstance();
+
+  // Enables the budgeted extraction in |main_frame|. |trusted_languages| are
+  // the languages that the pages of the host of the frame can be trusted to
+  // declare, as returned by LanguageDetectionCache.
+  void ConfigureFrame(web::WebFrame* main_frame,
+                      const std::vector<std::string>& trusted_languages);
+
+ private:
+  friend class base::NoDestructor<LanguageDetectionSamplingJavaScriptFeature>;
+  friend class LanguageDetectionSamplingJavaScriptFeatureTest;
+
+  LanguageDetectionSamplingJavaScriptFeature();
+  ~LanguageDetectionSamplingJavaScriptFeature() override;
+
+  LanguageDetectionSamplingJavaScriptFeature(
+      const LanguageDetectionSamplingJavaScriptFeature&) = delete;
+  LanguageDetectionSamplingJavaScriptFeature& operator=(
+      const LanguageDetectionSamplingJavaScriptFeature&) = delete;
+
+  // JavaScriptFeature:
+  absl::optional<std::string> GetScriptMessageHandlerName() const override;
+  void ScriptMessageReceived(web::WebState* web_state,
+                             const web::ScriptMessage& message) override;
+};
+
+#endif  // IOS_CHROME_BROWSER_TRANSLATE_LANGUAGE_DETECTION_SAMPLING_JAVA_SCRIPT_FEATURE_H_
@@ -0,0 +1,101 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/translate/language_detection_sampling_java_script_feature.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#import "ios/web/public/js_messaging/java_script_feature_util.h"
+#import "ios/web/public/js_messaging/script_message.h"
+#import "ios/web/public/js_messaging/web_frame.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+const char kScriptName[] = "language_detection_sampling_js";
+const char kScriptHandlerName[] = "LanguageDetectionSamplingMessageHandler";
+}  // namespace
+
+// static
+const int LanguageDetectionSamplingJavaScriptFeature::kMaxTextLength = 4096;
+
+// static
+LanguageDetectionSamplingJavaScriptFeature*
+LanguageDetectionSamplingJavaScriptFeature::GetInstance() {
+  static base::NoDestructor<LanguageDetectionSamplingJavaScriptFeature>
+      instance;
+  return instance.get();
+}
+
+LanguageDetectionSamplingJavaScriptFeature::
+    LanguageDetectionSamplingJavaScriptFeature()
+    : JavaScriptFeature(
+          // The extraction replaced is in the page content world.
+          ContentWorld::kPageContentWorld,
+          {FeatureScript::CreateWithFilename(
+              kScriptName,
+              FeatureScript::InjectionTime::kDocumentStart,
+              FeatureScript::TargetFrames::kMainFrame)},
+          {web::java_script_features::GetCommonJavaScriptFeature()}) {}
+
+LanguageDetectionSamplingJavaScriptFeature::
+    ~LanguageDetectionSamplingJavaScriptFeature() = default;
+
+void LanguageDetectionSamplingJavaScriptFeature::ConfigureFrame(
+    web::WebFrame* main_frame,
+    const std::vector<std::string>& trusted_languages) {
+  DCHECK(main_frame->IsMainFrame());
+  base::Value languages(base::Value::Type::LIST);
+  for (const std::string& language : trusted_languages)
+    languages.Append(language);
+  std::vector<base::Value> parameters;
+  parameters.push_back(base::Value(kMaxTextLength));
+  parameters.push_back(std::move(languages));
+  CallJavaScriptFunction(main_frame, "languageDetectionSampling.configure",
+                         parameters);
+}
+
+absl::optional<std::string>
+LanguageDetectionSamplingJavaScriptFeature::GetScriptMessageHandlerName()
+    const {
+  return kScriptHandlerName;
+}
+
+void LanguageDetectionSamplingJavaScriptFeature::ScriptMessageReceived(
+    web::WebState* web_state,
+    const web::ScriptMessage& script_message) {
+  // Verify that the message is well-formed before using it.
+  if (!script_message.is_main_frame())
+    return;
+  base::Value* message = script_message.body();
+  if (!message || !message->is_dict())
+    return;
+  absl::optional<bool> skipped = message->FindBoolKey("skipped");
+  absl::optional<bool> sampled = message->FindBoolKey("sampled");
+  absl::optional<double> text_length = message->FindDoubleKey("textLength");
+  absl::optional<double> extraction_time =
+      message->FindDoubleKey("extractionTime");
+  if (!skipped || !sampled || !text_length || !extraction_time)
+    return;
+
+  base::UmaHistogramBoolean("IOS.Translate.LanguageDetection.ExtractionSkipped",
+                            *skipped);
+  if (*skipped)
+    return;
+  base::UmaHistogramBoolean("IOS.Translate.LanguageDetection.TextSampled",
+                            *sampled);
+  base::UmaHistogramCounts100000(
+      "IOS.Translate.LanguageDetection.ExtractedTextLength",
+      static_cast<int>(*text_length));
+  base::UmaHistogramTimes(
+      "IOS.Translate.LanguageDetection.ExtractionTime",
+      base::TimeDelta::FromMillisecondsD(*extraction_time));
+}
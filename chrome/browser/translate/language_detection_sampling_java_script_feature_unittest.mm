@@ -0,0 +1,160 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/translate/language_detection_sampling_java_script_feature.h"
+
+#import <Foundation/Foundation.h>
+
+#include <string>
+#include <vector>
+
+#import "base/test/ios/wait_util.h"
+#include "base/test/metrics/histogram_tester.h"
+#import "ios/chrome/browser/web/chrome_web_test.h"
+#include "ios/web/public/js_messaging/web_frame_util.h"
+#import "ios/web/public/test/fakes/fake_web_client.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#import "testing/gtest_mac.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+using base::test::ios::WaitUntilConditionOrTimeout;
+using base::test::ios::kWaitForJSCompletionTimeout;
+
+namespace {
+
+// Stub of the language detection script of translate, whose extraction is
+// replaced by the feature.
+NSString* const kLanguageDetectionStub =
+    @"__gCrWeb.languageDetection = {"
+    @"  getTextContent: function(node, maxLength) { return 'original'; },"
+    @"  getMetaContentByHttpEquiv: function(httpEquiv) {"
+    @"    var meta = document.querySelector("
+    @"        'meta[http-equiv=\"' + httpEquiv + '\"]');"
+    @"    return meta ? meta.content : '';"
+    @"  }"
+    @"};"
+    @"__gCrWeb.languageDetection.originalGetTextContent ="
+    @"    __gCrWeb.languageDetection.getTextContent;";
+
+// Extracts the text of the body the way the language detection does.
+NSString* const kGetTextContent =
+    @"__gCrWeb.languageDetection.getTextContent(document.body, 65535)";
+
+const char kSkippedHistogram[] =
+    "IOS.Translate.LanguageDetection.ExtractionSkipped";
+const char kSampledHistogram[] = "IOS.Translate.LanguageDetection.TextSampled";
+
+}  // namespace
+
+class LanguageDetectionSamplingJavaScriptFeatureTest : public ChromeWebTest {
+ protected:
+  LanguageDetectionSamplingJavaScriptFeatureTest()
+      : ChromeWebTest(std::make_unique<web::FakeWebClient>()) {}
+
+  void SetUp() override {
+    ChromeWebTest::SetUp();
+    GetWebClient()->SetJavaScriptFeatures({&feature_});
+  }
+
+  web::FakeWebClient* GetWebClient() override {
+    return static_cast<web::FakeWebClient*>(
+        WebTestWithWebState::GetWebClient());
+  }
+
+  // Loads |html|, then configures the feature with |trusted_languages| and
+  // waits for the extraction to be replaced.
+  void LoadHtmlAndConfigure(NSString* html,
+                            const std::vector<std::string>& trusted_languages) {
+    LoadHtml(html);
+    ExecuteJavaScript(kLanguageDetectionStub);
+    feature_.ConfigureFrame(web::GetMainFrame(web_state()), trusted_languages);
+    ASSERT_TRUE(WaitUntilConditionOrTimeout(kWaitForJSCompletionTimeout, ^{
+      return [ExecuteJavaScript(
+          @"__gCrWeb.languageDetection.getTextContent !== "
+          @"__gCrWeb.languageDetection.originalGetTextContent") boolValue];
+    }));
+  }
+
+  // Waits for the metrics of an extraction to be recorded.
+  void WaitForMetrics() {
+    ASSERT_TRUE(WaitUntilConditionOrTimeout(kWaitForJSCompletionTimeout, ^{
+      return !histogram_tester_.GetAllSamples(kSkippedHistogram).empty();
+    }));
+  }
+
+  LanguageDetectionSamplingJavaScriptFeature feature_;
+  base::HistogramTester histogram_tester_;
+};
+
+// Tests that the whole text of a small page is extracted, except for the
+// content of scripts and hidden elements.
+TEST_F(LanguageDetectionSamplingJavaScriptFeatureTest, ExtractsSmallPage) {
+  LoadHtmlAndConfigure(@"<html><body><p>Hello</p><script>var a;</script>"
+                       @"<p hidden>Hidden</p><p style='display:none'>None</p>"
+                       @"<p>World</p></body></html>",
+                       {});
+
+  EXPECT_NSEQ(@"Hello\nWorld\n", ExecuteJavaScript(kGetTextContent));
+  WaitForMetrics();
+  histogram_tester_.ExpectUniqueSample(kSkippedHistogram, false, 1);
+  histogram_tester_.ExpectUniqueSample(kSampledHistogram, false, 1);
+}
+
+// Tests that the text of a large page is sampled over the whole page, within
+// the budget.
+TEST_F(LanguageDetectionSamplingJavaScriptFeatureTest, SamplesLargePage) {
+  NSMutableString* html = [NSMutableString stringWithString:@"<html><body>"];
+  const int kParagraphCount = 1000;
+  for (int i = 0; i < kParagraphCount; ++i)
+    [html appendFormat:@"<p>Paragraph %d of a very long page.</p>", i];
+  [html appendString:@"</body></html>"];
+  LoadHtmlAndConfigure(html, {});
+
+  NSString* text = ExecuteJavaScript(kGetTextContent);
+  EXPECT_LE(text.length, static_cast<NSUInteger>(
+                             LanguageDetectionSamplingJavaScriptFeature::
+                                 kMaxTextLength));
+  EXPECT_TRUE([text containsString:@"Paragraph 0 "]);
+  // The last of the 8 blocks starts at the 875th paragraph.
+  EXPECT_TRUE([text containsString:@"Paragraph 875 "]);
+  WaitForMetrics();
+  histogram_tester_.ExpectUniqueSample(kSampledHistogram, true, 1);
+}
+
+// Tests that the text is not extracted when the languages declared by the page
+// are the same trusted one.
+TEST_F(LanguageDetectionSamplingJavaScriptFeatureTest,
+       SkipsWhenDeclaredLanguageMatches) {
+  LoadHtmlAndConfigure(
+      @"<html lang='fr-FR'><head><meta http-equiv='content-language' "
+      @"content='fr'></head><body><p>Bonjour</p></body></html>",
+      {"de", "fr"});
+
+  EXPECT_NSEQ(@"", ExecuteJavaScript(kGetTextContent));
+  WaitForMetrics();
+  histogram_tester_.ExpectUniqueSample(kSkippedHistogram, true, 1);
+}
+
+// Tests that the text is extracted when the language declared by the page is
+// not trusted, or when it is not declared.
+TEST_F(LanguageDetectionSamplingJavaScriptFeatureTest,
+       ExtractsWhenDeclaredLanguageDiffers) {
+  LoadHtmlAndConfigure(
+      @"<html lang='de'><body><p>Guten Tag</p></body></html>", {"fr"});
+  EXPECT_NSEQ(@"Guten Tag\n", ExecuteJavaScript(kGetTextContent));
+
+  LoadHtmlAndConfigure(@"<html><body><p>Bonjour</p></body></html>", {"fr"});
+  EXPECT_NSEQ(@"Bonjour\n", ExecuteJavaScript(kGetTextContent));
+}
+
+// Tests that the original extraction is used for nodes other than the body.
+TEST_F(LanguageDetectionSamplingJavaScriptFeatureTest, OtherNodes) {
+  LoadHtmlAndConfigure(@"<html><body><p id='p'>Hello</p></body></html>", {});
+  EXPECT_NSEQ(@"original",
+              ExecuteJavaScript(@"__gCrWeb.languageDetection.getTextContent("
+                                @"document.getElementById('p'), 100)"));
+}
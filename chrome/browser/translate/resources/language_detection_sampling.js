@@ -0,0 +1,252 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+/**
+ * @fileoverview Budgeted extraction of the text used to detect the language
+ * of the page. Replaces the extraction of __gCrWeb.languageDetection, which
+ * walks the whole body and computes the style of every element, with one
+ * sampling representative text blocks up to a length cap.
+ */
+goog.provide('__crWeb.languageDetectionSampling');
+
+(function() {
+/**
+ * Namespace for this file. It depends on |__gCrWeb| having already been
+ * injected.
+ */
+__gCrWeb.languageDetectionSampling = {};
+
+/**
+ * Store the languageDetectionSampling namespace object in a global __gCrWeb
+ * object referenced by a string, so it does not get renamed by closure
+ * compiler during the minification.
+ */
+__gCrWeb['languageDetectionSampling'] = __gCrWeb.languageDetectionSampling;
+
+/**
+ * Maximum number of characters of the sampled text. The extraction of
+ * __gCrWeb.languageDetection is used as long as it is 0.
+ * @type {number}
+ */
+let maxTextLength_ = 0;
+
+/**
+ * Primary subtags of the languages that the pages of the host can be trusted
+ * to declare.
+ * @type {!Array<string>}
+ */
+let trustedLanguages_ = [];
+
+/**
+ * The extraction function of __gCrWeb.languageDetection, once replaced.
+ * @type {?function(Node, number): string}
+ */
+let originalGetTextContent_ = null;
+
+/**
+ * Number of characters of each sampled block of text.
+ * @type {number}
+ */
+const BLOCK_LENGTH = 512;
+
+/**
+ * Elements whose content is not text of the page.
+ * @type {!Set<string>}
+ */
+const NON_TEXT_NODE_NAMES = new Set([
+  'EMBED', 'NOSCRIPT', 'OBJECT', 'SCRIPT', 'STYLE', 'SVG', 'TEMPLATE'
+]);
+
+/**
+ * Configures the extraction of the text of the page.
+ * @param {number} maxTextLength Maximum number of characters of the text.
+ * @param {!Array<string>} trustedLanguages Languages that the pages of the
+ *     host can be trusted to declare.
+ */
+__gCrWeb.languageDetectionSampling.configure = function(
+    maxTextLength, trustedLanguages) {
+  maxTextLength_ = maxTextLength;
+  trustedLanguages_ = trustedLanguages.map(primaryLanguage_);
+  installSampling_();
+};
+
+/**
+ * Replaces the extraction function of __gCrWeb.languageDetection, or waits
+ * for it to be defined.
+ */
+function installSampling_() {
+  if (originalGetTextContent_) {
+    return;
+  }
+  const languageDetection = __gCrWeb['languageDetection'];
+  if (!languageDetection) {
+    document.addEventListener('DOMContentLoaded', installSampling_);
+    return;
+  }
+  originalGetTextContent_ = languageDetection['getTextContent'];
+  languageDetection['getTextContent'] = getTextContent_;
+}
+
+/**
+ * Extracts the text of |node|, up to |maxLength| characters. The text of the
+ * body is sampled; the other nodes, visited recursively by the original
+ * extraction, are handed to it.
+ * @param {Node} node The node to extract the text from.
+ * @param {number} maxLength Maximum number of characters to extract.
+ * @return {string} The text of |node|.
+ */
+function getTextContent_(node, maxLength) {
+  if (node !== document.body || maxTextLength_ <= 0) {
+    return originalGetTextContent_(node, maxLength);
+  }
+
+  const startTime = performance.now();
+  let text = '';
+  const skipped = declaredLanguageIsTrusted_();
+  let sampled = false;
+  if (!skipped) {
+    const nodes = collectTextNodes_(node);
+    const budget = Math.min(maxLength, maxTextLength_);
+    sampled = nodes.totalLength > budget;
+    text = sampled ? sampleText_(nodes.textNodes, budget) :
+                     joinText_(nodes.textNodes, budget);
+  }
+
+  __gCrWeb.common.sendWebKitMessage('LanguageDetectionSamplingMessageHandler', {
+    'skipped': skipped,
+    'sampled': sampled,
+    'textLength': text.length,
+    'extractionTime': performance.now() - startTime,
+  });
+  return text;
+}
+
+/**
+ * Returns the primary subtag of the language code |code|, in lower case.
+ * @param {string} code A language code such as 'en-US'.
+ * @return {string} The primary subtag, such as 'en'.
+ */
+function primaryLanguage_(code) {
+  return code.trim().split(/[-_,;\s]/)[0].toLowerCase();
+}
+
+/**
+ * Returns whether the page declares a language, through the lang attribute of
+ * the root element or the Content-Language meta tag, and all the declared
+ * languages are the same trusted one. The text is then not needed to detect
+ * the language of the page, which is the declared one.
+ * @return {boolean} Whether the extraction can be skipped.
+ */
+function declaredLanguageIsTrusted_() {
+  if (trustedLanguages_.length === 0) {
+    return false;
+  }
+  const declaredLanguages = [
+    document.documentElement.lang,
+    __gCrWeb['languageDetection']['getMetaContentByHttpEquiv'](
+        'content-language'),
+  ].filter(language => !!language);
+  if (declaredLanguages.length === 0) {
+    return false;
+  }
+  const declared = primaryLanguage_(declaredLanguages[0]);
+  return trustedLanguages_.includes(declared) &&
+      declaredLanguages.every(
+          language => primaryLanguage_(language) === declared);
+}
+
+/**
+ * Returns the text nodes under |root|, in document order, skipping the
+ * content of non text elements and of hidden elements.
+ * @param {Node} root The root of the nodes to collect.
+ * @return {{textNodes: !Array<!Text>, totalLength: number}} The text nodes,
+ *     and the total length of their text.
+ */
+function collectTextNodes_(root) {
+  const textNodes = [];
+  let totalLength = 0;
+  const walker = document.createTreeWalker(
+      root, NodeFilter.SHOW_ELEMENT | NodeFilter.SHOW_TEXT, {
+        acceptNode: function(node) {
+          if (node.nodeType === Node.TEXT_NODE) {
+            return NodeFilter.FILTER_ACCEPT;
+          }
+          // Rejecting an element skips its whole subtree. Computing the style
+          // of every element is too expensive on large pages, so only the
+          // elements hidden by attribute are skipped here.
+          if (NON_TEXT_NODE_NAMES.has(node.nodeName.toUpperCase()) ||
+              node.hidden) {
+            return NodeFilter.FILTER_REJECT;
+          }
+          return NodeFilter.FILTER_SKIP;
+        }
+      });
+  for (let node = walker.nextNode(); node; node = walker.nextNode()) {
+    const length = node.data.trim().length;
+    if (length > 0) {
+      textNodes.push(/** @type {!Text} */ (node));
+      totalLength += length;
+    }
+  }
+  return {textNodes: textNodes, totalLength: totalLength};
+}
+
+/**
+ * Returns whether the element containing |textNode| is rendered.
+ * @param {!Text} textNode The text node.
+ * @return {boolean} Whether the text is visible.
+ */
+function isVisible_(textNode) {
+  const element = textNode.parentElement;
+  if (!element) {
+    return true;
+  }
+  const style = window.getComputedStyle(element);
+  return style.display !== 'none' && style.visibility !== 'hidden';
+}
+
+/**
+ * Returns the text of |textNodes| joined by line breaks, up to |maxLength|
+ * characters.
+ * @param {!Array<!Text>} textNodes The text nodes.
+ * @param {number} maxLength Maximum number of characters to return.
+ * @return {string} The joined text.
+ */
+function joinText_(textNodes, maxLength) {
+  let text = '';
+  for (let i = 0; i < textNodes.length && text.length < maxLength; i++) {
+    if (isVisible_(textNodes[i])) {
+      text += textNodes[i].data.trim() + '\n';
+    }
+  }
+  return text.substring(0, maxLength);
+}
+
+/**
+ * Returns blocks of text of |textNodes| evenly spread over the page, so that
+ * the sample is representative of the whole page and not only of its header,
+ * up to |maxLength| characters.
+ * @param {!Array<!Text>} textNodes The text nodes.
+ * @param {number} maxLength Maximum number of characters to return.
+ * @return {string} The sampled text.
+ */
+function sampleText_(textNodes, maxLength) {
+  const blockCount = Math.max(1, Math.floor(maxLength / BLOCK_LENGTH));
+  const blockLength = Math.floor(maxLength / blockCount);
+  let text = '';
+  for (let block = 0; block < blockCount; block++) {
+    const start = Math.floor(block * textNodes.length / blockCount);
+    const end = Math.floor((block + 1) * textNodes.length / blockCount);
+    let blockText = '';
+    for (let i = start; i < end && blockText.length < blockLength; i++) {
+      if (isVisible_(textNodes[i])) {
+        blockText += textNodes[i].data.trim() + '\n';
+      }
+    }
+    text += blockText.substring(0, blockLength);
+  }
+  return text.substring(0, maxLength);
+}
+
+}());  // End of anonymous object
@@ -97,8 +97,13 @@ void OverlayJavaScriptDialogPresenter::RunJavaScriptDialog(
   request->GetCallbackManager()->AddCompletionCallback(
       base::BindOnce(&HandleJavaScriptDialogResponse, std::move(callback),
                      web_state->CreateDefaultGetter()));
+  // A page spamming dialogs only keeps its latest dialog waiting behind the
+  // presented one.  The replaced dialog is closed without a response.  Dialogs
+  // are shown by the page without user action, so they wait behind the
+  // other requests of the content area.
   OverlayRequestQueue::FromWebState(web_state, OverlayModality::kWebContentArea)
-      ->AddRequest(std::move(request));
+      ->AddOrReplaceRequest<JavaScriptDialogRequest>(
+          std::move(request), OverlayRequestQueue::Priority::kLow);
 }
 
 void OverlayJavaScriptDialogPresenter::CancelDialogs(web::WebState* web_state) {
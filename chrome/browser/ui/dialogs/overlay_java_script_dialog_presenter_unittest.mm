@@ -93,6 +93,41 @@ TEST_F(OverlayJavaScriptDialogPresenterTest, RunPrompt) {
   EXPECT_EQ(web::JAVASCRIPT_DIALOG_TYPE_PROMPT, dialog_request->type());
 }
 
+// Tests that a dialog run while another one is waiting replaces the waiting
+// dialog, which is closed without success.
+TEST_F(OverlayJavaScriptDialogPresenterTest, ReplaceWaitingDialog) {
+  presenter_.RunJavaScriptDialog(&web_state_, url_,
+                                 web::JAVASCRIPT_DIALOG_TYPE_ALERT, @"", @"",
+                                 base::BindOnce(^(bool, NSString*){
+                                 }));
+  __block bool replaced_dialog_closed = false;
+  __block bool replaced_dialog_success = true;
+  presenter_.RunJavaScriptDialog(
+      &web_state_, url_, web::JAVASCRIPT_DIALOG_TYPE_ALERT, @"", @"",
+      base::BindOnce(^(bool success, NSString* user_input) {
+        replaced_dialog_closed = true;
+        replaced_dialog_success = success;
+      }));
+  OverlayRequestQueue* queue = OverlayRequestQueue::FromWebState(
+      &web_state_, OverlayModality::kWebContentArea);
+  ASSERT_EQ(2U, queue->size());
+
+  presenter_.RunJavaScriptDialog(
+      &web_state_, url_, web::JAVASCRIPT_DIALOG_TYPE_CONFIRM, @"", @"",
+      base::BindOnce(^(bool success, NSString* user_input){
+      }));
+
+  // Verify that the queue did not grow and that the waiting alert was closed
+  // and replaced by the confirmation.
+  ASSERT_EQ(2U, queue->size());
+  EXPECT_TRUE(replaced_dialog_closed);
+  EXPECT_FALSE(replaced_dialog_success);
+  JavaScriptDialogRequest* dialog_request =
+      queue->GetRequest(1)->GetConfig<JavaScriptDialogRequest>();
+  ASSERT_TRUE(dialog_request);
+  EXPECT_EQ(web::JAVASCRIPT_DIALOG_TYPE_CONFIRM, dialog_request->type());
+}
+
 // Tests that the presenter removes all requests from the queue when
 // CancelDialogs() is called.
 TEST_F(OverlayJavaScriptDialogPresenterTest, CancelDialogs) {
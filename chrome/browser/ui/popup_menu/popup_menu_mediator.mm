@@ -251,6 +251,12 @@ PopupMenuTextItem* CreateEnterpriseInfoItem(NSString* imageName,
 
 #pragma mark - CRWWebStateObserver
 
+- (web::WebStateObserver::EventMask)throttledWebStateEvents {
+  // The menu only reflects the latest loading state.
+  return web::WebStateObserver::EventBit(
+      web::WebStateObserver::Event::kLoadProgressChanged);
+}
+
 - (void)webState:(web::WebState*)webState didLoadPageWithSuccess:(BOOL)success {
   DCHECK_EQ(_webState, webState);
   [self updatePopupMenu];
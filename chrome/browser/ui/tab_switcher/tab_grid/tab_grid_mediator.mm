@@ -275,6 +275,12 @@ web::WebState* GetWebStateWithId(WebStateList* web_state_list,
 
 #pragma mark - CRWWebStateObserver
 
+- (web::WebStateObserver::EventMask)throttledWebStateEvents {
+  // Grid cells only display the latest title.
+  return web::WebStateObserver::EventBit(
+      web::WebStateObserver::Event::kTitleWasSet);
+}
+
 - (void)webStateDidChangeTitle:(web::WebState*)webState {
   // Assumption: the ID of the webState didn't change as a result of this load.
   TabIdTabHelper* tabHelper = TabIdTabHelper::FromWebState(webState);
@@ -259,6 +259,12 @@ int GetIndexOfTabWithId(WebStateList* web_state_list, NSString* identifier) {
 
 #pragma mark - CRWWebStateObserver
 
+- (web::WebStateObserver::EventMask)throttledWebStateEvents {
+  // Tab strip cells only display the latest title.
+  return web::WebStateObserver::EventBit(
+      web::WebStateObserver::Event::kTitleWasSet);
+}
+
 - (void)webStateDidChangeTitle:(web::WebState*)webState {
   // Assumption: the ID of the webState didn't change as a result of this load.
   TabIdTabHelper* tabHelper = TabIdTabHelper::FromWebState(webState);
@@ -1063,6 +1063,12 @@ UIColor* BackgroundColor() {
 #pragma mark -
 #pragma mark - CRWWebStateObserver methods
 
+- (web::WebStateObserver::EventMask)throttledWebStateEvents {
+  // Tab views only display the latest title.
+  return web::WebStateObserver::EventBit(
+      web::WebStateObserver::Event::kTitleWasSet);
+}
+
 - (void)webStateDidStartLoading:(web::WebState*)webState {
   // webState can start loading before  didInsertWebState is called, in that
   // case early return as there is no view to update yet.
@@ -105,6 +105,12 @@
 
 #pragma mark - CRWWebStateObserver
 
+- (web::WebStateObserver::EventMask)throttledWebStateEvents {
+  // The progress bar only displays the latest progress.
+  return web::WebStateObserver::EventBit(
+      web::WebStateObserver::Event::kLoadProgressChanged);
+}
+
 - (void)webState:(web::WebState*)webState didLoadPageWithSuccess:(BOOL)success {
   DCHECK_EQ(_webState, webState);
   [self updateConsumer];
@@ -0,0 +1,28 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_UI_WEBUI_MEMORY_INTERNALS_UI_H_
+#define IOS_CHROME_BROWSER_UI_WEBUI_MEMORY_INTERNALS_UI_H_
+
+#include <string>
+
+#include "ios/web/public/webui/web_ui_ios_controller.h"
+
+namespace web {
+class WebUIIOS;
+}
+
+// The WebUIController for chrome://memory-internals. Renders the memory cost
+// estimated for each WebState and subsystem of the browser state.
+class MemoryInternalsUI : public web::WebUIIOSController {
+ public:
+  explicit MemoryInternalsUI(web::WebUIIOS* web_ui, const std::string& host);
+
+  MemoryInternalsUI(const MemoryInternalsUI&) = delete;
+  MemoryInternalsUI& operator=(const MemoryInternalsUI&) = delete;
+
+  ~MemoryInternalsUI() override;
+};
+
+#endif  // IOS_CHROME_BROWSER_UI_WEBUI_MEMORY_INTERNALS_UI_H_
@@ -0,0 +1,77 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/ui/webui/memory_internals_ui.h"
+
+#include <string>
+
+#include "base/json/json_writer.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/values.h"
+#include "ios/chrome/browser/browser_state/chrome_browser_state.h"
+#include "ios/chrome/browser/chrome_url_constants.h"
+#import "ios/chrome/browser/memory/memory_attribution_sampler.h"
+#import "ios/chrome/browser/memory/memory_attribution_sampler_factory.h"
+#include "ios/web/public/thread/web_thread.h"
+#include "ios/web/public/webui/url_data_source_ios.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+// A simple data source that returns a fresh memory attribution sample for the
+// associated browser state, along with the last sample recorded to UMA.
+class MemoryInternalsSource : public web::URLDataSourceIOS {
+ public:
+  explicit MemoryInternalsSource(ChromeBrowserState* browser_state)
+      : browser_state_(browser_state) {}
+
+  MemoryInternalsSource(const MemoryInternalsSource&) = delete;
+  MemoryInternalsSource& operator=(const MemoryInternalsSource&) = delete;
+
+  ~MemoryInternalsSource() override = default;
+
+  // web::URLDataSourceIOS:
+  std::string GetSource() const override {
+    return kChromeUIMemoryInternalsHost;
+  }
+
+  std::string GetMimeType(const std::string& path) const override {
+    return "text/plain";
+  }
+
+  void StartDataRequest(
+      const std::string& path,
+      web::URLDataSourceIOS::GotDataCallback callback) override {
+    DCHECK_CURRENTLY_ON(web::WebThread::UI);
+    MemoryAttributionSampler* sampler =
+        MemoryAttributionSamplerFactory::GetForBrowserState(browser_state_);
+
+    base::Value value(base::Value::Type::DICTIONARY);
+    value.SetKey("current_sample", sampler->TakeSample().ToValue());
+    value.SetKey("last_recorded_sample", sampler->last_sample().ToValue());
+
+    std::string json;
+    CHECK(base::JSONWriter::WriteWithOptions(
+        value, base::JSONWriter::OPTIONS_PRETTY_PRINT, &json));
+    std::move(callback).Run(base::RefCountedString::TakeString(&json));
+  }
+
+ private:
+  ChromeBrowserState* browser_state_;
+};
+
+}  // namespace
+
+MemoryInternalsUI::MemoryInternalsUI(web::WebUIIOS* web_ui,
+                                     const std::string& host)
+    : web::WebUIIOSController(web_ui, host) {
+  ChromeBrowserState* browser_state = ChromeBrowserState::FromWebUIIOS(web_ui);
+  web::URLDataSourceIOS::Add(browser_state,
+                             new MemoryInternalsSource(browser_state));
+}
+
+MemoryInternalsUI::~MemoryInternalsUI() = default;
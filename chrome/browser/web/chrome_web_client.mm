@@ -34,6 +34,8 @@
 #import "ios/chrome/browser/safe_browsing/safe_browsing_error.h"
 #import "ios/chrome/browser/safe_browsing/safe_browsing_unsafe_resource_container.h"
 #include "ios/chrome/browser/ssl/ios_ssl_error_handler.h"
+#include "ios/chrome/browser/translate/features.h"
+#import "ios/chrome/browser/translate/language_detection_sampling_java_script_feature.h"
 #import "ios/chrome/browser/ui/elements/windowed_container_view.h"
 #import "ios/chrome/browser/ui/reading_list/reading_list_features.h"
 #import "ios/chrome/browser/ui/reading_list/reading_list_javascript_feature.h"
@@ -324,6 +326,11 @@ std::vector<web::JavaScriptFeature*> ChromeWebClient::GetJavaScriptFeatures(
   features.push_back(
       password_manager::PasswordManagerJavaScriptFeature::GetInstance());
 
+  if (base::FeatureList::IsEnabled(kBudgetedLanguageDetection)) {
+    features.push_back(
+        LanguageDetectionSamplingJavaScriptFeature::GetInstance());
+  }
+
   return features;
 }
 
@@ -77,6 +77,7 @@ class SadTabTabHelper : public web::WebStateUserData<SadTabTabHelper>,
   void RemoveApplicationDidBecomeActiveObserver();
 
   // WebStateObserver:
+  EventMask GetObservedEvents() const override;
   void WasShown(web::WebState* web_state) override;
   void WasHidden(web::WebState* web_state) override;
   void RenderProcessGone(web::WebState* web_state) override;
@@ -80,6 +80,13 @@ void SadTabTabHelper::SetDelegate(id<SadTabTabHelperDelegate> delegate) {
   }
 }
 
+web::WebStateObserver::EventMask SadTabTabHelper::GetObservedEvents() const {
+  return EventBit(Event::kWasShown) | EventBit(Event::kWasHidden) |
+         EventBit(Event::kRenderProcessGone) |
+         EventBit(Event::kDidStartNavigation) |
+         EventBit(Event::kDidFinishNavigation);
+}
+
 void SadTabTabHelper::WasShown(web::WebState* web_state) {
   DCHECK_EQ(web_state_, web_state);
   if (requires_reload_on_becoming_visible_) {
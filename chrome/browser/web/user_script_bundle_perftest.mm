@@ -0,0 +1,113 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import <Foundation/Foundation.h>
+#import <WebKit/WebKit.h>
+
+#include <memory>
+
+#include "base/timer/elapsed_timer.h"
+#include "ios/chrome/browser/browser_state/test_chrome_browser_state.h"
+#include "ios/chrome/test/base/perf_test_ios.h"
+#import "ios/web/common/web_view_creation_util.h"
+#import "ios/web/js_messaging/user_script_combiner.h"
+#import "ios/web/public/js_messaging/java_script_feature.h"
+#include "ios/web/public/js_messaging/java_script_feature_util.h"
+#import "ios/web/public/test/js_test_util.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+// Class measuring the cost of parsing and evaluating the feature scripts in a
+// frame, when each script is injected separately and when the scripts are
+// combined into a single user script.
+class UserScriptBundlePerfTest : public PerfTest {
+ protected:
+  UserScriptBundlePerfTest() : PerfTest("User Script Bundles for WKWebView") {
+    browser_state_ = TestChromeBrowserState::Builder().Build();
+    scripts_ = [NSMutableArray array];
+    for (web::JavaScriptFeature* feature :
+         {web::java_script_features::GetBaseJavaScriptFeature(),
+          web::java_script_features::GetCommonJavaScriptFeature(),
+          web::java_script_features::GetMessageJavaScriptFeature()}) {
+      for (const web::JavaScriptFeature::FeatureScript& feature_script :
+           feature->GetScripts()) {
+        [scripts_ addObject:feature_script.GetScriptString()];
+      }
+    }
+    bundle_ = web::UserScriptCombiner::CombineScripts(scripts_);
+  }
+
+  // Loads an empty page in a new WKWebView injecting |scripts| as user
+  // scripts, and returns the time taken. Both the separate scripts and the
+  // bundle are run by WebKit during a single load, so the difference between
+  // the two only comes from the number of user scripts.
+  base::TimeDelta LoadWithUserScripts(NSArray<NSString*>* scripts) {
+    // The scripts injected once per window are skipped in a web view where
+    // they already ran, so each run uses a new web view.
+    WKWebViewConfiguration* configuration =
+        [[WKWebViewConfiguration alloc] init];
+    for (NSString* script in scripts) {
+      [configuration.userContentController
+          addUserScript:[[WKUserScript alloc]
+                              initWithSource:script
+                               injectionTime:
+                                   WKUserScriptInjectionTimeAtDocumentStart
+                            forMainFrameOnly:NO]];
+    }
+    WKWebView* web_view = [[WKWebView alloc] initWithFrame:CGRectZero
+                                             configuration:configuration];
+    // Create the web process before timing the load.
+    EXPECT_TRUE(web::test::LoadHtml(web_view, @"", nil));
+
+    base::ElapsedTimer timer;
+    EXPECT_TRUE(web::test::LoadHtml(web_view, @"<html></html>", nil));
+    return timer.Elapsed();
+  }
+
+  std::unique_ptr<ChromeBrowserState> browser_state_;
+  // The scripts of the features injected in every content world.
+  NSMutableArray<NSString*>* scripts_;
+  // |scripts_| combined into a single script.
+  NSString* bundle_;
+};
+
+// Tests the cost per frame of the feature scripts injected separately.
+TEST_F(UserScriptBundlePerfTest, SeparateScripts) {
+  LogPerfValue("Separate scripts", scripts_.count, "scripts");
+  RepeatTimedRuns("Separate scripts per frame",
+                  ^base::TimeDelta(int) {
+                    return LoadWithUserScripts(scripts_);
+                  },
+                  nil);
+}
+
+// Tests the cost per frame of the feature scripts combined into a bundle.
+TEST_F(UserScriptBundlePerfTest, BundledScripts) {
+  RepeatTimedRuns("Bundled scripts per frame",
+                  ^base::TimeDelta(int) {
+                    return LoadWithUserScripts(@[ bundle_ ]);
+                  },
+                  nil);
+}
+
+// Reports the number of user scripts injected into each frame of a web view
+// configured for a browser state.
+TEST_F(UserScriptBundlePerfTest, UserScriptCount) {
+  WKWebView* web_view = web::BuildWKWebView(CGRectZero, browser_state_.get());
+  NSArray<WKUserScript*>* user_scripts =
+      web_view.configuration.userContentController.userScripts;
+  NSUInteger all_frames_count = 0;
+  for (WKUserScript* user_script in user_scripts) {
+    if (!user_script.forMainFrameOnly)
+      ++all_frames_count;
+  }
+  LogPerfValue("User scripts in main frame", user_scripts.count, "scripts");
+  LogPerfValue("User scripts in subframes", all_frames_count, "scripts");
+}
+
+}  // namespace
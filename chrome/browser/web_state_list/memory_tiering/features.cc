@@ -0,0 +1,8 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/web_state_list/memory_tiering/features.h"
+
+const base::Feature kWebStateMemoryTiering{"WebStateMemoryTiering",
+                                           base::FEATURE_DISABLED_BY_DEFAULT};
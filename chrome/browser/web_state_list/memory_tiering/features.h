@@ -0,0 +1,15 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_WEB_STATE_LIST_MEMORY_TIERING_FEATURES_H_
+#define IOS_CHROME_BROWSER_WEB_STATE_LIST_MEMORY_TIERING_FEATURES_H_
+
+#include "base/feature_list.h"
+
+// Feature flag to progressively demote the least recently used background
+// WebStates to cheaper memory tiers on memory pressure, or when too many of
+// them have a web view.
+extern const base::Feature kWebStateMemoryTiering;
+
+#endif  // IOS_CHROME_BROWSER_WEB_STATE_LIST_MEMORY_TIERING_FEATURES_H_
@@ -0,0 +1,154 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_BROWSER_WEB_STATE_LIST_MEMORY_TIERING_WEB_STATE_MEMORY_TIERING_BROWSER_AGENT_H_
+#define IOS_CHROME_BROWSER_WEB_STATE_LIST_MEMORY_TIERING_WEB_STATE_MEMORY_TIERING_BROWSER_AGENT_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#import "ios/chrome/browser/main/browser_observer.h"
+#include "ios/chrome/browser/main/browser_user_data.h"
+#import "ios/chrome/browser/web_state_list/web_state_list_observer.h"
+
+namespace web {
+class WebState;
+}
+
+// Memory tiers of a WebState, from the most to the least expensive. These
+// values are persisted to logs. Entries should not be renumbered and numeric
+// values should never be reused.
+enum class WebStateMemoryTier {
+  // The WebState is untouched.
+  kActive = 0,
+  // The snapshot of the WebState was dropped from memory; it stays on disk.
+  kSnapshotEvicted = 1,
+  // The web view of the WebState was discarded; its navigation history is
+  // kept, and the page is reloaded when the WebState is activated.
+  kWebViewDiscarded = 2,
+  // The WebState was replaced by a new one restored from its serialized
+  // session, releasing the state of its tab helpers.
+  kSerialized = 3,
+  kMaxValue = kSerialized,
+};
+
+// An agent that sheds memory from the background WebStates of its browser.
+// On memory pressure, or when more background WebStates than a budget have a
+// web view, the least recently used background WebStates are progressively
+// demoted to cheaper tiers. A WebState is restored when it is activated.
+class WebStateMemoryTieringBrowserAgent
+    : public BrowserUserData<WebStateMemoryTieringBrowserAgent>,
+      BrowserObserver,
+      WebStateListObserver {
+ public:
+  // Maximum number of background WebStates keeping their web view.
+  static const size_t kBackgroundWebViewBudget;
+
+  WebStateMemoryTieringBrowserAgent(const WebStateMemoryTieringBrowserAgent&) =
+      delete;
+  WebStateMemoryTieringBrowserAgent& operator=(
+      const WebStateMemoryTieringBrowserAgent&) = delete;
+  ~WebStateMemoryTieringBrowserAgent() override;
+
+  // Demotes the background WebStates according to |memory_pressure_level|.
+  // Invoked on memory pressure.
+  void ShedMemory(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
+  // Returns the tier of |web_state|, which must be in the browser's
+  // WebStateList.
+  WebStateMemoryTier GetTier(web::WebState* web_state) const;
+
+  // Returns the number of WebStates in |tier|.
+  int GetWebStateCount(WebStateMemoryTier tier) const;
+
+  // Total memory reclaimed by the demotions, as measured a few seconds after
+  // each of them.
+  int64_t bytes_reclaimed() const { return bytes_reclaimed_; }
+
+ private:
+  friend class BrowserUserData<WebStateMemoryTieringBrowserAgent>;
+  BROWSER_USER_DATA_KEY_DECL();
+
+  // Tier and recency of a WebState.
+  struct TierInfo {
+    WebStateMemoryTier tier = WebStateMemoryTier::kActive;
+    // Last time the WebState stopped being active, null if it never was.
+    base::TimeTicks last_active_time;
+  };
+
+  explicit WebStateMemoryTieringBrowserAgent(Browser* browser);
+
+  // Demotes to |tier| the background WebStates in a lower tier, except for the
+  // |keep_count| most recently used ones. Returns the number of WebStates
+  // demoted.
+  int DemoteBackgroundWebStates(WebStateMemoryTier tier, size_t keep_count);
+
+  // Demotes the WebState at |index| to |tier|. Returns whether it was demoted.
+  bool DemoteWebStateAt(int index, WebStateMemoryTier tier);
+
+  // Replaces the WebState at |index| by one restored from its serialized
+  // session. Returns whether it was replaced.
+  bool SerializeWebStateAt(int index);
+
+  // Restores |web_state| after it was activated.
+  void RestoreWebState(web::WebState* web_state);
+
+  // Discards the web views of the background WebStates over the budget.
+  void EnforceWebViewBudget();
+
+  // Schedules a measurement of the memory reclaimed by demotions which started
+  // when the memory used was |memory_before_demotions|.
+  void ScheduleReclaimedMemoryMeasurement(uint64_t memory_before_demotions);
+
+  // Records the memory reclaimed since the memory used was
+  // |memory_before_demotions|, and the number of WebStates in each tier.
+  void MeasureReclaimedMemory(uint64_t memory_before_demotions);
+
+  // BrowserObserver:
+  void BrowserDestroyed(Browser* browser) override;
+
+  // WebStateListObserver:
+  void WebStateInsertedAt(WebStateList* web_state_list,
+                          web::WebState* web_state,
+                          int index,
+                          bool activating) override;
+  void WebStateReplacedAt(WebStateList* web_state_list,
+                          web::WebState* old_web_state,
+                          web::WebState* new_web_state,
+                          int index) override;
+  void WebStateDetachedAt(WebStateList* web_state_list,
+                          web::WebState* web_state,
+                          int index) override;
+  void WebStateActivatedAt(WebStateList* web_state_list,
+                           web::WebState* old_web_state,
+                           web::WebState* new_web_state,
+                           int active_index,
+                           ActiveWebStateChangeReason reason) override;
+
+  // The browser whose WebStates are tiered.
+  Browser* browser_;
+
+  // Tier of each WebState of the browser's WebStateList.
+  std::map<web::WebState*, TierInfo> tiers_;
+
+  // Whether a WebState is being replaced by SerializeWebStateAt.
+  bool serializing_ = false;
+
+  // Whether a measurement of the reclaimed memory is scheduled.
+  bool measurement_scheduled_ = false;
+
+  int64_t bytes_reclaimed_ = 0;
+
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
+  base::WeakPtrFactory<WebStateMemoryTieringBrowserAgent> weak_factory_{this};
+};
+
+#endif  // IOS_CHROME_BROWSER_WEB_STATE_LIST_MEMORY_TIERING_WEB_STATE_MEMORY_TIERING_BROWSER_AGENT_H_
@@ -0,0 +1,365 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/web_state_list/memory_tiering/web_state_memory_tiering_browser_agent.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "base/auto_reset.h"
+#include "base/bind.h"
+#include "base/check_op.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "ios/chrome/browser/browser_state/chrome_browser_state.h"
+#include "ios/chrome/browser/memory/memory_metrics.h"
+#import "ios/chrome/browser/snapshots/snapshot_tab_helper.h"
+#import "ios/chrome/browser/web_state_list/web_state_list.h"
+#import "ios/chrome/browser/web_state_list/web_usage_enabler/web_usage_enabler_browser_agent.h"
+#import "ios/web/public/navigation/navigation_manager.h"
+#import "ios/web/public/web_state.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+// Delay after the demotions before measuring the memory they reclaimed, as
+// web views release their memory asynchronously.
+const base::TimeDelta kReclaimedMemoryMeasurementDelay =
+    base::TimeDelta::FromSeconds(5);
+
+}  // namespace
+
+BROWSER_USER_DATA_KEY_IMPL(WebStateMemoryTieringBrowserAgent)
+
+// static
+const size_t WebStateMemoryTieringBrowserAgent::kBackgroundWebViewBudget = 4;
+
+WebStateMemoryTieringBrowserAgent::WebStateMemoryTieringBrowserAgent(
+    Browser* browser)
+    : browser_(browser) {
+  browser_->AddObserver(this);
+  WebStateList* web_state_list = browser_->GetWebStateList();
+  web_state_list->AddObserver(this);
+  for (int index = 0; index < web_state_list->count(); ++index)
+    tiers_[web_state_list->GetWebStateAt(index)] = TierInfo();
+
+  memory_pressure_listener_ = std::make_unique<base::MemoryPressureListener>(
+      FROM_HERE,
+      base::BindRepeating(&WebStateMemoryTieringBrowserAgent::ShedMemory,
+                          base::Unretained(this)));
+}
+
+WebStateMemoryTieringBrowserAgent::~WebStateMemoryTieringBrowserAgent() =
+    default;
+
+void WebStateMemoryTieringBrowserAgent::ShedMemory(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  if (!browser_)
+    return;
+
+  const uint64_t memory_before_demotions =
+      memory_util::GetRealMemoryUsedInBytes();
+  int demoted_count = 0;
+  switch (memory_pressure_level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+      return;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      demoted_count += DemoteBackgroundWebStates(
+          WebStateMemoryTier::kSnapshotEvicted, /*keep_count=*/0);
+      demoted_count +=
+          DemoteBackgroundWebStates(WebStateMemoryTier::kWebViewDiscarded,
+                                    kBackgroundWebViewBudget / 2);
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      demoted_count += DemoteBackgroundWebStates(
+          WebStateMemoryTier::kWebViewDiscarded, /*keep_count=*/0);
+      demoted_count += DemoteBackgroundWebStates(
+          WebStateMemoryTier::kSerialized, kBackgroundWebViewBudget);
+      break;
+  }
+
+  if (demoted_count)
+    ScheduleReclaimedMemoryMeasurement(memory_before_demotions);
+}
+
+WebStateMemoryTier WebStateMemoryTieringBrowserAgent::GetTier(
+    web::WebState* web_state) const {
+  auto iter = tiers_.find(web_state);
+  DCHECK(iter != tiers_.end());
+  return iter->second.tier;
+}
+
+int WebStateMemoryTieringBrowserAgent::GetWebStateCount(
+    WebStateMemoryTier tier) const {
+  return static_cast<int>(
+      std::count_if(tiers_.begin(), tiers_.end(), [tier](const auto& pair) {
+        return pair.second.tier == tier;
+      }));
+}
+
+int WebStateMemoryTieringBrowserAgent::DemoteBackgroundWebStates(
+    WebStateMemoryTier tier,
+    size_t keep_count) {
+  WebStateList* web_state_list = browser_->GetWebStateList();
+  std::vector<std::pair<base::TimeTicks, int>> background_web_states;
+  for (int index = 0; index < web_state_list->count(); ++index) {
+    if (index == web_state_list->active_index())
+      continue;
+    auto iter = tiers_.find(web_state_list->GetWebStateAt(index));
+    if (iter == tiers_.end())
+      continue;
+    background_web_states.emplace_back(iter->second.last_active_time, index);
+  }
+  if (background_web_states.size() <= keep_count)
+    return 0;
+
+  // Keep the most recently used WebStates, and demote the others. Demoting a
+  // WebState may replace it, but never changes the indexes.
+  std::sort(background_web_states.begin(), background_web_states.end(),
+            std::greater<>());
+  int demoted_count = 0;
+  for (size_t i = keep_count; i < background_web_states.size(); ++i) {
+    if (DemoteWebStateAt(background_web_states[i].second, tier))
+      ++demoted_count;
+  }
+  return demoted_count;
+}
+
+bool WebStateMemoryTieringBrowserAgent::DemoteWebStateAt(
+    int index,
+    WebStateMemoryTier tier) {
+  web::WebState* web_state = browser_->GetWebStateList()->GetWebStateAt(index);
+  TierInfo& info = tiers_[web_state];
+  if (info.tier >= tier || web_state->IsVisible() ||
+      web_state->IsBeingDestroyed()) {
+    return false;
+  }
+  // Keep the web view of the WebStates loading in the background.
+  if (tier >= WebStateMemoryTier::kWebViewDiscarded && web_state->IsLoading())
+    tier = WebStateMemoryTier::kSnapshotEvicted;
+  if (info.tier >= tier)
+    return false;
+
+  const WebStateMemoryTier previous_tier = info.tier;
+  if (previous_tier < WebStateMemoryTier::kSnapshotEvicted) {
+    if (SnapshotTabHelper* snapshot_tab_helper =
+            SnapshotTabHelper::FromWebState(web_state)) {
+      snapshot_tab_helper->RemoveSnapshotFromMemory();
+    }
+  }
+  if (tier >= WebStateMemoryTier::kWebViewDiscarded &&
+      previous_tier < WebStateMemoryTier::kWebViewDiscarded) {
+    // Go through the WebUsageEnabler, so that enabling web usage for the
+    // browser doesn't recreate the web view.
+    if (WebUsageEnablerBrowserAgent* web_usage_enabler =
+            WebUsageEnablerBrowserAgent::FromBrowser(browser_)) {
+      web_usage_enabler->DiscardWebState(web_state);
+    } else {
+      web_state->SetWebUsageEnabled(false);
+    }
+  }
+  info.tier = tier;
+
+  // |info| is invalidated if the WebState is replaced.
+  if (tier == WebStateMemoryTier::kSerialized && !SerializeWebStateAt(index)) {
+    tier = WebStateMemoryTier::kWebViewDiscarded;
+    info.tier = tier;
+    if (previous_tier == tier)
+      return false;
+  }
+
+  base::UmaHistogramEnumeration("IOS.WebStateMemoryTiering.Demoted", tier);
+  return true;
+}
+
+bool WebStateMemoryTieringBrowserAgent::SerializeWebStateAt(int index) {
+  WebStateList* web_state_list = browser_->GetWebStateList();
+  web::WebState* web_state = web_state_list->GetWebStateAt(index);
+
+  // Replacing the WebState would clear the opener of the WebStates it opened.
+  const int opened_index = web_state_list->GetIndexOfNextWebStateOpenedBy(
+      web_state, index, /*use_group=*/false);
+  if (opened_index != WebStateList::kInvalidIndex)
+    return false;
+
+  CRWSessionStorage* session_storage = web_state->BuildSessionStorage();
+  if (!session_storage)
+    return false;
+
+  web::WebState::CreateParams create_params(browser_->GetBrowserState());
+  std::unique_ptr<web::WebState> placeholder =
+      web::WebState::CreateWithStorageSession(create_params, session_storage);
+
+  // Don't load the placeholder until it is activated.
+  WebUsageEnablerBrowserAgent* web_usage_enabler =
+      WebUsageEnablerBrowserAgent::FromBrowser(browser_);
+  const bool saved_triggers_initial_load =
+      web_usage_enabler && web_usage_enabler->TriggersInitialLoad();
+  if (web_usage_enabler)
+    web_usage_enabler->SetTriggersInitialLoad(false);
+
+  // The placeholder is restored with the same tab ID, so it shares the snapshot
+  // of |web_state|. Detach the snapshot cache so that the observers removing
+  // the snapshot of replaced WebStates don't delete it.
+  if (SnapshotTabHelper* snapshot_tab_helper =
+          SnapshotTabHelper::FromWebState(web_state)) {
+    snapshot_tab_helper->SetSnapshotCache(nil);
+  }
+  {
+    base::AutoReset<bool> serializing(&serializing_, true);
+    web_state_list->ReplaceWebStateAt(index, std::move(placeholder));
+  }
+  if (web_usage_enabler)
+    web_usage_enabler->SetTriggersInitialLoad(saved_triggers_initial_load);
+  return true;
+}
+
+void WebStateMemoryTieringBrowserAgent::RestoreWebState(
+    web::WebState* web_state) {
+  auto iter = tiers_.find(web_state);
+  if (iter == tiers_.end() || iter->second.tier == WebStateMemoryTier::kActive)
+    return;
+
+  base::UmaHistogramEnumeration("IOS.WebStateMemoryTiering.Restored",
+                                iter->second.tier);
+  if (iter->second.tier >= WebStateMemoryTier::kWebViewDiscarded) {
+    WebUsageEnablerBrowserAgent* web_usage_enabler =
+        WebUsageEnablerBrowserAgent::FromBrowser(browser_);
+    if (web_usage_enabler) {
+      web_usage_enabler->RestoreDiscardedWebState(web_state);
+    } else {
+      web_state->SetWebUsageEnabled(true);
+    }
+    if (web_state->IsWebUsageEnabled())
+      web_state->GetNavigationManager()->LoadIfNecessary();
+  }
+  iter->second.tier = WebStateMemoryTier::kActive;
+}
+
+void WebStateMemoryTieringBrowserAgent::EnforceWebViewBudget() {
+  // Measuring the memory used is a system call, so only do it when the budget
+  // is exceeded rather than on every activation.
+  WebStateList* web_state_list = browser_->GetWebStateList();
+  size_t web_view_count = 0;
+  for (int index = 0; index < web_state_list->count(); ++index) {
+    if (index == web_state_list->active_index())
+      continue;
+    auto iter = tiers_.find(web_state_list->GetWebStateAt(index));
+    if (iter != tiers_.end() &&
+        iter->second.tier < WebStateMemoryTier::kWebViewDiscarded) {
+      ++web_view_count;
+    }
+  }
+  if (web_view_count <= kBackgroundWebViewBudget)
+    return;
+
+  const uint64_t memory_before_demotions =
+      memory_util::GetRealMemoryUsedInBytes();
+  if (DemoteBackgroundWebStates(WebStateMemoryTier::kWebViewDiscarded,
+                                kBackgroundWebViewBudget)) {
+    ScheduleReclaimedMemoryMeasurement(memory_before_demotions);
+  }
+}
+
+void WebStateMemoryTieringBrowserAgent::ScheduleReclaimedMemoryMeasurement(
+    uint64_t memory_before_demotions) {
+  if (measurement_scheduled_)
+    return;
+  measurement_scheduled_ = true;
+  base::ThreadTaskRunnerHandle::Get()->PostDelayedTask(
+      FROM_HERE,
+      base::BindOnce(&WebStateMemoryTieringBrowserAgent::MeasureReclaimedMemory,
+                     weak_factory_.GetWeakPtr(), memory_before_demotions),
+      kReclaimedMemoryMeasurementDelay);
+}
+
+void WebStateMemoryTieringBrowserAgent::MeasureReclaimedMemory(
+    uint64_t memory_before_demotions) {
+  measurement_scheduled_ = false;
+  const uint64_t memory_after_demotions =
+      memory_util::GetRealMemoryUsedInBytes();
+  const int64_t reclaimed_bytes =
+      memory_before_demotions > memory_after_demotions
+          ? memory_before_demotions - memory_after_demotions
+          : 0;
+  bytes_reclaimed_ += reclaimed_bytes;
+  base::UmaHistogramMemoryKB("IOS.WebStateMemoryTiering.MemoryReclaimed",
+                             reclaimed_bytes / 1024);
+  base::UmaHistogramCounts100(
+      "IOS.WebStateMemoryTiering.WebStateCount.SnapshotEvicted",
+      GetWebStateCount(WebStateMemoryTier::kSnapshotEvicted));
+  base::UmaHistogramCounts100(
+      "IOS.WebStateMemoryTiering.WebStateCount.WebViewDiscarded",
+      GetWebStateCount(WebStateMemoryTier::kWebViewDiscarded));
+  base::UmaHistogramCounts100(
+      "IOS.WebStateMemoryTiering.WebStateCount.Serialized",
+      GetWebStateCount(WebStateMemoryTier::kSerialized));
+}
+
+#pragma mark - BrowserObserver
+
+void WebStateMemoryTieringBrowserAgent::BrowserDestroyed(Browser* browser) {
+  DCHECK_EQ(browser, browser_);
+  memory_pressure_listener_.reset();
+  browser_->GetWebStateList()->RemoveObserver(this);
+  browser_->RemoveObserver(this);
+  browser_ = nullptr;
+  tiers_.clear();
+}
+
+#pragma mark - WebStateListObserver
+
+void WebStateMemoryTieringBrowserAgent::WebStateInsertedAt(
+    WebStateList* web_state_list,
+    web::WebState* web_state,
+    int index,
+    bool activating) {
+  tiers_[web_state] = TierInfo();
+}
+
+void WebStateMemoryTieringBrowserAgent::WebStateReplacedAt(
+    WebStateList* web_state_list,
+    web::WebState* old_web_state,
+    web::WebState* new_web_state,
+    int index) {
+  TierInfo info;
+  auto iter = tiers_.find(old_web_state);
+  if (iter != tiers_.end()) {
+    if (serializing_)
+      info = iter->second;
+    tiers_.erase(iter);
+  }
+  tiers_[new_web_state] = info;
+}
+
+void WebStateMemoryTieringBrowserAgent::WebStateDetachedAt(
+    WebStateList* web_state_list,
+    web::WebState* web_state,
+    int index) {
+  tiers_.erase(web_state);
+}
+
+void WebStateMemoryTieringBrowserAgent::WebStateActivatedAt(
+    WebStateList* web_state_list,
+    web::WebState* old_web_state,
+    web::WebState* new_web_state,
+    int active_index,
+    ActiveWebStateChangeReason reason) {
+  if (old_web_state) {
+    auto iter = tiers_.find(old_web_state);
+    if (iter != tiers_.end())
+      iter->second.last_active_time = base::TimeTicks::Now();
+  }
+  if (new_web_state)
+    RestoreWebState(new_web_state);
+
+  // The WebStateList can't be mutated from its observers, but discarding web
+  // views doesn't mutate it.
+  EnforceWebViewBudget();
+}
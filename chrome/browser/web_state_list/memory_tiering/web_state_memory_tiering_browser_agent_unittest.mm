@@ -0,0 +1,222 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/web_state_list/memory_tiering/web_state_memory_tiering_browser_agent.h"
+
+#import "ios/chrome/browser/main/test_browser.h"
+#import "ios/chrome/browser/snapshots/snapshot_cache.h"
+#import "ios/chrome/browser/snapshots/snapshot_tab_helper.h"
+#import "ios/chrome/browser/tabs/closing_web_state_observer_browser_agent.h"
+#import "ios/chrome/browser/web_state_list/web_state_list.h"
+#import "ios/chrome/browser/web_state_list/web_state_opener.h"
+#import "ios/chrome/browser/web_state_list/web_usage_enabler/web_usage_enabler_browser_agent.h"
+#import "ios/web/public/test/fakes/fake_navigation_manager.h"
+#import "ios/web/public/test/fakes/fake_web_state.h"
+#include "ios/web/public/test/web_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+#import "third_party/ocmock/OCMock/OCMock.h"
+#import "third_party/ocmock/gtest_support.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+class WebStateMemoryTieringBrowserAgentTest : public PlatformTest {
+ public:
+  WebStateMemoryTieringBrowserAgentTest()
+      : browser_(std::make_unique<TestBrowser>()),
+        web_state_list_(browser_->GetWebStateList()) {
+    WebUsageEnablerBrowserAgent::CreateForBrowser(browser_.get());
+    WebUsageEnablerBrowserAgent::FromBrowser(browser_.get())
+        ->SetWebUsageEnabled(true);
+    WebStateMemoryTieringBrowserAgent::CreateForBrowser(browser_.get());
+    agent_ = WebStateMemoryTieringBrowserAgent::FromBrowser(browser_.get());
+  }
+
+ protected:
+  // Appends |count| WebStates, then activates them in order so that the first
+  // one is the least recently used.
+  void AppendAndActivateWebStates(int count) {
+    for (int i = 0; i < count; ++i) {
+      auto web_state = std::make_unique<web::FakeWebState>();
+      web_state->SetNavigationManager(
+          std::make_unique<web::FakeNavigationManager>());
+      SnapshotTabHelper::CreateForWebState(web_state.get(),
+                                           [[NSUUID UUID] UUIDString]);
+      web_state_list_->InsertWebState(WebStateList::kInvalidIndex,
+                                      std::move(web_state),
+                                      WebStateList::INSERT_NO_FLAGS,
+                                      WebStateOpener());
+    }
+    for (int index = 0; index < web_state_list_->count(); ++index)
+      web_state_list_->ActivateWebStateAt(index);
+  }
+
+  WebStateMemoryTier GetTierAt(int index) {
+    return agent_->GetTier(web_state_list_->GetWebStateAt(index));
+  }
+
+  // Serializing a WebState creates a real one.
+  web::WebTaskEnvironment task_environment_;
+  std::unique_ptr<Browser> browser_;
+  WebStateList* web_state_list_;
+  WebStateMemoryTieringBrowserAgent* agent_;
+};
+
+// Tests that only the most recently used background WebStates keep their web
+// view.
+TEST_F(WebStateMemoryTieringBrowserAgentTest, WebViewBudget) {
+  const int budget = static_cast<int>(
+      WebStateMemoryTieringBrowserAgent::kBackgroundWebViewBudget);
+  const int count = budget + 3;
+  AppendAndActivateWebStates(count);
+
+  for (int index = 0; index < count; ++index) {
+    const bool discarded = index < count - 1 - budget;
+    EXPECT_EQ(discarded ? WebStateMemoryTier::kWebViewDiscarded
+                        : WebStateMemoryTier::kActive,
+              GetTierAt(index));
+    EXPECT_EQ(!discarded,
+              web_state_list_->GetWebStateAt(index)->IsWebUsageEnabled());
+  }
+  EXPECT_EQ(2, agent_->GetWebStateCount(WebStateMemoryTier::kWebViewDiscarded));
+}
+
+// Tests that a discarded WebState is restored and reloaded when activated.
+TEST_F(WebStateMemoryTieringBrowserAgentTest, RestoreOnActivation) {
+  AppendAndActivateWebStates(
+      WebStateMemoryTieringBrowserAgent::kBackgroundWebViewBudget + 2);
+  ASSERT_EQ(WebStateMemoryTier::kWebViewDiscarded, GetTierAt(0));
+
+  web_state_list_->ActivateWebStateAt(0);
+  web::WebState* web_state = web_state_list_->GetWebStateAt(0);
+  EXPECT_EQ(WebStateMemoryTier::kActive, GetTierAt(0));
+  EXPECT_TRUE(web_state->IsWebUsageEnabled());
+  EXPECT_TRUE(static_cast<web::FakeNavigationManager*>(
+                  web_state->GetNavigationManager())
+                  ->LoadIfNecessaryWasCalled());
+}
+
+// Tests that enabling web usage for the browser doesn't recreate the web views
+// discarded by the agent, and that the budget is still enforced afterwards.
+TEST_F(WebStateMemoryTieringBrowserAgentTest, WebUsageToggle) {
+  const int budget = static_cast<int>(
+      WebStateMemoryTieringBrowserAgent::kBackgroundWebViewBudget);
+  AppendAndActivateWebStates(budget + 2);
+  ASSERT_EQ(WebStateMemoryTier::kWebViewDiscarded, GetTierAt(0));
+
+  WebUsageEnablerBrowserAgent* web_usage_enabler =
+      WebUsageEnablerBrowserAgent::FromBrowser(browser_.get());
+  web_usage_enabler->SetWebUsageEnabled(false);
+  web_usage_enabler->SetWebUsageEnabled(true);
+  EXPECT_FALSE(web_state_list_->GetWebStateAt(0)->IsWebUsageEnabled());
+  EXPECT_EQ(WebStateMemoryTier::kWebViewDiscarded, GetTierAt(0));
+
+  // Activating a new WebState discards the next least recently used web view.
+  auto web_state = std::make_unique<web::FakeWebState>();
+  web_state->SetNavigationManager(
+      std::make_unique<web::FakeNavigationManager>());
+  web_state_list_->InsertWebState(WebStateList::kInvalidIndex,
+                                  std::move(web_state),
+                                  WebStateList::INSERT_ACTIVATE,
+                                  WebStateOpener());
+  EXPECT_EQ(WebStateMemoryTier::kWebViewDiscarded, GetTierAt(1));
+  EXPECT_FALSE(web_state_list_->GetWebStateAt(1)->IsWebUsageEnabled());
+  int web_usage_enabled_count = 0;
+  for (int index = 0; index < web_state_list_->count(); ++index) {
+    if (web_state_list_->GetWebStateAt(index)->IsWebUsageEnabled())
+      ++web_usage_enabled_count;
+  }
+  EXPECT_EQ(budget + 1, web_usage_enabled_count);
+}
+
+// Tests that moderate memory pressure evicts the snapshots of all the
+// background WebStates, and discards the least recently used web views.
+TEST_F(WebStateMemoryTieringBrowserAgentTest, ModerateMemoryPressure) {
+  AppendAndActivateWebStates(4);
+
+  agent_->ShedMemory(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+
+  const int kept_count = static_cast<int>(
+      WebStateMemoryTieringBrowserAgent::kBackgroundWebViewBudget / 2);
+  EXPECT_EQ(kept_count,
+            agent_->GetWebStateCount(WebStateMemoryTier::kSnapshotEvicted));
+  EXPECT_EQ(3 - kept_count,
+            agent_->GetWebStateCount(WebStateMemoryTier::kWebViewDiscarded));
+  EXPECT_EQ(WebStateMemoryTier::kActive, GetTierAt(3));
+}
+
+// Tests that critical memory pressure discards all the background web views,
+// and doesn't serialize the WebStates which opened others.
+TEST_F(WebStateMemoryTieringBrowserAgentTest, CriticalMemoryPressure) {
+  AppendAndActivateWebStates(1);
+  web::WebState* opener = web_state_list_->GetWebStateAt(0);
+  for (size_t i = 0;
+       i <= WebStateMemoryTieringBrowserAgent::kBackgroundWebViewBudget; ++i) {
+    auto web_state = std::make_unique<web::FakeWebState>();
+    web_state->SetNavigationManager(
+        std::make_unique<web::FakeNavigationManager>());
+    web_state_list_->InsertWebState(
+        WebStateList::kInvalidIndex, std::move(web_state),
+        WebStateList::INSERT_ACTIVATE, WebStateOpener(opener));
+  }
+  ASSERT_NE(opener, web_state_list_->GetActiveWebState());
+
+  agent_->ShedMemory(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+
+  EXPECT_EQ(opener, web_state_list_->GetWebStateAt(0));
+  EXPECT_EQ(WebStateMemoryTier::kWebViewDiscarded, GetTierAt(0));
+  EXPECT_FALSE(opener->IsWebUsageEnabled());
+  EXPECT_EQ(WebStateMemoryTier::kActive,
+            agent_->GetTier(web_state_list_->GetActiveWebState()));
+}
+
+// Tests that critical memory pressure replaces the least recently used
+// background WebStates over the budget by placeholders restored from their
+// session, which are not loaded until activated.
+TEST_F(WebStateMemoryTieringBrowserAgentTest, SerializeOnCriticalPressure) {
+  AppendAndActivateWebStates(
+      WebStateMemoryTieringBrowserAgent::kBackgroundWebViewBudget + 2);
+  web::WebState* web_state = web_state_list_->GetWebStateAt(0);
+
+  agent_->ShedMemory(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+
+  web::WebState* placeholder = web_state_list_->GetWebStateAt(0);
+  EXPECT_NE(web_state, placeholder);
+  EXPECT_EQ(WebStateMemoryTier::kSerialized, GetTierAt(0));
+  EXPECT_EQ(1, agent_->GetWebStateCount(WebStateMemoryTier::kSerialized));
+  EXPECT_EQ(WebStateMemoryTier::kWebViewDiscarded, GetTierAt(1));
+
+  web_state_list_->ActivateWebStateAt(0);
+  EXPECT_EQ(placeholder, web_state_list_->GetWebStateAt(0));
+  EXPECT_EQ(WebStateMemoryTier::kActive, GetTierAt(0));
+  EXPECT_TRUE(placeholder->IsWebUsageEnabled());
+}
+
+// Tests that serializing a WebState keeps its snapshot, which is shared with
+// the placeholder, when the observers removing the snapshot of replaced
+// WebStates are installed.
+TEST_F(WebStateMemoryTieringBrowserAgentTest, SerializationKeepsSnapshot) {
+  ClosingWebStateObserverBrowserAgent::CreateForBrowser(browser_.get());
+  AppendAndActivateWebStates(
+      WebStateMemoryTieringBrowserAgent::kBackgroundWebViewBudget + 2);
+  id snapshot_cache = OCMClassMock([SnapshotCache class]);
+  [[snapshot_cache reject] removeImageWithSnapshotID:[OCMArg any]];
+  for (int index = 0; index < web_state_list_->count(); ++index) {
+    SnapshotTabHelper::FromWebState(web_state_list_->GetWebStateAt(index))
+        ->SetSnapshotCache(snapshot_cache);
+  }
+  web::WebState* web_state = web_state_list_->GetWebStateAt(0);
+
+  agent_->ShedMemory(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+
+  ASSERT_NE(web_state, web_state_list_->GetWebStateAt(0));
+  EXPECT_EQ(WebStateMemoryTier::kSerialized, GetTierAt(0));
+  EXPECT_OCMOCK_VERIFY(snapshot_cache);
+}
@@ -5,6 +5,8 @@
 #ifndef IOS_CHROME_BROWSER_WEB_STATE_LIST_WEB_USAGE_ENABLER_WEB_USAGE_ENABLER_BROWSER_AGENT_H_
 #define IOS_CHROME_BROWSER_WEB_STATE_LIST_WEB_USAGE_ENABLER_WEB_USAGE_ENABLER_BROWSER_AGENT_H_
 
+#include <set>
+
 #import "ios/chrome/browser/main/browser_observer.h"
 #include "ios/chrome/browser/main/browser_user_data.h"
 #import "ios/chrome/browser/web_state_list/web_state_list_observer.h"
@@ -39,6 +41,15 @@ class WebUsageEnablerBrowserAgent
   // Sets the value for |TriggersInitialLoad|.
   void SetTriggersInitialLoad(bool triggers_initial_load);
 
+  // Disables web usage for |web_state|, which must be in the list, so that its
+  // web view is discarded. Web usage stays disabled for |web_state| when it is
+  // enabled for the list, until RestoreDiscardedWebState() is called.
+  void DiscardWebState(web::WebState* web_state);
+
+  // Sets the web usage of |web_state|, discarded by DiscardWebState(), back to
+  // |IsWebUsageEnabled|.
+  void RestoreDiscardedWebState(web::WebState* web_state);
+
  private:
   // Updates the web usage enabled status of all WebStates in |browser_|'s web
   // state list to |web_usage_enabled_|.
@@ -59,6 +70,9 @@ class WebUsageEnablerBrowserAgent
                           web::WebState* old_web_state,
                           web::WebState* new_web_state,
                           int index) override;
+  void WebStateDetachedAt(WebStateList* web_state_list,
+                          web::WebState* web_state,
+                          int index) override;
 
   explicit WebUsageEnablerBrowserAgent(Browser* browser);
   friend class BrowserUserData<WebUsageEnablerBrowserAgent>;
@@ -71,6 +85,8 @@ class WebUsageEnablerBrowserAgent
   // Whether the initial load for a WebState added to |web_state_list_| should
   // be triggered if |web_usage_enabled_| is true.
   bool triggers_initial_load_ = true;
+  // The WebStates whose web usage stays disabled, see DiscardWebState().
+  std::set<web::WebState*> discarded_web_states_;
 };
 
 #endif  // IOS_CHROME_BROWSER_WEB_STATE_LIST_WEB_USAGE_ENABLER_WEB_USAGE_ENABLER_BROWSER_AGENT_H_
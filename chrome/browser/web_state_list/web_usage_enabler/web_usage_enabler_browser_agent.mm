@@ -4,6 +4,7 @@
 
 #import "ios/chrome/browser/web_state_list/web_usage_enabler/web_usage_enabler_browser_agent.h"
 
+#include "base/check_op.h"
 #import "ios/chrome/browser/web_state_list/web_state_list.h"
 #import "ios/web/public/navigation/navigation_manager.h"
 #import "ios/web/public/web_state.h"
@@ -43,12 +44,28 @@ void WebUsageEnablerBrowserAgent::SetTriggersInitialLoad(
   triggers_initial_load_ = triggers_initial_load;
 }
 
+void WebUsageEnablerBrowserAgent::DiscardWebState(web::WebState* web_state) {
+  DCHECK_NE(WebStateList::kInvalidIndex,
+            browser_->GetWebStateList()->GetIndexOfWebState(web_state));
+  discarded_web_states_.insert(web_state);
+  web_state->SetWebUsageEnabled(false);
+}
+
+void WebUsageEnablerBrowserAgent::RestoreDiscardedWebState(
+    web::WebState* web_state) {
+  if (discarded_web_states_.erase(web_state))
+    web_state->SetWebUsageEnabled(web_usage_enabled_);
+}
+
 void WebUsageEnablerBrowserAgent::UpdateWebUsageForAllWebStates() {
   if (!browser_)
     return;
   WebStateList* web_state_list = browser_->GetWebStateList();
   for (int index = 0; index < web_state_list->count(); ++index) {
     web::WebState* web_state = web_state_list->GetWebStateAt(index);
+    // Enabling web usage would recreate the discarded web views.
+    if (discarded_web_states_.count(web_state))
+      continue;
     web_state->SetWebUsageEnabled(web_usage_enabled_);
   }
 }
@@ -78,5 +95,13 @@ void WebUsageEnablerBrowserAgent::WebStateReplacedAt(
     web::WebState* old_web_state,
     web::WebState* new_web_state,
     int index) {
+  discarded_web_states_.erase(old_web_state);
   UpdateWebUsageForAddedWebState(new_web_state);
 }
+
+void WebUsageEnablerBrowserAgent::WebStateDetachedAt(
+    WebStateList* web_state_list,
+    web::WebState* web_state,
+    int index) {
+  discarded_web_states_.erase(web_state);
+}
@@ -113,3 +113,22 @@ TEST_F(WebUsageEnablerBrowserAgentTest, DisableInitialLoad) {
   AppendNewWebState(kURL);
   EXPECT_TRUE(InitialLoadTriggeredForLastWebState());
 }
+
+// Tests that a discarded WebState keeps web usage disabled when web usage is
+// enabled for the list, until it is restored.
+TEST_F(WebUsageEnablerBrowserAgentTest, DiscardWebState) {
+  enabler_->SetWebUsageEnabled(true);
+  AppendNewWebState(kURL);
+  AppendNewWebState(kURL);
+  web::WebState* discarded_web_state = web_state_list_->GetWebStateAt(0);
+  enabler_->DiscardWebState(discarded_web_state);
+  EXPECT_FALSE(discarded_web_state->IsWebUsageEnabled());
+
+  enabler_->SetWebUsageEnabled(false);
+  enabler_->SetWebUsageEnabled(true);
+  EXPECT_FALSE(discarded_web_state->IsWebUsageEnabled());
+  EXPECT_TRUE(web_state_list_->GetWebStateAt(1)->IsWebUsageEnabled());
+
+  enabler_->RestoreDiscardedWebState(discarded_web_state);
+  EXPECT_TRUE(discarded_web_state->IsWebUsageEnabled());
+}
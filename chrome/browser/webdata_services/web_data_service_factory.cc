@@ -91,13 +91,14 @@ WebDataServiceFactory* WebDataServiceFactory::GetInstance() {
 }
 
 WebDataServiceFactory::WebDataServiceFactory()
-    : BrowserStateKeyedServiceFactory(
+    : AuditedBrowserStateKeyedServiceFactory(
           "WebDataService",
           BrowserStateDependencyManager::GetInstance()) {}
 
 WebDataServiceFactory::~WebDataServiceFactory() {}
 
-std::unique_ptr<KeyedService> WebDataServiceFactory::BuildServiceInstanceFor(
+std::unique_ptr<KeyedService>
+WebDataServiceFactory::BuildAuditedServiceInstanceFor(
     web::BrowserState* context) const {
   const base::FilePath& browser_state_path = context->GetStatePath();
   return std::make_unique<WebDataServiceWrapper>(
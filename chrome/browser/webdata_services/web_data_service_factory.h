@@ -10,7 +10,7 @@
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/no_destructor.h"
-#include "components/keyed_service/ios/browser_state_keyed_service_factory.h"
+#include "ios/chrome/browser/browser_state/audited_browser_state_keyed_service_factory.h"
 
 class ChromeBrowserState;
 class KeywordWebDataService;
@@ -25,7 +25,7 @@ class AutofillWebDataService;
 namespace ios {
 // Singleton that owns all WebDataServiceWrappers and associates them with
 // ChromeBrowserState.
-class WebDataServiceFactory : public BrowserStateKeyedServiceFactory {
+class WebDataServiceFactory : public AuditedBrowserStateKeyedServiceFactory {
  public:
   // Returns the AutofillWebDataService associated with |browser_state|.
   static WebDataServiceWrapper* GetForBrowserState(
@@ -64,8 +64,8 @@ class WebDataServiceFactory : public BrowserStateKeyedServiceFactory {
   WebDataServiceFactory();
   ~WebDataServiceFactory() override;
 
-  // BrowserStateKeyedServiceFactory implementation.
-  std::unique_ptr<KeyedService> BuildServiceInstanceFor(
+  // AuditedBrowserStateKeyedServiceFactory implementation.
+  std::unique_ptr<KeyedService> BuildAuditedServiceInstanceFor(
       web::BrowserState* context) const override;
   web::BrowserState* GetBrowserStateToUse(
       web::BrowserState* context) const override;
@@ -0,0 +1,128 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/test/benchmark/allocation_counter.h"
+
+#include <mach/mach.h>
+#include <malloc/malloc.h>
+
+#include <atomic>
+
+#include "base/check.h"
+#include "base/mac/mach_logging.h"
+
+namespace {
+
+std::atomic<int64_t> g_allocation_count{0};
+std::atomic<int64_t> g_allocated_bytes{0};
+
+// Whether a ScopedAllocationCounter exists.
+bool g_counter_exists = false;
+
+// The functions of the default zone replaced while counting.
+using MallocFunction = void* (*)(malloc_zone_t*, size_t);
+using CallocFunction = void* (*)(malloc_zone_t*, size_t, size_t);
+using ReallocFunction = void* (*)(malloc_zone_t*, void*, size_t);
+using MemalignFunction = void* (*)(malloc_zone_t*, size_t, size_t);
+
+MallocFunction g_original_malloc = nullptr;
+CallocFunction g_original_calloc = nullptr;
+MallocFunction g_original_valloc = nullptr;
+ReallocFunction g_original_realloc = nullptr;
+MemalignFunction g_original_memalign = nullptr;
+
+void RecordAllocation(size_t size) {
+  g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  g_allocated_bytes.fetch_add(static_cast<int64_t>(size),
+                              std::memory_order_relaxed);
+}
+
+void* CountingMalloc(malloc_zone_t* zone, size_t size) {
+  RecordAllocation(size);
+  return g_original_malloc(zone, size);
+}
+
+void* CountingCalloc(malloc_zone_t* zone, size_t count, size_t size) {
+  RecordAllocation(count * size);
+  return g_original_calloc(zone, count, size);
+}
+
+void* CountingValloc(malloc_zone_t* zone, size_t size) {
+  RecordAllocation(size);
+  return g_original_valloc(zone, size);
+}
+
+void* CountingRealloc(malloc_zone_t* zone, void* ptr, size_t size) {
+  RecordAllocation(size);
+  return g_original_realloc(zone, ptr, size);
+}
+
+void* CountingMemalign(malloc_zone_t* zone, size_t alignment, size_t size) {
+  RecordAllocation(size);
+  return g_original_memalign(zone, alignment, size);
+}
+
+// Makes the pages holding |zone| writable or read-only, as the default zone is
+// read-only since macOS 10.7 and iOS 5. Returns false on failure.
+bool SetZoneWritable(malloc_zone_t* zone, bool writable) {
+  vm_address_t zone_start = reinterpret_cast<vm_address_t>(zone);
+  vm_address_t start = trunc_page(zone_start);
+  vm_size_t size = round_page(zone_start + sizeof(malloc_zone_t)) - start;
+  vm_prot_t protection = VM_PROT_READ | (writable ? VM_PROT_WRITE : 0);
+  kern_return_t result = vm_protect(mach_task_self(), start, size,
+                                    /*set_maximum=*/false, protection);
+  MACH_DLOG_IF(ERROR, result != KERN_SUCCESS, result) << "vm_protect";
+  return result == KERN_SUCCESS;
+}
+
+}  // namespace
+
+ScopedAllocationCounter::ScopedAllocationCounter() {
+  DCHECK(!g_counter_exists);
+  g_counter_exists = true;
+  g_allocation_count = 0;
+  g_allocated_bytes = 0;
+
+  malloc_zone_t* zone = malloc_default_zone();
+  if (!SetZoneWritable(zone, true))
+    return;
+  g_original_malloc = zone->malloc;
+  g_original_calloc = zone->calloc;
+  g_original_valloc = zone->valloc;
+  g_original_realloc = zone->realloc;
+  g_original_memalign = zone->memalign;
+  zone->malloc = CountingMalloc;
+  zone->calloc = CountingCalloc;
+  zone->valloc = CountingValloc;
+  zone->realloc = CountingRealloc;
+  if (g_original_memalign)
+    zone->memalign = CountingMemalign;
+  SetZoneWritable(zone, false);
+  is_counting_ = true;
+}
+
+ScopedAllocationCounter::~ScopedAllocationCounter() {
+  g_counter_exists = false;
+  if (!is_counting_)
+    return;
+
+  malloc_zone_t* zone = malloc_default_zone();
+  bool writable = SetZoneWritable(zone, true);
+  CHECK(writable);
+  zone->malloc = g_original_malloc;
+  zone->calloc = g_original_calloc;
+  zone->valloc = g_original_valloc;
+  zone->realloc = g_original_realloc;
+  if (g_original_memalign)
+    zone->memalign = g_original_memalign;
+  SetZoneWritable(zone, false);
+}
+
+int64_t ScopedAllocationCounter::allocation_count() const {
+  return g_allocation_count.load(std::memory_order_relaxed);
+}
+
+int64_t ScopedAllocationCounter::allocated_bytes() const {
+  return g_allocated_bytes.load(std::memory_order_relaxed);
+}
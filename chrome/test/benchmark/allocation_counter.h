@@ -0,0 +1,32 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_TEST_BENCHMARK_ALLOCATION_COUNTER_H_
+#define IOS_CHROME_TEST_BENCHMARK_ALLOCATION_COUNTER_H_
+
+#include <stdint.h>
+
+// Counts the allocations made through the default malloc zone while it is
+// alive, on any thread. Only one instance may exist at a time.
+class ScopedAllocationCounter {
+ public:
+  ScopedAllocationCounter();
+  ScopedAllocationCounter(const ScopedAllocationCounter&) = delete;
+  ScopedAllocationCounter& operator=(const ScopedAllocationCounter&) = delete;
+  ~ScopedAllocationCounter();
+
+  // Whether the allocations can be counted. False if the default malloc zone
+  // could not be intercepted, in which case the counts are always 0.
+  bool is_counting() const { return is_counting_; }
+
+  // Number of allocations and total number of bytes requested since the
+  // counter was created.
+  int64_t allocation_count() const;
+  int64_t allocated_bytes() const;
+
+ private:
+  bool is_counting_ = false;
+};
+
+#endif  // IOS_CHROME_TEST_BENCHMARK_ALLOCATION_COUNTER_H_
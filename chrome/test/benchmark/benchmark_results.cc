@@ -0,0 +1,76 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/test/benchmark/benchmark_results.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/json/json_writer.h"
+#include "base/no_destructor.h"
+#include "base/values.h"
+
+const char kBenchmarkResultsFileSwitch[] = "benchmark-results-file";
+
+namespace {
+
+// Version of the format of the results, to be incremented when a field is
+// renamed or its meaning changes.
+const int kResultsFormatVersion = 1;
+
+std::vector<BenchmarkResult>& GetResults() {
+  static base::NoDestructor<std::vector<BenchmarkResult>> results;
+  return *results;
+}
+
+base::Value ResultToValue(const BenchmarkResult& result) {
+  base::Value value(base::Value::Type::DICTIONARY);
+  value.SetStringKey("name", result.name);
+  value.SetIntKey("operations_per_run", result.operations_per_run);
+  value.SetIntKey("runs", result.runs);
+  value.SetDoubleKey("ops_per_second", result.ops_per_second);
+  value.SetDoubleKey("min_ops_per_second", result.min_ops_per_second);
+  value.SetDoubleKey("max_ops_per_second", result.max_ops_per_second);
+  value.SetDoubleKey("allocations_per_op", result.allocations_per_op);
+  value.SetDoubleKey("allocated_bytes_per_op", result.allocated_bytes_per_op);
+  // base::Value has no 64-bit integers; doubles are exact up to 2^53.
+  value.SetDoubleKey("peak_resident_bytes",
+                     static_cast<double>(result.peak_resident_bytes));
+  return value;
+}
+
+}  // namespace
+
+void RecordBenchmarkResult(const BenchmarkResult& result) {
+  GetResults().push_back(result);
+}
+
+std::string GetBenchmarkResultsAsJSON() {
+  std::vector<BenchmarkResult> results = GetResults();
+  std::stable_sort(results.begin(), results.end(),
+                   [](const BenchmarkResult& a, const BenchmarkResult& b) {
+                     return a.name < b.name;
+                   });
+
+  base::Value benchmarks(base::Value::Type::LIST);
+  for (const BenchmarkResult& result : results)
+    benchmarks.Append(ResultToValue(result));
+
+  base::Value value(base::Value::Type::DICTIONARY);
+  value.SetIntKey("version", kResultsFormatVersion);
+  value.SetKey("benchmarks", std::move(benchmarks));
+
+  std::string json;
+  CHECK(base::JSONWriter::WriteWithOptions(
+      value, base::JSONWriter::OPTIONS_PRETTY_PRINT, &json));
+  return json;
+}
+
+bool WriteBenchmarkResults(const base::FilePath& path) {
+  return base::WriteFile(path, GetBenchmarkResultsAsJSON());
+}
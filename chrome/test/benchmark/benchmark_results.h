@@ -0,0 +1,49 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_TEST_BENCHMARK_BENCHMARK_RESULTS_H_
+#define IOS_CHROME_TEST_BENCHMARK_BENCHMARK_RESULTS_H_
+
+#include <stdint.h>
+
+#include <string>
+
+namespace base {
+class FilePath;
+}
+
+// Switch with the path of the file the results are written to. The results
+// are printed on the standard output if it is absent.
+extern const char kBenchmarkResultsFileSwitch[];
+
+// The result of a benchmark.
+struct BenchmarkResult {
+  std::string name;
+  // Number of operations in each timed run.
+  int operations_per_run = 0;
+  // Number of timed runs.
+  int runs = 0;
+  // Median, slowest and fastest throughput of the timed runs.
+  double ops_per_second = 0;
+  double min_ops_per_second = 0;
+  double max_ops_per_second = 0;
+  // Allocations made through the default malloc zone per operation, -1 if
+  // they could not be counted.
+  double allocations_per_op = -1;
+  double allocated_bytes_per_op = -1;
+  // Peak resident memory of the process when the benchmark completed.
+  int64_t peak_resident_bytes = 0;
+};
+
+// Adds |result| to the results of the benchmarks of the process.
+void RecordBenchmarkResult(const BenchmarkResult& result);
+
+// Returns the results recorded so far as JSON, sorted by benchmark name so
+// that the output of two runs can be compared line by line.
+std::string GetBenchmarkResultsAsJSON();
+
+// Writes the results recorded so far to |path|. Returns false on failure.
+bool WriteBenchmarkResults(const base::FilePath& path);
+
+#endif  // IOS_CHROME_TEST_BENCHMARK_BENCHMARK_RESULTS_H_
@@ -0,0 +1,84 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/test/benchmark/benchmark_test.h"
+
+#include <mach/mach.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/check_op.h"
+#include "base/mac/mach_logging.h"
+#include "base/time/time.h"
+#include "ios/chrome/test/benchmark/allocation_counter.h"
+#include "ios/chrome/test/benchmark/benchmark_results.h"
+
+namespace {
+
+// Returns the peak resident memory of the process, or 0 on failure.
+int64_t GetPeakResidentBytes() {
+  mach_task_basic_info_data_t info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  kern_return_t result =
+      task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                reinterpret_cast<task_info_t>(&info), &count);
+  if (result != KERN_SUCCESS) {
+    MACH_DLOG(ERROR, result) << "task_info";
+    return 0;
+  }
+  return static_cast<int64_t>(info.resident_size_max);
+}
+
+}  // namespace
+
+const int BenchmarkTest::kTimedRuns = 5;
+
+BenchmarkTest::BenchmarkTest() = default;
+
+BenchmarkTest::~BenchmarkTest() = default;
+
+void BenchmarkTest::RunBenchmark(const std::string& name,
+                                 int operations_per_run,
+                                 const base::RepeatingClosure& run) {
+  DCHECK_GT(operations_per_run, 0);
+  run.Run();
+
+  std::vector<double> ops_per_second;
+  for (int i = 0; i < kTimedRuns; ++i) {
+    base::TimeTicks start = base::TimeTicks::Now();
+    run.Run();
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+    // Guard against runs faster than the resolution of the clock.
+    elapsed = std::max(elapsed, base::TimeDelta::FromMicroseconds(1));
+    ops_per_second.push_back(operations_per_run / elapsed.InSecondsF());
+  }
+  std::sort(ops_per_second.begin(), ops_per_second.end());
+
+  BenchmarkResult result;
+  result.name = name;
+  result.operations_per_run = operations_per_run;
+  result.runs = kTimedRuns;
+  result.ops_per_second = ops_per_second[ops_per_second.size() / 2];
+  result.min_ops_per_second = ops_per_second.front();
+  result.max_ops_per_second = ops_per_second.back();
+
+  // The allocations are counted in a separate run, as intercepting them slows
+  // the allocator down.
+  {
+    ScopedAllocationCounter allocation_counter;
+    run.Run();
+    if (allocation_counter.is_counting()) {
+      result.allocations_per_op =
+          static_cast<double>(allocation_counter.allocation_count()) /
+          operations_per_run;
+      result.allocated_bytes_per_op =
+          static_cast<double>(allocation_counter.allocated_bytes()) /
+          operations_per_run;
+    }
+  }
+
+  result.peak_resident_bytes = GetPeakResidentBytes();
+  RecordBenchmarkResult(result);
+}
@@ -0,0 +1,33 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_CHROME_TEST_BENCHMARK_BENCHMARK_TEST_H_
+#define IOS_CHROME_TEST_BENCHMARK_BENCHMARK_TEST_H_
+
+#include <string>
+
+#include "base/callback.h"
+#include "testing/platform_test.h"
+
+// Base class of the headless benchmarks. Unlike PerfTest, it needs neither a
+// UI nor resources, so that the C++ cores of the browser can be measured
+// with fakes and compared across commits.
+class BenchmarkTest : public PlatformTest {
+ protected:
+  // Number of timed runs of each benchmark, after one untimed warm-up run.
+  static const int kTimedRuns;
+
+  BenchmarkTest();
+  ~BenchmarkTest() override;
+
+  // Measures |run|, which must perform |operations_per_run| operations, and
+  // records the result as |name|. |run| is invoked once to warm up, then
+  // kTimedRuns times to measure the throughput, then once more with the
+  // allocations counted.
+  void RunBenchmark(const std::string& name,
+                    int operations_per_run,
+                    const base::RepeatingClosure& run);
+};
+
+#endif  // IOS_CHROME_TEST_BENCHMARK_BENCHMARK_TEST_H_
@@ -0,0 +1,81 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/web/public/security/certificate_policy_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/strings/stringprintf.h"
+#include "ios/chrome/test/benchmark/benchmark_test.h"
+#include "ios/web/public/test/web_task_environment.h"
+#include "net/cert/cert_status_flags.h"
+#include "net/cert/x509_certificate.h"
+#include "net/test/cert_test_util.h"
+#include "net/test/test_data_directory.h"
+
+namespace {
+
+// Number of hosts with an allowed certificate.
+const int kHostCount = 100;
+
+// Number of queries or updates of each benchmark.
+const int kOperationCount = 10000;
+
+// Benchmarks the CertificatePolicyCache, queried for each navigation with a
+// certificate error. The cache is used on the IO thread, which is the main
+// thread of the IO_MAINLOOP environment.
+class CertificatePolicyCacheBenchmark : public BenchmarkTest {
+ protected:
+  CertificatePolicyCacheBenchmark()
+      : task_environment_(web::WebTaskEnvironment::Options::IO_MAINLOOP),
+        cache_(base::MakeRefCounted<web::CertificatePolicyCache>()),
+        cert_(net::ImportCertFromFile(net::GetTestCertsDirectory(),
+                                      "ok_cert.pem")) {
+    for (int i = 0; i < kHostCount; ++i)
+      hosts_.push_back(base::StringPrintf("www.example%d.com", i));
+  }
+
+  // Allows the certificate for each host in turn.
+  void AllowCerts() {
+    for (int i = 0; i < kOperationCount; ++i) {
+      cache_->AllowCertForHost(cert_.get(), hosts_[i % kHostCount],
+                               net::CERT_STATUS_DATE_INVALID);
+    }
+  }
+
+  // Queries the policy of each host in turn.
+  void QueryPolicies() {
+    for (int i = 0; i < kOperationCount; ++i) {
+      cache_->QueryPolicy(cert_.get(), hosts_[i % kHostCount],
+                          net::CERT_STATUS_DATE_INVALID);
+    }
+  }
+
+  web::WebTaskEnvironment task_environment_;
+  scoped_refptr<web::CertificatePolicyCache> cache_;
+  scoped_refptr<net::X509Certificate> cert_;
+  std::vector<std::string> hosts_;
+};
+
+// Measures the allowing of certificates.
+TEST_F(CertificatePolicyCacheBenchmark, AllowCertForHost) {
+  RunBenchmark("CertificatePolicyCache.AllowCertForHost", kOperationCount,
+               base::BindRepeating(
+                   &CertificatePolicyCacheBenchmark::AllowCerts,
+                   base::Unretained(this)));
+}
+
+// Measures the queries of the policies of allowed certificates.
+TEST_F(CertificatePolicyCacheBenchmark, QueryPolicy) {
+  AllowCerts();
+  RunBenchmark("CertificatePolicyCache.QueryPolicy", kOperationCount,
+               base::BindRepeating(
+                   &CertificatePolicyCacheBenchmark::QueryPolicies,
+                   base::Unretained(this)));
+}
+
+}  // namespace
@@ -0,0 +1,103 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/net/cookies/cookie_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/strings/stringprintf.h"
+#include "ios/chrome/test/benchmark/benchmark_test.h"
+#include "net/cookies/canonical_cookie.h"
+#include "url/gurl.h"
+
+namespace {
+
+// Number of hosts whose cookies are cached.
+const int kHostCount = 100;
+
+// Number of cookies with the observed name sent to each host.
+const int kCookiesPerHost = 4;
+
+// Number of updates of each benchmark.
+const int kOperationCount = 10000;
+
+// Each run must end with the second version of the cookies, so that the first
+// updates of the next run report changes.
+static_assert(kOperationCount % (2 * kHostCount) == 0,
+              "Runs must make an even number of passes over the hosts");
+
+// Name of the observed cookies.
+const char kCookieName[] = "session";
+
+net::CanonicalCookie MakeCookie(const GURL& url,
+                                const std::string& value,
+                                const std::string& path) {
+  return *net::CanonicalCookie::CreateUnsafeCookieForTesting(
+      kCookieName, value, url.host(), path, base::Time(), base::Time(),
+      base::Time(), false, false, net::CookieSameSite::NO_RESTRICTION,
+      net::COOKIE_PRIORITY_DEFAULT, false);
+}
+
+// Benchmarks the updates of a CookieCache, which are run each time cookies
+// are observed.
+class CookieCacheBenchmark : public BenchmarkTest {
+ protected:
+  CookieCacheBenchmark() {
+    for (int i = 0; i < kHostCount; ++i) {
+      GURL url(base::StringPrintf("https://www.example%d.com/a/b", i));
+      urls_.push_back(url);
+      for (int version = 0; version < 2; ++version) {
+        std::vector<net::CanonicalCookie> cookies;
+        for (int j = 0; j < kCookiesPerHost; ++j) {
+          cookies.push_back(MakeCookie(
+              url, base::StringPrintf("value%d-%d", j, version),
+              j % 2 ? "/" : "/a"));
+        }
+        cookies_[version].push_back(cookies);
+      }
+    }
+  }
+
+  // Updates the cache with the cookies of each host in turn. If
+  // |change_values| is true, the values of the cookies alternate between two
+  // versions on each pass, so that every update reports changes.
+  void Update(bool change_values) {
+    std::vector<net::CanonicalCookie> removed;
+    std::vector<net::CanonicalCookie> added;
+    for (int i = 0; i < kOperationCount; ++i) {
+      int host = i % kHostCount;
+      int version = change_values ? (i / kHostCount) % 2 : 0;
+      removed.clear();
+      added.clear();
+      cache_.Update(urls_[host], kCookieName, cookies_[version][host],
+                    &removed, &added);
+    }
+  }
+
+  net::CookieCache cache_;
+  std::vector<GURL> urls_;
+  // Two versions of the cookies of each host, differing by their values.
+  std::vector<std::vector<net::CanonicalCookie>> cookies_[2];
+};
+
+// Measures updates with cookies that did not change, the most common case.
+TEST_F(CookieCacheBenchmark, UpdateUnchanged) {
+  Update(/*change_values=*/false);
+  RunBenchmark("CookieCache.UpdateUnchanged", kOperationCount,
+               base::BindRepeating(&CookieCacheBenchmark::Update,
+                                   base::Unretained(this),
+                                   /*change_values=*/false));
+}
+
+// Measures updates with cookies whose values changed.
+TEST_F(CookieCacheBenchmark, UpdateChanged) {
+  RunBenchmark("CookieCache.UpdateChanged", kOperationCount,
+               base::BindRepeating(&CookieCacheBenchmark::Update,
+                                   base::Unretained(this),
+                                   /*change_values=*/true));
+}
+
+}  // namespace
@@ -0,0 +1,109 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/favicon/large_icon_cache.h"
+
+#include <memory>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/strings/stringprintf.h"
+#include "components/favicon_base/favicon_types.h"
+#include "ios/chrome/test/benchmark/benchmark_test.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/codec/png_codec.h"
+#include "url/gurl.h"
+
+namespace {
+
+// Number of pages with a cached icon, about as many as shown by the NTP and
+// the tab grid.
+const int kURLCount = 100;
+
+// Number of operations of each benchmark.
+const int kOperationCount = 10000;
+
+// Size of the cache when its budget is exceeded, in number of icons.
+const int kCachedIconCount = kURLCount / 2;
+
+// Returns a large icon result with a |size|x|size| PNG bitmap.
+std::unique_ptr<favicon_base::LargeIconResult> CreateLargeIconResult(
+    int size) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(size, size);
+  bitmap.eraseColor(SK_ColorRED);
+  scoped_refptr<base::RefCountedBytes> data =
+      base::MakeRefCounted<base::RefCountedBytes>();
+  gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &data->data());
+
+  favicon_base::FaviconRawBitmapResult bitmap_result;
+  bitmap_result.bitmap_data = data;
+  bitmap_result.pixel_size = gfx::Size(size, size);
+  bitmap_result.icon_url = GURL("https://www.example.com/icon.png");
+  bitmap_result.icon_type = favicon_base::IconType::kTouchIcon;
+  return std::make_unique<favicon_base::LargeIconResult>(bitmap_result);
+}
+
+// Benchmarks the LargeIconCache, used to show the icons of the NTP tiles
+// without waiting for the LargeIconService.
+class LargeIconCacheBenchmark : public BenchmarkTest {
+ protected:
+  LargeIconCacheBenchmark() : result_(CreateLargeIconResult(48)) {
+    for (int i = 0; i < kURLCount; ++i)
+      urls_.push_back(GURL(base::StringPrintf("https://www.example%d.com", i)));
+  }
+
+  // Caches the result of each URL in turn.
+  void SetCachedResults() {
+    for (int i = 0; i < kOperationCount; ++i)
+      cache_->SetCachedResult(urls_[i % kURLCount], *result_);
+  }
+
+  // Gets the result of each URL in turn.
+  void GetCachedResults() {
+    for (int i = 0; i < kOperationCount; ++i)
+      cache_->GetCachedResult(urls_[i % kURLCount]);
+  }
+
+  // Returns the estimated size of the cached result of one URL.
+  size_t GetResultSize() {
+    LargeIconCache cache;
+    cache.SetCachedResult(urls_[0], *result_);
+    return cache.size_in_bytes();
+  }
+
+  std::unique_ptr<LargeIconCache> cache_;
+  std::unique_ptr<favicon_base::LargeIconResult> result_;
+  std::vector<GURL> urls_;
+};
+
+// Measures the caching of results within the budget of the cache.
+TEST_F(LargeIconCacheBenchmark, SetCachedResult) {
+  cache_ = std::make_unique<LargeIconCache>();
+  RunBenchmark("LargeIconCache.SetCachedResult", kOperationCount,
+               base::BindRepeating(&LargeIconCacheBenchmark::SetCachedResults,
+                                   base::Unretained(this)));
+}
+
+// Measures the caching of results over the budget of the cache, each of them
+// evicting the least recently used one.
+TEST_F(LargeIconCacheBenchmark, SetCachedResultWithEviction) {
+  cache_ =
+      std::make_unique<LargeIconCache>(GetResultSize() * kCachedIconCount);
+  RunBenchmark("LargeIconCache.SetCachedResultWithEviction", kOperationCount,
+               base::BindRepeating(&LargeIconCacheBenchmark::SetCachedResults,
+                                   base::Unretained(this)));
+}
+
+// Measures the lookup of cached results.
+TEST_F(LargeIconCacheBenchmark, GetCachedResult) {
+  cache_ = std::make_unique<LargeIconCache>();
+  SetCachedResults();
+  RunBenchmark("LargeIconCache.GetCachedResult", kOperationCount,
+               base::BindRepeating(&LargeIconCacheBenchmark::GetCachedResults,
+                                   base::Unretained(this)));
+}
+
+}  // namespace
@@ -0,0 +1,88 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/overlays/overlay_request_queue_impl.h"
+
+#include "base/bind.h"
+#include "ios/chrome/browser/overlays/public/overlay_request.h"
+#include "ios/chrome/browser/overlays/test/fake_overlay_user_data.h"
+#include "ios/chrome/test/benchmark/benchmark_test.h"
+#import "ios/web/public/test/fakes/fake_web_state.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+// Number of requests in the queue, e.g. the dialogs of an abusive page.
+const int kRequestCount = 100;
+
+// Benchmarks the OverlayRequestQueueImpl of a FakeWebState, without delegate
+// so that the removed requests are destroyed.
+class OverlayRequestQueueBenchmark : public BenchmarkTest {
+ protected:
+  OverlayRequestQueueBenchmark() {
+    OverlayRequestQueueImpl::Container::CreateForWebState(&web_state_);
+    queue_ = OverlayRequestQueueImpl::Container::FromWebState(&web_state_)
+                 ->QueueForModality(OverlayModality::kWebContentArea);
+  }
+
+  // Adds kRequestCount requests to the queue.
+  void AddRequests() {
+    for (int i = 0; i < kRequestCount; ++i) {
+      queue_->AddRequest(
+          OverlayRequest::CreateWithConfig<FakeOverlayUserData>());
+    }
+  }
+
+  // Adds requests, then removes them as their UI is dismissed.
+  void AddAndPopRequests() {
+    AddRequests();
+    while (queue_->size())
+      queue_->PopFrontRequest();
+  }
+
+  // Adds requests, then cancels them all, as on navigation.
+  void AddAndCancelAllRequests() {
+    AddRequests();
+    queue_->CancelAllRequests();
+  }
+
+  // Adds requests, then cancels them one by one from the middle of the queue.
+  void AddAndCancelRequests() {
+    AddRequests();
+    while (queue_->size())
+      queue_->CancelRequest(queue_->GetRequest(queue_->size() / 2));
+  }
+
+  web::FakeWebState web_state_;
+  OverlayRequestQueueImpl* queue_ = nullptr;
+};
+
+// Measures the presentation of the requests in order.
+TEST_F(OverlayRequestQueueBenchmark, AddAndPop) {
+  RunBenchmark("OverlayRequestQueue.AddAndPop", kRequestCount,
+               base::BindRepeating(
+                   &OverlayRequestQueueBenchmark::AddAndPopRequests,
+                   base::Unretained(this)));
+}
+
+// Measures the cancellation of all the requests.
+TEST_F(OverlayRequestQueueBenchmark, AddAndCancelAll) {
+  RunBenchmark("OverlayRequestQueue.AddAndCancelAll", kRequestCount,
+               base::BindRepeating(
+                   &OverlayRequestQueueBenchmark::AddAndCancelAllRequests,
+                   base::Unretained(this)));
+}
+
+// Measures the cancellation of individual requests.
+TEST_F(OverlayRequestQueueBenchmark, AddAndCancel) {
+  RunBenchmark("OverlayRequestQueue.AddAndCancel", kRequestCount,
+               base::BindRepeating(
+                   &OverlayRequestQueueBenchmark::AddAndCancelRequests,
+                   base::Unretained(this)));
+}
+
+}  // namespace
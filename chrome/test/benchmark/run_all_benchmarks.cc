@@ -0,0 +1,46 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdio.h>
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/test/launcher/unit_test_launcher.h"
+#include "base/test/test_suite.h"
+#include "ios/chrome/test/benchmark/benchmark_results.h"
+
+namespace {
+
+// Runs the benchmarks then writes their results.
+int RunBenchmarks(base::TestSuite* test_suite) {
+  int result = test_suite->Run();
+
+  base::FilePath path =
+      base::CommandLine::ForCurrentProcess()->GetSwitchValuePath(
+          kBenchmarkResultsFileSwitch);
+  if (path.empty()) {
+    printf("%s\n", GetBenchmarkResultsAsJSON().c_str());
+  } else if (!WriteBenchmarkResults(path)) {
+    LOG(ERROR) << "Failed to write the benchmark results to " << path;
+    return 1;
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::TestSuite test_suite(argc, argv);
+
+  // On iOS, the tests run serially in the launcher process, so that the
+  // benchmarks do not compete for the CPU and all their results are written
+  // together.
+  return base::LaunchUnitTests(
+      argc, argv,
+      base::BindOnce(&RunBenchmarks, base::Unretained(&test_suite)));
+}
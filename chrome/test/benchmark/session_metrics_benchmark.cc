@@ -0,0 +1,56 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ios/chrome/browser/web_state_list/session_metrics.h"
+
+#include "base/bind.h"
+#include "ios/chrome/test/benchmark/benchmark_test.h"
+
+namespace {
+
+// Number of events of each benchmark.
+const int kOperationCount = 100000;
+
+// Number of events between two recordings of the metrics.
+const int kEventsPerRecording = 100;
+
+// Benchmarks SessionMetrics, which is notified of each change of the
+// WebStateLists of a browser state.
+class SessionMetricsBenchmark : public BenchmarkTest {
+ protected:
+  // Notifies the events of a tab being opened, activated and closed, and
+  // records the metrics regularly.
+  void NotifyEvents() {
+    for (int i = 0; i < kOperationCount; ++i) {
+      switch (i % 3) {
+        case 0:
+          session_metrics_.OnWebStateInserted();
+          break;
+        case 1:
+          session_metrics_.OnWebStateActivated();
+          break;
+        case 2:
+          session_metrics_.OnWebStateDetached();
+          break;
+      }
+      if (i % kEventsPerRecording == 0) {
+        session_metrics_.RecordAndClearSessionMetrics(
+            MetricsToRecordFlags::kOpenedTabCount |
+            MetricsToRecordFlags::kClosedTabCount |
+            MetricsToRecordFlags::kActivatedTabCount);
+      }
+    }
+  }
+
+  SessionMetrics session_metrics_;
+};
+
+// Measures the notification and the recording of the session metrics.
+TEST_F(SessionMetricsBenchmark, NotifyAndRecord) {
+  RunBenchmark("SessionMetrics.NotifyAndRecord", kOperationCount,
+               base::BindRepeating(&SessionMetricsBenchmark::NotifyEvents,
+                                   base::Unretained(this)));
+}
+
+}  // namespace
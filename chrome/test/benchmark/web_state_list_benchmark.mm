@@ -0,0 +1,126 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/chrome/browser/web_state_list/web_state_list.h"
+
+#include <memory>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/strings/stringprintf.h"
+#import "ios/chrome/browser/web_state_list/fake_web_state_list_delegate.h"
+#import "ios/chrome/browser/web_state_list/web_state_opener.h"
+#include "ios/chrome/test/benchmark/benchmark_test.h"
+#import "ios/web/public/test/fakes/fake_web_state.h"
+#include "url/gurl.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace {
+
+// Number of WebStates in the list, in the range of a heavy user's tabs.
+const int kWebStateCount = 100;
+
+// Number of operations of the benchmarks working on a full list.
+const int kOperationCount = 10000;
+
+// Benchmarks the operations of WebStateList on FakeWebStates.
+class WebStateListBenchmark : public BenchmarkTest {
+ protected:
+  WebStateListBenchmark() : web_state_list_(&web_state_list_delegate_) {}
+
+  // Returns a new FakeWebState whose URL is unique to |index|.
+  std::unique_ptr<web::WebState> CreateWebState(int index) {
+    auto web_state = std::make_unique<web::FakeWebState>();
+    web_state->SetCurrentURL(
+        GURL(base::StringPrintf("https://www.example%d.com/", index)));
+    return web_state;
+  }
+
+  // Fills the list with kWebStateCount WebStates, the last one active.
+  void FillWebStateList() {
+    for (int i = 0; i < kWebStateCount; ++i) {
+      web_state_list_.InsertWebState(i, CreateWebState(i),
+                                     WebStateList::INSERT_ACTIVATE,
+                                     WebStateOpener());
+    }
+  }
+
+  // Opens kWebStateCount WebStates, each from the active one, then closes them
+  // all.
+  void InsertAndCloseWebStates() {
+    for (int i = 0; i < kWebStateCount; ++i) {
+      web_state_list_.InsertWebState(
+          web_state_list_.count(), CreateWebState(i),
+          WebStateList::INSERT_ACTIVATE | WebStateList::INSERT_INHERIT_OPENER,
+          WebStateOpener(web_state_list_.GetActiveWebState()));
+    }
+    web_state_list_.CloseAllWebStates(WebStateList::CLOSE_NO_FLAGS);
+  }
+
+  // Moves WebStates across the whole list.
+  void MoveWebStates() {
+    for (int i = 0; i < kOperationCount; ++i) {
+      web_state_list_.MoveWebStateAt(i % kWebStateCount,
+                                     (i * 7) % kWebStateCount);
+    }
+  }
+
+  // Activates WebStates across the whole list.
+  void ActivateWebStates() {
+    for (int i = 0; i < kOperationCount; ++i)
+      web_state_list_.ActivateWebStateAt((i * 7) % kWebStateCount);
+  }
+
+  // Looks up WebStates by URL, as done when switching to an open tab.
+  void FindWebStatesWithURL() {
+    for (int i = 0; i < kOperationCount; ++i) {
+      web_state_list_.GetIndexOfWebStateWithURL(
+          urls_[(i * 7) % kWebStateCount]);
+    }
+  }
+
+  FakeWebStateListDelegate web_state_list_delegate_;
+  WebStateList web_state_list_;
+  std::vector<GURL> urls_;
+};
+
+// Measures the opening and closing of tabs.
+TEST_F(WebStateListBenchmark, InsertAndClose) {
+  RunBenchmark("WebStateList.InsertAndClose", kWebStateCount,
+               base::BindRepeating(
+                   &WebStateListBenchmark::InsertAndCloseWebStates,
+                   base::Unretained(this)));
+}
+
+// Measures the reordering of tabs.
+TEST_F(WebStateListBenchmark, Move) {
+  FillWebStateList();
+  RunBenchmark("WebStateList.Move", kOperationCount,
+               base::BindRepeating(&WebStateListBenchmark::MoveWebStates,
+                                   base::Unretained(this)));
+}
+
+// Measures the switching between tabs.
+TEST_F(WebStateListBenchmark, Activate) {
+  FillWebStateList();
+  RunBenchmark("WebStateList.Activate", kOperationCount,
+               base::BindRepeating(&WebStateListBenchmark::ActivateWebStates,
+                                   base::Unretained(this)));
+}
+
+// Measures the lookup of tabs by URL.
+TEST_F(WebStateListBenchmark, GetIndexOfWebStateWithURL) {
+  FillWebStateList();
+  for (int i = 0; i < kWebStateCount; ++i)
+    urls_.push_back(web_state_list_.GetWebStateAt(i)->GetVisibleURL());
+  RunBenchmark("WebStateList.GetIndexOfWebStateWithURL", kOperationCount,
+               base::BindRepeating(
+                   &WebStateListBenchmark::FindWebStatesWithURL,
+                   base::Unretained(this)));
+}
+
+}  // namespace
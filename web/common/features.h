@@ -88,6 +88,29 @@ extern const base::Feature kIOSSharedHighlightingColorChange;
 // transition type of new navigation item.
 extern const base::Feature kCreatePendingItemForPostFormSubmission;
 
+// Feature flag that restores session history by loading only the last
+// committed item, and replays the rest of the history into the web view only
+// when the user navigates to it.
+extern const base::Feature kLazySessionRestore;
+
+// Feature flag that coalesces LoadProgressChanged() and TitleWasSet()
+// notifications to at most one per display frame for the observers that
+// accept it.
+extern const base::Feature kThrottleWebStateObserverUpdates;
+
+// Feature flag that starts the hit test for the context menu when a touch
+// starts in the web view, instead of when the long press is recognized.
+extern const base::Feature kSpeculativeContextMenuHitTest;
+
+// Feature flag that creates web views ahead of time, so that realizing a
+// WebState takes its web view from a pool.
+extern const base::Feature kWebViewPool;
+
+// Feature flag that keeps the WKUserContentController configured with the
+// JavaScriptFeatures of a browser state when its configuration is purged, and
+// reuses it in the next configuration unless the features changed.
+extern const base::Feature kSharedUserContentController;
+
 }  // namespace features
 }  // namespace web
 
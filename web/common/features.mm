@@ -92,5 +92,20 @@ const base::Feature kCreatePendingItemForPostFormSubmission{
     "CreatePendingItemForPostFormSubmission",
     base::FEATURE_DISABLED_BY_DEFAULT};
 
+const base::Feature kLazySessionRestore{"LazySessionRestore",
+                                       base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::Feature kThrottleWebStateObserverUpdates{
+    "ThrottleWebStateObserverUpdates", base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::Feature kSpeculativeContextMenuHitTest{
+    "SpeculativeContextMenuHitTest", base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::Feature kWebViewPool{"WebViewPool",
+                                 base::FEATURE_DISABLED_BY_DEFAULT};
+
+const base::Feature kSharedUserContentController{
+    "SharedUserContentController", base::FEATURE_DISABLED_BY_DEFAULT};
+
 }  // namespace features
 }  // namespace web
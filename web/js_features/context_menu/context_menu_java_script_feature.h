@@ -12,12 +12,14 @@
 
 #include "base/callback.h"
 #include "base/supports_user_data.h"
+#include "base/time/time.h"
 #include "ios/web/public/js_messaging/java_script_feature.h"
+#import "ios/web/public/ui/context_menu_params.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace web {
 
 class BrowserState;
-struct ContextMenuParams;
 class WebState;
 
 class ContextMenuJavaScriptFeature : public JavaScriptFeature,
@@ -37,20 +39,75 @@ class ContextMenuJavaScriptFeature : public JavaScriptFeature,
   // Retrieves details of the DOM element at |point| in |web_state|'s currently
   // loaded webpage. |requestID| must be unique and can be used to identify
   // this request as it is returned with the element details in |callback|.
+  // Uses the result of the speculative fetch for |web_state| if it was started
+  // for the same point and the DOM did not change since.
   void GetElementAtPoint(WebState* web_state,
                          std::string requestID,
                          CGPoint point,
                          CGSize web_content_size,
                          ElementDetailsCallback callback);
 
+  // Starts retrieving the details of the DOM element at |point| in
+  // |web_state|'s currently loaded webpage, ahead of a likely call to
+  // GetElementAtPoint for the same point, e.g. when a touch which may become a
+  // long press starts. The result is kept until it is used by
+  // GetElementAtPoint, the DOM of the frame containing the element changes, or
+  // CancelSpeculativeFetch is called. Replaces any previous speculative fetch
+  // for |web_state|.
+  void StartSpeculativeFetch(WebState* web_state,
+                             CGPoint point,
+                             CGSize web_content_size);
+
+  // Discards the speculative fetch for |web_state|, if any.
+  void CancelSpeculativeFetch(WebState* web_state);
+
   // JavaScriptFeature:
   absl::optional<std::string> GetScriptMessageHandlerName() const override;
   void ScriptMessageReceived(WebState* web_state,
                              const ScriptMessage& message) override;
 
  private:
+  // A fetch started by StartSpeculativeFetch.
+  struct SpeculativeFetch {
+    SpeculativeFetch();
+    SpeculativeFetch(SpeculativeFetch&& other);
+    SpeculativeFetch& operator=(SpeculativeFetch&& other);
+    ~SpeculativeFetch();
+
+    std::string request_id;
+    CGPoint point = CGPointZero;
+    CGSize web_content_size = CGSizeZero;
+    base::TimeTicks start_time;
+    // The details of the element, once received.
+    absl::optional<ContextMenuParams> params;
+    // Number of DOM mutations observed by the frame of the element when the
+    // details were found, and the latest one reported by that frame. The
+    // details are outdated if they differ.
+    int dom_mutation_count = 0;
+    int latest_dom_mutation_count = 0;
+    // The GetElementAtPoint request waiting for |params|, if any.
+    std::string pending_request_id;
+    ElementDetailsCallback pending_callback;
+  };
+
+  // Calls findElementAtPoint in the main frame of |web_state|.
+  void FindElementAtPoint(WebState* web_state,
+                          const std::string& request_id,
+                          CGPoint point,
+                          CGSize web_content_size,
+                          bool speculative);
+
+  // Handles the result of a speculative fetch in |message|. Returns false if
+  // |message| is not about a speculative fetch for |web_state|.
+  bool SpeculativeFetchMessageReceived(WebState* web_state,
+                                       const std::string& request_id,
+                                       const ScriptMessage& message);
+
   // Outstanding |callbacks| keyed by requestIDs.
   std::map<std::string, ElementDetailsCallback> callbacks_;
+
+  // The speculative fetch of each WebState.
+  std::map<WebState*, SpeculativeFetch> speculative_fetches_;
 };
 
 }  // namespace web
@@ -4,8 +4,12 @@
 
 #import "ios/web/js_features/context_menu/context_menu_java_script_feature.h"
 
+#include <cmath>
+
 #import "base/callback.h"
+#include "base/metrics/histogram_functions.h"
 #import "base/strings/sys_string_conversions.h"
+#include "base/unguessable_token.h"
 #include "base/values.h"
 #import "ios/web/js_features/context_menu/context_menu_params_utils.h"
 #import "ios/web/public/browser_state.h"
@@ -25,6 +29,32 @@ const char kAllFramesContextMenuScript[] = "all_frames_context_menu_js";
 const char kMainFrameContextMenuScript[] = "main_frame_context_menu_js";
 
 const char kFindElementResultHandlerName[] = "FindElementResultHandler";
+
+// Maximum distance along each axis between the point of a speculative fetch
+// and the point of the long press for the speculative result to be used.
+const CGFloat kSpeculativeFetchPointTolerance = 5.0;
+
+// Outcome of a speculative fetch when the details of an element are requested.
+// These values are persisted to logs. Entries should not be renumbered and
+// numeric values should never be reused.
+enum class SpeculativeFetchResult {
+  // No speculative fetch was started.
+  kNone = 0,
+  // The details found by the speculative fetch were used.
+  kUsed = 1,
+  // The request waited for the details of the speculative fetch.
+  kUsedPending = 2,
+  // The speculative fetch was for another point.
+  kPointMismatch = 3,
+  // The DOM changed since the speculative fetch.
+  kDOMMutated = 4,
+  kMaxValue = kDOMMutated,
+};
+
+void RecordSpeculativeFetchResult(SpeculativeFetchResult result) {
+  base::UmaHistogramEnumeration("IOS.ContextMenu.SpeculativeHitTest.Result",
+                                result);
+}
 }
 
 namespace web {
@@ -59,24 +89,139 @@ ContextMenuJavaScriptFeature* ContextMenuJavaScriptFeature::FromBrowserState(
   return feature;
 }
 
+ContextMenuJavaScriptFeature::SpeculativeFetch::SpeculativeFetch() = default;
+ContextMenuJavaScriptFeature::SpeculativeFetch::SpeculativeFetch(
+    SpeculativeFetch&& other) = default;
+ContextMenuJavaScriptFeature::SpeculativeFetch&
+ContextMenuJavaScriptFeature::SpeculativeFetch::operator=(
+    SpeculativeFetch&& other) = default;
+ContextMenuJavaScriptFeature::SpeculativeFetch::~SpeculativeFetch() = default;
+
 void ContextMenuJavaScriptFeature::GetElementAtPoint(
     WebState* web_state,
     std::string requestID,
     CGPoint point,
     CGSize web_content_size,
     ElementDetailsCallback callback) {
+  auto speculative_fetch_it = speculative_fetches_.find(web_state);
+  if (speculative_fetch_it == speculative_fetches_.end()) {
+    RecordSpeculativeFetchResult(SpeculativeFetchResult::kNone);
+  } else {
+    SpeculativeFetch& fetch = speculative_fetch_it->second;
+    if (std::abs(fetch.point.x - point.x) > kSpeculativeFetchPointTolerance ||
+        std::abs(fetch.point.y - point.y) > kSpeculativeFetchPointTolerance ||
+        !CGSizeEqualToSize(fetch.web_content_size, web_content_size)) {
+      RecordSpeculativeFetchResult(SpeculativeFetchResult::kPointMismatch);
+      speculative_fetches_.erase(speculative_fetch_it);
+    } else if (fetch.dom_mutation_count != fetch.latest_dom_mutation_count) {
+      RecordSpeculativeFetchResult(SpeculativeFetchResult::kDOMMutated);
+      speculative_fetches_.erase(speculative_fetch_it);
+    } else {
+      base::UmaHistogramTimes("IOS.ContextMenu.SpeculativeHitTest.HeadStart",
+                              base::TimeTicks::Now() - fetch.start_time);
+      if (!fetch.params) {
+        // The details will be passed to |callback| when received.
+        RecordSpeculativeFetchResult(SpeculativeFetchResult::kUsedPending);
+        fetch.pending_request_id = requestID;
+        fetch.pending_callback = std::move(callback);
+        return;
+      }
+      RecordSpeculativeFetchResult(SpeculativeFetchResult::kUsed);
+      ContextMenuParams params = fetch.params.value();
+      speculative_fetches_.erase(speculative_fetch_it);
+      std::move(callback).Run(requestID, params);
+      return;
+    }
+  }
+
   callbacks_[requestID] = std::move(callback);
+  FindElementAtPoint(web_state, requestID, point, web_content_size,
+                     /*speculative=*/false);
+}
 
+void ContextMenuJavaScriptFeature::StartSpeculativeFetch(
+    WebState* web_state,
+    CGPoint point,
+    CGSize web_content_size) {
+  if (!GetMainFrame(web_state)) {
+    CancelSpeculativeFetch(web_state);
+    return;
+  }
+
+  SpeculativeFetch fetch;
+  fetch.request_id = base::UnguessableToken::Create().ToString();
+  fetch.point = point;
+  fetch.web_content_size = web_content_size;
+  fetch.start_time = base::TimeTicks::Now();
+  std::string request_id = fetch.request_id;
+  speculative_fetches_[web_state] = std::move(fetch);
+
+  FindElementAtPoint(web_state, request_id, point, web_content_size,
+                     /*speculative=*/true);
+}
+
+void ContextMenuJavaScriptFeature::CancelSpeculativeFetch(
+    WebState* web_state) {
+  speculative_fetches_.erase(web_state);
+}
+
+void ContextMenuJavaScriptFeature::FindElementAtPoint(
+    WebState* web_state,
+    const std::string& request_id,
+    CGPoint point,
+    CGSize web_content_size,
+    bool speculative) {
   WebFrame* main_frame = GetMainFrame(web_state);
   std::vector<base::Value> parameters;
-  parameters.push_back(base::Value(requestID));
+  parameters.push_back(base::Value(request_id));
   parameters.push_back(base::Value(point.x));
   parameters.push_back(base::Value(point.y));
   parameters.push_back(base::Value(web_content_size.width));
   parameters.push_back(base::Value(web_content_size.height));
+  parameters.push_back(base::Value(speculative));
   CallJavaScriptFunction(main_frame, "findElementAtPoint", parameters);
 }
 
+bool ContextMenuJavaScriptFeature::SpeculativeFetchMessageReceived(
+    WebState* web_state,
+    const std::string& request_id,
+    const ScriptMessage& message) {
+  auto speculative_fetch_it = speculative_fetches_.find(web_state);
+  if (speculative_fetch_it == speculative_fetches_.end() ||
+      speculative_fetch_it->second.request_id != request_id) {
+    return false;
+  }
+
+  SpeculativeFetch& fetch = speculative_fetch_it->second;
+  // Numbers are received from JavaScript as doubles.
+  absl::optional<double> dom_mutation_count =
+      message.body()->FindDoubleKey("domMutationCount");
+  if (message.body()->FindBoolKey("invalidated").value_or(false)) {
+    // The DOM of the frame of the element changed after its details were sent.
+    if (dom_mutation_count) {
+      fetch.latest_dom_mutation_count =
+          static_cast<int>(dom_mutation_count.value());
+    } else {
+      speculative_fetches_.erase(speculative_fetch_it);
+    }
+    return true;
+  }
+
+  fetch.params = web::ContextMenuParamsFromElementDictionary(message.body());
+  fetch.params->is_main_frame = message.is_main_frame();
+  fetch.dom_mutation_count = static_cast<int>(dom_mutation_count.value_or(0));
+  fetch.latest_dom_mutation_count = fetch.dom_mutation_count;
+
+  if (!fetch.pending_callback.is_null()) {
+    std::string pending_request_id = fetch.pending_request_id;
+    ElementDetailsCallback callback = std::move(fetch.pending_callback);
+    ContextMenuParams params = fetch.params.value();
+    speculative_fetches_.erase(speculative_fetch_it);
+    std::move(callback).Run(pending_request_id, params);
+  }
+  return true;
+}
+
 absl::optional<std::string>
 ContextMenuJavaScriptFeature::GetScriptMessageHandlerName() const {
   return kFindElementResultHandlerName;
@@ -96,6 +241,10 @@ void ContextMenuJavaScriptFeature::ScriptMessageReceived(
     return;
   }
 
+  if (SpeculativeFetchMessageReceived(web_state, *request_id, message)) {
+    return;
+  }
+
   auto callback_it = callbacks_.find(*request_id);
   if (callback_it == callbacks_.end()) {
     return;
@@ -21,6 +21,18 @@ using base::test::ios::kWaitForJSCompletionTimeout;
 
 namespace web {
 
+namespace {
+
+// A page with a link at the top left corner.
+NSString* const kLinkPageHtml =
+    @"<html><head>"
+     "<style>body { font-size:14em; }</style>"
+     "<meta name=\"viewport\" content=\"user-scalable=no, width=100\">"
+     "</head><body><p><a id=\"linkID\" "
+     "href=\"http://destination/\">link</a></p></body></html>";
+
+}  // namespace
+
 typedef WebTestWithWebState ContextMenuJavaScriptFeatureTest;
 
 TEST_F(ContextMenuJavaScriptFeatureTest, FetchElement) {
@@ -54,4 +66,58 @@ TEST_F(ContextMenuJavaScriptFeatureTest, FetchElement) {
   }));
 }
 
+// Tests that the details found by a speculative fetch are returned for a
+// request at the same point.
+TEST_F(ContextMenuJavaScriptFeatureTest, SpeculativeFetch) {
+  LoadHtml(kLinkPageHtml);
+
+  ContextMenuJavaScriptFeature* feature =
+      ContextMenuJavaScriptFeature::FromBrowserState(GetBrowserState());
+  feature->StartSpeculativeFetch(web_state(), CGPointMake(10.0, 10.0),
+                                 CGSizeMake(100.0, 100.0));
+
+  std::string request_id("123");
+  __block bool callback_called = false;
+  feature->GetElementAtPoint(
+      web_state(), request_id, CGPointMake(12.0, 11.0),
+      CGSizeMake(100.0, 100.0),
+      base::BindOnce(^(const std::string& callback_request_id,
+                       const web::ContextMenuParams& params) {
+        EXPECT_EQ(request_id, callback_request_id);
+        EXPECT_EQ(true, params.is_main_frame);
+        EXPECT_EQ("http://destination/", params.link_url.spec());
+        callback_called = true;
+      }));
+
+  ASSERT_TRUE(WaitUntilConditionOrTimeout(kWaitForJSCompletionTimeout, ^{
+    return callback_called;
+  }));
+}
+
+// Tests that a speculative fetch for another point is discarded.
+TEST_F(ContextMenuJavaScriptFeatureTest, SpeculativeFetchAtOtherPoint) {
+  LoadHtml(kLinkPageHtml);
+
+  ContextMenuJavaScriptFeature* feature =
+      ContextMenuJavaScriptFeature::FromBrowserState(GetBrowserState());
+  feature->StartSpeculativeFetch(web_state(), CGPointMake(90.0, 90.0),
+                                 CGSizeMake(100.0, 100.0));
+
+  std::string request_id("123");
+  __block bool callback_called = false;
+  feature->GetElementAtPoint(
+      web_state(), request_id, CGPointMake(10.0, 10.0),
+      CGSizeMake(100.0, 100.0),
+      base::BindOnce(^(const std::string& callback_request_id,
+                       const web::ContextMenuParams& params) {
+        EXPECT_EQ(request_id, callback_request_id);
+        EXPECT_EQ("http://destination/", params.link_url.spec());
+        callback_called = true;
+      }));
+
+  ASSERT_TRUE(WaitUntilConditionOrTimeout(kWaitForJSCompletionTimeout, ^{
+    return callback_called;
+  }));
+}
+
 }  // namespace web
@@ -88,8 +88,15 @@ var getResponseForImageElement = function(element) {
  *                 coordinates.
  * @param {number} y Vertical center of the selected point in page
  *                 coordinates.
+ * @param {boolean=} opt_speculative Whether the request is made ahead of a
+ *                   long press. If true, the frame containing the found
+ *                   element posts a 'FindElementResultHandler' message with
+ *                   {@code invalidated} set on the next change to its DOM, as
+ *                   the found element may no longer be the right one.
  */
-__gCrWeb['findElementAtPointInPageCoordinates'] = function(requestId, x, y) {
+__gCrWeb['findElementAtPointInPageCoordinates'] = function(
+    requestId, x, y, opt_speculative) {
+  var speculative = !!opt_speculative;
   var hitCoordinates = spiralCoordinates_(x, y);
   for (var index = 0; index < hitCoordinates.length; index++) {
     var coordinates = hitCoordinates[index];
@@ -104,7 +111,8 @@ __gCrWeb['findElementAtPointInPageCoordinates'] = function(requestId, x, y) {
         type: 'org.chromium.contextMenuMessage',
         requestId: requestId,
         x: x - element.offsetLeft,
-        y: y - element.offsetTop
+        y: y - element.offsetTop,
+        speculative: speculative
       };
       // The message will not be sent if |targetOrigin| is null, so use * which
       // allows the message to be delievered to the contentWindow regardless of
@@ -131,41 +139,114 @@ __gCrWeb['findElementAtPointInPageCoordinates'] = function(requestId, x, y) {
           tagName === 'select' || tagName === 'option') {
         // If the element is a known input element, stop the spiral search and
         // return empty results.
-        sendFindElementAtPointResponse(requestId, /*response=*/{});
+        sendFindElementAtPointResponse(requestId, /*response=*/{},
+                                       speculative);
         return;
       }
 
       if (getComputedWebkitTouchCallout_(element) !== 'none') {
         if (tagName === 'a' && element.href) {
           sendFindElementAtPointResponse(requestId,
-                                         getResponseForLinkElement(element));
+                                         getResponseForLinkElement(element),
+                                         speculative);
           return;
         }
 
         if (tagName === 'img' && element.src) {
           sendFindElementAtPointResponse(requestId,
-                                         getResponseForImageElement(element));
+                                         getResponseForImageElement(element),
+                                         speculative);
           return;
         }
       }
       element = element.parentNode;
     }
   }
-  sendFindElementAtPointResponse(requestId, /*response=*/{});
+  sendFindElementAtPointResponse(requestId, /*response=*/{}, speculative);
 };
 
+/**
+ * Number of DOM mutations observed in this frame since the observation started
+ * for a speculative request.
+ * @type {number}
+ * @private
+ */
+var domMutationCount_ = 0;
+
+/**
+ * The speculative request whose result is invalidated by the next DOM
+ * mutation, if any.
+ * @type {?string}
+ * @private
+ */
+var speculativeRequestId_ = null;
+
+/**
+ * Observer of the DOM mutations, created for the first speculative request.
+ * @type {MutationObserver}
+ * @private
+ */
+var mutationObserver_ = null;
+
 /**
  * Inserts |requestId| into |response| and sends the result as the payload of a
  * 'FindElementResultHandler' message back to the native application.
  * @param {string} requestId An identifier which will be returned in the result
  *                 dictionary of this request.
  * @param {!Object} response The 'FindElementResultHandler' message payload.
+ * @param {boolean} speculative Whether the request is speculative, in which
+ *                  case the next DOM mutation is reported for |requestId|.
  */
-var sendFindElementAtPointResponse = function(requestId, response) {
+var sendFindElementAtPointResponse = function(requestId, response,
+                                              speculative) {
   response.requestId = requestId;
+  if (speculative) {
+    observeDOMMutations_(requestId);
+  }
+  response.domMutationCount = domMutationCount_;
   __gCrWeb.common.sendWebKitMessage('FindElementResultHandler', response);
 };
 
+/**
+ * Starts observing the DOM mutations of this frame, until the next mutation
+ * which is reported to the native application as invalidating the result of
+ * the speculative request |requestId|.
+ * @param {string} requestId The identifier of the speculative request.
+ * @private
+ */
+var observeDOMMutations_ = function(requestId) {
+  speculativeRequestId_ = requestId;
+  if (!mutationObserver_) {
+    mutationObserver_ = new MutationObserver(onDOMMutations_);
+  }
+  mutationObserver_.observe(document, {
+    attributes: true,
+    characterData: true,
+    childList: true,
+    subtree: true
+  });
+};
+
+/**
+ * Reports the first DOM mutation after a speculative request, then stops
+ * observing the DOM until the next speculative request.
+ * @param {!Array<!MutationRecord>} mutations The observed mutations.
+ * @private
+ */
+var onDOMMutations_ = function(mutations) {
+  domMutationCount_ += mutations.length;
+  mutationObserver_.disconnect();
+  if (!speculativeRequestId_) {
+    return;
+  }
+  __gCrWeb.common.sendWebKitMessage('FindElementResultHandler', {
+    requestId: speculativeRequestId_,
+    invalidated: true,
+    domMutationCount: domMutationCount_
+  });
+  speculativeRequestId_ = null;
+};
+
 /**
  * Returns whether or not view port coordinates should be used for the given
  * window.
@@ -355,7 +436,8 @@ window.addEventListener('message', function(message) {
     __gCrWeb.findElementAtPointInPageCoordinates(
         payload.requestId,
         payload.x + window.pageXOffset,
-        payload.y + window.pageYOffset);
+        payload.y + window.pageYOffset,
+        payload.speculative);
   }
 });
 
@@ -27,13 +27,17 @@ goog.provide('__crWeb.mainFrameContextMenu');
  *                 coordinates.
  * @param {number} webViewWidth the width of web view.
  * @param {number} webViewHeight the height of web view.
+ * @param {boolean=} opt_speculative Whether the request is made ahead of a
+ *                   long press. See
+ *                   {@code findElementAtPointInPageCoordinates}.
  */
 __gCrWeb['findElementAtPoint'] =
-    function(requestId, x, y, webViewWidth, webViewHeight) {
+    function(requestId, x, y, webViewWidth, webViewHeight, opt_speculative) {
       var scale = getPageWidth() / webViewWidth;
       __gCrWeb.findElementAtPointInPageCoordinates(requestId,
                                                    x * scale,
-                                                   y * scale);
+                                                   y * scale,
+                                                   opt_speculative);
     };
 
 /**
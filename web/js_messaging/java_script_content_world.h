@@ -8,6 +8,7 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <vector>
 
 #import <WebKit/WebKit.h>
 
@@ -19,6 +20,7 @@ namespace web {
 
 class BrowserState;
 class JavaScriptFeature;
+class UserScriptCombiner;
 
 // Represents a content world which can be configured with a given set of
 // JavaScriptFeatures. An isolated world prevents the loaded web page’s
@@ -52,10 +54,25 @@ class JavaScriptContentWorld {
   // callbacks.
   void AddFeature(const JavaScriptFeature* feature);
 
+  // Adds |features| and their dependencies. The scripts of all the added
+  // features sharing an injection time and target frames are combined into a
+  // single user script, so prefer adding all the features at once.
+  void AddFeatures(const std::vector<const JavaScriptFeature*>& features);
+
   // Returns true if and only if |feature| has been added to this content world.
   bool HasFeature(const JavaScriptFeature* feature);
 
  private:
+  // Adds |feature| and its dependencies which have not been added yet, adding
+  // their scripts to |combiner| and configuring their communication callbacks.
+  void RegisterFeature(const JavaScriptFeature* feature,
+                       UserScriptCombiner* combiner);
+
+  // Adds a user script with |source| to the user content controller.
+  void AddUserScript(NSString* source,
+                     WKUserScriptInjectionTime injection_time,
+                     bool main_frame_only);
+
   // Processes the response of a script message and forwards it to |handler|.
   void ScriptMessageReceived(JavaScriptFeature::ScriptMessageHandler handler,
                              BrowserState* browser_state,
@@ -7,6 +7,7 @@
 #include "base/check_op.h"
 #include "base/notreached.h"
 #import "base/strings/sys_string_conversions.h"
+#import "ios/web/js_messaging/user_script_combiner.h"
 #import "ios/web/js_messaging/web_view_js_utils.h"
 #import "ios/web/js_messaging/web_view_web_state_map.h"
 #import "ios/web/public/browser_state.h"
@@ -79,6 +80,50 @@ bool JavaScriptContentWorld::HasFeature(const JavaScriptFeature* feature) {
 }
 
 void JavaScriptContentWorld::AddFeature(const JavaScriptFeature* feature) {
+  AddFeatures({feature});
+}
+
+void JavaScriptContentWorld::AddFeatures(
+    const std::vector<const JavaScriptFeature*>& features) {
+  UserScriptCombiner combiner;
+  for (const JavaScriptFeature* feature : features) {
+    RegisterFeature(feature, &combiner);
+  }
+
+  for (const UserScriptCombiner::Bundle& bundle : combiner.GetBundles()) {
+    WKUserScriptInjectionTime injection_time =
+        InjectionTimeToWKUserScriptInjectionTime(bundle.injection_time);
+    AddUserScript(bundle.source, injection_time, bundle.main_frame_only);
+  }
+}
+
+void JavaScriptContentWorld::AddUserScript(
+    NSString* source,
+    WKUserScriptInjectionTime injection_time,
+    bool main_frame_only) {
+  WKUserScript* user_script = nil;
+#if defined(__IPHONE_14_0) && __IPHONE_OS_VERSION_MAX_ALLOWED >= __IPHONE_14_0
+  if (@available(iOS 14, *)) {
+    if (content_world_) {
+      user_script = [[WKUserScript alloc] initWithSource:source
+                                           injectionTime:injection_time
+                                        forMainFrameOnly:main_frame_only
+                                          inContentWorld:content_world_];
+    }
+  }
+#endif  // defined(__IPHONE14_0)
+
+  if (!user_script) {
+    user_script = [[WKUserScript alloc] initWithSource:source
+                                         injectionTime:injection_time
+                                      forMainFrameOnly:main_frame_only];
+  }
+
+  [user_content_controller_ addUserScript:user_script];
+}
+
+void JavaScriptContentWorld::RegisterFeature(const JavaScriptFeature* feature,
+                                             UserScriptCombiner* combiner) {
   if (HasFeature(feature)) {
     // |feature| has already been added to this content world.
     return;
@@ -109,42 +154,11 @@ void JavaScriptContentWorld::AddFeature(const JavaScriptFeature* feature) {
 
   // Add dependent features first.
   for (const JavaScriptFeature* dep_feature : feature->GetDependentFeatures()) {
-    AddFeature(dep_feature);
+    RegisterFeature(dep_feature, combiner);
   }
 
-  // Setup user scripts.
-  for (const JavaScriptFeature::FeatureScript& feature_script :
-       feature->GetScripts()) {
-    WKUserScriptInjectionTime injection_time =
-        InjectionTimeToWKUserScriptInjectionTime(
-            feature_script.GetInjectionTime());
-
-    bool main_frame_only =
-        feature_script.GetTargetFrames() !=
-        JavaScriptFeature::FeatureScript::TargetFrames::kAllFrames;
-
-    WKUserScript* user_script = nil;
-#if defined(__IPHONE_14_0) && __IPHONE_OS_VERSION_MAX_ALLOWED >= __IPHONE_14_0
-    if (@available(iOS 14, *)) {
-      if (content_world_) {
-        user_script = [[WKUserScript alloc]
-              initWithSource:feature_script.GetScriptString()
-               injectionTime:injection_time
-            forMainFrameOnly:main_frame_only
-              inContentWorld:content_world_];
-      }
-    }
-#endif  // defined(__IPHONE14_0)
-
-    if (!user_script) {
-      user_script =
-          [[WKUserScript alloc] initWithSource:feature_script.GetScriptString()
-                                 injectionTime:injection_time
-                              forMainFrameOnly:main_frame_only];
-    }
-
-    [user_content_controller_ addUserScript:user_script];
-  }
+  // Setup user scripts, after the ones of the dependent features.
+  combiner->AddScriptsOfFeature(feature);
 
   // Setup Javascript message callback.
   auto optional_handler_name = feature->GetScriptMessageHandlerName();
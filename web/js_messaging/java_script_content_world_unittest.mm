@@ -47,6 +47,47 @@ TEST_F(JavaScriptContentWorldTest, AddFeature) {
   ASSERT_GT(scripts_count, initial_scripts_count);
 }
 
+// Tests that the scripts of a JavaScriptFeature sharing an injection time and
+// target frames are combined into a single user script.
+TEST_F(JavaScriptContentWorldTest, AddFeatureCombinesScripts) {
+  WKWebViewConfigurationProvider& configuration_provider =
+      WKWebViewConfigurationProvider::FromBrowserState(GetBrowserState());
+  WKUserContentController* user_content_controller =
+      configuration_provider.GetWebViewConfiguration().userContentController;
+
+  unsigned long initial_scripts_count =
+      [[user_content_controller userScripts] count];
+
+  web::JavaScriptContentWorld world(GetBrowserState());
+
+  FakeJavaScriptFeature feature(
+      JavaScriptFeature::ContentWorld::kAnyContentWorld);
+  ASSERT_EQ(2ul, feature.GetScripts().size());
+  world.AddFeatures({&feature});
+  EXPECT_TRUE(world.HasFeature(&feature));
+
+  NSArray<WKUserScript*>* user_scripts = [user_content_controller userScripts];
+  ASSERT_EQ(initial_scripts_count + 1, [user_scripts count]);
+
+  // Both scripts are in the added user script, in their original order.
+  NSString* source = [user_scripts lastObject].source;
+  NSRange first_range =
+      [source rangeOfString:feature.GetScripts()[0].GetScriptString()];
+  NSRange second_range =
+      [source rangeOfString:feature.GetScripts()[1].GetScriptString()];
+  ASSERT_NE(NSNotFound, static_cast<NSInteger>(first_range.location));
+  ASSERT_NE(NSNotFound, static_cast<NSInteger>(second_range.location));
+  EXPECT_LT(first_range.location, second_range.location);
+  EXPECT_EQ(WKUserScriptInjectionTimeAtDocumentEnd,
+            [user_scripts lastObject].injectionTime);
+  EXPECT_FALSE([user_scripts lastObject].forMainFrameOnly);
+
+  // Adding the feature again does not add any script.
+  world.AddFeatures({&feature});
+  EXPECT_EQ(initial_scripts_count + 1,
+            [[user_content_controller userScripts] count]);
+}
+
 // Tests adding a JavaScriptFeature to a specific JavaScriptContentWorld.
 TEST_F(JavaScriptContentWorldTest, AddFeatureToSpecificWKContentWorld) {
 #if defined(__IPHONE_14_0) && __IPHONE_OS_VERSION_MAX_ALLOWED >= __IPHONE_14_0
@@ -22,17 +22,19 @@ namespace {
 const char kWebJavaScriptFeatureManagerKeyName[] =
     "web_java_script_feature_manager";
 
-// Adds common features to |world|.
-void AddSharedCommonFeatures(web::JavaScriptContentWorld* world) {
+// Returns the common features to add to every content world.
+std::vector<const web::JavaScriptFeature*> GetSharedCommonFeatures() {
   // The scripts defined by these features were previously hardcoded into
   // js_compile.gni and are assumed to always exist by other feature javascript
   // (regardless of content world).
   // TODO(crbug.com/1152112): Remove unconditional injection of these features
   // once dependent features are migrated to JavaScriptFeatures and correctly
   // define their dependencies.
-  world->AddFeature(web::java_script_features::GetBaseJavaScriptFeature());
-  world->AddFeature(web::java_script_features::GetCommonJavaScriptFeature());
-  world->AddFeature(web::java_script_features::GetMessageJavaScriptFeature());
+  return {
+      web::java_script_features::GetBaseJavaScriptFeature(),
+      web::java_script_features::GetCommonJavaScriptFeature(),
+      web::java_script_features::GetMessageJavaScriptFeature(),
+  };
 }
 
 }  // namespace
@@ -62,27 +64,37 @@ void JavaScriptFeatureManager::ConfigureFeatures(
     std::vector<JavaScriptFeature*> features) {
   page_content_world_ =
       std::make_unique<JavaScriptContentWorld>(browser_state_);
-  AddSharedCommonFeatures(page_content_world_.get());
 
 #if defined(__IPHONE_14_0) && __IPHONE_OS_VERSION_MAX_ALLOWED >= __IPHONE_14_0
   if (@available(iOS 14, *)) {
     isolated_world_ = std::make_unique<JavaScriptContentWorld>(
         browser_state_, WKContentWorld.defaultClientWorld);
-    AddSharedCommonFeatures(isolated_world_.get());
   }
 #endif  // defined(__IPHONE14_0)
 
+  // Gather the features of each world before adding them, so that their
+  // scripts are combined into as few user scripts as possible.
+  std::vector<const JavaScriptFeature*> page_content_world_features =
+      GetSharedCommonFeatures();
+  std::vector<const JavaScriptFeature*> isolated_world_features =
+      GetSharedCommonFeatures();
+
   for (JavaScriptFeature* feature : features) {
     if (isolated_world_ &&
         feature->GetSupportedContentWorld() !=
             JavaScriptFeature::ContentWorld::kPageContentWorld) {
-      isolated_world_->AddFeature(feature);
+      isolated_world_features.push_back(feature);
     } else {
       DCHECK_NE(feature->GetSupportedContentWorld(),
                 JavaScriptFeature::ContentWorld::kIsolatedWorldOnly);
-      page_content_world_->AddFeature(feature);
+      page_content_world_features.push_back(feature);
     }
   }
+
+  page_content_world_->AddFeatures(page_content_world_features);
+  if (isolated_world_) {
+    isolated_world_->AddFeatures(isolated_world_features);
+  }
 }
 
 JavaScriptContentWorld* JavaScriptFeatureManager::GetContentWorldForFeature(
@@ -0,0 +1,70 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_WEB_JS_MESSAGING_USER_SCRIPT_COMBINER_H_
+#define IOS_WEB_JS_MESSAGING_USER_SCRIPT_COMBINER_H_
+
+#import <Foundation/Foundation.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#import "ios/web/public/js_messaging/java_script_feature.h"
+
+namespace web {
+
+// Combines the scripts of JavaScriptFeatures into a single script per
+// injection time and target frames, so that each frame parses and runs a few
+// bundles instead of one script per feature.
+//
+// The scripts keep their own once-injection wrapper (see
+// FeatureScript::GetScriptString), so the scripts to inject once per window
+// are still skipped when WebKit re-injects a bundle into a re-created
+// document. Each script is guarded so that an exception thrown by a script
+// does not prevent the following scripts of the bundle from running.
+class UserScriptCombiner {
+ public:
+  using InjectionTime = JavaScriptFeature::FeatureScript::InjectionTime;
+
+  // A combined script.
+  struct Bundle {
+    InjectionTime injection_time;
+    bool main_frame_only;
+    // The source of the combined scripts, in the order they were added.
+    __strong NSString* source;
+    // The number of scripts combined.
+    size_t script_count;
+  };
+
+  UserScriptCombiner();
+  UserScriptCombiner(const UserScriptCombiner&) = delete;
+  UserScriptCombiner& operator=(const UserScriptCombiner&) = delete;
+  ~UserScriptCombiner();
+
+  // Appends the scripts of |feature| to their bundle. Within a bundle, the
+  // scripts are injected in the order they were added, so the scripts of the
+  // dependencies of a feature must be added first.
+  void AddScriptsOfFeature(const JavaScriptFeature* feature);
+
+  // Returns a single script running each of |scripts| in order. A script
+  // which throws stops at the exception, as it would as a separate script,
+  // and the next scripts still run.
+  static NSString* CombineScripts(NSArray<NSString*>* scripts);
+
+  // Returns the bundles, ordered by injection time. For a given injection
+  // time, the bundle for all frames comes first, as the main frame scripts may
+  // depend on it.
+  std::vector<Bundle> GetBundles() const;
+
+ private:
+  // Injection time and whether the script only targets the main frame.
+  using BundleKey = std::pair<InjectionTime, bool>;
+
+  std::map<BundleKey, NSMutableArray<NSString*>*> scripts_;
+};
+
+}  // namespace web
+
+#endif  // IOS_WEB_JS_MESSAGING_USER_SCRIPT_COMBINER_H_
@@ -0,0 +1,69 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/web/js_messaging/user_script_combiner.h"
+
+#include "base/check.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace web {
+
+namespace {
+
+// Wrapper isolating a combined script from the exceptions of the others. The
+// script is wrapped in a block, like the once-injection wrapper already does,
+// so its var and function declarations stay global. The line breaks ensure
+// that a script ending with a line comment does not comment out the end of
+// the wrapper.
+NSString* const kScriptWrapperTemplate = @"try {\n%@\n} catch (error) {}\n";
+
+}  // namespace
+
+UserScriptCombiner::UserScriptCombiner() = default;
+
+UserScriptCombiner::~UserScriptCombiner() = default;
+
+void UserScriptCombiner::AddScriptsOfFeature(
+    const JavaScriptFeature* feature) {
+  DCHECK(feature);
+  for (const JavaScriptFeature::FeatureScript& feature_script :
+       feature->GetScripts()) {
+    const bool main_frame_only =
+        feature_script.GetTargetFrames() !=
+        JavaScriptFeature::FeatureScript::TargetFrames::kAllFrames;
+    NSMutableArray<NSString*>*& scripts =
+        scripts_[BundleKey(feature_script.GetInjectionTime(), main_frame_only)];
+    if (!scripts)
+      scripts = [NSMutableArray array];
+    [scripts addObject:feature_script.GetScriptString()];
+  }
+}
+
+// static
+NSString* UserScriptCombiner::CombineScripts(NSArray<NSString*>* scripts) {
+  NSMutableString* combined_script = [NSMutableString string];
+  for (NSString* script in scripts) {
+    [combined_script appendFormat:kScriptWrapperTemplate, script];
+  }
+  return combined_script;
+}
+
+std::vector<UserScriptCombiner::Bundle> UserScriptCombiner::GetBundles()
+    const {
+  std::vector<Bundle> bundles;
+  for (const auto& pair : scripts_) {
+    Bundle bundle;
+    bundle.injection_time = pair.first.first;
+    bundle.main_frame_only = pair.first.second;
+    bundle.source = CombineScripts(pair.second);
+    bundle.script_count = pair.second.count;
+    bundles.push_back(bundle);
+  }
+  return bundles;
+}
+
+}  // namespace web
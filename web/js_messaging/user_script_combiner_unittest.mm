@@ -0,0 +1,53 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/web/js_messaging/user_script_combiner.h"
+
+#import <WebKit/WebKit.h>
+
+#import "ios/web/public/test/js_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#import "testing/gtest_mac.h"
+#include "testing/platform_test.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace web {
+
+class UserScriptCombinerTest : public PlatformTest {
+ protected:
+  UserScriptCombinerTest() : web_view_([[WKWebView alloc] init]) {}
+
+  WKWebView* web_view_;
+};
+
+// Tests that a script throwing in the middle of a bundle does not prevent the
+// following scripts from running.
+TEST_F(UserScriptCombinerTest, ThrowingScriptDoesNotStopBundle) {
+  NSString* bundle = UserScriptCombiner::CombineScripts(@[
+    @"window.ran = ['first'];",
+    @"window.ran.push('second'); throw new Error('failure');"
+     "window.ran.push('unreachable');",
+    @"window.ran.push('third');",
+  ]);
+  test::ExecuteJavaScript(web_view_, bundle);
+  EXPECT_NSEQ(@"first,second,third",
+              test::ExecuteJavaScript(web_view_, @"window.ran.join(',')"));
+}
+
+// Tests that the var and function declarations of the combined scripts stay
+// global, as they are when each script is injected separately.
+TEST_F(UserScriptCombinerTest, DeclarationsStayGlobal) {
+  NSString* bundle = UserScriptCombiner::CombineScripts(@[
+    @"var combinedVar = 1; // A line comment ending the script.",
+    @"function combinedFunction() { return combinedVar + 1; }",
+  ]);
+  test::ExecuteJavaScript(web_view_, bundle);
+  EXPECT_NSEQ(@2, test::ExecuteJavaScript(web_view_,
+                                          @"window.combinedFunction()"));
+}
+
+}  // namespace web
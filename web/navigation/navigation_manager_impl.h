@@ -42,6 +42,16 @@ extern const char kRestoreNavigationItemCount[];
 // restoration.
 extern const char kRestoreNavigationTime[];
 
+// Names of UMA histograms to log the time between the start of a session
+// restoration and the commit of its first restored item, when the whole history
+// is replayed into the web view and when it is restored lazily.
+extern const char kRestoreSessionTimeToFirstCommit[];
+extern const char kLazyRestoreSessionTimeToFirstCommit[];
+
+// Name of UMA histogram to log the number of deferred items replayed into the
+// web view when the user navigates to lazily restored history.
+extern const char kLazyRestoreMaterializedItemCount[];
+
 // Defines the ways how a pending navigation can be initiated.
 enum class NavigationInitiationType {
   // Navigation initiation type is only valid for pending navigations, use NONE
@@ -263,6 +273,8 @@ class NavigationManagerImpl : public NavigationManager {
   NavigationItemImpl* GetLastCommittedItemInCurrentOrRestoredSession() const;
   // Unlike GetLastCommittedItemIndex(), this method does not return -1 during
   // session restoration (and returns last known committed item index instead).
+  // The index is in the items of the web view, and does not account for the
+  // deferred items of a lazily restored session.
   int GetLastCommittedItemIndexInCurrentOrRestoredSession() const;
 
   // Identical to GetItemAtIndex() but returns the underlying NavigationItemImpl
@@ -346,6 +358,56 @@ class NavigationManagerImpl : public NavigationManager {
       RestoreItemListType list_type,
       std::vector<std::unique_ptr<NavigationItem>> items_restored);
 
+  // Implementation of Restore(). If |allow_lazy_restore| is true and
+  // kLazySessionRestore is enabled, uses LazyRestore() instead of replaying
+  // the whole session into the web view.
+  void RestoreImpl(int last_committed_item_index,
+                   std::vector<std::unique_ptr<NavigationItem>> items,
+                   bool allow_lazy_restore);
+
+  // Restores the specified navigation session by loading only the item at
+  // |last_committed_item_index|. The other items are kept in
+  // |deferred_back_items_| and |deferred_forward_items_| until the user
+  // navigates to one of them.
+  void LazyRestore(int last_committed_item_index,
+                   std::vector<std::unique_ptr<NavigationItem>> items);
+
+  // Returns true if |index| designates a deferred item of a lazily restored
+  // session. The items of a lazily restored session are indexed as if they
+  // were all in the web view: deferred back items come first, then the items
+  // of the web view, then deferred forward items.
+  bool IsDeferredItemIndex(int index) const;
+
+  // Returns the number of deferred back items, i.e. the offset between the
+  // indices of the NavigationManager API and the indices of the items of the
+  // web view.
+  int GetDeferredBackItemCount() const;
+
+  // Returns the number of items of the web view, which excludes the deferred
+  // items of a lazily restored session.
+  int GetWebViewItemCount() const;
+
+  // Returns the item of the web view at |index|, which does not account for
+  // the deferred items of a lazily restored session.
+  NavigationItemImpl* GetWebViewItemImplAtIndex(size_t index) const;
+
+  // Replays the deferred items and the items of the web view into a new web
+  // view, and navigates to the item at |index|.
+  void MaterializeDeferredItems(int index);
+
+  // Restores |items| surrounded by the deferred items of a lazily restored
+  // session. |last_committed_item_index| is an index in |items|.
+  void RestoreWithDeferredItems(
+      int last_committed_item_index,
+      std::vector<std::unique_ptr<NavigationItem>> items,
+      bool allow_lazy_restore);
+
+  // Returns the items to serialize, including the deferred items of a lazily
+  // restored session, and sets |last_committed_item_index| to the index of the
+  // last committed item in the returned list.
+  std::vector<NavigationItemImpl*> GetItemsForSerialization(
+      int* last_committed_item_index) const;
+
   // Restores the specified navigation session in the current web view. This
   // differs from Restore() in that it doesn't reset the current navigation
   // history to empty before restoring. It simply appends the restored session
@@ -472,6 +534,22 @@ class NavigationManagerImpl : public NavigationManager {
   // registered in AddRestoreCompletionCallback() and are executed in
   // FinalizeSessionRestore().
   std::vector<base::OnceClosure> restore_session_completion_callbacks_;
+
+  // Items of a lazily restored session that precede (respectively follow) the
+  // items of the WKBackForwardList. Deferred forward items are dropped as soon
+  // as a new navigation is committed.
+  std::vector<std::unique_ptr<NavigationItem>> deferred_back_items_;
+  std::vector<std::unique_ptr<NavigationItem>> deferred_forward_items_;
+
+  // The item loaded by LazyRestore(). Kept until it is committed so that it is
+  // serialized if the session is saved before the load commits.
+  std::unique_ptr<NavigationItem> lazily_restored_item_;
+
+  // Non null between the start of a session restoration and the commit of its
+  // first restored item. Used to compare the latency of lazy and full session
+  // restoration. Not started for the replay of deferred items.
+  std::unique_ptr<base::ElapsedTimer> restore_commit_timer_;
+  bool is_lazy_restore_ = false;
 };
 
 }  // namespace web
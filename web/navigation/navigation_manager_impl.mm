@@ -66,6 +66,12 @@ namespace web {
 
 const char kRestoreNavigationItemCount[] = "IOS.RestoreNavigationItemCount";
 const char kRestoreNavigationTime[] = "IOS.RestoreNavigationTime";
+const char kRestoreSessionTimeToFirstCommit[] =
+    "IOS.RestoreSession.TimeToFirstCommit";
+const char kLazyRestoreSessionTimeToFirstCommit[] =
+    "IOS.RestoreSession.Lazy.TimeToFirstCommit";
+const char kLazyRestoreMaterializedItemCount[] =
+    "IOS.RestoreSession.Lazy.MaterializedItemCount";
 
 NavigationManager::WebLoadParams::WebLoadParams(const GURL& url)
     : url(url),
@@ -123,7 +129,29 @@ void NavigationManagerImpl::OnNavigationItemCommitted() {
   DCHECK(item);
   delegate_->OnNavigationItemCommitted(item);
 
+  if (lazily_restored_item_) {
+    if (item->GetURL() == lazily_restored_item_->GetURL()) {
+      static_cast<NavigationItemImpl*>(item)->RestoreStateFromItem(
+          lazily_restored_item_.get());
+    }
+    lazily_restored_item_.reset();
+  }
+
+  // A new navigation from a lazily restored item clobbers its forward history.
+  if (GetWebViewItemCount() > 1)
+    deferred_forward_items_.clear();
+
   if (!wk_navigation_util::IsRestoreSessionUrl(item->GetURL())) {
+    if (restore_commit_timer_) {
+      if (is_lazy_restore_) {
+        UMA_HISTOGRAM_TIMES(kLazyRestoreSessionTimeToFirstCommit,
+                            restore_commit_timer_->Elapsed());
+      } else {
+        UMA_HISTOGRAM_TIMES(kRestoreSessionTimeToFirstCommit,
+                            restore_commit_timer_->Elapsed());
+      }
+      restore_commit_timer_.reset();
+    }
     restored_visible_item_.reset();
     if (is_restore_session_in_progress_) {
       // There are crashes because restored_visible_item_ is nil and
@@ -162,11 +190,11 @@ void NavigationManagerImpl::OnNavigationStarted(const GURL& url) {
     // progress so the item returned by the last committed item is the
     // last_committed_web_view_item_ as the origins mistmatch.
     int index = GetLastCommittedItemIndexInCurrentOrRestoredSession();
-    DCHECK(index != -1 || 0 == GetItemCount());
+    DCHECK(index != -1 || 0 == GetWebViewItemCount());
     if (index != -1 && restored_visible_item_ &&
         restored_visible_item_->GetUserAgentType() != UserAgentType::NONE) {
       NavigationItemImpl* last_committed_item =
-          GetNavigationItemImplAtIndex(static_cast<size_t>(index));
+          GetWebViewItemImplAtIndex(static_cast<size_t>(index));
       last_committed_item->SetUserAgentType(
           restored_visible_item_->GetUserAgentType());
     }
@@ -433,6 +461,7 @@ int NavigationManagerImpl::GetIndexForOffset(int offset) const {
     current_item_index =
         empty_window_open_item_ ? 0 : web_view_cache_.GetCurrentItemIndex();
   }
+  current_item_index += GetDeferredBackItemCount();
 
   // Handled signed integer overflow or underflow.
   int index;
@@ -444,7 +473,7 @@ int NavigationManagerImpl::GetIndexForOffset(int offset) const {
 }
 
 void NavigationManagerImpl::SetPendingItemIndex(int index) {
-  pending_item_index_ = index;
+  pending_item_index_ = index == -1 ? -1 : index - GetDeferredBackItemCount();
 }
 
 void NavigationManagerImpl::ApplyWKWebViewForwardHistoryClobberWorkaround() {
@@ -453,7 +482,7 @@ void NavigationManagerImpl::ApplyWKWebViewForwardHistoryClobberWorkaround() {
   int current_item_index = web_view_cache_.GetCurrentItemIndex();
   DCHECK_GE(current_item_index, 0);
 
-  int item_count = GetItemCount();
+  int item_count = GetWebViewItemCount();
   DCHECK_LT(current_item_index, item_count);
 
   std::vector<std::unique_ptr<NavigationItem>> forward_items(
@@ -461,7 +490,7 @@ void NavigationManagerImpl::ApplyWKWebViewForwardHistoryClobberWorkaround() {
 
   for (size_t i = 0; i < forward_items.size(); i++) {
     const NavigationItemImpl* item =
-        GetNavigationItemImplAtIndex(i + current_item_index);
+        GetWebViewItemImplAtIndex(i + current_item_index);
     forward_items[i] = std::make_unique<web::NavigationItemImpl>(*item);
   }
 
@@ -577,27 +606,37 @@ void NavigationManagerImpl::GoToIndex(int index,
   delegate_->RecordPageStateInNavigationItem();
   delegate_->ClearDialogs();
 
+  if (IsDeferredItemIndex(index)) {
+    MaterializeDeferredItems(index);
+    DCHECK(web_view_cache_.IsAttachedToWebView());
+    return;
+  }
+
+  const int web_view_index = index - GetDeferredBackItemCount();
   if (!web_view_cache_.IsAttachedToWebView()) {
     // GoToIndex from detached mode is equivalent to restoring history with
     // |last_committed_item_index| updated to |index|.
-    Restore(index, web_view_cache_.ReleaseCachedItems());
+    RestoreWithDeferredItems(web_view_index,
+                             web_view_cache_.ReleaseCachedItems(),
+                             /*allow_lazy_restore=*/true);
     DCHECK(web_view_cache_.IsAttachedToWebView());
     return;
   }
 
   DiscardNonCommittedItems();
-  NavigationItem* item = GetItemAtIndex(index);
+  NavigationItem* item = GetWebViewItemImplAtIndex(web_view_index);
   item->SetTransitionType(ui::PageTransitionFromInt(
       item->GetTransitionType() | ui::PAGE_TRANSITION_FORWARD_BACK));
-  WKBackForwardListItem* wk_item = web_view_cache_.GetWKItemAtIndex(index);
+  WKBackForwardListItem* wk_item =
+      web_view_cache_.GetWKItemAtIndex(web_view_index);
   if (wk_item) {
     going_to_back_forward_list_item_ = true;
     delegate_->GoToBackForwardListItem(wk_item, item, initiation_type,
                                        has_user_gesture);
     going_to_back_forward_list_item_ = false;
   } else {
-    DCHECK(index == 0 && empty_window_open_item_)
-        << " wk_item should not be nullptr. index: " << index
+    DCHECK(web_view_index == 0 && empty_window_open_item_)
+        << " wk_item should not be nullptr. index: " << web_view_index
         << " has_empty_window_open_item: "
         << (empty_window_open_item_ != nullptr);
   }
@@ -676,7 +715,8 @@ int NavigationManagerImpl::GetLastCommittedItemIndex() const {
     return -1;
   }
 
-  return GetLastCommittedItemIndexInCurrentOrRestoredSession();
+  return GetLastCommittedItemIndexInCurrentOrRestoredSession() +
+         GetDeferredBackItemCount();
 }
 
 NavigationItem* NavigationManagerImpl::GetPendingItem() const {
@@ -765,7 +805,9 @@ void NavigationManagerImpl::LoadURLWithParams(
       DCHECK_GT(next_item_index, 0);
       cached_items.resize(next_item_index + 1);
       cached_items[next_item_index] = std::move(pending_item_);
-      Restore(next_item_index, std::move(cached_items));
+      deferred_forward_items_.clear();
+      RestoreWithDeferredItems(next_item_index, std::move(cached_items),
+                               /*allow_lazy_restore=*/true);
       DCHECK(web_view_cache_.IsAttachedToWebView());
       return;
     }
@@ -779,8 +821,9 @@ void NavigationManagerImpl::LoadIfNecessary() {
   if (!web_view_cache_.IsAttachedToWebView()) {
     // Loading from detached mode is equivalent to restoring cached history.
     // This can happen after clearing browsing data by removing the web view.
-    Restore(web_view_cache_.GetCurrentItemIndex(),
-            web_view_cache_.ReleaseCachedItems());
+    RestoreWithDeferredItems(web_view_cache_.GetCurrentItemIndex(),
+                             web_view_cache_.ReleaseCachedItems(),
+                             /*allow_lazy_restore=*/true);
     DCHECK(web_view_cache_.IsAttachedToWebView());
   } else {
     delegate_->LoadIfNecessary();
@@ -794,11 +837,8 @@ void NavigationManagerImpl::AddTransientURLRewriter(
 }
 
 int NavigationManagerImpl::GetItemCount() const {
-  if (empty_window_open_item_) {
-    return 1;
-  }
-
-  return web_view_cache_.GetBackForwardListItemCount();
+  return GetDeferredBackItemCount() + GetWebViewItemCount() +
+         static_cast<int>(deferred_forward_items_.size());
 }
 
 NavigationItem* NavigationManagerImpl::GetItemAtIndex(size_t index) const {
@@ -809,19 +849,33 @@ int NavigationManagerImpl::GetIndexOfItem(const NavigationItem* item) const {
   if (item == empty_window_open_item_.get())
     return 0;
 
-  for (size_t index = 0; index < web_view_cache_.GetBackForwardListItemCount();
-       index++) {
+  const int deferred_back_item_count = GetDeferredBackItemCount();
+  for (int index = 0; index < deferred_back_item_count; index++) {
+    if (deferred_back_items_[index].get() == item)
+      return index;
+  }
+
+  const int web_view_item_count =
+      static_cast<int>(web_view_cache_.GetBackForwardListItemCount());
+  for (int index = 0; index < web_view_item_count; index++) {
     if (web_view_cache_.GetNavigationItemImplAtIndex(
             index, false /* create_if_missing */) == item)
-      return index;
+      return deferred_back_item_count + index;
+  }
+
+  for (size_t index = 0; index < deferred_forward_items_.size(); index++) {
+    if (deferred_forward_items_[index].get() == item) {
+      return deferred_back_item_count + web_view_item_count +
+             static_cast<int>(index);
+    }
   }
   return -1;
 }
 
 int NavigationManagerImpl::GetPendingItemIndex() const {
-  if (is_restore_session_in_progress_)
+  if (is_restore_session_in_progress_ || pending_item_index_ == -1)
     return -1;
-  return pending_item_index_;
+  return pending_item_index_ + GetDeferredBackItemCount();
 }
 
 bool NavigationManagerImpl::CanGoBack() const {
@@ -890,8 +944,9 @@ void NavigationManagerImpl::Reload(ReloadType reload_type,
 
   if (!web_view_cache_.IsAttachedToWebView()) {
     // Reload from detached mode is equivalent to restoring history unchanged.
-    Restore(web_view_cache_.GetCurrentItemIndex(),
-            web_view_cache_.ReleaseCachedItems());
+    RestoreWithDeferredItems(web_view_cache_.GetCurrentItemIndex(),
+                             web_view_cache_.ReleaseCachedItems(),
+                             /*allow_lazy_restore=*/true);
     DCHECK(web_view_cache_.IsAttachedToWebView());
     return;
   }
@@ -940,7 +995,13 @@ NavigationItemList NavigationManagerImpl::GetBackwardItems() const {
 
   int current_back_forward_item_index = web_view_cache_.GetCurrentItemIndex();
   for (int index = current_back_forward_item_index - 1; index >= 0; index--) {
-    items.push_back(GetItemAtIndex(index));
+    items.push_back(GetWebViewItemImplAtIndex(index));
+  }
+  // The deferred back items of a lazily restored session precede the items of
+  // the web view.
+  for (auto iter = deferred_back_items_.rbegin();
+       iter != deferred_back_items_.rend(); ++iter) {
+    items.push_back(iter->get());
   }
 
   return items;
@@ -953,20 +1014,51 @@ NavigationItemList NavigationManagerImpl::GetForwardItems() const {
     return items;
 
   for (int index = web_view_cache_.GetCurrentItemIndex() + 1;
-       index < GetItemCount(); index++) {
-    items.push_back(GetItemAtIndex(index));
+       index < GetWebViewItemCount(); index++) {
+    items.push_back(GetWebViewItemImplAtIndex(index));
   }
+  // The deferred forward items of a lazily restored session follow the items
+  // of the web view.
+  for (const auto& item : deferred_forward_items_)
+    items.push_back(item.get());
   return items;
 }
 
 void NavigationManagerImpl::Restore(
     int last_committed_item_index,
     std::vector<std::unique_ptr<NavigationItem>> items) {
+  RestoreImpl(last_committed_item_index, std::move(items),
+              /*allow_lazy_restore=*/true);
+}
+
+bool NavigationManagerImpl::IsRestoreSessionInProgress() const {
+  return is_restore_session_in_progress_;
+}
+
+void NavigationManagerImpl::AddRestoreCompletionCallback(
+    base::OnceClosure callback) {
+  if (!is_restore_session_in_progress_) {
+    std::move(callback).Run();
+    return;
+  }
+  restore_session_completion_callbacks_.push_back(std::move(callback));
+}
+
+void NavigationManagerImpl::RestoreImpl(
+    int last_committed_item_index,
+    std::vector<std::unique_ptr<NavigationItem>> items,
+    bool allow_lazy_restore) {
   DCHECK(!is_restore_session_in_progress_);
   WillRestore(items.size());
 
   DCHECK_LT(last_committed_item_index, static_cast<int>(items.size()));
   DCHECK(items.empty() || last_committed_item_index >= 0);
+
+  // The restored session replaces the whole history, including the items
+  // deferred by a previous lazy restoration.
+  deferred_back_items_.clear();
+  deferred_forward_items_.clear();
+  lazily_restored_item_.reset();
   if (items.empty())
     return;
 
@@ -974,27 +1066,146 @@ void NavigationManagerImpl::Restore(
     web_view_cache_.ResetToAttached();
 
   DiscardNonCommittedItems();
-  if (GetItemCount() > 0) {
+  if (GetWebViewItemCount() > 0) {
     delegate_->RemoveWebView();
   }
-  DCHECK_EQ(0, GetItemCount());
+  DCHECK_EQ(0, GetWebViewItemCount());
   DCHECK_EQ(-1, pending_item_index_);
   last_committed_item_index_ = -1;
 
+  restore_commit_timer_ = std::make_unique<base::ElapsedTimer>();
+  is_lazy_restore_ =
+      allow_lazy_restore &&
+      base::FeatureList::IsEnabled(features::kLazySessionRestore);
+  if (is_lazy_restore_) {
+    LazyRestore(last_committed_item_index, std::move(items));
+    return;
+  }
+
   UnsafeRestore(last_committed_item_index, std::move(items));
 }
 
-bool NavigationManagerImpl::IsRestoreSessionInProgress() const {
-  return is_restore_session_in_progress_;
+void NavigationManagerImpl::LazyRestore(
+    int last_committed_item_index,
+    std::vector<std::unique_ptr<NavigationItem>> items) {
+  // WKWebView has no API to populate its back-forward list, so only the last
+  // committed item is loaded. The other items are replayed through
+  // restore_session.html if the user navigates to one of them, which most
+  // restored tabs never do.
+  for (size_t index = 0; index < items.size(); ++index) {
+    RewriteItemURLIfNecessary(items[index].get());
+  }
+
+  for (int index = 0; index < last_committed_item_index; index++) {
+    deferred_back_items_.push_back(std::move(items[index]));
+  }
+  for (size_t index = last_committed_item_index + 1; index < items.size();
+       index++) {
+    deferred_forward_items_.push_back(std::move(items[index]));
+  }
+  lazily_restored_item_ = std::move(items[last_committed_item_index]);
+
+  WebLoadParams params(lazily_restored_item_->GetURL());
+  if (lazily_restored_item_->GetVirtualURL() != params.url)
+    params.virtual_url = lazily_restored_item_->GetVirtualURL();
+  params.referrer = lazily_restored_item_->GetReferrer();
+  params.transition_type = ui::PAGE_TRANSITION_RELOAD;
+  LoadURLWithParams(params);
+
+  NavigationItemImpl* pending_item = GetPendingItemInCurrentOrRestoredSession();
+  if (pending_item) {
+    pending_item->SetTitle(lazily_restored_item_->GetTitle());
+    pending_item->RestoreStateFromItem(lazily_restored_item_.get());
+  }
 }
 
-void NavigationManagerImpl::AddRestoreCompletionCallback(
-    base::OnceClosure callback) {
-  if (!is_restore_session_in_progress_) {
-    std::move(callback).Run();
-    return;
+bool NavigationManagerImpl::IsDeferredItemIndex(int index) const {
+  if (index < 0 || index >= GetItemCount())
+    return false;
+  const int web_view_index = index - GetDeferredBackItemCount();
+  return web_view_index < 0 || web_view_index >= GetWebViewItemCount();
+}
+
+int NavigationManagerImpl::GetDeferredBackItemCount() const {
+  return static_cast<int>(deferred_back_items_.size());
+}
+
+void NavigationManagerImpl::MaterializeDeferredItems(int index) {
+  DCHECK(IsDeferredItemIndex(index));
+  UMA_HISTOGRAM_COUNTS_100(kLazyRestoreMaterializedItemCount,
+                           static_cast<int>(deferred_back_items_.size() +
+                                            deferred_forward_items_.size()));
+
+  std::vector<std::unique_ptr<NavigationItem>> items;
+  if (web_view_cache_.IsAttachedToWebView()) {
+    for (int item_index = 0; item_index < GetWebViewItemCount();
+         item_index++) {
+      NavigationItemImpl* item = GetWebViewItemImplAtIndex(item_index);
+      DCHECK(item);
+      items.push_back(std::make_unique<NavigationItemImpl>(*item));
+    }
+  } else {
+    items = web_view_cache_.ReleaseCachedItems();
   }
-  restore_session_completion_callbacks_.push_back(std::move(callback));
+
+  // RestoreWithDeferredItems() expects an index relative to the items of the
+  // web view.
+  RestoreWithDeferredItems(index - GetDeferredBackItemCount(),
+                           std::move(items),
+                           /*allow_lazy_restore=*/false);
+  // The replayed session already committed its first item, so its replay is
+  // not a restoration and must not be recorded as one. The timer is started
+  // synchronously by RestoreWithDeferredItems() while the commit is not.
+  restore_commit_timer_.reset();
+}
+
+void NavigationManagerImpl::RestoreWithDeferredItems(
+    int last_committed_item_index,
+    std::vector<std::unique_ptr<NavigationItem>> items,
+    bool allow_lazy_restore) {
+  last_committed_item_index += static_cast<int>(deferred_back_items_.size());
+  std::vector<std::unique_ptr<NavigationItem>> all_items =
+      std::move(deferred_back_items_);
+  deferred_back_items_.clear();
+  for (auto& item : items)
+    all_items.push_back(std::move(item));
+  for (auto& item : deferred_forward_items_)
+    all_items.push_back(std::move(item));
+  deferred_forward_items_.clear();
+
+  RestoreImpl(last_committed_item_index, std::move(all_items),
+              allow_lazy_restore);
+}
+
+std::vector<NavigationItemImpl*>
+NavigationManagerImpl::GetItemsForSerialization(
+    int* last_committed_item_index) const {
+  std::vector<NavigationItemImpl*> items;
+  for (const auto& item : deferred_back_items_)
+    items.push_back(static_cast<NavigationItemImpl*>(item.get()));
+
+  int index = GetLastCommittedItemIndex();
+  if (index == -1) {
+    // This can happen when a session is saved during restoration. Instead,
+    // default to the last item of the web view.
+    index = GetWebViewItemCount() - 1;
+  } else {
+    index -= GetDeferredBackItemCount();
+  }
+  if (GetWebViewItemCount() == 0 && lazily_restored_item_) {
+    // The lazily restored item has not been committed yet.
+    items.push_back(
+        static_cast<NavigationItemImpl*>(lazily_restored_item_.get()));
+    index = 0;
+  }
+  for (int item_index = 0; item_index < GetWebViewItemCount(); item_index++)
+    items.push_back(GetWebViewItemImplAtIndex(item_index));
+  *last_committed_item_index =
+      index + static_cast<int>(deferred_back_items_.size());
+
+  for (const auto& item : deferred_forward_items_)
+    items.push_back(static_cast<NavigationItemImpl*>(item.get()));
+  return items;
 }
 
 NavigationItemImpl*
@@ -1005,7 +1216,7 @@ NavigationManagerImpl::GetPendingItemInCurrentOrRestoredSession() const {
     }
     return pending_item_.get();
   }
-  return GetNavigationItemImplAtIndex(pending_item_index_);
+  return GetWebViewItemImplAtIndex(pending_item_index_);
 }
 
 NavigationItemImpl*
@@ -1016,12 +1227,12 @@ NavigationManagerImpl::GetLastCommittedItemInCurrentOrRestoredSession() const {
 
   int index = GetLastCommittedItemIndexInCurrentOrRestoredSession();
   if (index == -1) {
-    DCHECK_EQ(0, GetItemCount());
+    DCHECK_EQ(0, GetWebViewItemCount());
     return nullptr;
   }
 
   NavigationItemImpl* last_committed_item =
-      GetNavigationItemImplAtIndex(static_cast<size_t>(index));
+      GetWebViewItemImplAtIndex(static_cast<size_t>(index));
   if (last_committed_item && GetWebState() &&
       !CanTrustLastCommittedItem(last_committed_item)) {
     // Don't check trust level here, as at this point it's expected
@@ -1078,6 +1289,34 @@ int NavigationManagerImpl::GetLastCommittedItemIndexInCurrentOrRestoredSession()
 
 NavigationItemImpl* NavigationManagerImpl::GetNavigationItemImplAtIndex(
     size_t index) const {
+  const size_t deferred_back_item_count = deferred_back_items_.size();
+  if (index < deferred_back_item_count) {
+    return static_cast<NavigationItemImpl*>(deferred_back_items_[index].get());
+  }
+  index -= deferred_back_item_count;
+
+  const size_t web_view_item_count = GetWebViewItemCount();
+  if (index < web_view_item_count)
+    return GetWebViewItemImplAtIndex(index);
+  index -= web_view_item_count;
+
+  if (index < deferred_forward_items_.size()) {
+    return static_cast<NavigationItemImpl*>(
+        deferred_forward_items_[index].get());
+  }
+  return nullptr;
+}
+
+int NavigationManagerImpl::GetWebViewItemCount() const {
+  if (empty_window_open_item_) {
+    return 1;
+  }
+
+  return web_view_cache_.GetBackForwardListItemCount();
+}
+
+NavigationItemImpl* NavigationManagerImpl::GetWebViewItemImplAtIndex(
+    size_t index) const {
   if (empty_window_open_item_) {
     // Return nullptr for index != 0 instead of letting the code fall through
     // (which in most cases will return null anyways because wk_item should be
@@ -1283,7 +1522,7 @@ NavigationItem* NavigationManagerImpl::GetLastCommittedItemWithUserAgentType()
     const {
   for (int index = GetLastCommittedItemIndexInCurrentOrRestoredSession();
        index >= 0; index--) {
-    NavigationItem* item = GetItemAtIndex(index);
+    NavigationItem* item = GetWebViewItemImplAtIndex(index);
     if (wk_navigation_util::URLNeedsUserAgentType(item->GetURL())) {
       DCHECK_NE(item->GetUserAgentType(), UserAgentType::NONE);
       return item;
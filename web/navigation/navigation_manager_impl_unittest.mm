@@ -2724,6 +2724,131 @@ TEST_F(NavigationManagerTest, RestoreSessionWithEmptyHistory) {
   ASSERT_EQ(nullptr, manager_->GetPendingItem());
 }
 
+namespace {
+
+// Returns a session history of 3 items for the lazy restore tests.
+std::vector<std::unique_ptr<NavigationItem>> CreateLazyRestoreItems() {
+  std::vector<std::unique_ptr<NavigationItem>> items;
+  for (const char* spec :
+       {"http://www.0.com/", "http://www.1.com/", "http://www.2.com/"}) {
+    auto item = std::make_unique<NavigationItemImpl>();
+    item->SetURL(GURL(spec));
+    items.push_back(std::move(item));
+  }
+  return items;
+}
+
+}  // namespace
+
+// Tests that a lazy restore loads the last committed item directly and defers
+// the rest of the session.
+TEST_F(NavigationManagerTest, LazyRestoreLoadsLastCommittedItem) {
+  feature_.InitAndEnableFeature(features::kLazySessionRestore);
+  EXPECT_CALL(delegate_, LoadCurrentItem(testing::_));
+  manager_->Restore(1 /* last_committed_item_index */,
+                    CreateLazyRestoreItems());
+  EXPECT_FALSE(manager_->IsRestoreSessionInProgress());
+
+  NavigationItem* pending_item = manager_->GetPendingItem();
+  ASSERT_TRUE(pending_item);
+  EXPECT_EQ("http://www.1.com/", pending_item->GetURL());
+
+  [mock_wk_list_ setCurrentURL:@"http://www.1.com/"];
+  manager_->CommitPendingItem();
+
+  EXPECT_EQ(3, manager_->GetItemCount());
+  EXPECT_EQ(1, manager_->GetLastCommittedItemIndex());
+  EXPECT_TRUE(manager_->CanGoBack());
+  EXPECT_TRUE(manager_->CanGoForward());
+  EXPECT_FALSE(manager_->CanGoToOffset(-2));
+  EXPECT_FALSE(manager_->CanGoToOffset(2));
+  histogram_tester_.ExpectTotalCount(kLazyRestoreSessionTimeToFirstCommit, 1);
+  histogram_tester_.ExpectTotalCount(kRestoreSessionTimeToFirstCommit, 0);
+}
+
+// Tests that the deferred items of a lazy restore are exposed through the
+// NavigationManager API, e.g. to the back-forward history menu and to sync.
+TEST_F(NavigationManagerTest, LazyRestoreExposesDeferredItems) {
+  feature_.InitAndEnableFeature(features::kLazySessionRestore);
+  manager_->Restore(1 /* last_committed_item_index */,
+                    CreateLazyRestoreItems());
+  [mock_wk_list_ setCurrentURL:@"http://www.1.com/"];
+  manager_->CommitPendingItem();
+
+  ASSERT_EQ(3, manager_->GetItemCount());
+  EXPECT_EQ("http://www.0.com/", manager_->GetItemAtIndex(0)->GetURL());
+  EXPECT_EQ("http://www.1.com/", manager_->GetItemAtIndex(1)->GetURL());
+  EXPECT_EQ("http://www.2.com/", manager_->GetItemAtIndex(2)->GetURL());
+  EXPECT_FALSE(manager_->GetItemAtIndex(3));
+  EXPECT_EQ(manager_->GetLastCommittedItem(), manager_->GetItemAtIndex(1));
+
+  NavigationItemList back_items = manager_->GetBackwardItems();
+  ASSERT_EQ(1U, back_items.size());
+  EXPECT_EQ("http://www.0.com/", back_items[0]->GetURL());
+  EXPECT_EQ(0, manager_->GetIndexOfItem(back_items[0]));
+
+  NavigationItemList forward_items = manager_->GetForwardItems();
+  ASSERT_EQ(1U, forward_items.size());
+  EXPECT_EQ("http://www.2.com/", forward_items[0]->GetURL());
+  EXPECT_EQ(2, manager_->GetIndexOfItem(forward_items[0]));
+
+  // Selecting a back item in the history menu replays the whole session.
+  EXPECT_CALL(delegate_, RecordPageStateInNavigationItem());
+  EXPECT_CALL(delegate_, ClearDialogs());
+  manager_->GoToIndex(manager_->GetIndexOfItem(back_items[0]));
+  EXPECT_TRUE(manager_->IsRestoreSessionInProgress());
+}
+
+// Tests that navigating to a deferred item replays the whole session.
+TEST_F(NavigationManagerTest, LazyRestoreMaterializesDeferredItems) {
+  feature_.InitAndEnableFeature(features::kLazySessionRestore);
+  manager_->Restore(1 /* last_committed_item_index */,
+                    CreateLazyRestoreItems());
+  [mock_wk_list_ setCurrentURL:@"http://www.1.com/"];
+  manager_->CommitPendingItem();
+
+  EXPECT_CALL(delegate_, RecordPageStateInNavigationItem());
+  EXPECT_CALL(delegate_, ClearDialogs());
+  manager_->GoBack();
+  EXPECT_TRUE(manager_->IsRestoreSessionInProgress());
+
+  NavigationItem* pending_item =
+      manager_->GetPendingItemInCurrentOrRestoredSession();
+  ASSERT_TRUE(pending_item);
+  GURL pending_url = pending_item->GetURL();
+  EXPECT_EQ("restore_session.html", pending_url.ExtractFileName());
+  EXPECT_EQ("{\"offset\":-2,\"titles\":[\"\",\"\",\"\"],"
+            "\"urls\":[\"http://www.0.com/\",\"http://www.1.com/\","
+            "\"http://www.2.com/\"]}",
+            ExtractRestoredSession(pending_url));
+  histogram_tester_.ExpectUniqueSample(kLazyRestoreMaterializedItemCount, 2,
+                                       1);
+}
+
+// Tests that a new navigation from a lazily restored item drops its deferred
+// forward history but keeps the deferred back history.
+TEST_F(NavigationManagerTest, LazyRestoreDropsForwardItemsOnNewNavigation) {
+  feature_.InitAndEnableFeature(features::kLazySessionRestore);
+  manager_->Restore(1 /* last_committed_item_index */,
+                    CreateLazyRestoreItems());
+  [mock_wk_list_ setCurrentURL:@"http://www.1.com/"];
+  manager_->CommitPendingItem();
+
+  manager_->AddPendingItem(GURL("http://www.3.com/"), Referrer(),
+                           ui::PAGE_TRANSITION_TYPED,
+                           web::NavigationInitiationType::BROWSER_INITIATED,
+                           /*is_post_navigation=*/false,
+                           /*is_using_https_as_default_scheme=*/false);
+  [mock_wk_list_ setCurrentURL:@"http://www.3.com/"
+                  backListURLs:@[ @"http://www.1.com/" ]
+               forwardListURLs:nil];
+  manager_->CommitPendingItem();
+
+  EXPECT_FALSE(manager_->CanGoForward());
+  EXPECT_TRUE(manager_->CanGoToOffset(-2));
+  EXPECT_FALSE(manager_->CanGoToOffset(-3));
+}
+
 // Tests that the virtual URL of a restore_session redirect item is updated to
 // the target URL.
 TEST_F(NavigationManagerTest, HideInternalRedirectUrl) {
@@ -5,6 +5,7 @@
 #import "ios/web/navigation/session_storage_builder.h"
 
 #include <memory>
+#include <vector>
 
 #include "base/check_op.h"
 #include "base/mac/foundation_util.h"
@@ -34,23 +35,16 @@ CRWSessionStorage* SessionStorageBuilder::BuildStorage(
   DCHECK(navigation_manager);
   CRWSessionStorage* session_storage = [[CRWSessionStorage alloc] init];
   session_storage.hasOpener = web_state->HasOpener();
-  session_storage.lastCommittedItemIndex =
-      navigation_manager->GetLastCommittedItemIndex();
-  if (session_storage.lastCommittedItemIndex == -1) {
-    // This can happen when a session is saved during restoration. Instead,
-    // default to GetItemCount() - 1.
-    session_storage.lastCommittedItemIndex =
-        navigation_manager->GetItemCount() - 1;
-  }
+  int last_committed_item_index = -1;
+  std::vector<web::NavigationItemImpl*> items =
+      navigation_manager->GetItemsForSerialization(&last_committed_item_index);
+  session_storage.lastCommittedItemIndex = last_committed_item_index;
   NSMutableArray* item_storages = [[NSMutableArray alloc] init];
   NavigationItemStorageBuilder item_storage_builder;
   size_t originalIndex = session_storage.lastCommittedItemIndex;
   // Drop URLs larger than a certain threshold.
-  for (size_t index = 0;
-       index < static_cast<size_t>(navigation_manager->GetItemCount());
-       ++index) {
-    web::NavigationItemImpl* item =
-        navigation_manager->GetNavigationItemImplAtIndex(index);
+  for (size_t index = 0; index < items.size(); ++index) {
+    web::NavigationItemImpl* item = items[index];
     if (item->ShouldSkipSerialization() ||
         item->GetURL().spec().size() > url::kMaxURLChars) {
       if (index <= originalIndex) {
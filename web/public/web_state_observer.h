@@ -6,6 +6,7 @@
 #define IOS_WEB_PUBLIC_WEB_STATE_OBSERVER_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <string>
 #include <vector>
@@ -25,8 +26,61 @@ enum class PageLoadCompletionStatus : bool { SUCCESS = 0, FAILURE = 1 };
 // load events from WebState.
 class WebStateObserver {
  public:
+  // Events dispatched by WebState to its observers. WebStateDestroyed() is not
+  // listed because it is sent to all observers.
+  enum class Event {
+    kWasShown = 0,
+    kWasHidden,
+    kDidStartNavigation,
+    kDidRedirectNavigation,
+    kDidFinishNavigation,
+    kDidStartLoading,
+    kDidStopLoading,
+    kPageLoaded,
+    kLoadProgressChanged,
+    kDidChangeBackForwardState,
+    kTitleWasSet,
+    kDidChangeVisibleSecurityState,
+    kFaviconUrlUpdated,
+    kWebFrameDidBecomeAvailable,
+    kWebFrameWillBecomeUnavailable,
+    kRenderProcessGone,
+    kMaxValue = kRenderProcessGone,
+  };
+
+  // Number of values in Event.
+  static constexpr size_t kEventCount =
+      static_cast<size_t>(Event::kMaxValue) + 1;
+
+  // Bit mask of Events, as returned by GetObservedEvents().
+  using EventMask = uint32_t;
+  static constexpr EventMask kAllEvents = (1u << kEventCount) - 1;
+
+  // Returns the bit of |event| in an EventMask.
+  static constexpr EventMask EventBit(Event event) {
+    return 1u << static_cast<size_t>(event);
+  }
+
+  // Events that can be throttled, see GetThrottledEvents().
+  static constexpr EventMask kThrottleableEvents =
+      EventBit(Event::kLoadProgressChanged) | EventBit(Event::kTitleWasSet);
+
   virtual ~WebStateObserver();
 
+  // Returns the events this observer wants to be notified of. WebState only
+  // dispatches the other events to the observers that need them, which matters
+  // for frequent events such as LoadProgressChanged(). The value is read when
+  // the observer is added and must not change while it is observing.
+  virtual EventMask GetObservedEvents() const;
+
+  // Returns the events among kThrottleableEvents for which this observer only
+  // needs the latest state. When the ThrottleWebStateObserverUpdates feature is
+  // enabled, those events are delivered at most once per display frame, and
+  // the update completing a load is always delivered. Returns 0 by default, as
+  // most observers need every update. The value is read when the observer is
+  // added and must not change while it is observing.
+  virtual EventMask GetThrottledEvents() const;
+
   // These methods are invoked every time the WebState changes visibility.
   virtual void WasShown(WebState* web_state) {}
   virtual void WasHidden(WebState* web_state) {}
@@ -73,6 +73,10 @@
 // Invoked by WebStateObserverBridge::DidStartLoading.
 - (void)webStateDidStartLoading:(web::WebState*)webState;
 
+// Invoked by WebStateObserverBridge::GetThrottledEvents. Observers which only
+// display the latest progress or title can return them here.
+- (web::WebStateObserver::EventMask)throttledWebStateEvents;
+
 @end
 
 namespace web {
@@ -86,6 +90,7 @@ class WebStateObserverBridge : public web::WebStateObserver {
   ~WebStateObserverBridge() override;
 
   // web::WebStateObserver methods.
+  EventMask GetThrottledEvents() const override;
   void WasShown(web::WebState* web_state) override;
   void WasHidden(web::WebState* web_state) override;
   void DidStartNavigation(web::WebState* web_state,
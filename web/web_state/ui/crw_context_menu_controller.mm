@@ -4,6 +4,13 @@
 
 #import "ios/web/web_state/ui/crw_context_menu_controller.h"
 
+#import <UIKit/UIGestureRecognizerSubclass.h>
+
+#include "base/feature_list.h"
+#include "base/ios/block_types.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/time/time.h"
+#include "ios/web/common/features.h"
 #import "ios/web/js_features/context_menu/context_menu_params_utils.h"
 #import "ios/web/public/ui/context_menu_params.h"
 #import "ios/web/public/web_state.h"
@@ -18,6 +25,60 @@ namespace {
 const CGFloat kJavaScriptTimeout = 1;
 }  // namespace
 
+// Gesture recognizer reporting when a single touch starts and ends in its view.
+// It never recognizes a gesture, and does not delay or cancel the touches.
+@interface CRWTouchTrackingGestureRecognizer : UIGestureRecognizer
+
+// Called with the location of the touch in the view when it starts.
+@property(nonatomic, copy) void (^touchStartedHandler)(CGPoint location);
+
+// Called when the touch ends, is cancelled, or is joined by other touches.
+@property(nonatomic, copy) ProceduralBlock touchEndedHandler;
+
+@end
+
+@implementation CRWTouchTrackingGestureRecognizer
+
+- (instancetype)initWithTarget:(id)target action:(SEL)action {
+  self = [super initWithTarget:target action:action];
+  if (self) {
+    self.cancelsTouchesInView = NO;
+    self.delaysTouchesBegan = NO;
+    self.delaysTouchesEnded = NO;
+  }
+  return self;
+}
+
+- (void)touchesBegan:(NSSet<UITouch*>*)touches withEvent:(UIEvent*)event {
+  [super touchesBegan:touches withEvent:event];
+  if (self.numberOfTouches == 1 && touches.count == 1) {
+    if (self.touchStartedHandler)
+      self.touchStartedHandler([touches.anyObject locationInView:self.view]);
+    return;
+  }
+  [self touchEnded];
+}
+
+- (void)touchesEnded:(NSSet<UITouch*>*)touches withEvent:(UIEvent*)event {
+  [super touchesEnded:touches withEvent:event];
+  [self touchEnded];
+}
+
+- (void)touchesCancelled:(NSSet<UITouch*>*)touches withEvent:(UIEvent*)event {
+  [super touchesCancelled:touches withEvent:event];
+  [self touchEnded];
+}
+
+#pragma mark - Private
+
+- (void)touchEnded {
+  if (self.touchEndedHandler)
+    self.touchEndedHandler();
+  self.state = UIGestureRecognizerStateFailed;
+}
+
+@end
+
 @interface CRWContextMenuController () <UIContextMenuInteractionDelegate>
 
 @property(nonatomic, assign) web::ContextMenuParams params;
@@ -37,9 +98,20 @@ const CGFloat kJavaScriptTimeout = 1;
 
 @property(nonatomic, strong) CRWContextMenuElementFetcher* elementFetcher;
 
+// Recognizer starting a speculative fetch of the element under a touch, as it
+// may become a long press.
+@property(nonatomic, strong)
+    CRWTouchTrackingGestureRecognizer* touchTrackingRecognizer;
+
 @end
 
-@implementation CRWContextMenuController
+@implementation CRWContextMenuController {
+  // Time at which the last touch started.
+  base::TimeTicks _touchStartTime;
+  // Whether a speculative fetch was started for the current touch and was not
+  // used to build a menu yet.
+  BOOL _speculativeFetchStarted;
+}
 
 @synthesize highlightView = _highlightView;
 @synthesize dismissView = _dismissView;
@@ -58,6 +130,18 @@ const CGFloat kJavaScriptTimeout = 1;
     _elementFetcher =
         [[CRWContextMenuElementFetcher alloc] initWithWebView:webView
                                                      webState:webState];
+
+    __weak __typeof(self) weakSelf = self;
+    _touchTrackingRecognizer =
+        [[CRWTouchTrackingGestureRecognizer alloc] initWithTarget:nil
+                                                           action:nil];
+    _touchTrackingRecognizer.touchStartedHandler = ^(CGPoint location) {
+      [weakSelf touchStartedAtLocation:location];
+    };
+    _touchTrackingRecognizer.touchEndedHandler = ^{
+      [weakSelf touchEnded];
+    };
+    [webView addGestureRecognizer:_touchTrackingRecognizer];
   }
   return self;
 }
@@ -84,6 +168,33 @@ const CGFloat kJavaScriptTimeout = 1;
   return _dismissView;
 }
 
+#pragma mark - Private
+
+// Called when a touch starts at |location| in the web view.
+- (void)touchStartedAtLocation:(CGPoint)location {
+  _touchStartTime = base::TimeTicks::Now();
+  if (!base::FeatureList::IsEnabled(
+          web::features::kSpeculativeContextMenuHitTest)) {
+    return;
+  }
+  // Start the hit test now, so its result is likely available by the time the
+  // touch is recognized as a long press.
+  _speculativeFetchStarted = YES;
+  [self.elementFetcher
+      startSpeculativeFetchAtPoint:[self.webView.scrollView
+                                       convertPoint:location
+                                           fromView:self.webView]];
+}
+
+// Called when the touch ends or is cancelled.
+- (void)touchEnded {
+  if (!_speculativeFetchStarted)
+    return;
+  // The touch ended without becoming a long press.
+  _speculativeFetchStarted = NO;
+  [self.elementFetcher cancelSpeculativeFetch];
+}
+
 #pragma mark - UIContextMenuInteractionDelegate
 
 - (UIContextMenuConfiguration*)contextMenuInteraction:
@@ -92,6 +203,10 @@ const CGFloat kJavaScriptTimeout = 1;
   CGPoint locationInWebView =
       [self.webView.scrollView convertPoint:location fromView:interaction.view];
 
+  // The speculative fetch, if any, is used or discarded by the fetch below. It
+  // must not be cancelled when the touches are cancelled for the menu.
+  _speculativeFetchStarted = NO;
+
   // While traditionally using dispatch_async would be used here, we have to
   // instead use CFRunLoop because dispatch_async blocks the thread. As this
   // function is called by iOS when it detects the user's force touch, it is on
@@ -162,6 +277,17 @@ const CGFloat kJavaScriptTimeout = 1;
   return configuration;
 }
 
+- (void)contextMenuInteraction:(UIContextMenuInteraction*)interaction
+    willDisplayMenuForConfiguration:(UIContextMenuConfiguration*)configuration
+                           animator:
+                               (id<UIContextMenuInteractionAnimating>)animator {
+  if (_touchStartTime.is_null())
+    return;
+  base::UmaHistogramTimes("IOS.ContextMenu.TouchToMenuLatency",
+                          base::TimeTicks::Now() - _touchStartTime);
+  _touchStartTime = base::TimeTicks();
+}
+
 - (UITargetedPreview*)contextMenuInteraction:
                           (UIContextMenuInteraction*)interaction
     previewForHighlightingMenuWithConfiguration:
@@ -28,6 +28,15 @@ class WebState;
 // Cancels all the fetches current in progress.
 - (void)cancelFetches;
 
+// Starts fetching information about the DOM element at |point| (in the scroll
+// view coordinates), ahead of a likely call to |fetchDOMElementAtPoint:| for
+// the same point. That call then completes as soon as the information is
+// available, unless the DOM changed in between.
+- (void)startSpeculativeFetchAtPoint:(CGPoint)point;
+
+// Discards the information fetched by |startSpeculativeFetchAtPoint:|.
+- (void)cancelSpeculativeFetch;
+
 @end
 
 #endif  // IOS_WEB_WEB_STATE_UI_CRW_CONTEXT_MENU_ELEMENT_FETCHER_H_
@@ -51,8 +51,10 @@
 }
 
 - (void)dealloc {
-  if (self.webState)
+  if (self.webState) {
+    [self cancelSpeculativeFetch];
     self.webState->RemoveObserver(_observer.get());
+  }
 }
 
 - (void)fetchDOMElementAtPoint:(CGPoint)point
@@ -94,6 +96,25 @@
   }
 }
 
+- (void)startSpeculativeFetchAtPoint:(CGPoint)point {
+  if (!self.webState) {
+    return;
+  }
+  web::ContextMenuJavaScriptFeature::FromBrowserState(
+      self.webState->GetBrowserState())
+      ->StartSpeculativeFetch(self.webState, point,
+                              self.webView.scrollView.contentSize);
+}
+
+- (void)cancelSpeculativeFetch {
+  if (!self.webState) {
+    return;
+  }
+  web::ContextMenuJavaScriptFeature::FromBrowserState(
+      self.webState->GetBrowserState())
+      ->CancelSpeculativeFetch(self.webState);
+}
+
 #pragma mark - Private
 
 - (void)elementDetailsReceived:(web::ContextMenuParams&)params
@@ -116,8 +137,10 @@
 #pragma mark - CRWWebStateObserver
 
 - (void)webStateDestroyed:(web::WebState*)webState {
-  if (self.webState)
+  if (self.webState) {
+    [self cancelSpeculativeFetch];
     self.webState->RemoveObserver(_observer.get());
+  }
   self.webState = nullptr;
 }
 
@@ -1527,12 +1527,17 @@ typedef void (^ViewportStateCompletion)(const web::PageViewportState*);
 
 // Creates a web view if it's not yet created.
 - (WKWebView*)ensureWebViewCreated {
+  if (base::FeatureList::IsEnabled(web::features::kWebViewPool)) {
+    // A nil configuration lets the web view be taken from the pool.
+    return [self ensureWebViewCreatedWithConfiguration:nil];
+  }
   WKWebViewConfiguration* config =
       [self webViewConfigurationProvider].GetWebViewConfiguration();
   return [self ensureWebViewCreatedWithConfiguration:config];
 }
 
-// Creates a web view with given |config|. No-op if web view is already created.
+// Creates a web view with given |config|, or with the configuration of the
+// browser state if |config| is nil. No-op if web view is already created.
 - (WKWebView*)ensureWebViewCreatedWithConfiguration:
     (WKWebViewConfiguration*)config {
   if (!self.webView) {
@@ -1593,7 +1598,9 @@ typedef void (^ViewportStateCompletion)(const web::PageViewportState*);
   return self.webView;
 }
 
-// Returns a new autoreleased web view created with given configuration.
+// Returns a new autoreleased web view created with given configuration. If
+// |config| is nil, the web view is created with the configuration of the
+// browser state and may be taken from the pool of web views.
 - (WKWebView*)webViewWithConfiguration:(WKWebViewConfiguration*)config {
   // Do not attach the context menu controller immediately as the JavaScript
   // delegate must be specified.
@@ -1609,9 +1616,13 @@ typedef void (^ViewportStateCompletion)(const web::PageViewportState*);
         web::GetWebClient()->GetDefaultUserAgent(_containerView, GURL());
   }
 
-  return web::BuildWKWebView(CGRectZero, config,
-                             self.webStateImpl->GetBrowserState(),
-                             userAgentType, self);
+  web::BrowserState* browserState = self.webStateImpl->GetBrowserState();
+  if (!config) {
+    return web::BuildPooledWKWebView(CGRectZero, browserState, userAgentType,
+                                     self);
+  }
+  return web::BuildWKWebView(CGRectZero, config, browserState, userAgentType,
+                             self);
 }
 
 // Wraps the web view in a CRWWebViewContentView and adds it to the container
@@ -5,19 +5,25 @@
 #ifndef IOS_WEB_WEB_STATE_UI_WK_WEB_VIEW_CONFIGURATION_PROVIDER_H_
 #define IOS_WEB_WEB_STATE_UI_WK_WEB_VIEW_CONFIGURATION_PROVIDER_H_
 
+#include <memory>
+#include <vector>
+
 #include "base/macros.h"
 #include "base/observer_list.h"
 #include "base/supports_user_data.h"
 
 @class CRWWebUISchemeHandler;
 @class CRWWKScriptMessageRouter;
+@class WKUserContentController;
 @class WKWebViewConfiguration;
 
 namespace web {
 
 class BrowserState;
+class JavaScriptFeature;
 class WKContentRuleListProvider;
 class WKWebViewConfigurationProviderObserver;
+class WKWebViewPool;
 
 // A provider class associated with a single web::BrowserState object. Manages
 // the lifetime and performs setup of WKWebViewConfiguration and
@@ -36,7 +42,10 @@ class WKWebViewConfigurationProvider : public base::SupportsUserData::Data {
   // using the given |configuration|. First |configuration| is shallow cloned
   // and then Chrome's configuration initialization logic will be applied to
   // make it work for //ios/web. If |configuration| is nil, a new
-  // WKWebViewConfiguration object will be created and set.
+  // WKWebViewConfiguration object will be created and set, and it reuses the
+  // WKUserContentController of the previous configuration if
+  // kSharedUserContentController is enabled and the JavaScriptFeatures did not
+  // change.
   //
   // WARNING: This method should NOT be used
   // for any |configuration| that is originated from a //ios/web managed
@@ -68,15 +77,21 @@ class WKWebViewConfigurationProvider : public base::SupportsUserData::Data {
   // Callers must not retain the returned object.
   WKContentRuleListProvider* GetContentRuleListProvider();
 
+  // Returns the pool of web views created with the configuration associated
+  // with browser state. The pool is cleared when the configuration is purged.
+  WKWebViewPool& GetWebViewPool();
+
   // Recreates and re-adds all injected Javascript into the current
   // configuration. This will only affect WebStates that are loaded after a call
   // to this function. All current WebStates will keep their existing Javascript
   // until a reload.
   void UpdateScripts();
 
-  // Purges config and router objects if they exist. When this method is called
-  // config and config's process pool must not be retained by anyone (this will
-  // be enforced in debug builds).
+  // Purges config and router objects if they exist, and clears the pool of
+  // web views. The router is kept along with the shared user content
+  // controller if there is one. When this method is called config and config's
+  // process pool must not be retained by anyone (this will be enforced in debug
+  // builds).
   void Purge();
 
   // Adds |observer| to monitor changes to the ConfigurationProvider.
@@ -88,11 +103,21 @@ class WKWebViewConfigurationProvider : public base::SupportsUserData::Data {
  private:
   explicit WKWebViewConfigurationProvider(BrowserState* browser_state);
   WKWebViewConfigurationProvider() = delete;
+
+  // Returns the JavaScriptFeatures whose scripts are added to the user content
+  // controller.
+  std::vector<JavaScriptFeature*> GetJavaScriptFeatures();
+
   CRWWebUISchemeHandler* scheme_handler_ = nil;
   WKWebViewConfiguration* configuration_ = nil;
   CRWWKScriptMessageRouter* router_;
   BrowserState* browser_state_;
   std::unique_ptr<WKContentRuleListProvider> content_rule_list_provider_;
+  std::unique_ptr<WKWebViewPool> web_view_pool_;
+  // The user content controller set up with |shared_features_|, which is kept
+  // across Purge() when kSharedUserContentController is enabled.
+  WKUserContentController* shared_user_content_controller_ = nil;
+  std::vector<JavaScriptFeature*> shared_features_;
 
   // A list of observers notified when WKWebViewConfiguration changes.
   // This observer list has its' check_empty flag set to false, because
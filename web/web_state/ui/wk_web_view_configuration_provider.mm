@@ -6,13 +6,16 @@
 
 #import <Foundation/Foundation.h>
 #import <WebKit/WebKit.h>
+#include <utility>
 #include <vector>
 
 #include "base/check.h"
 #include "base/ios/ios_util.h"
 #include "base/memory/ptr_util.h"
+#include "base/metrics/histogram_macros.h"
 #include "base/notreached.h"
 #include "base/strings/sys_string_conversions.h"
+#include "base/timer/elapsed_timer.h"
 #include "components/safe_browsing/core/features.h"
 #include "ios/web/common/features.h"
 #import "ios/web/js_messaging/crw_wk_script_message_router.h"
@@ -23,6 +26,7 @@
 #include "ios/web/public/web_client.h"
 #import "ios/web/web_state/ui/wk_content_rule_list_provider.h"
 #import "ios/web/web_state/ui/wk_web_view_configuration_provider_observer.h"
+#import "ios/web/web_state/ui/wk_web_view_pool.h"
 #import "ios/web/webui/crw_web_ui_scheme_handler.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
@@ -86,16 +90,22 @@ WKWebViewConfigurationProvider::WKWebViewConfigurationProvider(
     BrowserState* browser_state)
     : browser_state_(browser_state),
       content_rule_list_provider_(
-          std::make_unique<WKContentRuleListProvider>(browser_state)) {}
+          std::make_unique<WKContentRuleListProvider>(browser_state)),
+      web_view_pool_(std::make_unique<WKWebViewPool>()) {}
 
 WKWebViewConfigurationProvider::~WKWebViewConfigurationProvider() = default;
 
 void WKWebViewConfigurationProvider::ResetWithWebViewConfiguration(
     WKWebViewConfiguration* configuration) {
   DCHECK([NSThread isMainThread]);
+  base::ElapsedTimer timer;
 
+  bool reuse_user_content_controller = false;
   if (!configuration) {
     configuration = [[WKWebViewConfiguration alloc] init];
+    reuse_user_content_controller =
+        shared_user_content_controller_ &&
+        shared_features_ == GetJavaScriptFeatures();
   } else {
     configuration = [configuration copy];
   }
@@ -138,7 +148,13 @@ void WKWebViewConfigurationProvider::ResetWithWebViewConfiguration(
   [configuration_ setAllowsInlineMediaPlayback:YES];
   // setJavaScriptCanOpenWindowsAutomatically is required to support popups.
   [[configuration_ preferences] setJavaScriptCanOpenWindowsAutomatically:YES];
-  UpdateScripts();
+  if (reuse_user_content_controller) {
+    // The scripts and the script message handlers of the features are already
+    // set up in the shared user content controller.
+    configuration_.userContentController = shared_user_content_controller_;
+  } else {
+    UpdateScripts();
+  }
 
   if (!scheme_handler_) {
     scoped_refptr<network::SharedURLLoaderFactory> shared_loader_factory =
@@ -168,6 +184,11 @@ void WKWebViewConfigurationProvider::ResetWithWebViewConfiguration(
       fetchDataRecordsOfTypes:data_types
             completionHandler:^(NSArray<WKWebsiteDataRecord*>* records){
             }];
+
+  UMA_HISTOGRAM_TIMES("IOS.WKWebViewConfiguration.ResetTime", timer.Elapsed());
+  UMA_HISTOGRAM_BOOLEAN(
+      "IOS.WKWebViewConfiguration.UserContentControllerReused",
+      reuse_user_content_controller);
 }
 
 WKWebViewConfiguration*
@@ -185,9 +206,11 @@ WKWebViewConfigurationProvider::GetWebViewConfiguration() {
 CRWWKScriptMessageRouter*
 WKWebViewConfigurationProvider::GetScriptMessageRouter() {
   DCHECK([NSThread isMainThread]);
-  if (!router_) {
-    WKUserContentController* userContentController =
-        [GetWebViewConfiguration() userContentController];
+  WKUserContentController* userContentController =
+      [GetWebViewConfiguration() userContentController];
+  // A router kept across Purge() is only valid while its user content
+  // controller is reused.
+  if (!router_ || router_.userContentController != userContentController) {
     router_ = [[CRWWKScriptMessageRouter alloc]
         initWithUserContentController:userContentController];
   }
@@ -199,21 +222,22 @@ WKWebViewConfigurationProvider::GetContentRuleListProvider() {
   return content_rule_list_provider_.get();
 }
 
+WKWebViewPool& WKWebViewConfigurationProvider::GetWebViewPool() {
+  return *web_view_pool_;
+}
+
 void WKWebViewConfigurationProvider::UpdateScripts() {
+  if (!configuration_) {
+    // The scripts are set up in the next configuration, which must not reuse
+    // the outdated scripts of the shared user content controller.
+    shared_user_content_controller_ = nil;
+  }
   [configuration_.userContentController removeAllUserScripts];
 
   JavaScriptFeatureManager* java_script_feature_manager =
       JavaScriptFeatureManager::FromBrowserState(browser_state_);
 
-  std::vector<JavaScriptFeature*> features;
-  for (JavaScriptFeature* feature :
-       java_script_features::GetBuiltInJavaScriptFeatures(browser_state_)) {
-    features.push_back(feature);
-  }
-  for (JavaScriptFeature* feature :
-       GetWebClient()->GetJavaScriptFeatures(browser_state_)) {
-    features.push_back(feature);
-  }
+  std::vector<JavaScriptFeature*> features = GetJavaScriptFeatures();
   java_script_feature_manager->ConfigureFeatures(features);
 
   // Main frame script depends upon scripts injected into all frames, so the
@@ -224,12 +248,36 @@ void WKWebViewConfigurationProvider::UpdateScripts() {
       addUserScript:InternalGetDocumentStartScriptForMainFrame(browser_state_)];
   [configuration_.userContentController
       addUserScript:InternalGetDocumentEndScriptForAllFrames(browser_state_)];
+
+  if (base::FeatureList::IsEnabled(features::kSharedUserContentController)) {
+    shared_user_content_controller_ = configuration_.userContentController;
+    shared_features_ = std::move(features);
+  }
 }
 
 void WKWebViewConfigurationProvider::Purge() {
   DCHECK([NSThread isMainThread]);
+  // The pooled web views hold the configuration and its process pool.
+  web_view_pool_->Clear();
   configuration_ = nil;
-  router_ = nil;
+  // The script message handlers of the router are registered with the shared
+  // user content controller, which would reject a new router.
+  if (!shared_user_content_controller_)
+    router_ = nil;
+}
+
+std::vector<JavaScriptFeature*>
+WKWebViewConfigurationProvider::GetJavaScriptFeatures() {
+  std::vector<JavaScriptFeature*> features;
+  for (JavaScriptFeature* feature :
+       java_script_features::GetBuiltInJavaScriptFeatures(browser_state_)) {
+    features.push_back(feature);
+  }
+  for (JavaScriptFeature* feature :
+       GetWebClient()->GetJavaScriptFeatures(browser_state_)) {
+    features.push_back(feature);
+  }
+  return features;
 }
 
 void WKWebViewConfigurationProvider::AddObserver(
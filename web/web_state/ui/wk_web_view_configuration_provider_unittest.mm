@@ -7,6 +7,8 @@
 #import <WebKit/WebKit.h>
 
 #include "base/memory/ptr_util.h"
+#include "base/test/scoped_feature_list.h"
+#include "ios/web/common/features.h"
 #import "ios/web/js_messaging/crw_wk_script_message_router.h"
 #import "ios/web/js_messaging/page_script_util.h"
 #import "ios/web/public/js_messaging/java_script_feature.h"
@@ -289,6 +291,53 @@ TEST_F(WKWebViewConfigurationProviderTest, ResetConfiguration) {
   EXPECT_NE(config, actual);
 }
 
+// Tests that the user content controller and the script message router are
+// reused by the configuration created after |Purge| when
+// kSharedUserContentController is enabled.
+TEST_F(WKWebViewConfigurationProviderTest, SharedUserContentController) {
+  base::test::ScopedFeatureList scoped_feature_list;
+  scoped_feature_list.InitAndEnableFeature(
+      features::kSharedUserContentController);
+
+  WKWebViewConfiguration* config = GetProvider().GetWebViewConfiguration();
+  WKUserContentController* user_content_controller =
+      config.userContentController;
+  NSUInteger script_count = user_content_controller.userScripts.count;
+  CRWWKScriptMessageRouter* router = GetProvider().GetScriptMessageRouter();
+
+  GetProvider().Purge();
+  WKWebViewConfiguration* new_config = GetProvider().GetWebViewConfiguration();
+  EXPECT_NE(config.processPool, new_config.processPool);
+  EXPECT_EQ(user_content_controller, new_config.userContentController);
+  EXPECT_EQ(script_count, new_config.userContentController.userScripts.count);
+  EXPECT_EQ(router, GetProvider().GetScriptMessageRouter());
+}
+
+// Tests that the user content controller is rebuilt after |Purge| when the
+// JavaScriptFeatures changed.
+TEST_F(WKWebViewConfigurationProviderTest,
+       SharedUserContentControllerRebuiltForNewFeatures) {
+  base::test::ScopedFeatureList scoped_feature_list;
+  scoped_feature_list.InitAndEnableFeature(
+      features::kSharedUserContentController);
+
+  WKUserContentController* user_content_controller =
+      GetProvider().GetWebViewConfiguration().userContentController;
+
+  std::unique_ptr<web::JavaScriptFeature> feature =
+      std::make_unique<web::JavaScriptFeature>(
+          web::JavaScriptFeature::ContentWorld::kPageContentWorld,
+          std::vector<const web::JavaScriptFeature::FeatureScript>());
+  GetWebClient()->SetJavaScriptFeatures({feature.get()});
+
+  GetProvider().Purge();
+  WKUserContentController* new_user_content_controller =
+      GetProvider().GetWebViewConfiguration().userContentController;
+  EXPECT_NE(user_content_controller, new_user_content_controller);
+  EXPECT_EQ(new_user_content_controller,
+            GetProvider().GetScriptMessageRouter().userContentController);
+}
+
 TEST_F(WKWebViewConfigurationProviderTest, GetContentRuleListProvider) {
   auto browser_state = std::make_unique<FakeBrowserState>();
   WKWebViewConfigurationProvider& provider = GetProvider(browser_state.get());
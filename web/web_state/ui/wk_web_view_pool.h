@@ -0,0 +1,77 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_WEB_WEB_STATE_UI_WK_WEB_VIEW_POOL_H_
+#define IOS_WEB_WEB_STATE_UI_WK_WEB_VIEW_POOL_H_
+
+#import <Foundation/Foundation.h>
+
+#include <memory>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+@class WKWebView;
+
+namespace web {
+
+// A bounded pool of web views created ahead of time with the configuration of
+// a browser state, so that realizing a WebState does not pay for the creation
+// of its web view. Web views are taken from the pool but never returned to it,
+// as a web view which displayed content keeps its back-forward list and the
+// state attached by its web controller. Not threadsafe. Must be used only on
+// the main thread.
+class WKWebViewPool {
+ public:
+  // Callback creating a web view for the pool.
+  using WebViewBuilder = base::RepeatingCallback<WKWebView*()>;
+
+  // The number of web views that the pool is filled with.
+  static const size_t kSize;
+  // Delay between taking a web view and refilling the pool, which keeps the
+  // creation of the next web view off the path of the current navigation.
+  static const base::TimeDelta kFillDelay;
+  // Delay before refilling the pool after memory pressure.
+  static const base::TimeDelta kMemoryPressureFillDelay;
+
+  WKWebViewPool();
+  ~WKWebViewPool();
+
+  // Takes a web view from the pool, or returns nil if the pool is empty, and
+  // schedules refilling the pool with web views created by |builder|. Records
+  // whether a web view was available.
+  WKWebView* TakeWebView(WebViewBuilder builder);
+
+  // Destroys the web views of the pool, e.g. when their configuration is
+  // purged. The pool is not refilled before the next call to TakeWebView().
+  void Clear();
+
+  // Returns the number of web views in the pool.
+  size_t size() const;
+
+ private:
+  // Schedules filling the pool after |delay|, unless already scheduled.
+  void ScheduleFill(base::TimeDelta delay);
+
+  // Fills the pool with web views created by |builder_|.
+  void Fill();
+
+  // Empties the pool and delays its refill under memory pressure.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
+  NSMutableArray<WKWebView*>* web_views_ = nil;
+  WebViewBuilder builder_;
+  base::OneShotTimer fill_timer_;
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
+  DISALLOW_COPY_AND_ASSIGN(WKWebViewPool);
+};
+
+}  // namespace web
+
+#endif  // IOS_WEB_WEB_STATE_UI_WK_WEB_VIEW_POOL_H_
@@ -0,0 +1,99 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/web/web_state/ui/wk_web_view_pool.h"
+
+#import <WebKit/WebKit.h>
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/check.h"
+#include "base/metrics/histogram_macros.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace web {
+
+namespace {
+// Histogram recording whether a web view was available in the pool.
+const char kWebViewPoolHitHistogram[] = "IOS.WKWebViewPool.Hit";
+}  // namespace
+
+// static
+const size_t WKWebViewPool::kSize = 1;
+// static
+const base::TimeDelta WKWebViewPool::kFillDelay =
+    base::TimeDelta::FromSeconds(2);
+// static
+const base::TimeDelta WKWebViewPool::kMemoryPressureFillDelay =
+    base::TimeDelta::FromMinutes(1);
+
+WKWebViewPool::WKWebViewPool() : web_views_([NSMutableArray array]) {
+  memory_pressure_listener_ = std::make_unique<base::MemoryPressureListener>(
+      FROM_HERE, base::BindRepeating(&WKWebViewPool::OnMemoryPressure,
+                                     base::Unretained(this)));
+}
+
+WKWebViewPool::~WKWebViewPool() = default;
+
+WKWebView* WKWebViewPool::TakeWebView(WebViewBuilder builder) {
+  DCHECK([NSThread isMainThread]);
+  DCHECK(builder);
+  builder_ = std::move(builder);
+
+  WKWebView* web_view = web_views_.firstObject;
+  UMA_HISTOGRAM_BOOLEAN(kWebViewPoolHitHistogram, web_view != nil);
+  if (web_view)
+    [web_views_ removeObjectAtIndex:0];
+
+  ScheduleFill(kFillDelay);
+  return web_view;
+}
+
+void WKWebViewPool::Clear() {
+  DCHECK([NSThread isMainThread]);
+  fill_timer_.Stop();
+  [web_views_ removeAllObjects];
+}
+
+size_t WKWebViewPool::size() const {
+  return web_views_.count;
+}
+
+void WKWebViewPool::ScheduleFill(base::TimeDelta delay) {
+  if (fill_timer_.IsRunning())
+    return;
+  fill_timer_.Start(FROM_HERE, delay,
+                    base::BindOnce(&WKWebViewPool::Fill,
+                                   base::Unretained(this)));
+}
+
+void WKWebViewPool::Fill() {
+  DCHECK(builder_);
+  while (web_views_.count < kSize) {
+    WKWebView* web_view = builder_.Run();
+    DCHECK(web_view);
+    [web_views_ addObject:web_view];
+  }
+}
+
+void WKWebViewPool::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  switch (memory_pressure_level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+      return;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      Clear();
+      // Only refill a pool which was in use, and not while the pressure lasts.
+      if (builder_)
+        ScheduleFill(kMemoryPressureFillDelay);
+      return;
+  }
+}
+
+}  // namespace web
@@ -0,0 +1,105 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/web/web_state/ui/wk_web_view_pool.h"
+
+#import <WebKit/WebKit.h>
+
+#include "base/bind.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace web {
+
+class WKWebViewPoolTest : public PlatformTest {
+ protected:
+  // Returns a builder creating bare web views and counting them.
+  WKWebViewPool::WebViewBuilder GetBuilder() {
+    return base::BindRepeating(&WKWebViewPoolTest::BuildWebView,
+                               base::Unretained(this));
+  }
+
+  WKWebView* BuildWebView() {
+    ++build_count_;
+    return [[WKWebView alloc] init];
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  WKWebViewPool pool_;
+  int build_count_ = 0;
+};
+
+// Tests that the pool is only filled after the first web view is taken, and
+// that the following web view is taken from the pool.
+TEST_F(WKWebViewPoolTest, FillsAfterFirstTake) {
+  base::HistogramTester histogram_tester;
+  EXPECT_FALSE(pool_.TakeWebView(GetBuilder()));
+  EXPECT_EQ(0U, pool_.size());
+  EXPECT_EQ(0, build_count_);
+
+  task_environment_.FastForwardBy(WKWebViewPool::kFillDelay);
+  EXPECT_EQ(WKWebViewPool::kSize, pool_.size());
+  EXPECT_EQ(static_cast<int>(WKWebViewPool::kSize), build_count_);
+
+  EXPECT_TRUE(pool_.TakeWebView(GetBuilder()));
+  histogram_tester.ExpectBucketCount("IOS.WKWebViewPool.Hit", false, 1);
+  histogram_tester.ExpectBucketCount("IOS.WKWebViewPool.Hit", true, 1);
+
+  // The pool is refilled after the web view is taken.
+  task_environment_.FastForwardBy(WKWebViewPool::kFillDelay);
+  EXPECT_EQ(WKWebViewPool::kSize, pool_.size());
+}
+
+// Tests that taking web views in a burst refills the pool once.
+TEST_F(WKWebViewPoolTest, CoalescesFills) {
+  for (int i = 0; i < 5; ++i)
+    pool_.TakeWebView(GetBuilder());
+  task_environment_.FastForwardBy(WKWebViewPool::kFillDelay);
+  EXPECT_EQ(static_cast<int>(WKWebViewPool::kSize), build_count_);
+}
+
+// Tests that Clear() empties the pool and cancels a pending fill.
+TEST_F(WKWebViewPoolTest, Clear) {
+  pool_.TakeWebView(GetBuilder());
+  task_environment_.FastForwardBy(WKWebViewPool::kFillDelay);
+  ASSERT_EQ(WKWebViewPool::kSize, pool_.size());
+
+  pool_.Clear();
+  EXPECT_EQ(0U, pool_.size());
+  EXPECT_FALSE(pool_.TakeWebView(GetBuilder()));
+
+  // The fill scheduled by the take above is cancelled by Clear().
+  pool_.Clear();
+  task_environment_.FastForwardBy(WKWebViewPool::kFillDelay);
+  EXPECT_EQ(0U, pool_.size());
+}
+
+// Tests that memory pressure empties the pool and delays its refill.
+TEST_F(WKWebViewPoolTest, MemoryPressure) {
+  pool_.TakeWebView(GetBuilder());
+  task_environment_.FastForwardBy(WKWebViewPool::kFillDelay);
+  ASSERT_EQ(WKWebViewPool::kSize, pool_.size());
+
+  base::MemoryPressureListener::SimulatePressureNotification(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(0U, pool_.size());
+
+  // Taking a web view does not bring the refill forward.
+  EXPECT_FALSE(pool_.TakeWebView(GetBuilder()));
+  task_environment_.FastForwardBy(WKWebViewPool::kFillDelay);
+  EXPECT_EQ(0U, pool_.size());
+
+  task_environment_.FastForwardBy(WKWebViewPool::kMemoryPressureFillDelay);
+  EXPECT_EQ(WKWebViewPool::kSize, pool_.size());
+}
+
+}  // namespace web
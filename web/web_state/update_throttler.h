@@ -0,0 +1,61 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IOS_WEB_WEB_STATE_UPDATE_THROTTLER_H_
+#define IOS_WEB_WEB_STATE_UPDATE_THROTTLER_H_
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace web {
+
+// Coalesces frequent updates so that |callback| runs at most once per
+// |interval|. An update received after a quiet interval is delivered
+// immediately. Updates received during the interval are coalesced into a
+// single one, delivered at the end of the interval, so the last update is
+// never lost.
+class UpdateThrottler {
+ public:
+  UpdateThrottler(base::TimeDelta interval, base::RepeatingClosure callback);
+  ~UpdateThrottler();
+
+  // Returns the duration of a frame of the main display.
+  static base::TimeDelta GetDisplayFrameInterval();
+
+  // Requests an update.
+  void Update();
+
+  // Immediately delivers the pending update, if any.
+  void Flush();
+
+  // Returns true if an update is waiting for the end of the interval.
+  bool HasPendingUpdate() const;
+
+  // Number of updates that were coalesced into a later one.
+  int suppressed_update_count() const { return suppressed_update_count_; }
+  void ResetSuppressedUpdateCount() { suppressed_update_count_ = 0; }
+
+ private:
+  // Runs |callback_| and starts a new interval.
+  void Deliver();
+
+  const base::TimeDelta interval_;
+  base::RepeatingClosure callback_;
+
+  // Time of the last delivered update.
+  base::TimeTicks last_delivery_time_;
+
+  // Runs at the end of the interval if an update is pending.
+  base::OneShotTimer timer_;
+
+  int suppressed_update_count_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(UpdateThrottler);
+};
+
+}  // namespace web
+
+#endif  // IOS_WEB_WEB_STATE_UPDATE_THROTTLER_H_
@@ -0,0 +1,68 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/web/web_state/update_throttler.h"
+
+#import <UIKit/UIKit.h>
+
+#include "base/bind.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace web {
+
+UpdateThrottler::UpdateThrottler(base::TimeDelta interval,
+                                 base::RepeatingClosure callback)
+    : interval_(interval), callback_(std::move(callback)) {
+  DCHECK(!callback_.is_null());
+}
+
+UpdateThrottler::~UpdateThrottler() = default;
+
+// static
+base::TimeDelta UpdateThrottler::GetDisplayFrameInterval() {
+  // ProMotion displays run at 120fps, other displays at 60fps.
+  NSInteger frames_per_second = UIScreen.mainScreen.maximumFramesPerSecond;
+  if (frames_per_second <= 0)
+    frames_per_second = 60;
+  return base::TimeDelta::FromSeconds(1) / frames_per_second;
+}
+
+void UpdateThrottler::Update() {
+  if (timer_.IsRunning()) {
+    // The pending update will carry this one.
+    suppressed_update_count_++;
+    return;
+  }
+
+  const base::TimeTicks next_delivery_time = last_delivery_time_ + interval_;
+  const base::TimeTicks now = base::TimeTicks::Now();
+  if (last_delivery_time_.is_null() || now >= next_delivery_time) {
+    Deliver();
+    return;
+  }
+
+  timer_.Start(FROM_HERE, next_delivery_time - now,
+               base::BindOnce(&UpdateThrottler::Deliver,
+                              base::Unretained(this)));
+}
+
+void UpdateThrottler::Flush() {
+  if (timer_.IsRunning())
+    Deliver();
+}
+
+bool UpdateThrottler::HasPendingUpdate() const {
+  return timer_.IsRunning();
+}
+
+void UpdateThrottler::Deliver() {
+  timer_.Stop();
+  last_delivery_time_ = base::TimeTicks::Now();
+  callback_.Run();
+}
+
+}  // namespace web
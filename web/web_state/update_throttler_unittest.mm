@@ -0,0 +1,98 @@
+// Copyright 2021 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#import "ios/web/web_state/update_throttler.h"
+
+#include "base/bind.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+
+#if !defined(__has_feature) || !__has_feature(objc_arc)
+#error "This file requires ARC support."
+#endif
+
+namespace web {
+
+namespace {
+constexpr base::TimeDelta kInterval = base::TimeDelta::FromMilliseconds(16);
+}  // namespace
+
+class UpdateThrottlerTest : public PlatformTest {
+ public:
+  UpdateThrottlerTest()
+      : throttler_(kInterval,
+                   base::BindRepeating(&UpdateThrottlerTest::OnUpdate,
+                                       base::Unretained(this))) {}
+
+  void OnUpdate() { update_count_++; }
+
+ protected:
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  UpdateThrottler throttler_;
+  int update_count_ = 0;
+};
+
+// Tests that the first update is delivered immediately.
+TEST_F(UpdateThrottlerTest, FirstUpdateIsImmediate) {
+  throttler_.Update();
+  EXPECT_EQ(1, update_count_);
+  EXPECT_FALSE(throttler_.HasPendingUpdate());
+}
+
+// Tests that updates received during an interval are coalesced and delivered
+// at the end of the interval.
+TEST_F(UpdateThrottlerTest, CoalescesUpdatesWithinInterval) {
+  throttler_.Update();
+  for (int i = 0; i < 10; i++)
+    throttler_.Update();
+  EXPECT_EQ(1, update_count_);
+  EXPECT_TRUE(throttler_.HasPendingUpdate());
+  EXPECT_EQ(9, throttler_.suppressed_update_count());
+
+  task_environment_.FastForwardBy(kInterval);
+  EXPECT_EQ(2, update_count_);
+  EXPECT_FALSE(throttler_.HasPendingUpdate());
+
+  // An update after a quiet interval is delivered immediately.
+  task_environment_.FastForwardBy(kInterval);
+  throttler_.Update();
+  EXPECT_EQ(3, update_count_);
+}
+
+// Tests that Flush() delivers the pending update immediately.
+TEST_F(UpdateThrottlerTest, Flush) {
+  throttler_.Update();
+  throttler_.Update();
+  EXPECT_EQ(1, update_count_);
+
+  throttler_.Flush();
+  EXPECT_EQ(2, update_count_);
+  EXPECT_FALSE(throttler_.HasPendingUpdate());
+
+  // Flushing without a pending update is a no-op.
+  throttler_.Flush();
+  EXPECT_EQ(2, update_count_);
+}
+
+// Tests that the suppressed update count can be reset.
+TEST_F(UpdateThrottlerTest, ResetSuppressedUpdateCount) {
+  throttler_.Update();
+  throttler_.Update();
+  throttler_.Update();
+  EXPECT_EQ(1, throttler_.suppressed_update_count());
+  throttler_.ResetSuppressedUpdateCount();
+  EXPECT_EQ(0, throttler_.suppressed_update_count());
+}
+
+// Tests that the display frame interval is at most the duration of a frame at
+// 60fps.
+TEST_F(UpdateThrottlerTest, DisplayFrameInterval) {
+  base::TimeDelta interval = UpdateThrottler::GetDisplayFrameInterval();
+  EXPECT_GT(interval, base::TimeDelta());
+  EXPECT_LE(interval, base::TimeDelta::FromSeconds(1) / 60);
+}
+
+}  // namespace web
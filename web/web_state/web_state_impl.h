@@ -8,6 +8,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <array>
 #include <map>
 #include <memory>
 #include <string>
@@ -26,6 +27,7 @@
 #include "ios/web/public/ui/java_script_dialog_type.h"
 #import "ios/web/public/web_state.h"
 #import "ios/web/public/web_state_delegate.h"
+#include "ios/web/public/web_state_observer.h"
 #include "url/gurl.h"
 
 @class CRWSessionStorage;
@@ -44,6 +46,7 @@ struct FaviconURL;
 class NavigationContextImpl;
 class NavigationManager;
 class SessionCertificatePolicyCacheImpl;
+class UpdateThrottler;
 class WebFrame;
 class WebUIIOS;
 
@@ -108,6 +111,14 @@ class WebStateImpl : public WebState,
   // Called when new FaviconURL candidates are received.
   void OnFaviconUrlUpdated(const std::vector<FaviconURL>& candidates);
 
+  // Returns the number of observer calls for |event| since the start of the
+  // current page load.
+  int GetObserverDispatchCount(WebStateObserver::Event event) const;
+
+  // Returns the number of throttled |event| notifications that were coalesced
+  // since the start of the current page load.
+  int GetSuppressedUpdateCount(WebStateObserver::Event event) const;
+
   // Returns the NavigationManager for this WebState.
   const NavigationManagerImpl& GetNavigationManagerImpl() const;
   NavigationManagerImpl& GetNavigationManagerImpl();
@@ -346,6 +357,34 @@ class WebStateImpl : public WebState,
   // Restores session history into the navigation manager.
   void RestoreSessionStorage(CRWSessionStorage* session_storage);
 
+  using WebStateObserverList =
+      base::ObserverList<WebStateObserver, true>::Unchecked;
+
+  // Returns the observers interested in |event|, and records that |event| is
+  // being dispatched to them.
+  WebStateObserverList& ObserversFor(WebStateObserver::Event event);
+
+  // Same as ObserversFor(), for the observers receiving throttled |event|
+  // notifications.
+  WebStateObserverList& ThrottledObserversFor(WebStateObserver::Event event);
+
+  // Returns true if some observers receive throttled |event| notifications.
+  bool HasThrottledObservers(WebStateObserver::Event event) const;
+
+  // Notifies the throttled observers of the latest load progress and title.
+  void DispatchThrottledLoadProgress();
+  void DispatchThrottledTitle();
+
+  // Delivers the pending throttled notifications, if any.
+  void FlushThrottledUpdates();
+
+  // Resets the dispatch counts at the start of a new page load.
+  void ResetObserverDispatchCounts();
+
+  // Reports the dispatch counts of the page load that just finished to tracing
+  // and UMA.
+  void ReportObserverDispatchCounts();
+
   // Delegate, not owned by this object.
   WebStateDelegate* delegate_;
 
@@ -373,7 +412,38 @@ class WebStateImpl : public WebState,
   std::unique_ptr<web::WebUIIOS> web_ui_;
 
   // A list of observers notified when page state changes. Weak references.
-  base::ObserverList<WebStateObserver, true>::Unchecked observers_;
+  // Only used to dispatch WebStateDestroyed(); other events are dispatched
+  // using |event_observers_|.
+  WebStateObserverList observers_;
+
+  // For each WebStateObserver::Event, the observers interested in that event.
+  std::array<WebStateObserverList, WebStateObserver::kEventCount>
+      event_observers_;
+
+  // For each WebStateObserver::Event, the number of observers in
+  // |event_observers_|.
+  std::array<int, WebStateObserver::kEventCount> event_observer_counts_ = {};
+
+  // For each WebStateObserver::Event in WebStateObserver::kThrottleableEvents,
+  // the observers receiving throttled notifications for that event, and their
+  // number. These observers are not in |event_observers_|.
+  std::array<WebStateObserverList, WebStateObserver::kEventCount>
+      throttled_event_observers_;
+  std::array<int, WebStateObserver::kEventCount>
+      throttled_event_observer_counts_ = {};
+
+  // Coalesce the LoadProgressChanged() and TitleWasSet() notifications sent to
+  // |throttled_event_observers_|.
+  std::unique_ptr<UpdateThrottler> load_progress_throttler_;
+  std::unique_ptr<UpdateThrottler> title_throttler_;
+
+  // Latest load progress, delivered by |load_progress_throttler_|.
+  double throttled_load_progress_ = 0.0;
+
+  // For each WebStateObserver::Event, the number of observer calls since the
+  // start of the current page load.
+  std::array<int, WebStateObserver::kEventCount> observer_dispatch_counts_ =
+      {};
 
   // All the WebStatePolicyDeciders asked for navigation decision. Weak
   // references.
@@ -11,8 +11,10 @@
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/stl_util.h"
 #include "base/strings/sys_string_conversions.h"
 #include "base/threading/sequenced_task_runner_handle.h"
+#include "base/trace_event/trace_event.h"
 #import "ios/web/common/crw_content_view.h"
 #include "ios/web/common/features.h"
 #include "ios/web/common/url_util.h"
@@ -45,6 +47,7 @@
 #import "ios/web/web_state/ui/crw_web_controller.h"
 #import "ios/web/web_state/ui/crw_web_controller_container_view.h"
 #import "ios/web/web_state/ui/crw_web_view_navigation_proxy.h"
+#import "ios/web/web_state/update_throttler.h"
 #include "ios/web/webui/web_ui_ios_controller_factory_registry.h"
 #include "ios/web/webui/web_ui_ios_impl.h"
 #include "net/http/http_response_headers.h"
@@ -61,6 +64,31 @@ namespace {
 web::WebState* ReturnWeakReference(base::WeakPtr<WebStateImpl> weak_web_state) {
   return weak_web_state.get();
 }
+
+// Names of the trace counters recording the number of observer calls per page
+// load, indexed by WebStateObserver::Event.
+const char* const kObserverDispatchCounterNames[] = {
+    "WebStateObserver.WasShown",
+    "WebStateObserver.WasHidden",
+    "WebStateObserver.DidStartNavigation",
+    "WebStateObserver.DidRedirectNavigation",
+    "WebStateObserver.DidFinishNavigation",
+    "WebStateObserver.DidStartLoading",
+    "WebStateObserver.DidStopLoading",
+    "WebStateObserver.PageLoaded",
+    "WebStateObserver.LoadProgressChanged",
+    "WebStateObserver.DidChangeBackForwardState",
+    "WebStateObserver.TitleWasSet",
+    "WebStateObserver.DidChangeVisibleSecurityState",
+    "WebStateObserver.FaviconUrlUpdated",
+    "WebStateObserver.WebFrameDidBecomeAvailable",
+    "WebStateObserver.WebFrameWillBecomeUnavailable",
+    "WebStateObserver.RenderProcessGone",
+};
+static_assert(base::size(kObserverDispatchCounterNames) ==
+                  WebStateObserver::kEventCount,
+              "kObserverDispatchCounterNames must match "
+              "WebStateObserver::Event");
 }  // namespace
 
 /* static */
@@ -91,6 +119,16 @@ WebStateImpl::WebStateImpl(const CreateParams& params,
                            ? UserAgentType::AUTOMATIC
                            : UserAgentType::MOBILE),
       weak_factory_(this) {
+  const base::TimeDelta frame_interval =
+      UpdateThrottler::GetDisplayFrameInterval();
+  load_progress_throttler_ = std::make_unique<UpdateThrottler>(
+      frame_interval,
+      base::BindRepeating(&WebStateImpl::DispatchThrottledLoadProgress,
+                          base::Unretained(this)));
+  title_throttler_ = std::make_unique<UpdateThrottler>(
+      frame_interval, base::BindRepeating(&WebStateImpl::DispatchThrottledTitle,
+                                          base::Unretained(this)));
+
   navigation_manager_ = std::make_unique<NavigationManagerImpl>();
 
   navigation_manager_->SetDelegate(this);
@@ -152,11 +190,62 @@ void WebStateImpl::SetDelegate(WebStateDelegate* delegate) {
 void WebStateImpl::AddObserver(WebStateObserver* observer) {
   DCHECK(!observers_.HasObserver(observer));
   observers_.AddObserver(observer);
+
+  const WebStateObserver::EventMask observed_events =
+      observer->GetObservedEvents();
+  WebStateObserver::EventMask throttled_events = 0;
+  if (base::FeatureList::IsEnabled(
+          features::kThrottleWebStateObserverUpdates)) {
+    throttled_events = observer->GetThrottledEvents() &
+                       WebStateObserver::kThrottleableEvents;
+  }
+  for (size_t index = 0; index < WebStateObserver::kEventCount; ++index) {
+    const auto event = static_cast<WebStateObserver::Event>(index);
+    if (!(observed_events & WebStateObserver::EventBit(event)))
+      continue;
+    if (throttled_events & WebStateObserver::EventBit(event)) {
+      throttled_event_observers_[index].AddObserver(observer);
+      ++throttled_event_observer_counts_[index];
+    } else {
+      event_observers_[index].AddObserver(observer);
+      ++event_observer_counts_[index];
+    }
+  }
 }
 
 void WebStateImpl::RemoveObserver(WebStateObserver* observer) {
   DCHECK(observers_.HasObserver(observer));
   observers_.RemoveObserver(observer);
+
+  // Do not call GetObservedEvents() again, as the observer may be partially
+  // destroyed.
+  for (size_t index = 0; index < WebStateObserver::kEventCount; ++index) {
+    if (event_observers_[index].HasObserver(observer)) {
+      event_observers_[index].RemoveObserver(observer);
+      --event_observer_counts_[index];
+    }
+    if (throttled_event_observers_[index].HasObserver(observer)) {
+      throttled_event_observers_[index].RemoveObserver(observer);
+      --throttled_event_observer_counts_[index];
+    }
+  }
+}
+
+int WebStateImpl::GetObserverDispatchCount(
+    WebStateObserver::Event event) const {
+  return observer_dispatch_counts_[static_cast<size_t>(event)];
+}
+
+int WebStateImpl::GetSuppressedUpdateCount(
+    WebStateObserver::Event event) const {
+  switch (event) {
+    case WebStateObserver::Event::kLoadProgressChanged:
+      return load_progress_throttler_->suppressed_update_count();
+    case WebStateObserver::Event::kTitleWasSet:
+      return title_throttler_->suppressed_update_count();
+    default:
+      return 0;
+  }
 }
 
 void WebStateImpl::AddPolicyDecider(WebStatePolicyDecider* decider) {
@@ -179,6 +268,67 @@ bool WebStateImpl::Configured() const {
   return web_controller_ != nil;
 }
 
+WebStateImpl::WebStateObserverList& WebStateImpl::ObserversFor(
+    WebStateObserver::Event event) {
+  const size_t index = static_cast<size_t>(event);
+  observer_dispatch_counts_[index] += event_observer_counts_[index];
+  return event_observers_[index];
+}
+
+WebStateImpl::WebStateObserverList& WebStateImpl::ThrottledObserversFor(
+    WebStateObserver::Event event) {
+  const size_t index = static_cast<size_t>(event);
+  observer_dispatch_counts_[index] += throttled_event_observer_counts_[index];
+  return throttled_event_observers_[index];
+}
+
+bool WebStateImpl::HasThrottledObservers(WebStateObserver::Event event) const {
+  return throttled_event_observer_counts_[static_cast<size_t>(event)] > 0;
+}
+
+void WebStateImpl::DispatchThrottledLoadProgress() {
+  for (auto& observer :
+       ThrottledObserversFor(WebStateObserver::Event::kLoadProgressChanged))
+    observer.LoadProgressChanged(this, throttled_load_progress_);
+}
+
+void WebStateImpl::DispatchThrottledTitle() {
+  for (auto& observer :
+       ThrottledObserversFor(WebStateObserver::Event::kTitleWasSet))
+    observer.TitleWasSet(this);
+}
+
+void WebStateImpl::FlushThrottledUpdates() {
+  load_progress_throttler_->Flush();
+  title_throttler_->Flush();
+}
+
+void WebStateImpl::ResetObserverDispatchCounts() {
+  observer_dispatch_counts_.fill(0);
+  load_progress_throttler_->ResetSuppressedUpdateCount();
+  title_throttler_->ResetSuppressedUpdateCount();
+}
+
+void WebStateImpl::ReportObserverDispatchCounts() {
+  int total_dispatch_count = 0;
+  for (size_t index = 0; index < WebStateObserver::kEventCount; ++index) {
+    TRACE_COUNTER_ID1("browser", kObserverDispatchCounterNames[index], this,
+                      observer_dispatch_counts_[index]);
+    total_dispatch_count += observer_dispatch_counts_[index];
+  }
+  UMA_HISTOGRAM_COUNTS_10000("IOS.WebState.ObserverDispatchesPerPageLoad",
+                             total_dispatch_count);
+
+  if (base::FeatureList::IsEnabled(
+          features::kThrottleWebStateObserverUpdates)) {
+    UMA_HISTOGRAM_COUNTS_1000(
+        "IOS.WebState.SuppressedLoadProgressUpdatesPerPageLoad",
+        load_progress_throttler_->suppressed_update_count());
+    UMA_HISTOGRAM_COUNTS_1000("IOS.WebState.SuppressedTitleUpdatesPerPageLoad",
+                              title_throttler_->suppressed_update_count());
+  }
+}
+
 CRWWebController* WebStateImpl::GetWebController() {
   return web_controller_;
 }
@@ -189,17 +339,21 @@ void WebStateImpl::SetWebController(CRWWebController* web_controller) {
 }
 
 void WebStateImpl::OnBackForwardStateChanged() {
-  for (auto& observer : observers_)
+  for (auto& observer :
+       ObserversFor(WebStateObserver::Event::kDidChangeBackForwardState))
     observer.DidChangeBackForwardState(this);
 }
 
 void WebStateImpl::OnTitleChanged() {
-  for (auto& observer : observers_)
+  for (auto& observer : ObserversFor(WebStateObserver::Event::kTitleWasSet))
     observer.TitleWasSet(this);
+  if (HasThrottledObservers(WebStateObserver::Event::kTitleWasSet))
+    title_throttler_->Update();
 }
 
 void WebStateImpl::OnRenderProcessGone() {
-  for (auto& observer : observers_)
+  for (auto& observer :
+       ObserversFor(WebStateObserver::Event::kRenderProcessGone))
     observer.RenderProcessGone(this);
 }
 
@@ -225,12 +379,15 @@ void WebStateImpl::SetIsLoading(bool is_loading) {
     return;
 
   is_loading_ = is_loading;
+  FlushThrottledUpdates();
 
   if (is_loading) {
-    for (auto& observer : observers_)
+    for (auto& observer :
+         ObserversFor(WebStateObserver::Event::kDidStartLoading))
       observer.DidStartLoading(this);
   } else {
-    for (auto& observer : observers_)
+    for (auto& observer :
+         ObserversFor(WebStateObserver::Event::kDidStopLoading))
       observer.DidStopLoading(this);
   }
 }
@@ -268,17 +425,22 @@ void WebStateImpl::OnPageLoaded(const GURL& url, bool load_success) {
   if (wk_navigation_util::IsWKInternalUrl(url))
     return;
 
+  FlushThrottledUpdates();
+
   PageLoadCompletionStatus load_completion_status =
       load_success ? PageLoadCompletionStatus::SUCCESS
                    : PageLoadCompletionStatus::FAILURE;
-  for (auto& observer : observers_)
+  for (auto& observer : ObserversFor(WebStateObserver::Event::kPageLoaded))
     observer.PageLoaded(this, load_completion_status);
+
+  ReportObserverDispatchCounts();
 }
 
 void WebStateImpl::OnFaviconUrlUpdated(
     const std::vector<FaviconURL>& candidates) {
   cached_favicon_urls_ = candidates;
-  for (auto& observer : observers_)
+  for (auto& observer :
+       ObserversFor(WebStateObserver::Event::kFaviconUrlUpdated))
     observer.FaviconUrlUpdated(this, candidates);
 }
 
@@ -338,8 +500,17 @@ const std::u16string& WebStateImpl::GetTitle() const {
 }
 
 void WebStateImpl::SendChangeLoadProgress(double progress) {
-  for (auto& observer : observers_)
+  for (auto& observer :
+       ObserversFor(WebStateObserver::Event::kLoadProgressChanged))
     observer.LoadProgressChanged(this, progress);
+
+  if (!HasThrottledObservers(WebStateObserver::Event::kLoadProgressChanged))
+    return;
+  throttled_load_progress_ = progress;
+  load_progress_throttler_->Update();
+  // The end of the load is always delivered without delay.
+  if (progress >= 1.0)
+    load_progress_throttler_->Flush();
 }
 
 void WebStateImpl::HandleContextMenu(const web::ContextMenuParams& params) {
@@ -551,7 +722,8 @@ UIView* WebStateImpl::GetWebViewContainer() {
 #pragma mark - RequestTracker management
 
 void WebStateImpl::DidChangeVisibleSecurityState() {
-  for (auto& observer : observers_)
+  for (auto& observer :
+       ObserversFor(WebStateObserver::Event::kDidChangeVisibleSecurityState))
     observer.DidChangeVisibleSecurityState(this);
 }
 
@@ -562,12 +734,14 @@ WebState::InterfaceBinder* WebStateImpl::GetInterfaceBinderForMainFrame() {
 #pragma mark - WebFrame management
 
 void WebStateImpl::OnWebFrameAvailable(web::WebFrame* frame) {
-  for (auto& observer : observers_)
+  for (auto& observer :
+       ObserversFor(WebStateObserver::Event::kWebFrameDidBecomeAvailable))
     observer.WebFrameDidBecomeAvailable(this, frame);
 }
 
 void WebStateImpl::OnWebFrameUnavailable(web::WebFrame* frame) {
-  for (auto& observer : observers_)
+  for (auto& observer :
+       ObserversFor(WebStateObserver::Event::kWebFrameWillBecomeUnavailable))
     observer.WebFrameWillBecomeUnavailable(this, frame);
 }
 
@@ -600,7 +774,7 @@ void WebStateImpl::WasShown() {
     return;
 
   [web_controller_ wasShown];
-  for (auto& observer : observers_)
+  for (auto& observer : ObserversFor(WebStateObserver::Event::kWasShown))
     observer.WasShown(this);
 }
 
@@ -609,7 +783,7 @@ void WebStateImpl::WasHidden() {
     return;
 
   [web_controller_ wasHidden];
-  for (auto& observer : observers_)
+  for (auto& observer : ObserversFor(WebStateObserver::Event::kWasHidden))
     observer.WasHidden(this);
 }
 
@@ -837,12 +1011,17 @@ void WebStateImpl::OnNavigationStarted(web::NavigationContextImpl* context) {
     return;
   }
 
-  for (auto& observer : observers_)
+  if (!context->IsSameDocument())
+    ResetObserverDispatchCounts();
+
+  for (auto& observer :
+       ObserversFor(WebStateObserver::Event::kDidStartNavigation))
     observer.DidStartNavigation(this, context);
 }
 
 void WebStateImpl::OnNavigationRedirected(web::NavigationContextImpl* context) {
-  for (auto& observer : observers_)
+  for (auto& observer :
+       ObserversFor(WebStateObserver::Event::kDidRedirectNavigation))
     observer.DidRedirectNavigation(this, context);
 }
 
@@ -857,7 +1036,8 @@ void WebStateImpl::OnNavigationFinished(web::NavigationContextImpl* context) {
     return;
   }
 
-  for (auto& observer : observers_)
+  for (auto& observer :
+       ObserversFor(WebStateObserver::Event::kDidFinishNavigation))
     observer.DidFinishNavigation(this, context);
 
   // Update cached_favicon_urls_.
@@ -868,7 +1048,8 @@ void WebStateImpl::OnNavigationFinished(web::NavigationContextImpl* context) {
   } else if (!cached_favicon_urls_.empty()) {
     // For same-document navigations favicon urls will not be refetched and
     // WebStateObserver:FaviconUrlUpdated must use the cached results.
-    for (auto& observer : observers_) {
+    for (auto& observer :
+         ObserversFor(WebStateObserver::Event::kFaviconUrlUpdated)) {
       observer.FaviconUrlUpdated(this, cached_favicon_urls_);
     }
   }
@@ -7,6 +7,7 @@
 #include <stddef.h>
 
 #include <memory>
+#include <vector>
 
 #import <OCMock/OCMock.h>
 
@@ -16,6 +17,7 @@
 #include "base/mac/foundation_util.h"
 #import "base/strings/sys_string_conversions.h"
 #include "base/test/gmock_callback_support.h"
+#include "base/test/scoped_feature_list.h"
 #import "base/test/ios/wait_util.h"
 #include "ios/web/common/features.h"
 #import "ios/web/common/uikit_ui_util.h"
@@ -110,6 +112,44 @@ class TestGlobalWebStateObserver : public GlobalWebStateObserver {
   bool web_state_destroyed_called_;
 };
 
+// Test observer which is only interested in TitleWasSet().
+class TitleWebStateObserver : public WebStateObserver {
+ public:
+  EventMask GetObservedEvents() const override {
+    return EventBit(Event::kTitleWasSet);
+  }
+  void TitleWasSet(WebState* web_state) override { title_was_set_count_++; }
+  void LoadProgressChanged(WebState* web_state, double progress) override {
+    load_progress_changed_count_++;
+  }
+  void WebStateDestroyed(WebState* web_state) override {
+    web_state_destroyed_called_ = true;
+    web_state->RemoveObserver(this);
+  }
+
+  int title_was_set_count_ = 0;
+  int load_progress_changed_count_ = 0;
+  bool web_state_destroyed_called_ = false;
+};
+
+// Test observer which records the LoadProgressChanged() notifications it
+// receives, optionally throttled.
+class ProgressObserver : public WebStateObserver {
+ public:
+  explicit ProgressObserver(EventMask throttled_events)
+      : throttled_events_(throttled_events) {}
+
+  EventMask GetThrottledEvents() const override { return throttled_events_; }
+  void LoadProgressChanged(WebState* web_state, double progress) override {
+    progress_values_.push_back(progress);
+  }
+
+  std::vector<double> progress_values_;
+
+ private:
+  const EventMask throttled_events_;
+};
+
 // Test decider to check that the WebStatePolicyDecider methods are called as
 // expected.
 class MockWebStatePolicyDecider : public WebStatePolicyDecider {
@@ -1003,6 +1043,62 @@ TEST_F(WebStateImplTest, FaviconUpdateForSameDocumentNavigations) {
   EXPECT_FALSE(observer->update_favicon_url_candidates_info());
 }
 
+// Tests that events are only dispatched to the observers interested in them,
+// and that dispatches are counted.
+TEST_F(WebStateImplTest, ObserverEventFiltering) {
+  TitleWebStateObserver title_observer;
+  web_state_->AddObserver(&title_observer);
+  FakeWebStateObserver all_events_observer(web_state_.get());
+
+  web_state_->OnTitleChanged();
+  web_state_->SendChangeLoadProgress(0.5);
+  EXPECT_EQ(1, title_observer.title_was_set_count_);
+  EXPECT_EQ(0, title_observer.load_progress_changed_count_);
+  EXPECT_TRUE(all_events_observer.title_was_set_info());
+  EXPECT_TRUE(all_events_observer.change_loading_progress_info());
+  EXPECT_EQ(2, web_state_->GetObserverDispatchCount(
+                   WebStateObserver::Event::kTitleWasSet));
+  EXPECT_EQ(1, web_state_->GetObserverDispatchCount(
+                   WebStateObserver::Event::kLoadProgressChanged));
+
+  // Removed observers are no longer notified.
+  web_state_->RemoveObserver(&title_observer);
+  web_state_->OnTitleChanged();
+  EXPECT_EQ(1, title_observer.title_was_set_count_);
+  EXPECT_EQ(3, web_state_->GetObserverDispatchCount(
+                   WebStateObserver::Event::kTitleWasSet));
+
+  // WebStateDestroyed() is sent regardless of the observed events.
+  web_state_->AddObserver(&title_observer);
+  web_state_.reset();
+  EXPECT_TRUE(title_observer.web_state_destroyed_called_);
+}
+
+// Tests that observers opting in to throttling always receive the end of the
+// load, and that the other observers receive every update.
+TEST_F(WebStateImplTest, ThrottledLoadProgress) {
+  base::test::ScopedFeatureList feature_list;
+  feature_list.InitAndEnableFeature(
+      features::kThrottleWebStateObserverUpdates);
+  ProgressObserver throttled_observer(WebStateObserver::EventBit(
+      WebStateObserver::Event::kLoadProgressChanged));
+  ProgressObserver unthrottled_observer(0);
+  web_state_->AddObserver(&throttled_observer);
+  web_state_->AddObserver(&unthrottled_observer);
+
+  web_state_->SendChangeLoadProgress(0.1);
+  EXPECT_EQ(std::vector<double>{0.1}, throttled_observer.progress_values_);
+
+  web_state_->SendChangeLoadProgress(0.5);
+  web_state_->SendChangeLoadProgress(1.0);
+  EXPECT_EQ(1.0, throttled_observer.progress_values_.back());
+  EXPECT_EQ((std::vector<double>{0.1, 0.5, 1.0}),
+            unthrottled_observer.progress_values_);
+
+  web_state_->RemoveObserver(&throttled_observer);
+  web_state_->RemoveObserver(&unthrottled_observer);
+}
+
 // Tests that BuildSessionStorage() and GetTitle() return information about the
 // most recently restored session if no navigation item has been committed. Also
 // tests that re-restoring that session includes updated userData.
@@ -10,8 +10,23 @@
 
 namespace web {
 
+// static
+constexpr size_t WebStateObserver::kEventCount;
+// static
+constexpr WebStateObserver::EventMask WebStateObserver::kAllEvents;
+// static
+constexpr WebStateObserver::EventMask WebStateObserver::kThrottleableEvents;
+
 WebStateObserver::WebStateObserver() = default;
 
 WebStateObserver::~WebStateObserver() = default;
 
+WebStateObserver::EventMask WebStateObserver::GetObservedEvents() const {
+  return kAllEvents;
+}
+
+WebStateObserver::EventMask WebStateObserver::GetThrottledEvents() const {
+  return 0;
+}
+
 }  // namespace web
@@ -15,6 +15,14 @@ WebStateObserverBridge::WebStateObserverBridge(id<CRWWebStateObserver> observer)
 
 WebStateObserverBridge::~WebStateObserverBridge() = default;
 
+WebStateObserver::EventMask WebStateObserverBridge::GetThrottledEvents()
+    const {
+  if ([observer_ respondsToSelector:@selector(throttledWebStateEvents)]) {
+    return [observer_ throttledWebStateEvents] & kThrottleableEvents;
+  }
+  return 0;
+}
+
 void WebStateObserverBridge::WasShown(web::WebState* web_state) {
   if ([observer_ respondsToSelector:@selector(webStateWasShown:)]) {
     [observer_ webStateWasShown:web_state];
@@ -43,6 +43,15 @@ WKWebView* BuildWKWebView(CGRect frame,
                           WKWebViewConfiguration* configuration,
                           BrowserState* browser_state);
 
+// Returns a WKWebView for displaying regular web content, created with the
+// configuration associated with |browser_state|. The web view is taken from
+// the WKWebViewPool of |browser_state| if one is available, and created
+// otherwise.
+WKWebView* BuildPooledWKWebView(CGRect frame,
+                                BrowserState* browser_state,
+                                UserAgentType user_agent_type,
+                                id<CRWInputViewProvider> input_view_provider);
+
 }  // namespace web
 
 #endif  // IOS_WEB_WEB_STATE_WEB_VIEW_INTERNAL_CREATION_UTIL_H_
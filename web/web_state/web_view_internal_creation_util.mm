@@ -4,11 +4,16 @@
 
 #import "ios/web/web_state/web_view_internal_creation_util.h"
 
+#include "base/bind.h"
 #include "base/check_op.h"
+#include "base/mac/foundation_util.h"
+#include "base/metrics/histogram_macros.h"
 #include "base/strings/sys_string_conversions.h"
+#include "base/timer/elapsed_timer.h"
 #import "ios/web/public/web_client.h"
 #import "ios/web/web_state/crw_web_view.h"
 #import "ios/web/web_state/ui/wk_web_view_configuration_provider.h"
+#import "ios/web/web_state/ui/wk_web_view_pool.h"
 
 #if !defined(__has_feature) || !__has_feature(objc_arc)
 #error "This file requires ARC support."
@@ -32,33 +37,19 @@ void VerifyWKWebViewCreationPreConditions(
             [configuration processPool]);
 }
 
-}  // namespace
-
-WKWebView* BuildWKWebViewForQueries(WKWebViewConfiguration* configuration,
-                                    BrowserState* browser_state) {
-  VerifyWKWebViewCreationPreConditions(browser_state, configuration);
-  return [[WKWebView alloc] initWithFrame:CGRectZero
-                            configuration:configuration];
-}
-
-WKWebView* BuildWKWebView(CGRect frame,
-                          WKWebViewConfiguration* configuration,
-                          BrowserState* browser_state,
-                          UserAgentType user_agent_type,
-                          id<CRWInputViewProvider> input_view_provider) {
+// Creates a CRWWebView with |configuration| and the settings shared by all the
+// web views displaying regular web content.
+CRWWebView* CreateCRWWebView(CGRect frame,
+                             WKWebViewConfiguration* configuration,
+                             BrowserState* browser_state) {
   VerifyWKWebViewCreationPreConditions(browser_state, configuration);
 
   GetWebClient()->PreWebViewCreation();
 
+  base::ElapsedTimer timer;
   CRWWebView* web_view = [[CRWWebView alloc] initWithFrame:frame
                                              configuration:configuration];
-  web_view.inputViewProvider = input_view_provider;
-
-  // Set the user agent type.
-  if (user_agent_type != web::UserAgentType::NONE) {
-    web_view.customUserAgent = base::SysUTF8ToNSString(
-        web::GetWebClient()->GetUserAgent(user_agent_type));
-  }
+  UMA_HISTOGRAM_TIMES("IOS.WKWebView.CreationTime", timer.Elapsed());
 
   // By default the web view uses a very sluggish scroll speed. Set it to a more
   // reasonable value.
@@ -71,6 +62,47 @@ WKWebView* BuildWKWebView(CGRect frame,
   return web_view;
 }
 
+// Applies the settings which depend on the user of |web_view|.
+void ConfigureCRWWebView(CRWWebView* web_view,
+                         UserAgentType user_agent_type,
+                         id<CRWInputViewProvider> input_view_provider) {
+  web_view.inputViewProvider = input_view_provider;
+
+  // Set the user agent type.
+  if (user_agent_type != web::UserAgentType::NONE) {
+    web_view.customUserAgent = base::SysUTF8ToNSString(
+        web::GetWebClient()->GetUserAgent(user_agent_type));
+  }
+}
+
+// Creates a web view for the WKWebViewPool of |browser_state|.
+WKWebView* BuildWKWebViewForPool(BrowserState* browser_state) {
+  WKWebViewConfigurationProvider& config_provider =
+      WKWebViewConfigurationProvider::FromBrowserState(browser_state);
+  return CreateCRWWebView(CGRectZero,
+                          config_provider.GetWebViewConfiguration(),
+                          browser_state);
+}
+
+}  // namespace
+
+WKWebView* BuildWKWebViewForQueries(WKWebViewConfiguration* configuration,
+                                    BrowserState* browser_state) {
+  VerifyWKWebViewCreationPreConditions(browser_state, configuration);
+  return [[WKWebView alloc] initWithFrame:CGRectZero
+                            configuration:configuration];
+}
+
+WKWebView* BuildWKWebView(CGRect frame,
+                          WKWebViewConfiguration* configuration,
+                          BrowserState* browser_state,
+                          UserAgentType user_agent_type,
+                          id<CRWInputViewProvider> input_view_provider) {
+  CRWWebView* web_view = CreateCRWWebView(frame, configuration, browser_state);
+  ConfigureCRWWebView(web_view, user_agent_type, input_view_provider);
+  return web_view;
+}
+
 WKWebView* BuildWKWebView(CGRect frame,
                           WKWebViewConfiguration* configuration,
                           BrowserState* browser_state) {
@@ -78,4 +110,23 @@ WKWebView* BuildWKWebView(CGRect frame,
                         UserAgentType::MOBILE, nil);
 }
 
+WKWebView* BuildPooledWKWebView(CGRect frame,
+                                BrowserState* browser_state,
+                                UserAgentType user_agent_type,
+                                id<CRWInputViewProvider> input_view_provider) {
+  WKWebViewConfigurationProvider& config_provider =
+      WKWebViewConfigurationProvider::FromBrowserState(browser_state);
+  WKWebView* pooled_web_view = config_provider.GetWebViewPool().TakeWebView(
+      base::BindRepeating(&BuildWKWebViewForPool, browser_state));
+  if (!pooled_web_view) {
+    return BuildWKWebView(frame, config_provider.GetWebViewConfiguration(),
+                          browser_state, user_agent_type, input_view_provider);
+  }
+
+  CRWWebView* web_view = base::mac::ObjCCastStrict<CRWWebView>(pooled_web_view);
+  ConfigureCRWWebView(web_view, user_agent_type, input_view_provider);
+  web_view.frame = frame;
+  return web_view;
+}
+
 }  // namespace web